@@ -338,6 +338,10 @@ set(CONFIG_THEAD_RVV_ADD_INT8 ON)
 set(CONFIG_THEAD_RVV_AVERAGEPOOL_FP32 ON)
 set(CONFIG_THEAD_RVV_AVERAGEPOOL_FP16 ON)
 set(CONFIG_THEAD_RVV_AVERAGEPOOL_INT8 ON)
+set(CONFIG_THEAD_RVV_CACHE_CONV1D_FP32 ON)
+set(CONFIG_THEAD_RVV_CACHE_CONV1D_FP16 ON)
+set(CONFIG_THEAD_RVV_CACHE_MATMUL_FP32 ON)
+set(CONFIG_THEAD_RVV_CACHE_MATMUL_FP16 ON)
 set(CONFIG_THEAD_RVV_CLIP_FP32 ON)
 set(CONFIG_THEAD_RVV_CLIP_FP16 ON)
 set(CONFIG_THEAD_RVV_CLIP_INT8 ON)
@@ -356,6 +360,7 @@ set(CONFIG_THEAD_RVV_CONVOLUTION1D_INT8 ON)
 set(CONFIG_THEAD_RVV_DEPTHWISE_CONVOLUTION1D_INT8 ON)
 set(CONFIG_THEAD_RVV_DECONVOLUTION_FP32 ON)
 set(CONFIG_THEAD_RVV_DECONVOLUTION_FP16 ON)
+set(CONFIG_THEAD_RVV_DECONVOLUTION_INT8 ON)
 set(CONFIG_THEAD_RVV_DIV_FP32 ON)
 set(CONFIG_THEAD_RVV_DIV_FP16 ON)
 set(CONFIG_THEAD_RVV_DIV_INT8 ON)
@@ -365,6 +370,8 @@ set(CONFIG_THEAD_RVV_ERF_FP16 ON)
 set(CONFIG_THEAD_RVV_ERF_INT8 ON)
 set(CONFIG_THEAD_RVV_EXPAND_DIMS_FP32 ON)
 set(CONFIG_THEAD_RVV_EXPAND_DIMS_FP16 ON)
+set(CONFIG_THEAD_RVV_FSMN_FP32 ON)
+set(CONFIG_THEAD_RVV_FSMN_FP16 ON)
 set(CONFIG_THEAD_RVV_FULLYCONNECTED_FP32 ON)
 set(CONFIG_THEAD_RVV_FULLYCONNECTED_FP16 ON)
 set(CONFIG_THEAD_RVV_FULLYCONNECTED_INT8 ON)
@@ -329,12 +329,19 @@ set(CONFIG_GRAPH_REFERENCE_RMS_NORM ON)
 set(CONFIG_GRAPH_REFERENCE_SCALED_DOT_PRODUCT_ATTENTION ON)
 set(CONFIG_E907_OPT_SOURCE ON)
 set(CONFIG_E907_OPT_CONVOLUTION ON)
+set(CONFIG_E907_OPT_DEPTHWISE_CONVOLUTION ON)
 set(CONFIG_E907_OPT_CONCAT ON)
 set(CONFIG_E907_OPT_RELU ON)
 set(CONFIG_E907_OPT_FC ON)
 set(CONFIG_E907_OPT_MUL ON)
 set(CONFIG_E907_OPT_SUM ON)
 set(CONFIG_E907_OPT_SOFTMAX ON)
+set(CONFIG_E907_OPT_AVERAGEPOOL ON)
+set(CONFIG_E907_OPT_MAXPOOL ON)
+set(CONFIG_E907_OPT_ADD ON)
+set(CONFIG_E907_OPT_SIGMOID ON)
+set(CONFIG_E907_OPT_TANH ON)
+set(CONFIG_E907_OPT_RESHAPE ON)
 set(CONFIG_USE_SHL_DEBUG ON)
 set(CONFIG_SHL_LAYER_BENCHMARK ON)
 set(CONFIG_SHL_TRACE ON)
\ No newline at end of file
@@ -382,16 +382,6 @@ int shl_c906_cache_conv1d_fp16(struct csinn_tensor *input, struct csinn_tensor *
 int shl_c906_lrn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                       struct csinn_lrn_params *params);
 
-void asr_buffer_init_c906(struct csinn_asr_buffer_t *buffer, size_t buffer_size, size_t data_lenth);
-
-void *asr_buffer_insert_c906_front(struct csinn_asr_buffer_t *buffer, void *input, size_t len);
-
-void *asr_buffer_insert_c906_back(struct csinn_asr_buffer_t *buffer, void *input, size_t len);
-
-void *asr_buffer_get_buffer_c906(struct csinn_asr_buffer_t *buffer);
-
-void asr_buffer_reset_c906(struct csinn_asr_buffer_t *buffer);
-
 void shl_c906_reset_fcsr();
 int shl_c906_get_fcsr();
 
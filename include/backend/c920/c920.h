@@ -150,6 +150,9 @@ int shl_c920_matmul_a0b1_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
 int shl_c920_matmul_a0b1_fp16_block_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                                           struct csinn_tensor *output,
                                           struct csinn_matmul_params *params);
+int shl_c920_matmul_a0b1_dynamic_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
+                                       struct csinn_tensor *output,
+                                       struct csinn_matmul_params *params);
 
 void shl_c920_u8_to_f32(const uint8_t *input, float *output, int32_t offset, float *scale,
                         uint32_t length);
@@ -30,7 +30,28 @@
 int shl_e907_fullyconnected_init(struct csinn_tensor *input, struct csinn_tensor *output,
                                  struct csinn_tensor *weights, struct csinn_tensor *bias,
                                  struct csinn_fc_params *params);
+int shl_e907_depthwise_conv2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                        struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                        struct csinn_conv2d_params *params);
+int shl_e907_avgpool2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                 struct csinn_pool_params *params);
+int shl_e907_maxpool2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                 struct csinn_pool_params *params);
+int shl_e907_sigmoid_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_sigmoid_params *params);
+int shl_e907_tanh_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_siso_params *params);
 
+int shl_e907_add_int8(struct csinn_tensor *input0, struct csinn_tensor *input1,
+                      struct csinn_tensor *output, struct csinn_diso_params *params);
+int shl_e907_avgpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_pool_params *params);
+int shl_e907_global_avgpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params);
+int shl_e907_maxpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_pool_params *params);
+int shl_e907_global_maxpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params);
 int shl_e907_concat_int8(struct csinn_tensor **input, struct csinn_tensor *output,
                          struct csinn_concat_params *params);
 int shl_e907_fullyconnected_int8(struct csinn_tensor *input, struct csinn_tensor *output,
@@ -47,6 +68,21 @@ int shl_e907_sum_int8(struct csinn_tensor *input, struct csinn_tensor *output,
 int shl_e907_conv2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_tensor *kernel, struct csinn_tensor *bias,
                          struct csinn_conv2d_params *params);
+int shl_e907_depthwise_conv2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                   struct csinn_conv2d_params *params);
+int shl_e907_reshape_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                          struct csinn_reshape_params *params);
+int shl_e907_sigmoid_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                          struct csinn_sigmoid_params *params);
+int shl_e907_tanh_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                       struct csinn_siso_params *params);
+
+int shl_e907_fullyconnected_int16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                  struct csinn_tensor *weights, struct csinn_tensor *bias,
+                                  struct csinn_fc_params *params);
+int shl_e907_relu_int16(struct csinn_tensor *input, struct csinn_tensor *output,
+                        struct csinn_relu_params *params);
 
 int shl_rvp_get_xlenb();
 void shl_rvp_int8_to_int16(int8_t *src, int16_t *dst, size_t len);
@@ -57,6 +93,10 @@ intXLEN_t shl_rvp_int16_to_xlen(int16_t val);
 intXLEN_t shl_rvp_int32_to_xlen(int32_t val);
 void shl_rvp_requantize(int32_t *src, int32_t multiplier, int32_t shift, int channel_size);
 void shl_rvp_saturated_int8(int32_t *src, int8_t *dst, int32_t out_zp, int size);
+void shl_rvp_saturated_int16(int32_t *src, int16_t *dst, int32_t out_zp, int size);
+void shl_rvp_int8_lut_init(int8_t *lut, struct csinn_tensor *input, struct csinn_tensor *output,
+                           float (*func)(float));
+void shl_rvp_int8_lut(const int8_t *input, int8_t *output, const int8_t *lut, int size);
 
 static inline int32_t shl_rvp_mulh(int32_t rs1, int32_t rs2)
 {
@@ -65,6 +105,22 @@ static inline int32_t shl_rvp_mulh(int32_t rs1, int32_t rs2)
     return ret;
 }
 
+// four int8 lanes of one word, assembled from bytes: rows and windows are not word aligned
+static inline uint32_t shl_rvp_load_8x4(const int8_t *src)
+{
+    const uint8_t *p = (const uint8_t *)src;
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void shl_rvp_store_8x4(int8_t *dst, uint32_t val)
+{
+    uint8_t *p = (uint8_t *)dst;
+    p[0] = val;
+    p[1] = val >> 8;
+    p[2] = val >> 16;
+    p[3] = val >> 24;
+}
+
 static inline int8_t shl_rvp_clip_i8(int32_t val)
 {
     if (val > 127) {
@@ -76,4 +132,15 @@ static inline int8_t shl_rvp_clip_i8(int32_t val)
     }
 }
 
+static inline int16_t shl_rvp_clip_i16(int32_t val)
+{
+    if (val > 32767) {
+        return 32767;
+    } else if (val < -32768) {
+        return -32768;
+    } else {
+        return (int16_t)val;
+    }
+}
+
 #endif  // INCLUDE_SHL_E907_H_
@@ -589,6 +589,10 @@ int shl_ref_matmul_f32(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
 int shl_ref_matmul_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                          struct csinn_tensor *output, struct csinn_matmul_params *params);
 
+int shl_ref_matmul_a0b1_dynamic_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
+                                      struct csinn_tensor *output,
+                                      struct csinn_matmul_params *params);
+
 int shl_ref_max_stride_f32(struct csinn_tensor *input, struct csinn_tensor *output,
                            struct csinn_reduce_params *params);
 
@@ -1302,16 +1306,19 @@ int shl_ref_reshape_init(struct csinn_tensor *input, struct csinn_tensor *output
 int shl_ref_transpose_init(struct csinn_tensor *input, struct csinn_tensor *output,
                            struct csinn_transpose_params *params);
 
-void asr_buffer_init(struct csinn_asr_buffer_t *buffer, size_t buffer_size, size_t data_lenth);
+void asr_buffer_init(struct csinn_asr_buffer_t *buffer, size_t data_lenth);
 
-void *asr_buffer_insert_front(struct csinn_asr_buffer_t *buffer, void *input, size_t len);
+void asr_buffer_insert_front(struct csinn_asr_buffer_t *buffer, void *input, size_t len);
 
-void *asr_buffer_insert_back(struct csinn_asr_buffer_t *buffer, void *input, size_t len);
+void asr_buffer_insert_back(struct csinn_asr_buffer_t *buffer, void *input, size_t len);
 
-void *asr_buffer_get_buffer(struct csinn_asr_buffer_t *buffer);
+void *asr_buffer_get_data(struct csinn_asr_buffer_t *buffer, size_t offset, size_t *contig_lenth);
 
 void asr_buffer_reset(struct csinn_asr_buffer_t *buffer);
 
+int shl_ref_fsmn_push_frame(struct csinn_tensor *frame, struct csinn_tensor *frame_sequence,
+                            struct csinn_tensor *frame_counter, struct csinn_fsmn_params *params);
+
 #ifdef __cplusplus
 }
 #endif
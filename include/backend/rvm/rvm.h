@@ -53,6 +53,20 @@ int shl_rvm_matmul_init_fp16(struct csinn_tensor *mat0, struct csinn_tensor *mat
 int shl_rvm_matmul_init_int8(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                              struct csinn_tensor *output, struct csinn_matmul_params *params);
 
+int shl_rvm_avgpool2d_init_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                struct csinn_pool_params *params);
+int shl_rvm_avgpool2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                struct csinn_pool_params *params);
+int shl_rvm_global_avgpool2d_init(struct csinn_tensor *input, struct csinn_tensor *output,
+                                  struct csinn_pool_params *params);
+
+int shl_rvm_maxpool2d_init_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                struct csinn_pool_params *params);
+int shl_rvm_maxpool2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                struct csinn_pool_params *params);
+int shl_rvm_global_maxpool2d_init(struct csinn_tensor *input, struct csinn_tensor *output,
+                                  struct csinn_pool_params *params);
+
 /************************************ convolution *********************************/
 /*********************************** im2col + gemm ********************************/
 void shl_rvm_conv1x1s1_gemm_reorder_kernel_int8(struct csinn_tensor *kernel,
@@ -141,4 +141,17 @@ int shl_rvv_scaled_dot_product_attention_cap(struct csinn_tensor *query, struct
 int shl_rvv_llm_pos_cap(struct csinn_tensor *input, struct csinn_tensor *output,
                         struct csinn_llm_pos_params *params);
 
+int shl_rvv_fsmn_cap(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                     struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                     struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                     struct csinn_fsmn_params *params);
+
+int shl_rvv_cache_matmul_cap(struct csinn_tensor *input, struct csinn_tensor *output,
+                             struct csinn_tensor *weight, struct csinn_tensor *bias,
+                             struct csinn_cache_matmul_params *params);
+
+int shl_rvv_cache_conv1d_cap(struct csinn_tensor *input, struct csinn_tensor *output,
+                             struct csinn_tensor *weight, struct csinn_tensor *bias,
+                             struct csinn_cache_conv1d_params *params);
+
 #endif  // INCLUDE_SHL_RVV_CAP_H_
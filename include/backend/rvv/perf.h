@@ -158,4 +158,19 @@ int shl_rvv_scaled_dot_product_attention_perf(struct csinn_tensor *query, struct
 int shl_rvv_llm_pos_perf(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_llm_pos_params *params, struct csinn_perf_info *perf_info);
 
+int shl_rvv_fsmn_perf(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                      struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                      struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                      struct csinn_fsmn_params *params, struct csinn_perf_info *perf_info);
+
+int shl_rvv_cache_matmul_perf(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_matmul_params *params,
+                              struct csinn_perf_info *perf_info);
+
+int shl_rvv_cache_conv1d_perf(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_conv1d_params *params,
+                              struct csinn_perf_info *perf_info);
+
 #endif  // INCLUDE_SHL_RVV_PERF_H_
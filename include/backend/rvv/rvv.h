@@ -86,6 +86,12 @@ int shl_rvv_deconv2d_init_fp32(struct csinn_tensor *input, struct csinn_tensor *
 int shl_rvv_deconv2d_init_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                                struct csinn_tensor *kernel, struct csinn_tensor *bias,
                                struct csinn_conv2d_params *params);
+int shl_rvv_deconv2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                               struct csinn_conv2d_params *params);
+int shl_rvv_deconv2d_init_int4(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                               struct csinn_conv2d_params *params);
 
 int shl_rvv_avgpool2d_init_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                                 struct csinn_pool_params *params);
@@ -599,6 +605,20 @@ int shl_rvv_deconv2d_gemm_col2im_fp16(struct csinn_tensor *input, struct csinn_t
                                       struct csinn_tensor *kernel, struct csinn_tensor *bias,
                                       struct csinn_conv2d_params *params);
 
+void shl_rvv_deconv2d_gemm_col2im_reorder_kernel_common_int8(struct csinn_tensor *kernel,
+                                                             struct csinn_conv2d_params *params,
+                                                             bool int4);
+void shl_rvv_deconv2d_gemm_col2im_reorder_kernel_int8(struct csinn_tensor *kernel,
+                                                      struct csinn_conv2d_params *params);
+int shl_rvv_deconv2d_gemm_col2im_common_int8(struct csinn_tensor *input,
+                                             struct csinn_tensor *output,
+                                             struct csinn_tensor *kernel,
+                                             struct csinn_tensor *bias,
+                                             struct csinn_conv2d_params *params, bool int4);
+int shl_rvv_deconv2d_gemm_col2im_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                      struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                      struct csinn_conv2d_params *params);
+
 /*************************************** gemm *************************************/
 void shl_rvv_reorder_kernel_n8_fp32(float *a, float *sa, int m, int k, int ldx);
 void shl_rvv_reorder_input_z8_fp32(float *b, float *sb, int k, int n, int ldx);
@@ -862,6 +882,8 @@ int shl_rvv_sigmoid_fp32(struct csinn_tensor *input, struct csinn_tensor *output
                          struct csinn_sigmoid_params *params);
 int shl_rvv_sigmoid_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_sigmoid_params *params);
+int shl_rvv_sigmoid_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_sigmoid_params *params);
 int shl_rvv_sigmoid_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_sigmoid_params *params);
 
@@ -872,6 +894,9 @@ int shl_rvv_softmax_fp16(struct csinn_tensor *input, struct csinn_tensor *output
 int shl_rvv_softmax_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_softmax_params *params);
 
+float shl_rvv_reduce_max_fp32(const float *x, int n);
+int shl_rvv_find_ge_fp32(const float *x, int n, float thr);
+
 int shl_rvv_prelu_fp32(struct csinn_tensor *input, struct csinn_tensor *alpha,
                        struct csinn_tensor *output, struct csinn_prelu_params *params);
 int shl_rvv_prelu_fp16(struct csinn_tensor *input, struct csinn_tensor *alpha,
@@ -890,6 +915,8 @@ int shl_rvv_silu_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                       struct csinn_sigmoid_params *params);
 int shl_rvv_silu_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                       struct csinn_sigmoid_params *params);
+int shl_rvv_silu_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                           struct csinn_sigmoid_params *params);
 int shl_rvv_silu_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                       struct csinn_sigmoid_params *params);
 
@@ -973,6 +1000,8 @@ int shl_rvv_erf_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                      struct csinn_siso_params *params);
 int shl_rvv_erf_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                      struct csinn_siso_params *params);
+int shl_rvv_erf_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                          struct csinn_siso_params *params);
 int shl_rvv_erf_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                      struct csinn_siso_params *params);
 
@@ -1033,6 +1062,27 @@ void shl_rvv_matmul_8xmf2_int8_dot(int8_t *dst, const int8_t *sa, const int8_t *
                                    int n, int ldc, int32_t z1, int32_t z2, int32_t z3, int32_t mult,
                                    int32_t shift);
 
+void shl_rvv_quantize_block_q8_fp32(const float *src, int8_t *dst, float *scale, int M, int K,
+                                    bool per_token);
+void shl_rvv_quantize_block_q8_fp16(const __fp16 *src, int8_t *dst, float *scale, int M, int K,
+                                    bool per_token);
+void shl_rvv_gemm_a0b1_int8_block_q8(float *dst, const int8_t *sa, const float *sa_scale,
+                                     const int8_t *sb, const __fp16 *sb_scale, int M, int K, int N,
+                                     int ldc);
+void shl_rvv_gemm_a0b1_int8_block_q4(float *dst, const int8_t *sa, const float *sa_scale,
+                                     const int8_t *sb, const __fp16 *sb_scale, int M, int K, int N,
+                                     int ldc);
+int shl_rvv_matmul_a0b1_dynamic_quant_common(
+    struct csinn_tensor *mat0, struct csinn_tensor *mat1, struct csinn_tensor *output,
+    struct csinn_matmul_params *params,
+    void (*gemm_q8)(float *, const int8_t *, const float *, const int8_t *, const __fp16 *, int,
+                    int, int, int),
+    void (*gemm_q4)(float *, const int8_t *, const float *, const int8_t *, const __fp16 *, int,
+                    int, int, int));
+int shl_rvv_matmul_a0b1_dynamic_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
+                                      struct csinn_tensor *output,
+                                      struct csinn_matmul_params *params);
+
 int shl_rvv_matmul_fp32(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                         struct csinn_tensor *output, struct csinn_matmul_params *params);
 int shl_rvv_matmul_fp16(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
@@ -1040,6 +1090,52 @@ int shl_rvv_matmul_fp16(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
 int shl_rvv_matmul_int8(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                         struct csinn_tensor *output, struct csinn_matmul_params *params);
 
+/******************************** asr *****************************/
+int shl_rvv_fsmn_fp32(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                      struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                      struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                      struct csinn_fsmn_params *params);
+int shl_rvv_fsmn_fp16(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                      struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                      struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                      struct csinn_fsmn_params *params);
+
+int shl_rvv_cache_matmul_init_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *weight, struct csinn_tensor *bias,
+                                   struct csinn_cache_matmul_params *params);
+int shl_rvv_cache_matmul_init_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *weight, struct csinn_tensor *bias,
+                                   struct csinn_cache_matmul_params *params);
+int shl_rvv_cache_matmul_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_matmul_params *params);
+int shl_rvv_cache_matmul_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_matmul_params *params);
+void shl_rvv_cache_matmul_push_fp32(float *frame, int frame_size, float *bias_data,
+                                    struct csinn_tensor *output,
+                                    struct csinn_cache_matmul_params *params);
+void shl_rvv_cache_matmul_push_fp16(__fp16 *frame, int frame_size, __fp16 *bias_data,
+                                    struct csinn_tensor *output,
+                                    struct csinn_cache_matmul_params *params);
+
+int shl_rvv_cache_conv1d_init_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *weight, struct csinn_tensor *bias,
+                                   struct csinn_cache_conv1d_params *params);
+int shl_rvv_cache_conv1d_init_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *weight, struct csinn_tensor *bias,
+                                   struct csinn_cache_conv1d_params *params);
+int shl_rvv_cache_conv1d_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_conv1d_params *params);
+int shl_rvv_cache_conv1d_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_conv1d_params *params);
+void shl_rvv_cache_conv1d_push_fp32(float *frame, int frame_size, struct csinn_tensor *output,
+                                    struct csinn_cache_conv1d_params *params);
+void shl_rvv_cache_conv1d_push_fp16(__fp16 *frame, int frame_size, struct csinn_tensor *output,
+                                    struct csinn_cache_conv1d_params *params);
+
 /******************************** llm *****************************/
 int shl_rvv_embedding_int32(struct csinn_tensor *input, struct csinn_tensor *weight,
                             struct csinn_tensor *output, struct csinn_diso_params *params);
@@ -1181,6 +1277,34 @@ void shl_rvv_tensor_nc1xc0_to_ndarray_inplace_int8(struct csinn_tensor *t);
 
 void shl_rvv_nc1xc0_fp16_to_nchw_fp32(struct csinn_tensor *dest, struct csinn_tensor *src);
 
+void shl_rvv_batch_fold(void *dst, const void *src, int batch, int rows, int row_size,
+                        int batch_stride);
+void shl_rvv_batch_unfold(void *dst, const void *src, int batch, int rows, int row_size,
+                          int batch_stride);
+
+void shl_rvv_int8_lut_init(int8_t *lut, struct csinn_tensor *input, struct csinn_tensor *output,
+                           float (*func)(float));
+void shl_rvv_int8_lut(const int8_t *input, int8_t *output, const int8_t *lut, int size);
+int32_t shl_rvv_rsqrt_fixed(uint64_t x, int32_t *exp);
+
+/* minimum number of elements an op must touch before it is split over threads */
+#define SHL_RVV_PARALLEL_THRESHOLD 16384
+void shl_rvv_parallel_for(int n, int64_t size, void (*func)(void *arg, int start, int end),
+                          void *arg);
+int shl_rvv_parallel_split(int64_t size);
+void shl_rvv_unary_op_flat(void *input, void *output, int64_t size, int elem_size,
+                           void (*unary_op)(void *input, void *output, int32_t size, void *arg),
+                           void *arg);
+struct shl_rvv_pool_task {
+    struct csinn_tensor *input;
+    struct csinn_tensor *output;
+    struct csinn_pool_params *params;
+};
+int shl_rvv_pool_packn_parallel(struct csinn_tensor *input, struct csinn_tensor *output,
+                                struct csinn_pool_params *params,
+                                int (*kernel)(struct csinn_tensor *, struct csinn_tensor *,
+                                              struct csinn_pool_params *));
+
 struct csinn_callback *shl_cb_map_rvv(int op, int dtype);
 void shl_rvv_reg_op(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *init, void *exec,
                     void *est, void *cap, void *perf);
@@ -1225,6 +1349,9 @@ int shl_rvv_binary_op_broadcast_fp16(struct csinn_tensor *input0, struct csinn_t
                                      struct csinn_tensor *output, void *binary_op_callback[]);
 int shl_rvv_binary_op_broadcast_int8(struct csinn_tensor *input0, struct csinn_tensor *input1,
                                      struct csinn_tensor *output, void *binary_op_callback[]);
+void shl_rvv_binary_op_flat(void *input0, void *input1, void *output, int64_t size,
+                            int elem_size, int mode, void *binary_op, float *scale,
+                            int32_t *zero_point);
 
 #ifdef SHL_USE_DOT_INT4
 int shl_rvv_conv2d_init_int4(struct csinn_tensor *input, struct csinn_tensor *output,
@@ -1254,6 +1381,11 @@ void shl_rvv_fc_gemv_transform_weight_int4_dot(struct csinn_tensor *weights);
 int shl_rvv_fullyconnected_packn_int4_dot(struct csinn_tensor *input, struct csinn_tensor *output,
                                           struct csinn_tensor *weights, struct csinn_tensor *bias,
                                           struct csinn_fc_params *params);
+void shl_rvv_deconv2d_gemm_col2im_reorder_kernel_int4(struct csinn_tensor *kernel,
+                                                      struct csinn_conv2d_params *params);
+int shl_rvv_deconv2d_gemm_col2im_int4(struct csinn_tensor *input, struct csinn_tensor *output,
+                                      struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                      struct csinn_conv2d_params *params);
 #endif
 
 struct shl_rvv_option {
@@ -1264,6 +1396,18 @@ struct shl_rvv_option {
 struct shl_rvv_option *shl_rvv_get_graph_option(struct csinn_session *sess);
 bool shl_rvv_get_binary_model_op_init(struct csinn_session *sess);
 
+#if __riscv_vector
+/* round(x * m * 2^(shift - 31)) with saturation, m and shift from shl_quantize_multiplier */
+static inline vint32m4_t shl_rvv_requantize_i32m4(vint32m4_t _x, int32_t m, int32_t shift,
+                                                  size_t vl)
+{
+    int32_t rshift = 31 - shift;
+    rshift = rshift < 0 ? 0 : (rshift > 63 ? 63 : rshift);
+    vint64m8_t _prod = vwmul_vx_i64m8(_x, m, vl);
+    return vnclip_wx_i32m4(_prod, rshift, vl);
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
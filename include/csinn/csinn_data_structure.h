@@ -66,6 +66,13 @@ enum csinn_mem_type_enum {
     CSINN_MEM_TYPE_BLOCK_Q4_0_REARRANGE,
 };
 
+/** CSI-NN dynamic activation quantization of matmul against block quantized weights */
+enum csinn_act_quant_enum {
+    CSINN_ACT_QUANT_NONE = 0, /**< Compute in the activation dtype */
+    CSINN_ACT_QUANT_BLOCK,    /**< Int8 with one scale per 32 values, as block q8_0 */
+    CSINN_ACT_QUANT_TOKEN,    /**< Int8 with one scale per row */
+};
+
 /** CSI-NN quant type */
 enum csinn_quant_enum {
     CSINN_QUANT_UNSET = 0,       /**< The quantization type is not set */
@@ -111,6 +118,7 @@ enum csinn_api_enum {
     CSINN_RVM,      /**< RISC-V Matrix extension general platform */
     CSINN_E907,     /**< E907 CPU platform */
     CSINN_C920V2,   /**< C920V2 CPU platform */
+    CSINN_NPU_SIM,  /**< CPU-hosted stand-in of an NPU, runs hybrid subgraphs with reference ops */
     CSINN_API_SIZE,
 };
 
@@ -353,6 +361,15 @@ enum csinn_runtime_enum {
     CSINN_GET_OUTPUT,
     CSINN_TENSOR_ENTRY,
     CSINN_LOAD_BG,
+    CSINN_GET_STATE_NUMBER,
+    CSINN_GET_STATE,
+    CSINN_ALLOC_STATE,
+    CSINN_SAVE_STATE,
+    CSINN_RESTORE_STATE,
+    CSINN_RESET_STATE,
+    CSINN_BIND_STATE,
+    CSINN_SESSION_CLONE,
+    CSINN_FREE_SESSION_CLONE,
     CSINN_RUNTIME_OP_SIZE,
 };
 
@@ -551,6 +568,20 @@ struct csinn_session {
 
     void *trace; /**< Refers to trace data, it is valid after set
                       profiler_level=CSINN_PROFILER_LEVEL_TRACE */
+    int32_t thread_num;  /**< Threads used by this session, 0 or 1: follow the global setting */
+    uint64_t cpu_mask;   /**< CPUs the worker threads are bound to, bit i is cpu i, 0: unbound.
+                              Kernels still on OpenMP, e.g. rvv depthwise and the c920 gemms,
+                              run on the global omp team, which is not bound by this mask */
+    void *thread_pool;   /**< Persistent workers, created at the first run with thread_num > 1 */
+};
+
+/** CSI-NN streaming state set */
+struct csinn_session_state {
+    int32_t state_num;                     /**< The number of state tensors */
+    struct csinn_tensor **state;           /**< State tensors, data points to this set's storage */
+    struct csinn_asr_buffer_t *asr_buffer; /**< Ring position of each cache op state, the buffer
+                                                member is unused */
+    bool own_data;                         /**< Whether the state data is released with the set */
 };
 
 /** CSI-NN tensor */
@@ -698,6 +729,8 @@ struct csinn_roi_pool_params {
 /** CSI-NN single input single output params */
 struct csinn_siso_params {
     struct csinn_params_base base; /**< The basic information of the operator */
+    int8_t *lut; /**< 256 entry int8 lookup table of elementwise ops, allocated by the backend
+                      init */
 };
 
 /** CSI-NN scatter_nd params */
@@ -708,6 +741,7 @@ struct csinn_scatter_nd_params {
 /** CSI-NN sigmoid params */
 struct csinn_sigmoid_params {
     struct csinn_params_base base; /**< The basic information of the operator */
+    int8_t *lut; /**< 256 entry int8 lookup table, allocated by the backend init */
 };
 
 /** CSI-NN relu params */
@@ -785,6 +819,8 @@ struct csinn_matmul_params {
     struct csinn_params_base base; /**< The basic information of the operator */
     bool trans_a;                  /**< Indicates whether the first input is transposed */
     bool trans_b;                  /**< Indicates whether the second input is transposed */
+    int32_t act_quant; /**< enum csinn_act_quant_enum, int8 x int8 dot products when the
+                            second input is block quantized */
 };
 
 /** CSI-NN double input single output params */
@@ -1167,12 +1203,13 @@ struct csinn_layer_norm_params {
     int32_t axis;
 };
 
+/** ring buffer of cached asr frames */
 struct csinn_asr_buffer_t {
-    size_t writer_index;
+    size_t writer_index;  // ring offset of the last insertion
     size_t buffer_lenth;  // lenth of buffer
     size_t data_lenth;    // lenth of data
     uint8_t *buffer;
-    uint8_t flag;
+    uint8_t flag;  // set once the window starts at writer_index instead of the buffer head
 };
 
 struct csinn_cache_matmul_params {
@@ -1229,8 +1266,11 @@ struct csinn_rope_params {
     int32_t xpos_down;
     int32_t n_dims;
     int32_t *pos;
+    /* rope_cache holds (sin, cos) pairs as [pos][head][head_dim] in the input dtype, or
+     * with rope_cache_shared one fp32 [pos][head_dim] table used by every head */
     bool use_rope_cache;
     void *rope_cache;
+    bool rope_cache_shared;
 };
 
 /** CSI-NN LLM position OP type */
@@ -1246,7 +1286,8 @@ struct csinn_llm_pos_params {
     struct csinn_params_base base; /**< The basic information of the operator */
     int32_t bsz;                   /**< batch size, dynamic set */
     int32_t seqlen;                /**< seqlen, dynamic set */
-    int32_t *pos;
+    int32_t *pos;                  /**< [bsz, seqlen] position of every token, dynamic set */
+    int32_t *slot;                 /**< [bsz] kv cache slot of every sequence, NULL: slot i */
     int32_t mode;
     void *cache_buffer;
 };
@@ -232,6 +232,117 @@ int csinn_load_binary_model(struct csinn_session *session);
  */
 struct csinn_session *__attribute__((weak)) csinn_import_binary_model(char *bm_addr);
 
+/**
+ * @brief       Clone an execution context of the session
+ *
+ * @param[in]   sess    The session to be cloned, it must have been setup
+ * @return      Point to the new context <code>csinn_session*</code>, NULL on failure
+ *
+ * @details     The context shares the weights and the kernels prepared by
+ *              <code>csinn_session_setup</code> with the origin session, and has its own
+ *              activations, input/output tensors and streaming states. Different contexts of
+ *              one session can run concurrently from different threads. Profiling is disabled in
+ *              the context, and hybrid sessions with subgraphs are unsupported. Inputs must be
+ *              set by <code>csinn_update_input</code> on each context.
+ */
+struct csinn_session *csinn_session_clone(struct csinn_session *sess);
+
+/**
+ * @brief       Release a context created by <code>csinn_session_clone</code>
+ *
+ * @param[in]   sess    The context to be released, before its origin session is released
+ *
+ * @details     The context replaces <code>csinn_session_deinit</code> and
+ *              <code>csinn_free_session</code>, the shared weights are not touched.
+ */
+void csinn_free_session_clone(struct csinn_session *sess);
+
+/* streaming state */
+/**
+ * @brief       Get the number of streaming states of the model
+ *
+ * @param[in]   sess    The session to be obtained
+ * @return      Return the state number
+ *
+ * @details     States are the data carried from one <code>csinn_session_run</code> to the next
+ *              by frame-by-frame models, such as the frame sequence of fsmn and the cache of
+ *              cache_matmul and cache_conv1d. They are enumerated after
+ *              <code>csinn_session_setup</code>.
+ */
+int csinn_get_state_number(struct csinn_session *sess);
+
+/**
+ * @brief           Get the specified streaming state of the model
+ *
+ * @param[in]       index   State index
+ * @param[in, out]  state   State tensor
+ * @param[in]       sess    The session to be obtained
+ * @return          The return value is greater than 0 on success.
+ *
+ * @details     The interface fills the description of the state into the parameter state,
+ *              its data points to the storage currently used by the session.
+ */
+int csinn_get_state(int index, struct csinn_tensor *state, struct csinn_session *sess);
+
+/**
+ * @brief       Allocate a streaming state set for the session
+ *
+ * @param[in]   sess    The session to be referred
+ * @return      Allocated state set in reset state <code>csinn_session_state*</code>
+ *
+ * @details     Each independent stream served by the session needs its own state set.
+ */
+struct csinn_session_state *csinn_alloc_session_state(struct csinn_session *sess);
+
+/**
+ * @brief       Release a streaming state set
+ *
+ * @param[in]   state   The state set to be released, it must not be bound to a session
+ */
+void csinn_free_session_state(struct csinn_session_state *state);
+
+/**
+ * @brief       Copy the current streaming states of the session into a state set
+ *
+ * @param[out]  state   Target state set
+ * @param[in]   sess    The session to be obtained
+ * @return      The return value is greater than 0 on success.
+ */
+int csinn_session_save_state(struct csinn_session_state *state, struct csinn_session *sess);
+
+/**
+ * @brief       Copy a state set into the current streaming states of the session
+ *
+ * @param[in]   state   Source state set
+ * @param[out]  sess    The session to be set
+ * @return      The return value is greater than 0 on success.
+ */
+int csinn_session_restore_state(struct csinn_session_state *state, struct csinn_session *sess);
+
+/**
+ * @brief       Reset the current streaming states of the session to the start of a stream
+ *
+ * @param[out]  sess    The session to be set
+ * @return      The return value is greater than 0 on success.
+ */
+int csinn_session_reset_state(struct csinn_session *sess);
+
+/**
+ * @brief       Bind a state set to the session
+ *
+ * @param[in]   state   The state set to be used by subsequent runs, NULL returns to the
+ *                      session's own states
+ * @param[out]  sess    The session to be set
+ * @return      The return value is greater than 0 on success.
+ *
+ * @details     Binding only switches the storage used by the session, no state data is
+ *              copied, so one session with one copy of weights can serve several streams by
+ *              binding the state set of a stream before each run.
+ *              <code>csinn_session_deinit</code> returns the session to its own states, the
+ *              bound set is left to its owner.
+ */
+int csinn_session_bind_state(struct csinn_session_state *state, struct csinn_session *sess);
+
 /* input/output */
 /**
  * @brief       Set the input number of the model
@@ -1010,6 +1010,7 @@ int shl_gref_scaled_dot_product_attention_infer_shape(
 
 struct shl_ref_graph *shl_subgraph_establish(struct shl_ref_graph *ograph);
 struct shl_ref_graph *shl_gref_get_graph(struct csinn_session *sess);
+void shl_gref_free_layer_buffers(struct shl_ref_graph *graph);
 int shl_gref_graph_insert(struct shl_node *node, struct shl_ref_graph *graph);
 void shl_gref_post_dfs(struct shl_ref_graph *graph,
                        void (*fvisit)(struct shl_ref_graph *, struct shl_node *));
@@ -1044,8 +1045,35 @@ struct shl_ref_graph *shl_subgraph_topology_sort(struct shl_ref_graph *graph);
 void shl_subgraph_fvisit_fuse(struct shl_ref_graph *graph, struct shl_node *node);
 void shl_subgraph_fvisit_print(struct shl_ref_graph *graph, struct shl_node *node);
 int shl_subgraph_get_device(struct shl_node *node);
+
+struct shl_gref_async;
+struct shl_gref_async *shl_gref_async_create(int max_jobs);
+void shl_gref_async_destroy(struct shl_gref_async *async);
+void shl_gref_async_reset(struct shl_gref_async *async);
+void shl_gref_async_submit(struct shl_gref_async *async, struct shl_node *n);
+int shl_gref_async_finished(struct shl_gref_async *async, bool wait);
+void shl_gref_set_async_subgraph(struct csinn_session *sess, bool enable);
+void shl_gref_set_sim_latency(struct csinn_session *sess, int32_t latency_us);
 void *shl_gref_runtime_callback(int api);
 
+struct shl_gref_stripe {
+    int layer_num; /* layers fused from this one on, 0 when the layer runs alone */
+    int out_rows;  /* rows of the chain output produced per stripe */
+};
+void shl_gref_stripe_plan(struct csinn_session *sess);
+int shl_gref_stripe_run(struct shl_ref_graph *graph, int head, struct shl_gref_stripe *stripe);
+void shl_gref_set_stripe_budget(struct csinn_session *sess, int32_t bytes);
+void shl_gref_set_stripe_tiling(struct csinn_session *sess, bool enable);
+int shl_gref_get_state_number(struct csinn_session *sess);
+int shl_gref_get_state(int index, struct csinn_tensor *state, struct csinn_session *sess);
+struct csinn_session_state *shl_gref_alloc_state(struct csinn_session *sess);
+int shl_gref_save_state(struct csinn_session_state *state, struct csinn_session *sess);
+int shl_gref_restore_state(struct csinn_session_state *state, struct csinn_session *sess);
+int shl_gref_reset_state(struct csinn_session *sess);
+int shl_gref_bind_state(struct csinn_session_state *state, struct csinn_session *sess);
+struct csinn_session *shl_gref_session_clone(struct csinn_session *sess);
+void shl_gref_free_session_clone(struct csinn_session *sess);
+
 int shl_gref_siso_infer_shape(struct csinn_tensor *input, struct csinn_tensor *output,
                               void *params);
 int shl_gref_diso_infer_shape(struct csinn_tensor *input0, struct csinn_tensor *input1,
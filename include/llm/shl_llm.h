@@ -73,6 +73,26 @@ struct shl_llm_model {
 
     struct shl_llm_layer layers[32];
     int layers_num;
+
+    /* weights mapped by the loader, NULL when the tensors own their data */
+    void *mmap_addr;
+    size_t mmap_size;
+    bool prefetch;  // llm_run reads ahead the weights of the next layer
+};
+
+enum shl_llm_mlock {
+    SHL_LLM_MLOCK_NONE = 0,
+    SHL_LLM_MLOCK_HOT,  // norms and output head, read in full by every token
+    SHL_LLM_MLOCK_ALL,
+};
+
+/* residency of the mapped weight file, zero: fault pages in on first use */
+struct shl_llm_load_options {
+    bool populate;  // MAP_POPULATE, read the whole file at load
+    bool willneed;  // MADV_WILLNEED on the whole file, read ahead asynchronously
+    bool hugepage;  // copy into MAP_HUGETLB memory, MADV_HUGEPAGE on the file if none
+    bool prefetch;  // MADV_WILLNEED on layer i + 1 while layer i runs
+    int32_t mlock;  // enum shl_llm_mlock
 };
 
 struct shl_transformer_block {
@@ -86,6 +106,31 @@ struct shl_transformer_block {
     struct csinn_tensor *mask;
 };
 
+enum shl_llm_rope_scaling {
+    SHL_LLM_ROPE_SCALING_NONE = 0,
+    SHL_LLM_ROPE_SCALING_LINEAR,  // positions divided by the factor
+    SHL_LLM_ROPE_SCALING_NTK,     // base raised so the lowest frequency stretches by the factor
+    SHL_LLM_ROPE_SCALING_YARN,    // per-frequency blend of the two plus attention scaling
+};
+
+/* rotary embedding of a model, zero fields take the llama defaults */
+struct shl_llm_rope_config {
+    float theta;         // frequency base, 10000
+    int32_t scaling;     // enum shl_llm_rope_scaling
+    float factor;        // context extension factor, 1
+    int32_t orig_ctx;    // training context length (yarn), max_seq_len / factor
+    float beta_fast;     // yarn ramp bounds in rotations, 32
+    float beta_slow;     // 1
+};
+
+/* time spent in each stage of llm_run, accumulated until the caller resets it */
+struct shl_llm_stats {
+    int64_t n_runs;
+    uint64_t embedding_ns;
+    uint64_t *layer_ns;  // [layers_num], caller allocated
+    uint64_t output_ns;
+};
+
 struct shl_llm_ctx {
     int layers_num;
     struct shl_transformer_block **transformer_block;
@@ -93,6 +138,14 @@ struct shl_llm_ctx {
     struct csinn_session *output_session;
     struct csinn_tensor *start_pos;
     char *path;
+    int max_batch;  // number of sequences the kv cache holds
+    int prefill_chunk;  // max tokens per forward, longer inputs are split, 0: no limit
+    int32_t act_quant;  // enum csinn_act_quant_enum, int8 activations for block quantized weights
+    int n_heads;
+    int head_dim;
+    int max_seq_len;    // positions per kv slot
+    struct shl_llm_stats *stats;  // optional llm_run timing, NULL: off
+    float *rope_table;  // [max_seq_len][head_dim / 2][sin, cos], shared by every layer
 
     struct shl_llm_model *shl_model;
 
@@ -103,10 +156,24 @@ struct shl_llm_ctx {
     int32_t save_model;
 };
 
+/*
+ * token and pos are laid out as [n_seqs, n_tokens], every sequence carries its own
+ * positions and writes to its own kv cache slot. n_seqs = 0 is treated as 1,
+ * slot = NULL maps sequence i to kv slot i.
+ *
+ * Only the tokens listed in logits_idx (indices in [0, n_tokens), the same for
+ * every sequence) go through the output norm and vocab projection, the output
+ * session then holds [n_seqs, n_logits, vocab] logits. n_logits = 0 or
+ * logits_idx = NULL selects the last token only.
+ */
 struct shl_llm_input {
     int32_t n_tokens;
     int32_t *token;
     int32_t *pos;
+    int32_t n_seqs;
+    int32_t *slot;
+    int32_t n_logits;
+    int32_t *logits_idx;
 };
 
 struct llama_config {
@@ -116,6 +183,11 @@ struct llama_config {
     int n_layers;
     float nor_eps;
     int vocab_size;
+    int max_batch;  // max sequences per llm_run, 0 is treated as 1
+    int prefill_chunk;  // see shl_llm_ctx
+    int32_t act_quant;  // see shl_llm_ctx
+    int max_seq_len;    // 0 is treated as 2048
+    struct shl_llm_rope_config rope;
 
     struct shl_llm_model *shl_model;
 
@@ -126,8 +198,133 @@ struct llama_config {
     int32_t save_model;
 };
 
+struct shl_llm_seq {
+    bool active;
+    int32_t n_past;  // tokens already in the kv cache slot
+};
+
+/*
+ * Per-sequence token sampling, stages whose field is left at zero are skipped and a
+ * zeroed struct is greedy decoding. Penalties look at the last penalty_last_n tokens
+ * passed to shl_llm_sampler_accept (sampled tokens are accepted automatically).
+ */
+struct shl_llm_sampler_params {
+    float temperature;        // <= 0: argmax
+    int32_t top_k;            // <= 0: no limit
+    float top_p;              // nucleus mass, <= 0 or >= 1: disabled
+    float min_p;              // drop tokens with p < min_p * p_max, <= 0: disabled
+    float repeat_penalty;     // logit / rp if > 0 else logit * rp, <= 0 or 1: disabled
+    float presence_penalty;   // logit -= presence_penalty if seen
+    float frequency_penalty;  // logit -= frequency_penalty * times seen
+    int32_t penalty_last_n;
+    uint64_t seed;
+};
+
+struct shl_llm_candidate {
+    int32_t id;
+    float logit;
+};
+
+struct shl_llm_sampler {
+    struct shl_llm_sampler_params params;
+    int32_t vocab_size;
+    uint64_t rng;
+
+    /* ring of the last penalty_last_n accepted tokens */
+    int32_t *history;
+    int32_t n_history;
+    int32_t history_pos;
+
+    /* scratch */
+    struct shl_llm_candidate *cand;     // top_k entries, vocab_size without top_k
+    struct shl_llm_candidate *penalty;  // penalized tokens and their original logits
+};
+
+/*
+ * Keys/values of positions [0, n_tokens) of one kv slot, taken after prefilling
+ * tokens. data is [layers_num][k, v][n_tokens][row_size]; a loaded snapshot points
+ * into the read-only file mapping and may be restored into any number of slots.
+ */
+struct shl_llm_kv_snapshot {
+    int32_t layers_num;
+    int32_t n_tokens;
+    int32_t dtype;
+    int32_t row_size;  // bytes of one position of cache_k or cache_v
+    int32_t *tokens;
+    void *data;
+
+    void *mmap_addr;  // NULL when the snapshot owns tokens and data
+    size_t mmap_size;
+};
+
+/* continuous batching: one kv cache slot per active sequence, slot i is seqs[i] */
+struct shl_llm_sched {
+    struct shl_llm_ctx *ctx;
+    struct shl_llm_seq *seqs;
+    int max_seqs;
+    int max_seq_len;
+    int n_active;
+    int vocab_size;
+    float *logits;  // [max_seqs, vocab_size], last logits of every slot
+    struct shl_llm_sampler **sampler;  // per slot, NULL: greedy
+
+    /* batch scratch */
+    int32_t *token;
+    int32_t *pos;
+    int32_t *slot;
+};
+
 struct shl_llm_ctx *llama2_build(struct llama_config *config);
 int llm_run(struct shl_llm_ctx *ctx, struct shl_llm_input *embd);
+float *shl_llm_rope_table(struct shl_llm_rope_config *rope, int head_dim, int max_seq_len);
+
+struct shl_llm_sched *shl_llm_sched_init(struct shl_llm_ctx *ctx);
+void shl_llm_sched_free(struct shl_llm_sched *sched);
+int shl_llm_sched_admit(struct shl_llm_sched *sched, int32_t *prompt, int n_prompt);
+int shl_llm_sched_admit_prefix(struct shl_llm_sched *sched, struct shl_llm_kv_snapshot *snap,
+                               int32_t *prompt, int n_prompt);
+void shl_llm_sched_retire(struct shl_llm_sched *sched, int slot);
+int shl_llm_sched_step(struct shl_llm_sched *sched, const int32_t *tokens);
+float *shl_llm_sched_logits(struct shl_llm_sched *sched, int slot);
+int shl_llm_sched_set_sampler(struct shl_llm_sched *sched, int slot,
+                              struct shl_llm_sampler_params *params);
+int32_t shl_llm_sched_sample(struct shl_llm_sched *sched, int slot);
+
+/*
+ * Speculative decoding: verify feeds the pending token of the slot followed by
+ * n_draft proposed tokens in one forward, samples the target model at every
+ * position and keeps drafts while they match. out receives the accepted drafts
+ * plus the token sampled after them (at most n_draft + 1), the last one is the
+ * new pending token. Rejected positions are dropped by moving n_past back, which
+ * rollback also does for a draft model's scheduler, down to 0 for an empty prefix.
+ * On an error verify returns -1 and leaves n_past untouched.
+ */
+int shl_llm_sched_verify(struct shl_llm_sched *sched, int slot, int32_t token,
+                         const int32_t *draft, int n_draft, int32_t *out);
+int shl_llm_sched_rollback(struct shl_llm_sched *sched, int slot, int n_past);
+int shl_llm_draft_lookup(const int32_t *tokens, int n_tokens, int ngram, int32_t *draft,
+                         int max_draft);
+
+struct shl_llm_kv_snapshot *shl_llm_kv_snapshot_take(struct shl_llm_ctx *ctx, int slot,
+                                                     const int32_t *tokens, int n_tokens);
+int shl_llm_kv_snapshot_restore(struct shl_llm_ctx *ctx, int slot,
+                                struct shl_llm_kv_snapshot *snap, int n_tokens);
+int shl_llm_kv_snapshot_match(struct shl_llm_kv_snapshot *snap, const int32_t *tokens,
+                              int n_tokens);
+int shl_llm_kv_snapshot_save(struct shl_llm_kv_snapshot *snap, const char *path);
+struct shl_llm_kv_snapshot *shl_llm_kv_snapshot_load(const char *path);
+void shl_llm_kv_snapshot_free(struct shl_llm_kv_snapshot *snap);
+
+struct shl_llm_sampler *shl_llm_sampler_init(struct shl_llm_sampler_params *params,
+                                             int vocab_size);
+void shl_llm_sampler_free(struct shl_llm_sampler *sampler);
+void shl_llm_sampler_accept(struct shl_llm_sampler *sampler, int32_t token);
+int32_t shl_llm_sampler_sample(struct shl_llm_sampler *sampler, float *logits);
+
+int64_t shl_llm_weight_size(struct csinn_tensor *tensor);
+int shl_llm_model_advise(struct shl_llm_model *model, int layer);
+int shl_llm_model_lock(struct shl_llm_model *model, int32_t level);
+
 int shl_block_quantize(struct csinn_tensor *src, struct csinn_tensor *dst);
 struct csinn_tensor *quantize_tensor(struct csinn_tensor *src, enum csinn_mem_type_enum mtype);
 
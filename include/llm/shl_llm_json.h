@@ -25,6 +25,7 @@ extern "C" {
 #include "llm/shl_llm.h"
 
 struct shl_llm_model *shl_llm_load_json(char *dir_path);
+struct shl_llm_model *shl_llm_load_json_opt(char *dir_path, struct shl_llm_load_options *opt);
 int shl_llm_save_json(char *dir_path, struct shl_llm_model *model);
 #ifdef __cplusplus
 }
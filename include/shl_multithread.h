@@ -27,4 +27,16 @@ void shl_multithread_set_threads(int threads);
 
 int shl_multithread_is_enable();
 
+struct shl_thread_pool;
+struct shl_thread_pool *shl_thread_pool_create(int threads, uint64_t cpu_mask);
+void shl_thread_pool_destroy(struct shl_thread_pool *pool);
+void shl_thread_pool_run(struct shl_thread_pool *pool, void (*func)(void *arg, int idx, int num),
+                         void *arg);
+
+void *shl_multithread_session_begin(struct csinn_session *sess);
+void shl_multithread_session_end(void *data);
+void shl_multithread_session_free(struct csinn_session *sess);
+int shl_multithread_get_threads();
+void shl_multithread_parallel_for(int n, void (*func)(void *arg, int start, int end), void *arg);
+
 #endif  // INCLUDE_SHL_MULTITHREAD_H_
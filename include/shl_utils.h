@@ -54,6 +54,14 @@ struct shl_gref_target_data {
     struct shl_ref_graph *graph;
     int is_hybrid_quantization_type;
     void *cpu_option;
+    struct csinn_session_state *bound_state; /* state set bound by csinn_session_bind_state */
+    struct csinn_session_state *own_state;   /* session's own state storage while unbound */
+    bool async_subgraph;    /* overlap hybrid subgraphs with the cpu ops that do not need them */
+    int32_t sim_latency_us; /* extra latency of each CSINN_NPU_SIM subgraph run */
+    void *async;            /* device worker of the asynchronous hybrid executor */
+    void *stripe;           /* row-stripe plan of fused layer chains, indexed by layer */
+    int32_t stripe_budget;  /* scratch bytes of one fused chain, 0 default, < 0 no fusion */
+    bool stripe_tiling;     /* run every conv/pool/activation chain in row stripes */
 };
 
 void shl_get_top5(float *buf, uint32_t size, float *prob, uint32_t *cls);
@@ -89,6 +97,17 @@ struct shl_cb_op_list *shl_cb_list_end(struct shl_cb_op_list *list);
 struct csinn_callback *shl_cb_list_match(struct shl_cb_op_list *list, enum csinn_dtype_enum dtype,
                                          enum csinn_op_enum op_name);
 
+/* callbacks of a backend indexed by [op][dtype], the dtype row of an op is allocated
+ * when the first callback of the op is registered */
+struct shl_cb_op_map {
+    struct csinn_callback *op[CSINN_OP_AND_UTILS_SIZE];
+};
+
+struct csinn_callback *shl_cb_op_map_add(struct shl_cb_op_map *map, enum csinn_dtype_enum dtype,
+                                         enum csinn_op_enum op_name);
+struct csinn_callback *shl_cb_op_map_match(struct shl_cb_op_map *map, enum csinn_dtype_enum dtype,
+                                           enum csinn_op_enum op_name);
+
 struct shl_bm_sections {
     int32_t graph_offset;
     int32_t graph_size;
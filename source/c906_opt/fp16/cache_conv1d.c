@@ -25,7 +25,7 @@ int shl_c906_cache_conv1d_init(struct csinn_tensor *input, struct csinn_tensor *
     bool binary_model_op_init = shl_c906_get_binary_model_op_init(params->base.sess);
     size_t data_size =
         output->dim[0] * output->dim[1] * output->dim[2] * sizeof(__fp16);  // 512*13*2
-    asr_buffer_init_c906(&params->asr_buffer, 2 * data_size, data_size);
+    asr_buffer_init(&params->asr_buffer, data_size);
 
     struct csinn_callback *cb = params->base.cb;
     if (input->dtype == CSINN_DTYPE_FLOAT16) {
@@ -173,31 +173,9 @@ int shl_c906_cache_conv1d_fp16(struct csinn_tensor *input, struct csinn_tensor *
         }
     }
 
-    size_t insert_lenth = output->dim[1] * input->dim[1];  // 512*6
-    __fp16 *output_from_buffer;
-    output_from_buffer = asr_buffer_insert_c906_back(&params->asr_buffer, output_data,
-                                                     insert_lenth * sizeof(__fp16));
-    size_t output_lenth = output->dim[0] * output->dim[1] * output->dim[2];
-    int *shape = output->dim;
+    shl_rvv_cache_conv1d_push_fp16(output_data, output_depth * batches, output, params);
 
-    __fp16 *p_input = output_from_buffer;
-    __fp16 *p_output = output->data;
-    for (int i = 0; i < shape[2]; i++) {
-        int j = 0;
-        for (; j + 15 < shape[1]; j += 16) {
-            int out_pos = j * shape[2] + i;
-            vfloat16m2_t _output_from_buffer;
-            _output_from_buffer = vle16_v_f16m2(p_input + i * shape[1] + j, 16);
-            vsse16_v_f16m2(p_output + out_pos, 2 * shape[2], _output_from_buffer, 16);
-        }
-        if (j != shape[1]) {
-            int vl = shape[1] - j;
-            int out_pos = j * shape[2] + i;
-            vfloat16m2_t _output_from_buffer;
-            _output_from_buffer = vle16_v_f16m2(p_input + i * shape[1] + j, vl);
-            vsse16_v_f16m2(p_output + out_pos, 2 * shape[2], _output_from_buffer, vl);
-        }
-    }
     // requantize
     shl_rvv_sidcso_op_requantize_fp16(input, output, weight);
+    return CSINN_TRUE;
 }
\ No newline at end of file
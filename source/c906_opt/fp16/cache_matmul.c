@@ -19,81 +19,6 @@
 #include "c906/c906.h"
 #include "shl_memory.h"
 
-// asr data buffer
-void asr_buffer_init_c906(struct csinn_asr_buffer_t *buffer, size_t buffer_size, size_t data_lenth)
-{
-    buffer->buffer = shl_mem_alloc(buffer_size);
-    buffer->buffer_lenth = buffer_size;
-    buffer->data_lenth = data_lenth;
-    buffer->writer_index = buffer_size - data_lenth;
-    buffer->flag = 0;  //用来记录有没有经过位置0.有的话置为1.
-}
-
-// insert front
-void *asr_buffer_insert_c906_front(struct csinn_asr_buffer_t *buffer, void *input, size_t len)
-{
-    int start_position = buffer->writer_index - len;
-    uint8_t *p = NULL;
-    if (buffer->flag == 0) {
-        if (start_position < 0) {
-            buffer->flag = 1;
-        }
-    }
-    if (start_position >= 0) {
-        p = &buffer->buffer[start_position];
-        memcpy(p, input, len);
-        buffer->writer_index = start_position;
-        if (buffer->flag == 0) {
-            return (void *)&buffer->buffer[0];
-        } else {
-            return (void *)p;
-        }
-    } else {
-        start_position = buffer->buffer_lenth - buffer->data_lenth;
-        p = &buffer->buffer[start_position];
-        memcpy(p, input, len);
-        memcpy(p + len, &buffer->buffer[buffer->writer_index], buffer->data_lenth - len);
-        buffer->writer_index = start_position;
-        return (void *)p;
-    }
-}
-
-void *asr_buffer_insert_c906_back(struct csinn_asr_buffer_t *buffer, void *input, size_t len)
-{
-    int end_position = buffer->writer_index + len;
-    uint8_t *p = NULL;
-    if (end_position <= buffer->buffer_lenth) {
-        p = &buffer->buffer[buffer->writer_index];
-        memcpy(p, input, len);
-        buffer->writer_index += len;
-        p -= (buffer->data_lenth - len);
-    } else {
-        p = &buffer->buffer[buffer->writer_index + len - buffer->data_lenth];
-        memcpy(&buffer->buffer[0], p, buffer->data_lenth - len);
-        buffer->writer_index = buffer->data_lenth;
-        memcpy(&buffer->buffer[buffer->data_lenth - len], input, len);
-        p = &buffer->buffer[0];
-    }
-    return (void *)p;
-}
-
-// get buffer
-void *asr_buffer_get_buffer_c906(struct csinn_asr_buffer_t *buffer)
-{
-    return asr_buffer_insert_c906_back(buffer, NULL, 0);
-}
-
-// reset buffer
-void asr_buffer_reset_c906(struct csinn_asr_buffer_t *buffer)
-{
-    shl_mem_free(buffer->buffer);
-    buffer->writer_index = 0;
-    buffer->buffer = NULL;
-    buffer->buffer_lenth = 0;
-    buffer->data_lenth = 0;
-    buffer->flag = 0;
-}
-
 int shl_c906_cache_matmul_init(struct csinn_tensor *input, struct csinn_tensor *output,
                                struct csinn_tensor *weight, struct csinn_tensor *bias,
                                struct csinn_cache_matmul_params *params)
@@ -101,7 +26,7 @@ int shl_c906_cache_matmul_init(struct csinn_tensor *input, struct csinn_tensor *
     bool binary_model_op_init = shl_c906_get_binary_model_op_init(params->base.sess);
     size_t data_size =
         params->shape[0] * params->shape[1] * params->shape[2] * params->shape[3] * sizeof(__fp16);
-    asr_buffer_init_c906(&params->asr_buffer, 2 * data_size, data_size);
+    asr_buffer_init(&params->asr_buffer, data_size);
 
     int accum_depth = weight->dim[0];
     int output_depth = weight->dim[1];
@@ -249,55 +174,8 @@ int shl_c906_cache_matmul_fp16(struct csinn_tensor *input, struct csinn_tensor *
             n -= vl;
         }
     }
-    __fp16 judge =
-        bias_data[0] + bias_data[1] + bias_data[2] + bias_data[3] + bias_data[4] + bias_data[5];
-
-    size_t insert_lenth = output_depth * batches;
-    __fp16 *output_from_buffer;
-    if (fabs(judge) < 0.01) {
-        output_from_buffer = asr_buffer_insert_c906_front(&params->asr_buffer, output_data,
-                                                          insert_lenth * sizeof(__fp16));
-    } else {
-        output_from_buffer = asr_buffer_insert_c906_back(&params->asr_buffer, output_data,
-                                                         insert_lenth * sizeof(__fp16));
-    }
+    shl_rvv_cache_matmul_push_fp16(output_data, output_depth * batches, bias_data, output, params);
 
-    // deal with reshape & transpose
-    int *shape = output->dim;
-
-    // transpose can only be 0,2,3,1 or 0,2,1,3
-    if (params->axes[2] == 3)  // 0,2,3,1
-    {
-        int batch = shape[3];
-        int shape3 = shape[2];
-        int flatten_shape = shape[1] * shape[2];
-        __fp16 *ptr = output_from_buffer;
-        for (int i = 0; i < batch; i++) {
-            for (int j = 0; j < flatten_shape; j += 16) {
-                int out_pos = j * batch + i;
-                vfloat16m2_t _output_from_buffer;
-                _output_from_buffer = vle16_v_f16m2(ptr, 16);
-                vsse16_v_f16m2(output_data + out_pos, 2 * batch, _output_from_buffer, 16);
-                ptr += 16;
-            }
-        }
-
-    } else  // 0,2,1,3
-    {
-        int batch = shape[2];
-        int shape3 = shape[3];
-        int flatten_shape = shape[1] * shape[3];
-        __fp16 *ptr = output_from_buffer;
-        for (int i = 0; i < batch; i++) {
-            for (int j = 0; j < flatten_shape; j += 16) {
-                int out_pos = i * shape3 + j % shape3 + batch * shape3 * (j / shape3);
-                vfloat16m2_t v_output_from_buffer;
-                v_output_from_buffer = vle16_v_f16m2(ptr, 16);
-                vse16_v_f16m2(output_data + out_pos, v_output_from_buffer, 16);
-                ptr += 16;
-            }
-        }
-    }
     // requantize
     shl_rvv_sidcso_op_requantize_fp16(input, output, weight);
     return CSINN_TRUE;
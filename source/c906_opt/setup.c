@@ -20,24 +20,22 @@
 #include "c906/cap.h"
 #include "c906/perf.h"
 
-static struct shl_cb_op_list shl_c906_cb_op_list;
+static struct shl_cb_op_map shl_c906_cb_op_map;
 
 int shl_c906_reg_op(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *init, void *exec)
 {
-    struct shl_cb_op_list *list_end = shl_cb_list_end(&shl_c906_cb_op_list);
-    struct shl_cb_op_list *next = shl_mem_alloc(sizeof(struct shl_cb_op_list));
-    next->cb = shl_mem_alloc(sizeof(struct csinn_callback));
-    next->cb->init = init;
-    next->cb->exec = exec;
-    next->dtype = dtype;
-    next->op_name = op_name;
-    list_end->next = next;
+    struct csinn_callback *cb = shl_cb_op_map_add(&shl_c906_cb_op_map, dtype, op_name);
+    if (cb == NULL) {
+        return CSINN_FALSE;
+    }
+    cb->init = init;
+    cb->exec = exec;
     return CSINN_TRUE;
 }
 
 int shl_c906_reg_op_est(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *est)
 {
-    struct csinn_callback *cb = shl_cb_list_match(&shl_c906_cb_op_list, dtype, op_name);
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_c906_cb_op_map, dtype, op_name);
     if (cb == NULL) {
         shl_debug_info("%s: cannot find c906 est\n", __func__);
     } else {
@@ -49,7 +47,7 @@ int shl_c906_reg_op_est(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name,
 
 int shl_c906_reg_op_cap(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *caps)
 {
-    struct csinn_callback *cb = shl_cb_list_match(&shl_c906_cb_op_list, dtype, op_name);
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_c906_cb_op_map, dtype, op_name);
     if (cb == NULL) {
         shl_debug_info("%s: cannot find c906 caps\n", __func__);
     } else {
@@ -61,7 +59,7 @@ int shl_c906_reg_op_cap(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name,
 
 int shl_c906_reg_op_perf(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *perf)
 {
-    struct csinn_callback *cb = shl_cb_list_match(&shl_c906_cb_op_list, dtype, op_name);
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_c906_cb_op_map, dtype, op_name);
     if (cb == NULL) {
         shl_debug_info("%s: cannot find c906 perf\n", __func__);
     } else {
@@ -74,7 +72,7 @@ int shl_c906_reg_op_perf(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name
 struct csinn_callback *__attribute__((weak)) shl_cb_map_rvv(int op, int dtype);
 struct csinn_callback *shl_cb_map_c906(int op, int dtype)
 {
-    struct csinn_callback *cb = shl_cb_list_match(&shl_c906_cb_op_list, dtype, op);
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_c906_cb_op_map, dtype, op);
     if (cb == NULL) {
         cb = shl_cb_map_rvv(op, dtype);
     }
@@ -115,6 +113,7 @@ void shl_c906_session_init(struct csinn_session *sess)
 void shl_c906_session_deinit(struct csinn_session *sess)
 {
     struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+    shl_gref_free_layer_buffers(graph);
     shl_mem_free(graph->input);
     shl_mem_free(graph->output);
     shl_mem_free(graph->layer);
@@ -364,6 +363,15 @@ void *shl_c906_runtime_callback(int api)
         case CSINN_GET_INPUT:
         case CSINN_GET_OUTPUT:
         case CSINN_TENSOR_ENTRY:
+        case CSINN_GET_STATE_NUMBER:
+        case CSINN_GET_STATE:
+        case CSINN_ALLOC_STATE:
+        case CSINN_SAVE_STATE:
+        case CSINN_RESTORE_STATE:
+        case CSINN_RESET_STATE:
+        case CSINN_BIND_STATE:
+        case CSINN_SESSION_CLONE:
+        case CSINN_FREE_SESSION_CLONE:
             return shl_gref_runtime_callback(api);
             break;
         default:
@@ -95,7 +95,7 @@ int shl_c920_matmul_a0b0_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
         // requantize
         shl_rvv_sidcso_op_requantize_fp16(mat0, output, mat1);
     } else if (batches_a > 1 && batches_b == 1) {
-        __fp16 *in0 = (__fp16 *)shl_mem_alloc(dim_m * dim_k * sizeof(__fp16));
+        __fp16 *in0 = (__fp16 *)shl_mem_alloc(batches_a * dim_m * dim_k * sizeof(__fp16));
         __fp16 *in1;
         if (!(mat1->is_const)) {
             in1 = (__fp16 *)shl_mem_alloc(dim_k * dim_n * sizeof(__fp16));
@@ -105,16 +105,13 @@ int shl_c920_matmul_a0b0_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
             in1 = mat1_data;
         }
 
-        for (int b = 0; b < batches_a; b++) {
-            shl_c920_reorder_a_block_8xk_fp16(mat0_data, in0, dim_m, dim_k, MATMUL_M_BLK,
-                                              MATMUL_K_BLK);
-
-            shl_c920_gemm_block_8xpack2n_fp16(output_data, in0, in1, NULL, dim_m, dim_k, dim_n,
-                                              MATMUL_M_BLK, MATMUL_K_BLK, MATMUL_N_BLK);
-
-            mat0_data += dim_m * dim_k;
-            output_data += dim_m * dim_n;
-        }
+        /* mat1 is shared by every batch, fold the batches into the rows of a single gemm
+         * so that mat1 is streamed once instead of once per batch */
+        const int fold_m = batches_a * dim_m;
+        shl_c920_reorder_a_block_8xk_fp16(mat0_data, in0, fold_m, dim_k, MATMUL_M_BLK,
+                                          MATMUL_K_BLK);
+        shl_c920_gemm_block_8xpack2n_fp16(output_data, in0, in1, NULL, fold_m, dim_k, dim_n,
+                                          MATMUL_M_BLK, MATMUL_K_BLK, MATMUL_N_BLK);
         shl_mem_free(in0);
         if (!(mat1->is_const)) {
             shl_mem_free(in1);
@@ -180,20 +177,16 @@ int shl_c920_matmul_a0b0_fp16_w_int8(struct csinn_tensor *mat0, struct csinn_ten
         shl_mem_free(in0);
         shl_mem_free(in1);
     } else if (batches_a > 1 && batches_b == 1) {
-        __fp16 *in0 = (__fp16 *)shl_mem_alloc(dim_m * dim_k * sizeof(__fp16));
+        __fp16 *in0 = (__fp16 *)shl_mem_alloc(batches_a * dim_m * dim_k * sizeof(__fp16));
         __fp16 *in1 = (__fp16 *)shl_mem_alloc(size1 * sizeof(__fp16));
         shl_rvv_dequantize_i8_to_f16(mat1_data, in1, size1, zp, scale);
 
-        for (int b = 0; b < batches_a; b++) {
-            shl_c920_reorder_a_block_8xk_fp16(mat0_data, in0, dim_m, dim_k, MATMUL_M_BLK,
-                                              MATMUL_K_BLK);
-
-            shl_c920_gemm_block_8xpack2n_fp16(output_data, in0, in1, NULL, dim_m, dim_k, dim_n,
-                                              MATMUL_M_BLK, MATMUL_K_BLK, MATMUL_N_BLK);
-
-            mat0_data += dim_m * dim_k;
-            output_data += dim_m * dim_n;
-        }
+        // shared mat1, fold the batches into M
+        const int fold_m = batches_a * dim_m;
+        shl_c920_reorder_a_block_8xk_fp16(mat0_data, in0, fold_m, dim_k, MATMUL_M_BLK,
+                                          MATMUL_K_BLK);
+        shl_c920_gemm_block_8xpack2n_fp16(output_data, in0, in1, NULL, fold_m, dim_k, dim_n,
+                                          MATMUL_M_BLK, MATMUL_K_BLK, MATMUL_N_BLK);
         shl_mem_free(in0);
         shl_mem_free(in1);
     } else {
@@ -285,13 +278,9 @@ int shl_c920_matmul_a0b1_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
     } else if (batches_a > 1 && batches_b == 1) {
         __fp16 *in1 = (__fp16 *)shl_mem_alloc(dim_k * dim_n * sizeof(__fp16));
         reorder_mat1_npack2n_fp16(mat1_data, in1, dim_n, dim_k);
-
-        for (int b = 0; b < batches_a; b++) {
-            shl_c920_gemm_a0nb1r_8xpack2n_fp16(output_data, mat0_data, in1, NULL, dim_m, dim_k,
-                                               dim_n);
-            mat0_data += dim_m * dim_k;
-            output_data += dim_m * dim_n;
-        }
+        // shared mat1, fold the batches into M
+        shl_c920_gemm_a0nb1r_8xpack2n_fp16(output_data, mat0_data, in1, NULL, batches_a * dim_m,
+                                           dim_k, dim_n);
         shl_mem_free(in1);
     } else {
         shl_debug_error("matmul unsupported this broadcast\n");
@@ -364,12 +353,9 @@ int shl_c920_matmul_a0b1_fp16_block_quant(struct csinn_tensor *mat0, struct csin
             output_data += dim_m * dim_n;
         }
     } else if (batches_a > 1 && batches_b == 1) {
-        for (int b = 0; b < batches_a; b++) {
-            gemm_a0nb1n_dot_fp16(output_data, mat0_data, mat1_data, NULL, dim_m, dim_k, dim_n,
-                                 scale_data);
-            mat0_data += dim_m * dim_k;
-            output_data += dim_m * dim_n;
-        }
+        // shared mat1, fold the batches into M
+        gemm_a0nb1n_dot_fp16(output_data, mat0_data, mat1_data, NULL, batches_a * dim_m, dim_k,
+                             dim_n, scale_data);
     } else {
         shl_debug_error("matmul unsupported this broadcast\n");
         return CSINN_FALSE;
@@ -402,7 +388,11 @@ int shl_c920_matmul_init_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
     }
 
     if (!params->trans_a && params->trans_b) {
-        if (mat0->dtype == CSINN_DTYPE_FLOAT16 && mat1->dtype == CSINN_DTYPE_FLOAT16) {
+        if (params->act_quant != CSINN_ACT_QUANT_NONE &&
+            (mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0 ||
+             mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0)) {
+            cb->exec = shl_c920_matmul_a0b1_dynamic_quant;
+        } else if (mat0->dtype == CSINN_DTYPE_FLOAT16 && mat1->dtype == CSINN_DTYPE_FLOAT16) {
             cb->exec = shl_c920_matmul_a0b1_fp16;
         } else if (mat0->dtype == CSINN_DTYPE_FLOAT16 &&
                    ((mat1->dtype == CSINN_DTYPE_INT8 && mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0) ||
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "c920/c920.h"
+
+/*
+ * W8A8 matmul against block quantized weights on the shared rvv kernels, every thread takes
+ * a range of columns so each weight row is read by one thread only.
+ */
+struct gemm_block_task {
+    float *dst;
+    const int8_t *sa;
+    const float *sa_scale;
+    const int8_t *sb;
+    const __fp16 *sb_scale;
+    int M;
+    int K;
+    int N;
+    int ldc;
+    int align; /* columns of one unit, whole vectors per thread */
+};
+
+/* columns of the units [start, end) */
+static bool gemm_block_columns(struct gemm_block_task *t, int start, int end, int *N_start,
+                               int *N_end)
+{
+    *N_start = start * t->align < t->N ? start * t->align : t->N;
+    *N_end = end * t->align < t->N ? end * t->align : t->N;
+    return *N_end > *N_start;
+}
+
+static void gemm_block_q8_units(void *arg, int start, int end)
+{
+    struct gemm_block_task *t = arg;
+    int N_start, N_end;
+    if (gemm_block_columns(t, start, end, &N_start, &N_end)) {
+        shl_rvv_gemm_a0b1_int8_block_q8(t->dst + N_start, t->sa, t->sa_scale,
+                                        t->sb + N_start * t->K,
+                                        t->sb_scale + N_start * t->K / 32, t->M, t->K,
+                                        N_end - N_start, t->ldc);
+    }
+}
+
+static void gemm_block_q4_units(void *arg, int start, int end)
+{
+    struct gemm_block_task *t = arg;
+    int N_start, N_end;
+    if (gemm_block_columns(t, start, end, &N_start, &N_end)) {
+        shl_rvv_gemm_a0b1_int8_block_q4(t->dst + N_start, t->sa, t->sa_scale,
+                                        t->sb + N_start * t->K / 2,
+                                        t->sb_scale + N_start * t->K / 32, t->M, t->K,
+                                        N_end - N_start, t->ldc);
+    }
+}
+
+static void gemm_a0b1_int8_block_q8_parallel(float *dst, const int8_t *sa,
+                                             const float *sa_scale, const int8_t *sb,
+                                             const __fp16 *sb_scale, int M, int K, int N, int ldc)
+{
+    const int align = csrr_vlenb() / sizeof(int32_t) * 2;
+    struct gemm_block_task task = {dst, sa, sa_scale, sb, sb_scale, M, K, N, ldc, align};
+    shl_multithread_parallel_for((N + align - 1) / align, gemm_block_q8_units, &task);
+}
+
+static void gemm_a0b1_int8_block_q4_parallel(float *dst, const int8_t *sa,
+                                             const float *sa_scale, const int8_t *sb,
+                                             const __fp16 *sb_scale, int M, int K, int N, int ldc)
+{
+    const int align = csrr_vlenb() / sizeof(int32_t) * 2;
+    struct gemm_block_task task = {dst, sa, sa_scale, sb, sb_scale, M, K, N, ldc, align};
+    shl_multithread_parallel_for((N + align - 1) / align, gemm_block_q4_units, &task);
+}
+
+int shl_c920_matmul_a0b1_dynamic_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
+                                       struct csinn_tensor *output,
+                                       struct csinn_matmul_params *params)
+{
+    return shl_rvv_matmul_a0b1_dynamic_quant_common(mat0, mat1, output, params,
+                                                    gemm_a0b1_int8_block_q8_parallel,
+                                                    gemm_a0b1_int8_block_q4_parallel);
+}
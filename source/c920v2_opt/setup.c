@@ -20,35 +20,26 @@
 #include "c920v2/cap.h"
 #include "c920v2/perf.h"
 
-#define C920V2_OP_PATTERN_MAX 40
-static struct shl_cb_table shl_c920v2_cb_table[C920V2_OP_PATTERN_MAX];
+static struct shl_cb_op_map shl_c920v2_cb_op_map;
 
 void shl_c920v2_reg_op(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *init,
                        void *exec, void *est, void *cap, void *perf)
 {
-    static int i = 0;
-    if (i >= C920V2_OP_PATTERN_MAX) {
-        shl_debug_error("C920V2 callback length is greater than C920V2_OP_PATTERN_MAX!\n");
+    struct csinn_callback *cb = shl_cb_op_map_add(&shl_c920v2_cb_op_map, dtype, op_name);
+    if (cb == NULL) {
+        return;
     }
-    shl_c920v2_cb_table[i].shl_cb_key = op_name * CSINN_DTYPE_SIZE + dtype;
-    shl_c920v2_cb_table[i].shl_cb_value.init = init;
-    shl_c920v2_cb_table[i].shl_cb_value.exec = exec;
-    shl_c920v2_cb_table[i].shl_cb_value.est = est;
-    shl_c920v2_cb_table[i].shl_cb_value.caps = cap;
-    shl_c920v2_cb_table[i].shl_cb_value.perf = perf;
-    i++;
+    cb->init = init;
+    cb->exec = exec;
+    cb->est = est;
+    cb->caps = cap;
+    cb->perf = perf;
 }
 
 struct csinn_callback *shl_cb_map_rvv(int op, int dtype);
 struct csinn_callback *shl_cb_map_c920v2(int op, int dtype)
 {
-    struct csinn_callback *cb = NULL;
-    for (int i = 0; i < C920V2_OP_PATTERN_MAX; i++) {
-        if (shl_c920v2_cb_table[i].shl_cb_key == (op * CSINN_DTYPE_SIZE + dtype)) {
-            cb = &(shl_c920v2_cb_table[i].shl_cb_value);
-            break;
-        }
-    }
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_c920v2_cb_op_map, dtype, op);
     if ((cb == NULL) || (cb->est == NULL && (cb->init == NULL || cb->exec == NULL))) {
         cb = shl_cb_map_rvv(op, dtype);
     }
@@ -89,6 +80,7 @@ void shl_c920v2_session_init(struct csinn_session *sess)
 void shl_c920v2_session_deinit(struct csinn_session *sess)
 {
     struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+    shl_gref_free_layer_buffers(graph);
     shl_mem_free(graph->input);
     shl_mem_free(graph->output);
     shl_mem_free(graph->layer);
@@ -379,6 +371,15 @@ void *shl_c920v2_runtime_callback(int api)
         case CSINN_SET_OUTPUT:
         case CSINN_GET_INPUT:
         case CSINN_TENSOR_ENTRY:
+        case CSINN_GET_STATE_NUMBER:
+        case CSINN_GET_STATE:
+        case CSINN_ALLOC_STATE:
+        case CSINN_SAVE_STATE:
+        case CSINN_RESTORE_STATE:
+        case CSINN_RESET_STATE:
+        case CSINN_BIND_STATE:
+        case CSINN_SESSION_CLONE:
+        case CSINN_FREE_SESSION_CLONE:
             return shl_gref_runtime_callback(api);
             break;
         default:
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "e907/e907.h"
+
+#define E907_ADD_BLOCK 64
+
+/************************************************************************************
+ * s3(q3 - z3) = s1(q1 - z1) + s2(q2 - z2)
+ * both inputs are brought to the larger scale in Q14 first, so a1 and a2 fit int16:
+ * q3 = [ (q1 - z1) * a1 + (q2 - z2) * a2 ] * (s_max / s3 / 2^14) + z3
+ * a1 = s1/s_max * 2^14, a2 = s2/s_max * 2^14
+ ************************************************************************************/
+static void e907_add_block_int8(const int8_t *in0, int step0, const int8_t *in1, int step1,
+                                int32_t *acc, int len, int16_t z1, int16_t z2, int16_t a1,
+                                int16_t a2)
+{
+    const int xlenh = shl_rvp_get_xlenb() >> 1;  // xlen in half-word
+    intXLEN_t z1_16xn = shl_rvp_int16_to_xlen(z1);
+    intXLEN_t z2_16xn = shl_rvp_int16_to_xlen(z2);
+    // each word pairs (q1 - z1) in the high half with (q2 - z2) in the low half
+    intXLEN_t coef_16xn = shl_rvp_int32_to_xlen((int32_t)(((uint32_t)(uint16_t)a1 << 16) |
+                                                          (uint16_t)a2));
+
+    int j = 0;
+    for (; j + xlenh - 1 < len; j += xlenh) {
+        intXLEN_t x0, x1;  // byte loads, the int8 rows carry no alignment
+        int16_t *x0_i16 = (int16_t *)(&x0);
+        int16_t *x1_i16 = (int16_t *)(&x1);
+        for (int k = 0; k < xlenh; k++) {
+            x0_i16[k] = in0[(j + k) * step0];
+            x1_i16[k] = in1[(j + k) * step1];
+        }
+        x0 = __rv__sub16(x0, z1_16xn);
+        x1 = __rv__sub16(x1, z2_16xn);
+        // even and odd elements, one pair per word: {x0[2k], x1[2k]} and {x0[2k+1], x1[2k+1]}
+        intXLEN_t even = __rv__kmda(__rv__pkbb16(x0, x1), coef_16xn);
+        intXLEN_t odd = __rv__kmda(__rv__pktt16(x0, x1), coef_16xn);
+        int32_t *even_i32 = (int32_t *)(&even);
+        int32_t *odd_i32 = (int32_t *)(&odd);
+        for (int k = 0; k < xlenh / 2; k++) {
+            acc[j + 2 * k] = even_i32[k];
+            acc[j + 2 * k + 1] = odd_i32[k];
+        }
+    }
+    for (; j < len; j++) {
+        acc[j] = (in0[j * step0] - z1) * a1 + (in1[j * step1] - z2) * a2;
+    }
+}
+
+int shl_e907_add_int8(struct csinn_tensor *input0, struct csinn_tensor *input1,
+                      struct csinn_tensor *output, struct csinn_diso_params *params)
+{
+    int8_t *input0_data = (int8_t *)input0->data;
+    int8_t *input1_data = (int8_t *)input1->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    int in_size0 = csinn_tensor_size(input0);
+    int in_size1 = csinn_tensor_size(input1);
+    int out_size = csinn_tensor_size(output);
+
+    if ((in_size0 != out_size && in_size0 != 1) || (in_size1 != out_size && in_size1 != 1) ||
+        input0->quant_channel != 1 || input1->quant_channel != 1) {
+        return shl_ref_add_quant(input0, input1, output, params);
+    }
+
+    float s1 = input0->qinfo->scale;
+    float s2 = input1->qinfo->scale;
+    float s_max = s1 > s2 ? s1 : s2;
+    int16_t a1 = (int16_t)roundf(s1 / s_max * 16384.0f);
+    int16_t a2 = (int16_t)roundf(s2 / s_max * 16384.0f);
+    int32_t multiplier, shift;
+    shl_quantize_multiplier(s_max / output->qinfo->scale / 16384.0f, &multiplier, &shift);
+
+    int16_t z1 = input0->qinfo->zero_point;
+    int16_t z2 = input1->qinfo->zero_point;
+    int32_t z3 = output->qinfo->zero_point;
+    int step0 = in_size0 == 1 ? 0 : 1;
+    int step1 = in_size1 == 1 ? 0 : 1;
+
+    int32_t acc[E907_ADD_BLOCK];
+    for (int i = 0; i < out_size; i += E907_ADD_BLOCK) {
+        int len = out_size - i < E907_ADD_BLOCK ? out_size - i : E907_ADD_BLOCK;
+        e907_add_block_int8(input0_data + i * step0, step0, input1_data + i * step1, step1, acc,
+                            len, z1, z2, a1, a2);
+        shl_rvp_requantize(acc, multiplier, shift, len);
+        shl_rvp_saturated_int8(acc, output_data + i, z3, len);
+    }
+
+    return CSINN_TRUE;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "e907/e907.h"
+
+int shl_e907_avgpool2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                 struct csinn_pool_params *params)
+{
+    struct csinn_callback *cb = params->base.cb;
+    int32_t in_h = input->dim[2];
+    int32_t in_w = input->dim[3];
+
+    if (params->base.layout != CSINN_LAYOUT_NCHW || input->quant_channel != 1 ||
+        output->quant_channel != 1) {
+        cb->exec = shl_ref_avgpool2d_quant;
+    } else if (in_h == params->filter_height && in_w == params->filter_width &&
+               params->pad_top == 0 && params->pad_left == 0 && params->pad_down == 0 &&
+               params->pad_right == 0) {
+        cb->exec = shl_e907_global_avgpool2d_int8;
+    } else {
+        cb->exec = shl_e907_avgpool2d_int8;
+    }
+    return CSINN_TRUE;
+}
+
+// sum of len int8 values, four bytes per smaqa against packed ones
+static inline int32_t avgpool_sum_int8(const int8_t *src, int len)
+{
+    intXLEN_t acc = 0;
+    int i = 0;
+    for (; i + 3 < len; i += 4) {
+        acc = __rv__smaqa(acc, shl_rvp_load_8x4(src + i), 0x01010101);
+    }
+    // only the low word lane is used on rv64
+    int32_t sum = (int32_t)acc;
+    for (; i < len; i++) {
+        sum += src[i];
+    }
+    return sum;
+}
+
+/************************************************************************************
+ * s2(q2 - z2) = s1 * sum(q1 - z1) / count
+ * q2 = sum(q1 - z1) * (s1/s2) / count + z2
+ ************************************************************************************/
+int shl_e907_avgpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_pool_params *params)
+{
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    const int batch = input->dim[0];
+    const int channel = input->dim[1];
+    const int in_h = input->dim[2];
+    const int in_w = input->dim[3];
+    const int out_h = output->dim[2];
+    const int out_w = output->dim[3];
+    const int kernel_h = params->filter_height;
+    const int kernel_w = params->filter_width;
+
+    const int32_t z1 = input->qinfo->zero_point;
+    const int32_t z2 = output->qinfo->zero_point;
+    const float scale = input->qinfo->scale / output->qinfo->scale;
+    const float scale_full = scale / (kernel_h * kernel_w);
+
+    for (int bc = 0; bc < batch * channel; bc++) {
+        int8_t *in_ptr = input_data + bc * in_h * in_w;
+        int8_t *out_ptr = output_data + bc * out_h * out_w;
+        for (int oh = 0; oh < out_h; oh++) {
+            int h_origin = oh * params->stride_height - params->pad_top;
+            int h_start = h_origin > 0 ? h_origin : 0;
+            int h_end = h_origin + kernel_h < in_h ? h_origin + kernel_h : in_h;
+            for (int ow = 0; ow < out_w; ow++) {
+                int w_origin = ow * params->stride_width - params->pad_left;
+                int w_start = w_origin > 0 ? w_origin : 0;
+                int w_end = w_origin + kernel_w < in_w ? w_origin + kernel_w : in_w;
+
+                int32_t sum = 0;
+                for (int h = h_start; h < h_end; h++) {
+                    sum += avgpool_sum_int8(in_ptr + h * in_w + w_start, w_end - w_start);
+                }
+                int count = (h_end - h_start) * (w_end - w_start);
+                sum -= count * z1;
+                if (params->count_include_pad) {
+                    count = kernel_h * kernel_w;
+                }
+                float s = count == kernel_h * kernel_w ? scale_full : scale / count;
+                *out_ptr++ = shl_rvp_clip_i8((int32_t)roundf(sum * s) + z2);
+            }
+        }
+    }
+    return CSINN_TRUE;
+}
+
+int shl_e907_global_avgpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
+{
+    if (params->base.layout != CSINN_LAYOUT_NCHW || input->quant_channel != 1 ||
+        output->quant_channel != 1) {
+        return shl_ref_global_avgpool2d_quant(input, output, params);
+    }
+
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    const int batch = input->dim[0];
+    const int channel = input->dim[1];
+    const int in_size = input->dim[2] * input->dim[3];
+
+    const int32_t z1 = input->qinfo->zero_point;
+    const int32_t z2 = output->qinfo->zero_point;
+    const float scale = input->qinfo->scale / output->qinfo->scale / in_size;
+
+    for (int bc = 0; bc < batch * channel; bc++) {
+        int32_t sum = avgpool_sum_int8(input_data + bc * in_size, in_size) - in_size * z1;
+        output_data[bc] = shl_rvp_clip_i8((int32_t)roundf(sum * scale) + z2);
+    }
+    return CSINN_TRUE;
+}
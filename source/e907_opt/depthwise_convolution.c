@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "e907/e907.h"
+
+/*************************************************************
+ * kernel_tm: [channel, kernel_h, kernel_w4], every kernel row zero-padded to a multiple
+ * of four bytes so that one smaqa consumes four taps of a row
+ *************************************************************/
+static void shl_e907_dwconv_reorder_kernel_int8(struct csinn_tensor *kernel,
+                                                struct csinn_conv2d_params *params)
+{
+    int8_t *kernel_data = (int8_t *)kernel->data;
+    const int channel = kernel->dim[0];
+    const int kernel_h = kernel->dim[2];
+    const int kernel_w = kernel->dim[3];
+    const int kernel_w4 = (kernel_w + 3) & -4;
+
+    int8_t *kernel_tm = (int8_t *)shl_mem_alloc(channel * kernel_h * kernel_w4 * sizeof(int8_t));
+    for (int c = 0; c < channel; c++) {
+        for (int h = 0; h < kernel_h; h++) {
+            memcpy(kernel_tm + (c * kernel_h + h) * kernel_w4,
+                   kernel_data + (c * kernel_h + h) * kernel_w, kernel_w * sizeof(int8_t));
+        }
+    }
+    params->conv_extra.kernel_tm = csinn_alloc_tensor(NULL);
+    params->conv_extra.kernel_tm->data = kernel_tm;
+}
+
+int shl_e907_depthwise_conv2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                        struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                        struct csinn_conv2d_params *params)
+{
+    struct csinn_callback *cb = params->base.cb;
+    const int channel = kernel->dim[0];
+    const int kernel_size = kernel->dim[2] * kernel->dim[3];
+
+    bool sym_kernel = true;
+    for (int i = 0; i < kernel->quant_channel; i++) {
+        sym_kernel = sym_kernel && kernel->qinfo[i].zero_point == 0;
+    }
+    // depth multiplier > 1 and dilation stay on the reference
+    if (params->base.layout != CSINN_LAYOUT_NCHW || channel != input->dim[1] ||
+        params->dilation_height != 1 ||
+        params->dilation_width != 1 || !sym_kernel ||
+        (kernel->quant_channel != 1 && kernel->quant_channel != channel)) {
+        cb->exec = shl_ref_depthwise_conv2d_quant;
+        return CSINN_TRUE;
+    }
+
+    // enable fuse zeropoint to bias, the padding is filled with the input zeropoint
+    if (!params->conv_extra.fuse_zp2bias) {
+        params->conv_extra.fuse_zp2bias = true;
+        int32_t *bias_data = (int32_t *)bias->data;
+        int8_t *kernel_data = (int8_t *)kernel->data;
+        int32_t input_zp = input->qinfo->zero_point;
+
+        if (bias_data == NULL) {
+            // XXX: memory leak
+            bias_data = (int32_t *)shl_mem_alloc(channel * sizeof(int32_t));
+            bias->data = bias_data;
+        }
+        for (int c = 0; c < channel; c++) {
+            int32_t tmp = 0;
+            for (int j = 0; j < kernel_size; j++) {
+                tmp += kernel_data[c * kernel_size + j] * input_zp;
+            }
+            bias_data[c] -= tmp;
+        }
+    }
+    for (int i = 0; i < kernel->quant_channel; i++) {
+        float real_scale = input->qinfo->scale * kernel->qinfo[i].scale / output->qinfo->scale;
+        shl_quantize_multiplier(real_scale, &(kernel->qinfo[i].multiplier),
+                                &(kernel->qinfo[i].shift));
+    }
+    shl_e907_dwconv_reorder_kernel_int8(kernel, params);
+    cb->exec = shl_e907_depthwise_conv2d_int8;
+    return CSINN_TRUE;
+}
+
+/************************************************************************************
+ * acc = bias - z1 * sum(k) + sum(q1 * k), with the input padded by z1
+ * every kernel row is a sequence of 4-byte smaqa dot products, the padded taps of
+ * kernel_tm are zero so the bytes read past the window do not contribute
+ ************************************************************************************/
+int shl_e907_depthwise_conv2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                   struct csinn_conv2d_params *params)
+{
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+    int8_t *kernel_data = (int8_t *)params->conv_extra.kernel_tm->data;
+    int32_t *bias_data = (int32_t *)bias->data;
+
+    const int batch = input->dim[0];
+    const int channel = input->dim[1];
+    const int in_h = input->dim[2];
+    const int in_w = input->dim[3];
+    const int out_h = output->dim[2];
+    const int out_w = output->dim[3];
+    const int kernel_h = kernel->dim[2];
+    const int kernel_w = kernel->dim[3];
+    const int kernel_w4 = (kernel_w + 3) & -4;
+    const int stride_h = params->stride_height;
+    const int stride_w = params->stride_width;
+    const int pad_top = params->pad_top;
+    const int pad_left = params->pad_left;
+
+    const int padded_h = in_h + pad_top + params->pad_down;
+    const int padded_w = in_w + pad_left + params->pad_right + kernel_w4 - kernel_w;
+    const int out_size = out_h * out_w;
+    const int32_t out_zp = output->qinfo->zero_point;
+
+    int8_t *input_padd = (int8_t *)shl_mem_alloc(padded_h * padded_w * sizeof(int8_t));
+    int32_t *output_tmp = (int32_t *)shl_mem_alloc(out_size * sizeof(int32_t));
+    // the border is the same for every channel, only the interior is copied below
+    memset(input_padd, (int8_t)input->qinfo->zero_point, padded_h * padded_w * sizeof(int8_t));
+
+    for (int b = 0; b < batch; b++) {
+        for (int c = 0; c < channel; c++) {
+            int8_t *in_ptr = input_data + (b * channel + c) * in_h * in_w;
+            for (int h = 0; h < in_h; h++) {
+                memcpy(input_padd + (h + pad_top) * padded_w + pad_left, in_ptr + h * in_w,
+                       in_w * sizeof(int8_t));
+            }
+
+            int8_t *k_ptr = kernel_data + c * kernel_h * kernel_w4;
+            int32_t bias_c = bias_data ? bias_data[c] : 0;
+            int32_t *out_ptr = output_tmp;
+            for (int oh = 0; oh < out_h; oh++) {
+                for (int ow = 0; ow < out_w; ow++) {
+                    int8_t *win = input_padd + oh * stride_h * padded_w + ow * stride_w;
+                    intXLEN_t acc = 0;
+                    for (int kh = 0; kh < kernel_h; kh++) {
+                        int8_t *in_row = win + kh * padded_w;
+                        int8_t *k_row = k_ptr + kh * kernel_w4;
+                        for (int kw = 0; kw < kernel_w4; kw += 4) {
+                            acc = __rv__smaqa(acc, shl_rvp_load_8x4(in_row + kw),
+                                              shl_rvp_load_8x4(k_row + kw));
+                        }
+                    }
+                    // only the low word lane is used on rv64
+                    *out_ptr++ = bias_c + (int32_t)acc;
+                }
+            }
+
+            int q = kernel->quant_channel == 1 ? 0 : c;
+            shl_rvp_requantize(output_tmp, kernel->qinfo[q].multiplier, kernel->qinfo[q].shift,
+                               out_size);
+            shl_rvp_saturated_int8(output_tmp, output_data + (b * channel + c) * out_size, out_zp,
+                                   out_size);
+        }
+    }
+
+    shl_mem_free(input_padd);
+    shl_mem_free(output_tmp);
+    return CSINN_TRUE;
+}
@@ -53,6 +53,23 @@ int shl_e907_fullyconnected_init(struct csinn_tensor *input, struct csinn_tensor
                                     &(weights->qinfo[i].shift));
         }
         cb->exec = shl_e907_fullyconnected_int8;
+    } else if (input->dtype == CSINN_DTYPE_INT16) {
+        bool sym = input->qinfo->zero_point == 0;
+        for (int i = 0; i < weights->quant_channel; i++) {
+            sym = sym && weights->qinfo[i].zero_point == 0;
+        }
+        // asymmetric int16 would overflow the zeropoint folded into an int32 bias
+        if (!sym || weights->dtype != CSINN_DTYPE_INT16 ||
+            (bias->data != NULL && bias->dtype != CSINN_DTYPE_INT32)) {
+            cb->exec = shl_ref_fullyconnected_quant;
+            return CSINN_TRUE;
+        }
+        for (int i = 0; i < weights->quant_channel; i++) {
+            float real_scale = input->qinfo->scale * weights->qinfo[i].scale / output->qinfo->scale;
+            shl_quantize_multiplier(real_scale, &(weights->qinfo[i].multiplier),
+                                    &(weights->qinfo[i].shift));
+        }
+        cb->exec = shl_e907_fullyconnected_int16;
     }
     return CSINN_TRUE;
 }
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "e907/e907.h"
+
+int shl_e907_maxpool2d_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                 struct csinn_pool_params *params)
+{
+    struct csinn_callback *cb = params->base.cb;
+    int32_t in_h = input->dim[2];
+    int32_t in_w = input->dim[3];
+
+    if (params->base.layout != CSINN_LAYOUT_NCHW || input->quant_channel != 1 ||
+        output->quant_channel != 1) {
+        cb->exec = shl_ref_maxpool2d_quant;
+        return CSINN_TRUE;
+    }
+    if (in_h == params->filter_height && in_w == params->filter_width &&
+        params->pad_top == 0 && params->pad_left == 0 && params->pad_down == 0 &&
+        params->pad_right == 0) {
+        cb->exec = shl_e907_global_maxpool2d_int8;
+    } else {
+        cb->exec = shl_e907_maxpool2d_int8;
+    }
+    float real_scale = input->qinfo->scale / output->qinfo->scale;
+    shl_quantize_multiplier(real_scale, &output->qinfo->multiplier, &output->qinfo->shift);
+    return CSINN_TRUE;
+}
+
+/************************************************************************************
+ * max is monotonic, so only the selected value is requantized
+ * q2 = (max(q1) - z1) * s1/s2 + z2
+ ************************************************************************************/
+static void maxpool_requantize_int8(int8_t *data, int size, struct csinn_tensor *input,
+                                    struct csinn_tensor *output)
+{
+    int32_t z1 = input->qinfo->zero_point;
+    int32_t z2 = output->qinfo->zero_point;
+    int32_t multiplier = output->qinfo->multiplier;
+    int32_t shift = output->qinfo->shift;
+    if (input->qinfo->scale == output->qinfo->scale && z1 == z2) {
+        return;
+    }
+    for (int i = 0; i < size; i++) {
+        int32_t res = (int32_t)data[i] - z1;
+        if (shift >= -2) {
+            res <<= shift + 2;
+            res = shl_rvp_mulh(res, multiplier);
+            res >>= 1;
+        } else {
+            res = shl_rvp_mulh(res, multiplier);
+            res >>= -shift - 1;
+        }
+        res += z2;
+        data[i] = shl_rvp_clip_i8(res);
+    }
+}
+
+// dst[i] = max(dst[i], src[i]), four lanes per smax8
+static inline void maxpool_row_max_int8(int8_t *dst, const int8_t *src, int len)
+{
+    int i = 0;
+    for (; i + 3 < len; i += 4) {
+        shl_rvp_store_8x4(dst + i,
+                          __rv__smax8(shl_rvp_load_8x4(dst + i), shl_rvp_load_8x4(src + i)));
+    }
+    for (; i < len; i++) {
+        dst[i] = dst[i] > src[i] ? dst[i] : src[i];
+    }
+}
+
+/************************************************************************************
+ * the rows of a window are reduced with smax8 over the whole input width first,
+ * the columns of each window are then picked out of that row
+ ************************************************************************************/
+int shl_e907_maxpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_pool_params *params)
+{
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    const int batch = input->dim[0];
+    const int channel = input->dim[1];
+    const int in_h = input->dim[2];
+    const int in_w = input->dim[3];
+    const int out_h = output->dim[2];
+    const int out_w = output->dim[3];
+    const int kernel_h = params->filter_height;
+    const int kernel_w = params->filter_width;
+
+    int8_t *row_max = (int8_t *)shl_mem_alloc(in_w * sizeof(int8_t));
+    for (int bc = 0; bc < batch * channel; bc++) {
+        int8_t *in_ptr = input_data + bc * in_h * in_w;
+        int8_t *out_ptr = output_data + bc * out_h * out_w;
+        for (int oh = 0; oh < out_h; oh++) {
+            int h_origin = oh * params->stride_height - params->pad_top;
+            int h_start = h_origin > 0 ? h_origin : 0;
+            int h_end = h_origin + kernel_h < in_h ? h_origin + kernel_h : in_h;
+            memcpy(row_max, in_ptr + h_start * in_w, in_w * sizeof(int8_t));
+            for (int h = h_start + 1; h < h_end; h++) {
+                maxpool_row_max_int8(row_max, in_ptr + h * in_w, in_w);
+            }
+            for (int ow = 0; ow < out_w; ow++) {
+                int w_origin = ow * params->stride_width - params->pad_left;
+                int w_start = w_origin > 0 ? w_origin : 0;
+                int w_end = w_origin + kernel_w < in_w ? w_origin + kernel_w : in_w;
+                int8_t max = row_max[w_start];
+                for (int w = w_start + 1; w < w_end; w++) {
+                    max = row_max[w] > max ? row_max[w] : max;
+                }
+                out_ptr[ow] = max;
+            }
+            out_ptr += out_w;
+        }
+    }
+    shl_mem_free(row_max);
+
+    maxpool_requantize_int8(output_data, csinn_tensor_size(output), input, output);
+    return CSINN_TRUE;
+}
+
+int shl_e907_global_maxpool2d_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
+{
+    if (params->base.layout != CSINN_LAYOUT_NCHW || input->quant_channel != 1 ||
+        output->quant_channel != 1) {
+        return shl_ref_global_maxpool2d_quant(input, output, params);
+    }
+
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    const int batch = input->dim[0];
+    const int channel = input->dim[1];
+    const int in_size = input->dim[2] * input->dim[3];
+
+    for (int bc = 0; bc < batch * channel; bc++) {
+        int8_t *in_ptr = input_data + bc * in_size;
+        int8_t max = in_ptr[0];
+        int i = 0;
+        if (in_size >= 4) {
+            uint32_t max4 = shl_rvp_load_8x4(in_ptr);
+            for (i = 4; i + 3 < in_size; i += 4) {
+                max4 = __rv__smax8(max4, shl_rvp_load_8x4(in_ptr + i));
+            }
+            int8_t *lane = (int8_t *)&max4;
+            for (int l = 0; l < 4; l++) {
+                max = lane[l] > max ? lane[l] : max;
+            }
+        }
+        for (; i < in_size; i++) {
+            max = in_ptr[i] > max ? in_ptr[i] : max;
+        }
+        output_data[bc] = max;
+    }
+
+    maxpool_requantize_int8(output_data, batch * channel, input, output);
+    return CSINN_TRUE;
+}
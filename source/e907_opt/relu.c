@@ -27,6 +27,24 @@ int shl_e907_relu_int8(struct csinn_tensor *input, struct csinn_tensor *output,
 {
     int8_t *input_data = (int8_t *)input->data;
     int8_t *output_data = (int8_t *)output->data;
+    int size = csinn_tensor_size(input);
+
+    // same quantization on both sides: q2 = max(q1, z1), four lanes per smax8
+    if (input->qinfo->scale == output->qinfo->scale &&
+        input->qinfo->zero_point == output->qinfo->zero_point) {
+        int8_t z = input->qinfo->zero_point;
+        uint32_t z_8x4 = (uint8_t)z * 0x01010101u;
+        int i = 0;
+        // word lanes only for word aligned tensors, e.g. not for split or sliced views
+        bool aligned = (((uintptr_t)input_data | (uintptr_t)output_data) & 3) == 0;
+        for (; aligned && i + 3 < size; i += 4) {
+            *(uint32_t *)(output_data + i) = __rv__smax8(*(uint32_t *)(input_data + i), z_8x4);
+        }
+        for (; i < size; i++) {
+            output_data[i] = input_data[i] > z ? input_data[i] : z;
+        }
+        return CSINN_TRUE;
+    }
 
     float real_scale = input->qinfo->scale / output->qinfo->scale;
     shl_quantize_multiplier(real_scale, &output->qinfo->multiplier, &output->qinfo->shift);
@@ -36,7 +54,6 @@ int shl_e907_relu_int8(struct csinn_tensor *input, struct csinn_tensor *output,
     int32_t shift = output->qinfo->shift;
     int32_t z2 = output->qinfo->zero_point;
 
-    int size = csinn_tensor_size(input);
     int i = 0;
     for (; i < size; i++) {
         int32_t res = (int32_t)input_data[i] - z1;
@@ -50,3 +67,50 @@ int shl_e907_relu_int8(struct csinn_tensor *input, struct csinn_tensor *output,
 
     return CSINN_TRUE;
 }
+
+int shl_e907_relu_int16(struct csinn_tensor *input, struct csinn_tensor *output,
+                        struct csinn_relu_params *params)
+{
+    int16_t *input_data = (int16_t *)input->data;
+    int16_t *output_data = (int16_t *)output->data;
+    int size = csinn_tensor_size(input);
+
+    // same quantization on both sides: q2 = max(q1, z1), two lanes per smax16
+    if (input->qinfo->scale == output->qinfo->scale &&
+        input->qinfo->zero_point == output->qinfo->zero_point) {
+        int16_t z = input->qinfo->zero_point;
+        uint32_t z_16x2 = (uint16_t)z * 0x00010001u;
+        int i = 0;
+        bool aligned = (((uintptr_t)input_data | (uintptr_t)output_data) & 3) == 0;
+        for (; aligned && i + 1 < size; i += 2) {
+            *(uint32_t *)(output_data + i) = __rv__smax16(*(uint32_t *)(input_data + i), z_16x2);
+        }
+        for (; i < size; i++) {
+            output_data[i] = input_data[i] > z ? input_data[i] : z;
+        }
+        return CSINN_TRUE;
+    }
+
+    float real_scale = input->qinfo->scale / output->qinfo->scale;
+    shl_quantize_multiplier(real_scale, &output->qinfo->multiplier, &output->qinfo->shift);
+
+    int32_t z1 = input->qinfo->zero_point;
+    int32_t multiplier = output->qinfo->multiplier;
+    int32_t shift = output->qinfo->shift;
+    int32_t z2 = output->qinfo->zero_point;
+
+    for (int i = 0; i < size; i++) {
+        int32_t res = (int32_t)input_data[i] - z1;
+        res = res > 0 ? res : 0;
+        res = shl_rvp_mulh(res << 1, multiplier);
+        if (shift < 0) {
+            res >>= -shift;
+        } else {
+            res <<= shift;
+        }
+        res += z2;
+        output_data[i] = shl_rvp_clip_i16(res);
+    }
+
+    return CSINN_TRUE;
+}
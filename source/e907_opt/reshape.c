@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "e907/e907.h"
+
+/************************************************************************************
+ * the raw codes are copied when the quantization info is unchanged by reshape,
+ * otherwise they are requantized by the reference
+ ************************************************************************************/
+int shl_e907_reshape_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                          struct csinn_reshape_params *params)
+{
+    if (input->quant_channel != 1 || output->quant_channel != 1 ||
+        input->qinfo->scale != output->qinfo->scale ||
+        input->qinfo->zero_point != output->qinfo->zero_point) {
+        return shl_ref_reshape_quant(input, output, params);
+    }
+
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+    if (input_data != output_data) {
+        memcpy(output_data, input_data, csinn_tensor_byte_size(input));
+    }
+    return CSINN_TRUE;
+}
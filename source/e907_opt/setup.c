@@ -18,24 +18,22 @@
 
 #include "e907/e907.h"
 
-static struct shl_cb_op_list shl_e907_cb_op_list;
+static struct shl_cb_op_map shl_e907_cb_op_map;
 
 int shl_e907_reg_op(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *init, void *exec)
 {
-    struct shl_cb_op_list *list_end = shl_cb_list_end(&shl_e907_cb_op_list);
-    struct shl_cb_op_list *next = shl_mem_alloc(sizeof(struct shl_cb_op_list));
-    next->cb = shl_mem_alloc(sizeof(struct csinn_callback));
-    next->cb->init = init;
-    next->cb->exec = exec;
-    next->dtype = dtype;
-    next->op_name = op_name;
-    list_end->next = next;
+    struct csinn_callback *cb = shl_cb_op_map_add(&shl_e907_cb_op_map, dtype, op_name);
+    if (cb == NULL) {
+        return CSINN_FALSE;
+    }
+    cb->init = init;
+    cb->exec = exec;
     return CSINN_TRUE;
 }
 
 int shl_e907_reg_op_est(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *est)
 {
-    struct csinn_callback *cb = shl_cb_list_match(&shl_e907_cb_op_list, dtype, op_name);
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_e907_cb_op_map, dtype, op_name);
     if (cb == NULL) {
         shl_debug_info("%s: cannot find e907 est\n", __func__);
     } else {
@@ -48,7 +46,7 @@ int shl_e907_reg_op_est(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name,
 struct csinn_callback *__attribute__((weak)) shl_cb_map_rvv(int op, int dtype);
 struct csinn_callback *shl_cb_map_e907(int op, int dtype)
 {
-    struct csinn_callback *cb = shl_cb_list_match(&shl_e907_cb_op_list, dtype, op);
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_e907_cb_op_map, dtype, op);
     if (cb == NULL) {
         cb = shl_cb_map_rvv(op, dtype);
     }
@@ -62,15 +60,35 @@ void __attribute__((weak)) shl_target_init_e907()
 #ifndef CONFIG_E907_OPT_CONVOLUTION_DISABLED
     shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_CONV2D, NULL, shl_e907_conv2d_int8);
 #endif
+#ifndef CONFIG_E907_OPT_DEPTHWISE_CONVOLUTION_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_DEPTHWISE_CONV2D,
+                    shl_e907_depthwise_conv2d_init_int8, NULL);
+#endif
+#ifndef CONFIG_E907_OPT_AVERAGEPOOL_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_AVGPOOL2D, shl_e907_avgpool2d_init_int8, NULL);
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_GLOBAL_AVGPOOL2D, NULL,
+                    shl_e907_global_avgpool2d_int8);
+#endif
+#ifndef CONFIG_E907_OPT_MAXPOOL_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_MAXPOOL2D, shl_e907_maxpool2d_init_int8, NULL);
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_GLOBAL_MAXPOOL2D, NULL,
+                    shl_e907_global_maxpool2d_int8);
+#endif
+#ifndef CONFIG_E907_OPT_ADD_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_ADD, NULL, shl_e907_add_int8);
+#endif
 #ifndef CONFIG_E907_OPT_CONCAT_DISABLED
     shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_CONCAT, NULL, shl_e907_concat_int8);
 #endif
 #ifndef CONFIG_E907_OPT_RELU_DISABLED
     shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_RELU, NULL, shl_e907_relu_int8);
+    shl_e907_reg_op(CSINN_DTYPE_INT16, CSINN_OP_RELU, NULL, shl_e907_relu_int16);
 #endif
 #ifndef CONFIG_E907_OPT_FC_DISABLED
     shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_FULLYCONNECTED, shl_e907_fullyconnected_init,
                     shl_e907_fullyconnected_int8);
+    shl_e907_reg_op(CSINN_DTYPE_INT16, CSINN_OP_FULLYCONNECTED, shl_e907_fullyconnected_init,
+                    shl_e907_fullyconnected_int16);
 #endif
 #ifndef CONFIG_E907_OPT_MUL_DISABLED
     shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_MUL, NULL, shl_e907_mul_int8);
@@ -81,19 +99,46 @@ void __attribute__((weak)) shl_target_init_e907()
 #ifndef CONFIG_E907_OPT_SOFTMAX_DISABLED
     shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_SOFTMAX, NULL, shl_e907_softmax_int8);
 #endif
+#ifndef CONFIG_E907_OPT_SIGMOID_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_SIGMOID, shl_e907_sigmoid_init_int8, NULL);
+#endif
+#ifndef CONFIG_E907_OPT_TANH_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_TANH, shl_e907_tanh_init_int8, NULL);
+#endif
+#ifndef CONFIG_E907_OPT_RESHAPE_DISABLED
+    shl_e907_reg_op(CSINN_DTYPE_INT8, CSINN_OP_RESHAPE, NULL, shl_e907_reshape_int8);
+#endif
 
     shl_register_runtime_callback(CSINN_E907, shl_gref_runtime_callback);
 #ifndef CONFIG_GRAPH_REFERENCE_CONVOLUTION_DISABLED
     shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_CONV2D, shl_gref_conv2d);
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_DEPTHWISE_CONV2D, shl_gref_depthwise_conv2d);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_AVERAGEPOOL_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_AVGPOOL2D, shl_gref_avgpool2d);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_GLOBAL_AVERAGEPOOL_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_GLOBAL_AVGPOOL2D, shl_gref_global_avgpool2d);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_MAXPOOL_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_MAXPOOL2D, shl_gref_maxpool2d);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_GLOBAL_MAXPOOL_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_GLOBAL_MAXPOOL2D, shl_gref_global_maxpool2d);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_ADD_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_ADD, shl_gref_add);
 #endif
 #ifndef CONFIG_GRAPH_REFERENCE_CONCAT_DISABLED
     shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_CONCAT, shl_gref_concat);
 #endif
 #ifndef CONFIG_GRAPH_REFERENCE_RELU_DISABLED
     shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_RELU, shl_gref_relu);
+    shl_e907_reg_op_est(CSINN_DTYPE_INT16, CSINN_OP_RELU, shl_gref_relu);
 #endif
 #ifndef CONFIG_GRAPH_REFERENCE_FULLYCONNECTED_DISABLED
     shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_FULLYCONNECTED, shl_gref_fullyconnected);
+    shl_e907_reg_op_est(CSINN_DTYPE_INT16, CSINN_OP_FULLYCONNECTED, shl_gref_fullyconnected);
 #endif
 #ifndef CONFIG_GRAPH_REFERENCE_MUL_DISABLED
     shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_MUL, shl_gref_mul);
@@ -104,4 +149,13 @@ void __attribute__((weak)) shl_target_init_e907()
 #ifndef CONFIG_GRAPH_REFERENCE_SOFTMAX_DISABLED
     shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_SOFTMAX, shl_gref_softmax);
 #endif
+#ifndef CONFIG_GRAPH_REFERENCE_SIGMOID_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_SIGMOID, shl_gref_sigmoid);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_TANH_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_TANH, shl_gref_tanh);
+#endif
+#ifndef CONFIG_GRAPH_REFERENCE_RESHAPE_DISABLED
+    shl_e907_reg_op_est(CSINN_DTYPE_INT8, CSINN_OP_RESHAPE, shl_gref_reshape);
+#endif
 }
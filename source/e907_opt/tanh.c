@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "e907/e907.h"
+
+int shl_e907_tanh_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_siso_params *params)
+{
+    struct csinn_callback *cb = params->base.cb;
+    if (input->quant_channel == 1 && output->quant_channel == 1) {
+        params->lut = shl_mem_alloc(256);
+        shl_rvp_int8_lut_init(params->lut, input, output, tanhf);
+        cb->exec = shl_e907_tanh_int8;
+    } else {
+        cb->exec = shl_ref_tanh_quant;
+    }
+    return CSINN_TRUE;
+}
+
+/************************************************************************************
+ * only 256 input codes exist: look the results up in the table built at init
+ ************************************************************************************/
+int shl_e907_tanh_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                       struct csinn_siso_params *params)
+{
+    shl_rvp_int8_lut(input->data, output->data, params->lut, csinn_tensor_size(input));
+    return CSINN_TRUE;
+}
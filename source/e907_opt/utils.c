@@ -140,3 +140,61 @@ void shl_rvp_saturated_int8(int32_t *src, int8_t *dst, int32_t out_zp, int size)
         dst[i] = shl_rvp_clip_i8(res);
     }
 }
+
+/********************* for int16 quantization *********************/
+// add output_zeropoint, saturate to int16
+void shl_rvp_saturated_int16(int32_t *src, int16_t *dst, int32_t out_zp, int size)
+{
+    int i = 0;
+#if __riscv_xlen == 64
+    int64_t out_zp_32x2 = shl_rvp_int32_to_xlen(out_zp);
+    for (; i + 1 < size; i += 2) {
+        int64_t *src_i32x2 = src + i;
+        int64_t tmp = __rv__add32(src_i32x2[0], out_zp_32x2);
+        int64_t res = __rv__sclip32(tmp, 15);
+        int32_t *res1 = (int32_t *)(&res);
+        dst[i] = (int16_t)res1[0];
+        dst[i + 1] = (int16_t)res1[1];
+    }
+#endif
+    for (; i < size; i++) {
+        int32_t res = src[i] + out_zp;
+        dst[i] = shl_rvp_clip_i16(res);
+    }
+}
+
+/*
+ * Tabulate an elementwise function over every int8 code of a per-tensor quantized input:
+ * lut[(uint8_t)q1] = q2 with s2(q2 - z2) = func(s1(q1 - z1)).
+ */
+void shl_rvp_int8_lut_init(int8_t *lut, struct csinn_tensor *input, struct csinn_tensor *output,
+                           float (*func)(float))
+{
+    float s1 = input->qinfo->scale;
+    int32_t z1 = input->qinfo->zero_point;
+    float s2 = output->qinfo->scale;
+    int32_t z2 = output->qinfo->zero_point;
+    for (int q = INT8_MIN; q <= INT8_MAX; q++) {
+        float y = func((q - z1) * s1);
+        lut[(uint8_t)q] = shl_rvp_clip_i8((int32_t)roundf(y / s2) + z2);
+    }
+}
+
+// output[i] = lut[(uint8_t)input[i]], four codes per word when both sides are word aligned
+void shl_rvp_int8_lut(const int8_t *input, int8_t *output, const int8_t *lut, int size)
+{
+    const uint8_t *in = (const uint8_t *)input;
+    bool aligned = (((uintptr_t)input | (uintptr_t)output) & 3) == 0;
+    int i = 0;
+    for (; aligned && i + 3 < size; i += 4) {
+        uint32_t codes = *(uint32_t *)(in + i);
+        uint32_t res = (uint8_t)lut[codes & 0xff];
+        res |= (uint32_t)(uint8_t)lut[(codes >> 8) & 0xff] << 8;
+        res |= (uint32_t)(uint8_t)lut[(codes >> 16) & 0xff] << 16;
+        res |= (uint32_t)(uint8_t)lut[codes >> 24] << 24;
+        *(uint32_t *)(output + i) = res;
+    }
+    for (; i < size; i++) {
+        output[i] = lut[in[i]];
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shl_gref.h"
+
+/*
+ * Device worker of the asynchronous hybrid executor: subgraphs are queued by the
+ * scheduler thread and run in submission order on one worker thread, like commands
+ * pushed to an accelerator. Finished subgraphs are reported back by layer index, the
+ * scheduler keeps all the tensor bookkeeping on its own thread.
+ */
+
+#ifndef SHL_BUILD_RTOS
+#include <pthread.h>
+
+struct shl_gref_async {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t job_cond;
+    pthread_cond_t done_cond;
+    struct shl_node **job;
+    int job_head;
+    int job_tail;
+    int *done;
+    int done_head;
+    int done_tail;
+    bool quit;
+};
+
+static void *async_worker(void *arg)
+{
+    struct shl_gref_async *async = arg;
+
+    pthread_mutex_lock(&async->mutex);
+    while (true) {
+        while (async->job_head == async->job_tail && !async->quit) {
+            pthread_cond_wait(&async->job_cond, &async->mutex);
+        }
+        if (async->job_head == async->job_tail) {
+            break;
+        }
+        struct shl_node *n = async->job[async->job_head++];
+        pthread_mutex_unlock(&async->mutex);
+
+        shl_subgraph_run(n);
+
+        pthread_mutex_lock(&async->mutex);
+        async->done[async->done_tail++] = n->subgraph_idx;
+        pthread_cond_signal(&async->done_cond);
+    }
+    pthread_mutex_unlock(&async->mutex);
+    return NULL;
+}
+
+struct shl_gref_async *shl_gref_async_create(int max_jobs)
+{
+    struct shl_gref_async *async = shl_mem_alloc(sizeof(struct shl_gref_async));
+    async->job = shl_mem_alloc(max_jobs * sizeof(struct shl_node *));
+    async->done = shl_mem_alloc(max_jobs * sizeof(int));
+    pthread_mutex_init(&async->mutex, NULL);
+    pthread_cond_init(&async->job_cond, NULL);
+    pthread_cond_init(&async->done_cond, NULL);
+    if (pthread_create(&async->thread, NULL, async_worker, async) != 0) {
+        shl_debug_error("%s: failed to create device worker\n", __func__);
+        pthread_mutex_destroy(&async->mutex);
+        pthread_cond_destroy(&async->job_cond);
+        pthread_cond_destroy(&async->done_cond);
+        shl_mem_free(async->job);
+        shl_mem_free(async->done);
+        shl_mem_free(async);
+        return NULL;
+    }
+    return async;
+}
+
+void shl_gref_async_destroy(struct shl_gref_async *async)
+{
+    pthread_mutex_lock(&async->mutex);
+    async->quit = true;
+    pthread_cond_signal(&async->job_cond);
+    pthread_mutex_unlock(&async->mutex);
+    pthread_join(async->thread, NULL);
+
+    pthread_mutex_destroy(&async->mutex);
+    pthread_cond_destroy(&async->job_cond);
+    pthread_cond_destroy(&async->done_cond);
+    shl_mem_free(async->job);
+    shl_mem_free(async->done);
+    shl_mem_free(async);
+}
+
+/* every subgraph is submitted at most once per run, so the queues restart at zero */
+void shl_gref_async_reset(struct shl_gref_async *async)
+{
+    pthread_mutex_lock(&async->mutex);
+    async->job_head = async->job_tail = 0;
+    async->done_head = async->done_tail = 0;
+    pthread_mutex_unlock(&async->mutex);
+}
+
+void shl_gref_async_submit(struct shl_gref_async *async, struct shl_node *n)
+{
+    pthread_mutex_lock(&async->mutex);
+    async->job[async->job_tail++] = n;
+    pthread_cond_signal(&async->job_cond);
+    pthread_mutex_unlock(&async->mutex);
+}
+
+/* layer index of a finished subgraph, -1 if none is finished and wait is false */
+int shl_gref_async_finished(struct shl_gref_async *async, bool wait)
+{
+    int idx = -1;
+    pthread_mutex_lock(&async->mutex);
+    while (wait && async->done_head == async->done_tail) {
+        pthread_cond_wait(&async->done_cond, &async->mutex);
+    }
+    if (async->done_head != async->done_tail) {
+        idx = async->done[async->done_head++];
+    }
+    pthread_mutex_unlock(&async->mutex);
+    return idx;
+}
+#else
+struct shl_gref_async *shl_gref_async_create(int max_jobs) { return NULL; }
+void shl_gref_async_destroy(struct shl_gref_async *async) {}
+void shl_gref_async_reset(struct shl_gref_async *async) {}
+void shl_gref_async_submit(struct shl_gref_async *async, struct shl_node *n) {}
+int shl_gref_async_finished(struct shl_gref_async *async, bool wait) { return -1; }
+#endif
+
+void shl_gref_set_async_subgraph(struct csinn_session *sess, bool enable)
+{
+    struct shl_gref_target_data *td = sess->td;
+    td->async_subgraph = enable;
+}
+
+void shl_gref_set_sim_latency(struct csinn_session *sess, int32_t latency_us)
+{
+    struct shl_gref_target_data *td = sess->td;
+    td->sim_latency_us = latency_us;
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shl_gref.h"
+
+/*
+ * A clone is an execution context of an already setup session. Layer nodes and every var
+ * tensor are duplicated, so each context keeps its own activations, I/O tensors and reference
+ * counts. Const tensors and op params are shared, which keeps a single copy of the weights and
+ * of the kernels reordered or transformed by the op init. Params that are written by exec, the
+ * ring buffers of cache_matmul and cache_conv1d, and the fsmn frame state are duplicated.
+ */
+struct shl_gref_clone_map {
+    struct shl_node **from;
+    struct shl_node **to;
+    int num;
+    int size;
+};
+
+static struct shl_node *clone_map_find(struct shl_gref_clone_map *map, struct shl_node *node)
+{
+    for (int i = 0; i < map->num; i++) {
+        if (map->from[i] == node) {
+            return map->to[i];
+        }
+    }
+    return NULL;
+}
+
+static void clone_map_insert(struct shl_gref_clone_map *map, struct shl_node *from,
+                             struct shl_node *to)
+{
+    if (map->num == map->size) {
+        map->size += 128;
+        map->from = shl_mem_realloc(map->from, map->size * sizeof(struct shl_node *),
+                                    map->num * sizeof(struct shl_node *));
+        map->to = shl_mem_realloc(map->to, map->size * sizeof(struct shl_node *),
+                                  map->num * sizeof(struct shl_node *));
+    }
+    map->from[map->num] = from;
+    map->to[map->num] = to;
+    map->num++;
+}
+
+static bool is_graph_input(struct shl_ref_graph *graph, struct shl_node *node)
+{
+    for (int i = 0; i < graph->input_num; i++) {
+        if (graph->input[i] == node) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static struct shl_node *clone_var(struct shl_node *node, struct shl_ref_graph *graph,
+                                  struct shl_gref_clone_map *map, struct csinn_session *sess)
+{
+    /* const tensor is shared */
+    if (node->in_num == 0) {
+        return node;
+    }
+    struct shl_node *ret = clone_map_find(map, node);
+    if (ret) {
+        return ret;
+    }
+
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    csinn_tensor_copy(t, node->data);
+    t->sess = sess;
+    /* activations are allocated by run, inputs are set by csinn_update_input */
+    if (node->in[0] != NULL || is_graph_input(graph, node)) {
+        t->data = NULL;
+        if (t->mtype == CSINN_MEM_TYPE_CPU_ACC) {
+            t->mtype = CSINN_MEM_TYPE_CPU_NOT_ALIGNED;
+        }
+    }
+    ret = shl_node_alloc(CSINN_TENSOR, node->name, 1, node->out_num, t);
+    ret->subgraph_idx = node->subgraph_idx;
+    ret->ref_count_init = node->ref_count_init;
+    clone_map_insert(map, node, ret);
+    return ret;
+}
+
+static struct shl_node *clone_frame_state(struct shl_node *node)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    csinn_tensor_copy(t, node->data);
+    /* a new context starts a new stream */
+    t->data = shl_mem_alloc(csinn_tensor_byte_size(t));
+    return shl_node_alloc(CSINN_TENSOR, node->name, 0, 1, t);
+}
+
+static void clone_asr_buffer(struct csinn_asr_buffer_t *dest, struct csinn_asr_buffer_t *src)
+{
+    *dest = *src;
+    if (src->buffer != NULL) {
+        /* same as asr_buffer_init */
+        dest->buffer = shl_mem_alloc(src->buffer_lenth);
+        dest->writer_index = src->data_lenth;
+        dest->flag = 0;
+    }
+}
+
+static void *clone_params(struct shl_node *node)
+{
+    if (node->type == CSINN_OP_CACHE_MATMUL) {
+        struct csinn_cache_matmul_params *src = node->data;
+        struct csinn_cache_matmul_params *ret =
+            shl_mem_alloc(sizeof(struct csinn_cache_matmul_params));
+        *ret = *src;
+        clone_asr_buffer(&ret->asr_buffer, &src->asr_buffer);
+        return ret;
+    } else if (node->type == CSINN_OP_CACHE_CONV1D) {
+        struct csinn_cache_conv1d_params *src = node->data;
+        struct csinn_cache_conv1d_params *ret =
+            shl_mem_alloc(sizeof(struct csinn_cache_conv1d_params));
+        *ret = *src;
+        clone_asr_buffer(&ret->asr_buffer, &src->asr_buffer);
+        return ret;
+    }
+    return node->data;
+}
+
+static struct shl_ref_graph *clone_graph(struct shl_ref_graph *graph, struct csinn_session *sess)
+{
+    struct shl_gref_clone_map map = {0};
+    struct shl_ref_graph *ret = shl_mem_alloc(sizeof(struct shl_ref_graph));
+    ret->layer_size = graph->layer_index;
+    ret->layer_index = graph->layer_index;
+    ret->layer = shl_mem_alloc(ret->layer_size * sizeof(struct shl_node *));
+
+    for (int i = 0; i < graph->layer_index; i++) {
+        struct shl_node *n = graph->layer[i];
+        struct shl_node *l = shl_node_alloc(n->type, n->name, n->in_num, n->out_num, NULL);
+        l->data = clone_params(n);
+        l->subgraph_idx = n->subgraph_idx;
+        for (int j = 0; j < n->in_num; j++) {
+            if (n->type == CSINN_OP_FSMN && (j == 3 || j == 4)) {
+                l->in[j] = clone_frame_state(n->in[j]);
+                l->in[j]->out[0] = l;
+            } else {
+                l->in[j] = clone_var(n->in[j], graph, &map, sess);
+            }
+        }
+        for (int j = 0; j < n->out_num; j++) {
+            l->out[j] = clone_var(n->out[j], graph, &map, sess);
+            l->out[j]->in[0] = l;
+        }
+        clone_map_insert(&map, n, l);
+        ret->layer[i] = l;
+    }
+
+    /* consumers of the cloned var tensors */
+    for (int i = 0; i < map.num; i++) {
+        struct shl_node *from = map.from[i];
+        struct shl_node *to = map.to[i];
+        if (to->type != CSINN_TENSOR) {
+            continue;
+        }
+        for (int j = 0; j < from->out_num; j++) {
+            to->out[j] = from->out[j] ? clone_map_find(&map, from->out[j]) : NULL;
+        }
+    }
+
+    ret->input_num = graph->input_num;
+    ret->input = shl_mem_alloc(ret->input_num * sizeof(struct shl_node *));
+    for (int i = 0; i < graph->input_num; i++) {
+        ret->input[i] = clone_var(graph->input[i], graph, &map, sess);
+    }
+    ret->output_num = graph->output_num;
+    ret->output = shl_mem_alloc(ret->output_num * sizeof(struct shl_node *));
+    for (int i = 0; i < graph->output_num; i++) {
+        ret->output[i] = clone_var(graph->output[i], graph, &map, sess);
+    }
+
+    shl_mem_free(map.from);
+    shl_mem_free(map.to);
+    return ret;
+}
+
+struct csinn_session *shl_gref_session_clone(struct csinn_session *sess)
+{
+    struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+    for (int i = 0; i < graph->layer_index; i++) {
+        if (graph->layer[i]->type == CSINN_SUBGRAPH) {
+            shl_debug_error("%s: subgraph is unsupported\n", __func__);
+            return NULL;
+        }
+    }
+
+    struct csinn_session *ret = csinn_alloc_session();
+    *ret = *sess;
+    /* trace data belongs to the origin session */
+    ret->profiler_level = CSINN_PROFILER_LEVEL_UNSET;
+    ret->trace = NULL;
+    /* every clone runs on its own workers */
+    ret->thread_pool = NULL;
+
+    struct shl_gref_target_data *td = shl_mem_alloc(sizeof(struct shl_gref_target_data));
+    *td = *(struct shl_gref_target_data *)sess->td;
+    td->bound_state = NULL;
+    td->own_state = NULL;
+    td->async = NULL;
+    td->graph = clone_graph(graph, ret);
+    ret->td = td;
+
+    ret->input = shl_mem_alloc(ret->input_num * sizeof(struct csinn_tensor *));
+    for (int i = 0; i < ret->input_num && i < td->graph->input_num; i++) {
+        ret->input[i] = td->graph->input[i]->data;
+    }
+    ret->output = shl_mem_alloc(ret->output_num * sizeof(struct csinn_tensor *));
+    for (int i = 0; i < ret->output_num && i < td->graph->output_num; i++) {
+        ret->output[i] = td->graph->output[i]->data;
+    }
+    return ret;
+}
+
+static void free_var(struct shl_node *node)
+{
+    struct csinn_tensor *t = node->data;
+    csinn_free_tensor(t);
+    shl_node_free(node);
+}
+
+void shl_gref_free_session_clone(struct csinn_session *sess)
+{
+    struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+
+    /* graph inputs are the only var tensors without a producer layer */
+    for (int i = 0; i < graph->input_num; i++) {
+        if (graph->input[i]->in_num == 1 && graph->input[i]->in[0] == NULL) {
+            free_var(graph->input[i]);
+        }
+    }
+    for (int i = 0; i < graph->layer_index; i++) {
+        struct shl_node *n = graph->layer[i];
+        for (int j = 0; j < n->out_num; j++) {
+            free_var(n->out[j]);
+        }
+        if (n->type == CSINN_OP_FSMN) {
+            shl_mem_free(((struct csinn_tensor *)n->in[3]->data)->data);
+            free_var(n->in[3]);
+            shl_mem_free(((struct csinn_tensor *)n->in[4]->data)->data);
+            free_var(n->in[4]);
+        } else if (n->type == CSINN_OP_CACHE_MATMUL) {
+            struct csinn_cache_matmul_params *params = n->data;
+            shl_mem_free(params->asr_buffer.buffer);
+            shl_mem_free(params);
+        } else if (n->type == CSINN_OP_CACHE_CONV1D) {
+            struct csinn_cache_conv1d_params *params = n->data;
+            shl_mem_free(params->asr_buffer.buffer);
+            shl_mem_free(params);
+        }
+        shl_node_free(n);
+    }
+
+    shl_mem_free(graph->layer);
+    shl_mem_free(graph->input);
+    shl_mem_free(graph->output);
+    shl_mem_free(graph);
+    shl_mem_free(sess->td);
+    shl_mem_free(sess->input);
+    shl_mem_free(sess->output);
+    shl_mem_free(sess);
+}
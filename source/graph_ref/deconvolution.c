@@ -36,7 +36,8 @@ int shl_gref_deconv2d_infer_shape(struct csinn_tensor *input, struct csinn_tenso
         c = 1;
         h = 2;
         w = 3;
-        kernel_oc = params->group == input->dim[c] ? kernel->dim[0] : kernel->dim[1];
+        kernel_oc =
+            params->group == input->dim[c] ? kernel->dim[0] : kernel->dim[1] * params->group;
     } else if (input->layout == CSINN_LAYOUT_NHWC) {
         h = 1;
         w = 2;
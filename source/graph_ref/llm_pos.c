@@ -31,11 +31,17 @@ int shl_gref_llm_pos_infer_shape(struct csinn_tensor *input, struct csinn_tensor
     if (params->mode == CSINN_LLM_POS_CACHE_COPY_IN) {
         // do nothing
     } else if (params->mode == CSINN_LLM_POS_CACHE_COPY_OUT) {
+        /* keys/values of every sequence up to the longest one in the batch */
+        int kv_len = 0;
+        for (int i = 0; i < params->bsz; i++) {
+            int len = params->pos[i * params->seqlen] + params->seqlen;
+            kv_len = len > kv_len ? len : kv_len;
+        }
         output->dim_count = 4;
-        output->dim[0] = 1;
-        output->dim[1] = params->pos[0] + params->seqlen;
-        output->dim[2] = 32;
-        output->dim[3] = 128;
+        output->dim[0] = params->bsz;
+        output->dim[1] = kv_len;
+        output->dim[2] = input->dim[2];
+        output->dim[3] = input->dim[3];
     } else if (params->mode == CSINN_LLM_POS_MASK) {
         output->dim_count = input->dim_count;
         for (int i = 0; i < input->dim_count; i++) {
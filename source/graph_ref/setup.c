@@ -795,6 +795,7 @@ void shl_gref_session_setup(struct csinn_session *sess)
     }
 
     td->graph = ggraph;
+    shl_gref_stripe_plan(sess);
 
     if (save_binary_model) {
         /* dump top(global) graph */
@@ -1302,6 +1303,107 @@ static int op_run(struct shl_node *node)
     return ret;
 }
 
+enum {
+    LAYER_PENDING = 0,
+    LAYER_INFLIGHT,
+    LAYER_DONE,
+};
+
+/* all producers of the layer's inputs have finished */
+static bool layer_ready(struct shl_node *n, uint8_t *state)
+{
+    for (int j = 0; j < n->in_num; j++) {
+        struct shl_node *in = n->in[j];
+        if (in == NULL || in->in == NULL || in->in[0] == NULL) {
+            continue;
+        }
+        if (state[in->in[0]->subgraph_idx] != LAYER_DONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Dataflow execution of a hybrid graph: ready subgraphs are queued to the device
+ * worker as soon as their inputs exist, and cpu ops whose inputs are ready run on
+ * this thread meanwhile instead of waiting for the subgraphs in front of them.
+ */
+static int session_run_async(struct csinn_session *sess)
+{
+    struct shl_gref_target_data *td = sess->td;
+    struct shl_ref_graph *g = td->graph;
+    struct shl_gref_async *async = td->async;
+    int ret = CSINN_TRUE;
+
+    uint8_t *state = shl_mem_alloc(g->layer_index);
+    int remain = g->layer_index;
+    int inflight = 0;
+    int first = 0;
+    shl_gref_async_reset(async);
+
+    while (remain > 0) {
+        int idx;
+        while ((idx = shl_gref_async_finished(async, false)) >= 0) {
+            shl_subgraph_run_deinit(g->layer[idx], g);
+            state[idx] = LAYER_DONE;
+            inflight--;
+            remain--;
+        }
+        while (first < g->layer_index && state[first] == LAYER_DONE) {
+            first++;
+        }
+
+        /* keep the device busy first, then run one cpu op and look again */
+        struct shl_node *cpu_op = NULL;
+        for (int i = first; i < g->layer_index; i++) {
+            struct shl_node *n = g->layer[i];
+            if (state[i] != LAYER_PENDING || !layer_ready(n, state)) {
+                continue;
+            }
+            if (n->type == CSINN_SUBGRAPH) {
+                shl_subgraph_run_init(n);
+                shl_gref_async_submit(async, n);
+                state[i] = LAYER_INFLIGHT;
+                inflight++;
+            } else if (cpu_op == NULL) {
+                cpu_op = n;
+            }
+        }
+
+        if (cpu_op != NULL) {
+            if (cpu_op->type < 0 || cpu_op->type >= CSINN_OP_SIZE) {
+                shl_debug_error("%s: unknown layer %s\n", __func__, cpu_op->name);
+                ret = CSINN_FALSE;
+                break;
+            }
+            op_run_init(cpu_op);
+            op_run(cpu_op);
+            op_run_deinit(cpu_op, g);
+            state[cpu_op->subgraph_idx] = LAYER_DONE;
+            remain--;
+        } else if (inflight > 0) {
+            idx = shl_gref_async_finished(async, true);
+            shl_subgraph_run_deinit(g->layer[idx], g);
+            state[idx] = LAYER_DONE;
+            inflight--;
+            remain--;
+        } else if (remain > 0) {
+            shl_debug_error("%s: no layer is ready to run\n", __func__);
+            ret = CSINN_FALSE;
+            break;
+        }
+    }
+
+    /* never leave the worker behind with subgraphs of this run */
+    while (inflight > 0) {
+        shl_gref_async_finished(async, true);
+        inflight--;
+    }
+    shl_mem_free(state);
+    return ret;
+}
+
 int shl_gref_session_run(struct csinn_session *sess)
 {
     SHL_TRACE_CALL(shl_trace_duration_begin(sess->trace, __func__, SHL_TRACE_EVENT_RUNTIME, NULL));
@@ -1315,9 +1417,47 @@ int shl_gref_session_run(struct csinn_session *sess)
         session_dynamic_infer_shape(sess);
     }
 
+    struct shl_gref_target_data *td = sess->td;
+    if (sess->base_run_mode == CSINN_RM_CPU_BASE_HYBRID && td->async_subgraph &&
+        sess->profiler_level == CSINN_PROFILER_LEVEL_UNSET) {
+        if (td->async == NULL) {
+            td->async = shl_gref_async_create(g->layer_index);
+        }
+        if (td->async != NULL) {
+            ret = session_run_async(sess);
+            SHL_TRACE_CALL(
+                shl_trace_duration_end(sess->trace, __func__, SHL_TRACE_EVENT_RUNTIME, NULL));
+            return ret;
+        }
+    }
+
+    struct shl_gref_stripe *stripe = NULL;
+    if (sess->profiler_level == CSINN_PROFILER_LEVEL_UNSET) {
+        stripe = td->stripe;
+    }
+
     for (int i = 0; i < g->layer_index; i++) {
         struct shl_node *n = g->layer[i];
 
+        if (stripe != NULL && stripe[i].layer_num > 0) {
+            /* fused chain, only its last output is materialized */
+            int num = stripe[i].layer_num;
+            op_run_init(g->layer[i + num - 1]);
+            if (shl_gref_stripe_run(g, i, &stripe[i]) != CSINN_TRUE) {
+                ret = CSINN_FALSE;
+            }
+            /* the intermediates never got a buffer, only their ref counts are released */
+            for (int j = i; j < i + num - 1; j++) {
+                struct csinn_tensor *t = g->layer[j]->out[0]->data;
+                t->data = NULL;
+            }
+            for (int j = i; j < i + num; j++) {
+                op_run_deinit(g->layer[j], g);
+            }
+            i += num - 1;
+            continue;
+        }
+
         char **output_filenames = NULL;
         char **output_names = NULL;
         int output_num = 0;
@@ -1473,8 +1613,44 @@ void shl_gref_set_output(int index, struct csinn_tensor *output, struct csinn_se
     }
 }
 
+/* buffers the op inits hang off the params, the params themselves belong to the caller */
+void shl_gref_free_layer_buffers(struct shl_ref_graph *graph)
+{
+    for (int i = 0; i < graph->layer_index; i++) {
+        struct shl_node *n = graph->layer[i];
+        if (n->type == CSINN_OP_DECONV2D || n->type == CSINN_OP_GROUP_DECONV2D) {
+            struct csinn_conv2d_params *params = n->data;
+            if (params->conv_extra.kernel_tm != NULL) {
+                shl_mem_free(params->conv_extra.kernel_tm->data);
+                csinn_free_tensor(params->conv_extra.kernel_tm);
+                params->conv_extra.kernel_tm = NULL;
+            }
+        } else if (n->type == CSINN_OP_SIGMOID || n->type == CSINN_OP_SILU) {
+            struct csinn_sigmoid_params *params = n->data;
+            shl_mem_free(params->lut);
+            params->lut = NULL;
+        } else if (n->type == CSINN_OP_ERF || n->type == CSINN_OP_TANH) {
+            struct csinn_siso_params *params = n->data;
+            shl_mem_free(params->lut);
+            params->lut = NULL;
+        }
+    }
+}
+
 void shl_gref_session_deinit(struct csinn_session *sess)
 {
+    struct shl_gref_target_data *td = sess->td;
+    /* the graph must not release the storage of a state set owned by the caller */
+    if (td->bound_state != NULL) {
+        shl_gref_bind_state(NULL, sess);
+    }
+    if (td->async != NULL) {
+        shl_gref_async_destroy(td->async);
+        td->async = NULL;
+    }
+    shl_mem_free(td->stripe);
+    td->stripe = NULL;
+
     if (sess->base_run_mode == CSINN_RM_CPU_BASE_HYBRID) {
         struct shl_ref_graph *g = shl_gref_get_graph(sess);
 
@@ -1499,6 +1675,7 @@ void shl_gref_session_deinit(struct csinn_session *sess)
     }
 
     struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+    shl_gref_free_layer_buffers(graph);
     shl_mem_free(graph->input);
     shl_mem_free(graph->output);
 }
@@ -2073,6 +2250,33 @@ void *shl_gref_runtime_callback(int api)
         case CSINN_LOAD_BG:
             return shl_gref_load_binary_model;
             break;
+        case CSINN_GET_STATE_NUMBER:
+            return shl_gref_get_state_number;
+            break;
+        case CSINN_GET_STATE:
+            return shl_gref_get_state;
+            break;
+        case CSINN_ALLOC_STATE:
+            return shl_gref_alloc_state;
+            break;
+        case CSINN_SAVE_STATE:
+            return shl_gref_save_state;
+            break;
+        case CSINN_RESTORE_STATE:
+            return shl_gref_restore_state;
+            break;
+        case CSINN_RESET_STATE:
+            return shl_gref_reset_state;
+            break;
+        case CSINN_BIND_STATE:
+            return shl_gref_bind_state;
+            break;
+        case CSINN_SESSION_CLONE:
+            return shl_gref_session_clone;
+            break;
+        case CSINN_FREE_SESSION_CLONE:
+            return shl_gref_free_session_clone;
+            break;
         default:
             shl_debug_info("%s: Cannot find callback\n", __func__);
             break;
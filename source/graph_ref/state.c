@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shl_gref.h"
+
+/*
+ * Streaming state of frame-by-frame models lives inside the graph: the frame_sequence and
+ * frame_counter inputs of fsmn, and the asr ring buffer in the params of cache_matmul and
+ * cache_conv1d. The slots are enumerated in graph order, so the index of a state is stable for
+ * a given session and is shared by every state set allocated from it.
+ */
+struct shl_gref_state_slot {
+    struct csinn_tensor *tensor;
+    struct csinn_asr_buffer_t *asr_buffer;
+    char *name;
+};
+
+static void state_slot_set(struct shl_gref_state_slot *slot, int index, struct csinn_tensor *tensor,
+                           struct csinn_asr_buffer_t *asr_buffer, char *name)
+{
+    if (slot == NULL) {
+        return;
+    }
+    slot[index].tensor = tensor;
+    slot[index].asr_buffer = asr_buffer;
+    slot[index].name = name;
+}
+
+static int collect_graph_state(struct shl_ref_graph *graph, struct shl_gref_state_slot *slot,
+                               int num)
+{
+    for (int i = 0; i < graph->layer_index; i++) {
+        struct shl_node *n = graph->layer[i];
+        if (n->type == CSINN_SUBGRAPH) {
+            num = collect_graph_state(n->data, slot, num);
+        } else if (n->type == CSINN_OP_FSMN) {
+            /* frame_sequence and frame_counter */
+            state_slot_set(slot, num++, n->in[3]->data, NULL, n->name);
+            state_slot_set(slot, num++, n->in[4]->data, NULL, n->name);
+        } else if (n->type == CSINN_OP_CACHE_MATMUL) {
+            struct csinn_cache_matmul_params *params = n->data;
+            /* the ring buffer is allocated by the init of the selected kernel */
+            if (params->asr_buffer.buffer != NULL) {
+                state_slot_set(slot, num++, NULL, &params->asr_buffer, n->name);
+            }
+        } else if (n->type == CSINN_OP_CACHE_CONV1D) {
+            struct csinn_cache_conv1d_params *params = n->data;
+            if (params->asr_buffer.buffer != NULL) {
+                state_slot_set(slot, num++, NULL, &params->asr_buffer, n->name);
+            }
+        }
+    }
+    return num;
+}
+
+static struct shl_gref_state_slot *get_state_slot(struct csinn_session *sess, int *num)
+{
+    struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+    *num = collect_graph_state(graph, NULL, 0);
+    if (*num == 0) {
+        return NULL;
+    }
+    struct shl_gref_state_slot *slot = shl_mem_alloc(*num * sizeof(struct shl_gref_state_slot));
+    collect_graph_state(graph, slot, 0);
+    return slot;
+}
+
+static void *state_slot_data(struct shl_gref_state_slot *slot)
+{
+    return slot->tensor ? slot->tensor->data : slot->asr_buffer->buffer;
+}
+
+static size_t state_slot_size(struct shl_gref_state_slot *slot)
+{
+    return slot->tensor ? csinn_tensor_byte_size(slot->tensor) : slot->asr_buffer->buffer_lenth;
+}
+
+static void state_slot_describe(struct csinn_tensor *dest, struct shl_gref_state_slot *slot)
+{
+    if (slot->tensor) {
+        csinn_tensor_copy(dest, slot->tensor);
+    } else {
+        dest->data = slot->asr_buffer->buffer;
+        dest->dtype = CSINN_DTYPE_UINT8;
+        dest->layout = CSINN_LAYOUT_N;
+        dest->dim_count = 1;
+        dest->dim[0] = slot->asr_buffer->buffer_lenth;
+        dest->name = slot->name;
+        dest->is_const = 0;
+    }
+}
+
+int shl_gref_get_state_number(struct csinn_session *sess)
+{
+    return collect_graph_state(shl_gref_get_graph(sess), NULL, 0);
+}
+
+int shl_gref_get_state(int index, struct csinn_tensor *state, struct csinn_session *sess)
+{
+    int num;
+    struct shl_gref_state_slot *slot = get_state_slot(sess, &num);
+    if (index < 0 || index >= num) {
+        shl_debug_error("%s: state index %d out of range %d\n", __func__, index, num);
+        shl_mem_free(slot);
+        return CSINN_FALSE;
+    }
+    state_slot_describe(state, &slot[index]);
+    shl_mem_free(slot);
+    return CSINN_TRUE;
+}
+
+static struct csinn_session_state *state_alloc(struct shl_gref_state_slot *slot, int num,
+                                               bool own_data)
+{
+    struct csinn_session_state *state = shl_mem_alloc(sizeof(struct csinn_session_state));
+    state->state_num = num;
+    state->state = shl_mem_alloc(num * sizeof(struct csinn_tensor *));
+    state->asr_buffer = shl_mem_alloc(num * sizeof(struct csinn_asr_buffer_t));
+    state->own_data = own_data;
+    for (int i = 0; i < num; i++) {
+        struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+        state_slot_describe(t, &slot[i]);
+        if (own_data) {
+            t->data = shl_mem_alloc(state_slot_size(&slot[i]));
+        }
+        if (slot[i].asr_buffer) {
+            state->asr_buffer[i] = *slot[i].asr_buffer;
+            state->asr_buffer[i].buffer = NULL;
+        }
+        state->state[i] = t;
+    }
+    return state;
+}
+
+static void state_reset_slot(struct csinn_session_state *state, int index,
+                             struct shl_gref_state_slot *slot)
+{
+    memset(state->state[index]->data, 0, state_slot_size(slot));
+    if (slot->asr_buffer) {
+        /* same as asr_buffer_init */
+        state->asr_buffer[index].writer_index = slot->asr_buffer->data_lenth;
+        state->asr_buffer[index].flag = 0;
+    }
+}
+
+struct csinn_session_state *shl_gref_alloc_state(struct csinn_session *sess)
+{
+    int num;
+    struct shl_gref_state_slot *slot = get_state_slot(sess, &num);
+    struct csinn_session_state *state = state_alloc(slot, num, true);
+    for (int i = 0; i < num; i++) {
+        state_reset_slot(state, i, &slot[i]);
+    }
+    shl_mem_free(slot);
+    return state;
+}
+
+static int state_check(struct csinn_session_state *state, struct shl_gref_state_slot *slot,
+                       int num)
+{
+    if (state->state_num != num) {
+        shl_debug_error("state set has %d states, session has %d\n", state->state_num, num);
+        return CSINN_FALSE;
+    }
+    for (int i = 0; i < num; i++) {
+        if (csinn_tensor_byte_size(state->state[i]) != state_slot_size(&slot[i])) {
+            shl_debug_error("state %d of %s mismatch\n", i, slot[i].name);
+            return CSINN_FALSE;
+        }
+    }
+    return CSINN_TRUE;
+}
+
+int shl_gref_save_state(struct csinn_session_state *state, struct csinn_session *sess)
+{
+    int num;
+    struct shl_gref_state_slot *slot = get_state_slot(sess, &num);
+    if (state_check(state, slot, num) != CSINN_TRUE) {
+        shl_mem_free(slot);
+        return CSINN_FALSE;
+    }
+    for (int i = 0; i < num; i++) {
+        memcpy(state->state[i]->data, state_slot_data(&slot[i]), state_slot_size(&slot[i]));
+        if (slot[i].asr_buffer) {
+            state->asr_buffer[i].writer_index = slot[i].asr_buffer->writer_index;
+            state->asr_buffer[i].flag = slot[i].asr_buffer->flag;
+        }
+    }
+    shl_mem_free(slot);
+    return CSINN_TRUE;
+}
+
+int shl_gref_restore_state(struct csinn_session_state *state, struct csinn_session *sess)
+{
+    int num;
+    struct shl_gref_state_slot *slot = get_state_slot(sess, &num);
+    if (state_check(state, slot, num) != CSINN_TRUE) {
+        shl_mem_free(slot);
+        return CSINN_FALSE;
+    }
+    for (int i = 0; i < num; i++) {
+        memcpy(state_slot_data(&slot[i]), state->state[i]->data, state_slot_size(&slot[i]));
+        if (slot[i].asr_buffer) {
+            slot[i].asr_buffer->writer_index = state->asr_buffer[i].writer_index;
+            slot[i].asr_buffer->flag = state->asr_buffer[i].flag;
+        }
+    }
+    shl_mem_free(slot);
+    return CSINN_TRUE;
+}
+
+int shl_gref_reset_state(struct csinn_session *sess)
+{
+    int num;
+    struct shl_gref_state_slot *slot = get_state_slot(sess, &num);
+    for (int i = 0; i < num; i++) {
+        memset(state_slot_data(&slot[i]), 0, state_slot_size(&slot[i]));
+        if (slot[i].asr_buffer) {
+            slot[i].asr_buffer->writer_index = slot[i].asr_buffer->data_lenth;
+            slot[i].asr_buffer->flag = 0;
+        }
+    }
+    shl_mem_free(slot);
+    return CSINN_TRUE;
+}
+
+/*
+ * Binding swaps the storage pointers of every state slot, no data is copied. The ring position
+ * of the cache ops is kept in params, so it is written back to the previously bound set before
+ * the position of the new set is loaded. The session's own storage is parked in own_state until
+ * a NULL set is bound again.
+ */
+int shl_gref_bind_state(struct csinn_session_state *state, struct csinn_session *sess)
+{
+    struct shl_gref_target_data *td = sess->td;
+    if (state == td->bound_state) {
+        return CSINN_TRUE;
+    }
+
+    int num;
+    struct shl_gref_state_slot *slot = get_state_slot(sess, &num);
+    if (state && state_check(state, slot, num) != CSINN_TRUE) {
+        shl_mem_free(slot);
+        return CSINN_FALSE;
+    }
+
+    struct csinn_session_state *prev = td->bound_state;
+    if (prev == NULL) {
+        td->own_state = state_alloc(slot, num, false);
+        prev = td->own_state;
+    }
+    struct csinn_session_state *next = state ? state : td->own_state;
+
+    for (int i = 0; i < num; i++) {
+        if (slot[i].tensor) {
+            slot[i].tensor->data = next->state[i]->data;
+        } else {
+            prev->asr_buffer[i].writer_index = slot[i].asr_buffer->writer_index;
+            prev->asr_buffer[i].flag = slot[i].asr_buffer->flag;
+            slot[i].asr_buffer->buffer = next->state[i]->data;
+            slot[i].asr_buffer->writer_index = next->asr_buffer[i].writer_index;
+            slot[i].asr_buffer->flag = next->asr_buffer[i].flag;
+        }
+    }
+    shl_mem_free(slot);
+
+    td->bound_state = state;
+    if (state == NULL) {
+        csinn_free_session_state(td->own_state);
+        td->own_state = NULL;
+    }
+    return CSINN_TRUE;
+}
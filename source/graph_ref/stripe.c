@@ -0,0 +1,501 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shl_gref.h"
+
+/*
+ * Row-stripe execution of layer chains: the chain output is produced a band of
+ * rows at a time, every layer of the chain runs its own exec on the rows the next
+ * layer needs (halo included), and the intermediate tensors only ever exist as
+ * stripes in a scratch buffer sized to stay in cache, instead of being written to
+ * and read back from memory at full resolution.
+ *
+ * Inverted residual blocks are always fused. With shl_gref_set_stripe_tiling()
+ * every chain of convolution/pooling/activation layers is, which also bounds the
+ * im2col buffers of the convolutions to one stripe for large inputs.
+ */
+
+/* default scratch budget of one chain, sized for the L2 of c906/c908 class cores */
+#define STRIPE_DEFAULT_BUDGET (256 * 1024)
+
+static bool is_conv_layer(struct shl_node *n)
+{
+    switch (n->type) {
+        case CSINN_OP_CONV2D:
+        case CSINN_OP_CONV2D_RELU:
+        case CSINN_OP_CONV2D_RELU6:
+        case CSINN_OP_DEPTHWISE_CONV2D:
+        case CSINN_OP_DEPTHWISE_CONV2D_RELU:
+        case CSINN_OP_DEPTHWISE_CONV2D_RELU6:
+        case CSINN_OP_GROUP_CONV2D:
+        case CSINN_OP_GROUP_CONV2D_RELU:
+        case CSINN_OP_GROUP_CONV2D_RELU6:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* ceil mode windows may run past the bottom pad, and global pooling is not row local */
+static bool is_pool_layer(struct shl_node *n)
+{
+    if (n->type != CSINN_OP_MAXPOOL2D && n->type != CSINN_OP_AVGPOOL2D) {
+        return false;
+    }
+    struct csinn_pool_params *params = n->data;
+    struct csinn_tensor *input = n->in[0]->data;
+    return params->ceil_mode == 0 && params->filter_height < input->dim[2];
+}
+
+struct csinn_callback *shl_cb_map_ref(int op, int dtype);
+
+/* optimized pooling kernels are selected for the pads of the whole tensor, stripes
+ * with other pads run the reference kernel */
+static void *pool_ref_exec(struct shl_node *n, int dtype)
+{
+    struct csinn_callback *cb = shl_cb_map_ref(n->type, dtype);
+    return cb != NULL ? cb->exec : NULL;
+}
+
+/* layers computing each output element from the same input element */
+static bool is_elementwise_layer(struct shl_node *n)
+{
+    switch (n->type) {
+        case CSINN_OP_RELU:
+        case CSINN_OP_RELU1:
+        case CSINN_OP_RELU6:
+        case CSINN_OP_RELUN:
+        case CSINN_OP_CLIP:
+        case CSINN_OP_LEAKY_RELU:
+        case CSINN_OP_SIGMOID:
+        case CSINN_OP_HARD_SIGMOID:
+        case CSINN_OP_TANH:
+        case CSINN_OP_SILU:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_activation_layer(struct shl_node *n)
+{
+    return n->type == CSINN_OP_RELU || n->type == CSINN_OP_RELU6 || n->type == CSINN_OP_CLIP;
+}
+
+static bool is_pointwise_conv(struct shl_node *n)
+{
+    if (n->type != CSINN_OP_CONV2D && n->type != CSINN_OP_CONV2D_RELU &&
+        n->type != CSINN_OP_CONV2D_RELU6) {
+        return false;
+    }
+    struct csinn_conv2d_params *params = n->data;
+    struct csinn_tensor *kernel = n->in[1]->data;
+    return params->group == 1 && kernel->dim[2] == 1 && kernel->dim[3] == 1 &&
+           params->stride_height == 1 && params->stride_width == 1 && params->pad_top == 0 &&
+           params->pad_down == 0 && params->pad_left == 0 && params->pad_right == 0;
+}
+
+static bool is_depthwise_conv(struct shl_node *n)
+{
+    return n->type == CSINN_OP_DEPTHWISE_CONV2D || n->type == CSINN_OP_DEPTHWISE_CONV2D_RELU ||
+           n->type == CSINN_OP_DEPTHWISE_CONV2D_RELU6;
+}
+
+/* vertical window of a layer: output row r reads input rows [r * stride - pad, + extent) */
+static void layer_window(struct shl_node *n, int *extent, int *stride, int *pad)
+{
+    if (is_conv_layer(n)) {
+        struct csinn_conv2d_params *params = n->data;
+        struct csinn_tensor *kernel = n->in[1]->data;
+        *extent = (kernel->dim[2] - 1) * params->dilation_height + 1;
+        *stride = params->stride_height;
+        *pad = params->pad_top;
+    } else if (is_pool_layer(n)) {
+        struct csinn_pool_params *params = n->data;
+        *extent = params->filter_height;
+        *stride = params->stride_height;
+        *pad = params->pad_top;
+    } else {
+        *extent = 1;
+        *stride = 1;
+        *pad = 0;
+    }
+}
+
+/* the layer output feeds exactly the next layer and nothing else sees it */
+static bool is_private_link(struct shl_node *prod, struct shl_node *cons)
+{
+    if (prod->out_num != 1 || cons->in[0] != prod->out[0]) {
+        return false;
+    }
+    struct csinn_tensor *t = prod->out[0]->data;
+    /* one reference from the producer, one from the consumer */
+    return prod->out[0]->ref_count_init == 2 && t->mtype != CSINN_MEM_TYPE_CPU_ACC;
+}
+
+static int elem_size(struct csinn_tensor *t)
+{
+    switch (t->dtype) {
+        case CSINN_DTYPE_INT8:
+            return 1;
+        case CSINN_DTYPE_FLOAT16:
+            return 2;
+        case CSINN_DTYPE_FLOAT32:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+/* all the layers run their own exec on NCHW tensors of one supported dtype */
+static bool is_stripe_compatible(struct shl_node **layer, int num)
+{
+    struct csinn_tensor *input = layer[0]->in[0]->data;
+    if (elem_size(input) == 0) {
+        return false;
+    }
+    for (int i = 0; i < num; i++) {
+        struct csinn_params_base *params = layer[i]->data;
+        struct csinn_tensor *in = layer[i]->in[0]->data;
+        struct csinn_tensor *out = layer[i]->out[0]->data;
+        if (params->api == CSINN_TVMGEN || params->cb == NULL || params->cb->exec == NULL) {
+            return false;
+        }
+        if (in->dtype != input->dtype || out->dtype != input->dtype || in->dim_count != 4 ||
+            out->dim_count != 4 || in->layout != CSINN_LAYOUT_NCHW ||
+            out->layout != CSINN_LAYOUT_NCHW || in->dim[0] != out->dim[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Inverted residual block: pointwise expand, depthwise, pointwise project, each
+ * optionally followed by a standalone activation. Returns the number of layers.
+ */
+static int match_inverted_residual(struct shl_ref_graph *graph, int head)
+{
+    struct shl_node **layer = graph->layer + head;
+    int remain = graph->layer_index - head;
+    int num = 0;
+
+    if (!is_pointwise_conv(layer[num++])) {
+        return 0;
+    }
+    if (num < remain && is_activation_layer(layer[num]) &&
+        is_private_link(layer[num - 1], layer[num])) {
+        num++;
+    }
+    if (num >= remain || !is_depthwise_conv(layer[num]) ||
+        !is_private_link(layer[num - 1], layer[num])) {
+        return 0;
+    }
+    num++;
+    if (num < remain && is_activation_layer(layer[num]) &&
+        is_private_link(layer[num - 1], layer[num])) {
+        num++;
+    }
+    if (num >= remain || !is_pointwise_conv(layer[num]) ||
+        !is_private_link(layer[num - 1], layer[num])) {
+        return 0;
+    }
+    num++;
+
+    return is_stripe_compatible(layer, num) ? num : 0;
+}
+
+/* longest chain of row local layers from head, only fused when it has a spatial layer */
+static int match_tiled_chain(struct shl_ref_graph *graph, int head)
+{
+    struct shl_node **layer = graph->layer + head;
+    int remain = graph->layer_index - head;
+    int num = 0;
+    bool spatial = false;
+
+    while (num < remain) {
+        struct shl_node *n = layer[num];
+        if (!is_conv_layer(n) && !is_pool_layer(n) && !is_elementwise_layer(n)) {
+            break;
+        }
+        if (num > 0 && !is_private_link(layer[num - 1], n)) {
+            break;
+        }
+        struct csinn_tensor *input = n->in[0]->data;
+        if (is_pool_layer(n) && pool_ref_exec(n, input->dtype) == NULL) {
+            break;
+        }
+        spatial |= !is_elementwise_layer(n);
+        num++;
+    }
+    while (num > 0 && !is_stripe_compatible(layer, num)) {
+        num--;
+    }
+    return spatial && num > 0 ? num : 0;
+}
+
+/* upper bound of the rows each layer reads when the chain produces out_rows rows */
+static void stripe_rows(struct shl_node **layer, int num, int out_rows, int *rows)
+{
+    rows[num] = out_rows;
+    for (int i = num - 1; i >= 0; i--) {
+        int extent, stride, pad;
+        layer_window(layer[i], &extent, &stride, &pad);
+        struct csinn_tensor *in = layer[i]->in[0]->data;
+        rows[i] = (rows[i + 1] - 1) * stride + extent;
+        if (rows[i] > in->dim[2]) {
+            rows[i] = in->dim[2];
+        }
+    }
+}
+
+/* elements of one row across all the channels */
+static int64_t row_size(struct csinn_tensor *t)
+{
+    return (int64_t)t->dim[1] * t->dim[3];
+}
+
+/* scratch of a stripe: the gathered chain input and two ping-pong layer outputs */
+static int64_t stripe_scratch(struct shl_node **layer, int num, int *rows, int64_t *buf_size)
+{
+    struct csinn_tensor *input = layer[0]->in[0]->data;
+    int esize = elem_size(input);
+    int64_t max_out = 0;
+    for (int i = 0; i < num; i++) {
+        int64_t size = row_size(layer[i]->out[0]->data) * rows[i + 1] * esize;
+        max_out = size > max_out ? size : max_out;
+    }
+    buf_size[0] = row_size(input) * rows[0] * esize;
+    buf_size[1] = max_out;
+    return buf_size[0] + 2 * max_out;
+}
+
+/*
+ * Most output rows per stripe whose scratch fits the budget. When stripes that
+ * small would recompute more than half of the chain input again as halo, fused
+ * blocks are left alone (0) while tiled chains grow their stripes until the halo
+ * is back under that bound, since bounding memory is the point of tiling.
+ */
+static int stripe_out_rows(struct shl_node **layer, int num, int64_t budget, bool tiled)
+{
+    struct csinn_tensor *input = layer[0]->in[0]->data;
+    struct csinn_tensor *output = layer[num - 1]->out[0]->data;
+    int *rows = shl_mem_alloc((num + 1) * sizeof(int));
+    int64_t buf_size[2];
+
+    /* the scratch grows with the stripe height */
+    int low = 1;
+    int high = output->dim[2];
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        stripe_rows(layer, num, mid, rows);
+        if (stripe_scratch(layer, num, rows, buf_size) > budget) {
+            high = mid - 1;
+        } else {
+            low = mid;
+        }
+    }
+
+    int out_rows = low;
+    for (; out_rows < output->dim[2]; out_rows++) {
+        stripe_rows(layer, num, out_rows, rows);
+        int64_t useful = (int64_t)out_rows * input->dim[2] / output->dim[2];
+        if (rows[0] * 2 <= useful * 3) {
+            break;
+        }
+        if (!tiled) {
+            out_rows = 0;
+            break;
+        }
+    }
+    shl_mem_free(rows);
+    return out_rows;
+}
+
+void shl_gref_stripe_plan(struct csinn_session *sess)
+{
+    struct shl_gref_target_data *td = sess->td;
+    struct shl_ref_graph *graph = td->graph;
+
+    shl_mem_free(td->stripe);
+    td->stripe = NULL;
+    if (sess->base_run_mode == CSINN_RM_CPU_BASE_HYBRID || sess->dynamic_shape ||
+        sess->profiler_level != CSINN_PROFILER_LEVEL_UNSET || td->stripe_budget < 0) {
+        return;
+    }
+    /*
+     * backends with their own graph options (c906/c908/c920, rvm) may run packn or nhwc
+     * kernels, which re-layout their tensors in exec: the stripe views would drop that
+     */
+    if (td->cpu_option != NULL) {
+        return;
+    }
+    int64_t budget = td->stripe_budget > 0 ? td->stripe_budget : STRIPE_DEFAULT_BUDGET;
+
+    struct shl_gref_stripe *plan = NULL;
+    for (int i = 0; i < graph->layer_index; i++) {
+        bool tiled = false;
+        int num = match_inverted_residual(graph, i);
+        if (num == 0 && td->stripe_tiling) {
+            num = match_tiled_chain(graph, i);
+            tiled = true;
+        }
+        if (num == 0) {
+            continue;
+        }
+        int out_rows = stripe_out_rows(graph->layer + i, num, budget, tiled);
+        if (out_rows == 0) {
+            continue;
+        }
+        if (plan == NULL) {
+            plan = shl_mem_alloc(graph->layer_index * sizeof(struct shl_gref_stripe));
+        }
+        plan[i].layer_num = num;
+        plan[i].out_rows = out_rows;
+        shl_debug_info("%s: %s..%s in stripes of %d rows\n", __func__, graph->layer[i]->name,
+                       graph->layer[i + num - 1]->name, out_rows);
+        i += num - 1;
+    }
+    td->stripe = plan;
+}
+
+void shl_gref_set_stripe_budget(struct csinn_session *sess, int32_t bytes)
+{
+    struct shl_gref_target_data *td = sess->td;
+    td->stripe_budget = bytes;
+}
+
+void shl_gref_set_stripe_tiling(struct csinn_session *sess, bool enable)
+{
+    struct shl_gref_target_data *td = sess->td;
+    td->stripe_tiling = enable;
+}
+
+/* run one layer on a stripe, the pads are those of the rows at the stripe edges */
+static int stripe_layer_exec(struct shl_node *n, struct csinn_tensor *input,
+                             struct csinn_tensor *output, int pad_top, int pad_down)
+{
+    struct csinn_params_base *base = n->data;
+    int (*func)() = base->cb->exec;
+
+    if (is_conv_layer(n)) {
+        struct csinn_conv2d_params params = *(struct csinn_conv2d_params *)n->data;
+        params.pad_top = pad_top;
+        params.pad_down = pad_down;
+        return func(input, output, n->in[1]->data, n->in[2]->data, &params);
+    } else if (is_pool_layer(n)) {
+        struct csinn_pool_params params = *(struct csinn_pool_params *)n->data;
+        if (pad_top != params.pad_top || pad_down != params.pad_down) {
+            func = pool_ref_exec(n, input->dtype);
+        }
+        params.pad_top = pad_top;
+        params.pad_down = pad_down;
+        return func(input, output, &params);
+    }
+    return func(input, output, n->data);
+}
+
+int shl_gref_stripe_run(struct shl_ref_graph *graph, int head, struct shl_gref_stripe *stripe)
+{
+    struct shl_node **layer = graph->layer + head;
+    int num = stripe->layer_num;
+    struct csinn_tensor *input = layer[0]->in[0]->data;
+    struct csinn_tensor *output = layer[num - 1]->out[0]->data;
+    int esize = elem_size(input);
+    int ret = CSINN_TRUE;
+
+    int *rows = shl_mem_alloc((num + 1) * 5 * sizeof(int));
+    int *lo = rows + num + 1;
+    int *hi = lo + num + 1;
+    int *pad_top = hi + num + 1;
+    int *pad_down = pad_top + num + 1;
+    int64_t buf_size[2];
+    stripe_rows(layer, num, stripe->out_rows, rows);
+    stripe_scratch(layer, num, rows, buf_size);
+    char *in_buf = shl_mem_alloc(buf_size[0]);
+    char *buf[2] = {shl_mem_alloc(buf_size[1]), shl_mem_alloc(buf_size[1])};
+
+    for (int b = 0; b < input->dim[0] && ret == CSINN_TRUE; b++) {
+        for (int o0 = 0; o0 < output->dim[2] && ret == CSINN_TRUE; o0 += stripe->out_rows) {
+            /* walk back from the output stripe to the rows every layer reads */
+            lo[num] = o0;
+            hi[num] = o0 + stripe->out_rows < output->dim[2] ? o0 + stripe->out_rows
+                                                              : output->dim[2];
+            for (int i = num - 1; i >= 0; i--) {
+                int extent, stride, pad;
+                layer_window(layer[i], &extent, &stride, &pad);
+                struct csinn_tensor *in = layer[i]->in[0]->data;
+                int first = lo[i + 1] * stride - pad;
+                int last = (hi[i + 1] - 1) * stride - pad + extent;
+                lo[i] = first > 0 ? first : 0;
+                hi[i] = last < in->dim[2] ? last : in->dim[2];
+                pad_top[i] = lo[i] - first;
+                pad_down[i] = last - hi[i];
+            }
+
+            int64_t in_row = (int64_t)input->dim[3] * esize;
+            int in_rows = hi[0] - lo[0];
+            char *src = (char *)input->data + b * row_size(input) * input->dim[2] * esize;
+            for (int c = 0; c < input->dim[1]; c++) {
+                memcpy(in_buf + c * in_rows * in_row,
+                       src + ((int64_t)c * input->dim[2] + lo[0]) * in_row, in_rows * in_row);
+            }
+
+            char *cur = in_buf;
+            for (int i = 0; i < num; i++) {
+                struct csinn_tensor vin = *(struct csinn_tensor *)layer[i]->in[0]->data;
+                struct csinn_tensor vout = *(struct csinn_tensor *)layer[i]->out[0]->data;
+                vin.dim[0] = 1;
+                vin.dim[2] = hi[i] - lo[i];
+                vin.data = cur;
+                vout.dim[0] = 1;
+                vout.dim[2] = hi[i + 1] - lo[i + 1];
+                vout.data = buf[i % 2];
+                if (stripe_layer_exec(layer[i], &vin, &vout, pad_top[i], pad_down[i]) !=
+                    CSINN_TRUE) {
+                    shl_debug_error("%s: %s failed\n", __func__, layer[i]->name);
+                    ret = CSINN_FALSE;
+                    break;
+                }
+                /* a packed layout would be lost with the views, see shl_gref_stripe_plan */
+                if (vin.data != cur || vout.data != buf[i % 2] ||
+                    vout.layout != CSINN_LAYOUT_NCHW || vout.dim_count != 4) {
+                    shl_debug_error("%s: %s changed the layout of its stripe\n", __func__,
+                                    layer[i]->name);
+                    ret = CSINN_FALSE;
+                    break;
+                }
+                cur = vout.data;
+            }
+
+            int64_t out_row = (int64_t)output->dim[3] * esize;
+            int out_rows = hi[num] - lo[num];
+            char *dst = (char *)output->data + b * row_size(output) * output->dim[2] * esize;
+            for (int c = 0; c < output->dim[1] && ret == CSINN_TRUE; c++) {
+                memcpy(dst + ((int64_t)c * output->dim[2] + lo[num]) * out_row,
+                       cur + c * out_rows * out_row, out_rows * out_row);
+            }
+        }
+    }
+
+    shl_mem_free(in_buf);
+    shl_mem_free(buf[0]);
+    shl_mem_free(buf[1]);
+    shl_mem_free(rows);
+    return ret;
+}
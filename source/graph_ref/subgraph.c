@@ -17,6 +17,9 @@
  */
 
 #include "shl_gref.h"
+#ifndef SHL_BUILD_RTOS
+#include <unistd.h>
+#endif
 
 void shl_gref_reset_graph_visit(struct shl_ref_graph *graph)
 {
@@ -375,11 +378,32 @@ static void set_sub_session(struct csinn_session *sub_sess, struct csinn_params_
         } else if (params->quant_type == CSINN_QUANT_INT4_SYM) {
             sub_sess->base_dtype = CSINN_DTYPE_INT4;
         }
+    } else if (params->api == CSINN_NPU_SIM) {
+        /* stand-in device: run the subgraph as a reference graph session on the host */
+        sub_sess->base_api = CSINN_REF;
+        sub_sess->base_dtype = base_sess->base_dtype;
+        sub_sess->debug_level = base_sess->debug_level;
+        sub_sess->base_run_mode = CSINN_RM_CPU_GRAPH;
+        sub_sess->base_quant_type = base_sess->base_quant_type;
+        sub_sess->model.save_mode = CSINN_RUN_ONLY;
+        for (int i = 0; i < graph->layer_index; i++) {
+            struct shl_node *node = graph->layer[i];
+            if (node->type != CSINN_SUBGRAPH_RETURN) {
+                struct csinn_params_base *node_params = node->data;
+                node_params->api = CSINN_REF;
+            }
+        }
     } else {
         shl_debug_error("sub session api unsupport\n");
     }
 }
 
+/* subgraph session of the CPU-hosted stand-in device */
+static bool is_sim_session(struct csinn_session *sess)
+{
+    return sess->base_api == CSINN_REF && sess->base_run_mode == CSINN_RM_CPU_GRAPH;
+}
+
 int shl_subgraph_setup(struct shl_node *n)
 {
     struct shl_ref_graph *sgraph = n->data;
@@ -393,6 +417,11 @@ int shl_subgraph_setup(struct shl_node *n)
     struct csinn_session *sub_sess = csinn_alloc_session();
     set_sub_session(sub_sess, init_params, sgraph);
     csinn_session_init(sub_sess);
+    if (is_sim_session(sub_sess)) {
+        struct shl_gref_target_data *ori_td = ori_sess->td;
+        struct shl_gref_target_data *sub_td = sub_sess->td;
+        sub_td->sim_latency_us = ori_td->sim_latency_us;
+    }
 
     csinn_set_input_number(sgraph->input_num, sub_sess);
     csinn_set_output_number(sgraph->output_num, sub_sess);
@@ -717,6 +746,14 @@ int shl_subgraph_run_init(struct shl_node *n)
     return CSINN_TRUE;
 }
 
+static struct csinn_session *producer_session(struct shl_ref_graph *graph,
+                                              struct shl_node *producer)
+{
+    struct shl_ref_graph *sgraph = graph->layer[producer->subgraph_idx]->data;
+    struct csinn_params_base *params = sgraph->layer[0]->data;
+    return params->sess;
+}
+
 int shl_subgraph_run_deinit(struct shl_node *node, struct shl_ref_graph *graph)
 {
     struct shl_ref_graph *sgraph = node->data;
@@ -750,8 +787,9 @@ int shl_subgraph_run_deinit(struct shl_node *node, struct shl_ref_graph *graph)
         if (node->in[i]->ref_count > 0) {
             node->in[i]->ref_count--;
             if (node->in[i]->ref_count == 0) {
-                if (node->in[i]->in &&
-                    graph->layer[node->in[i]->in[0]->subgraph_idx]->type == CSINN_SUBGRAPH) {
+                struct shl_node *producer = node->in[i]->in ? node->in[i]->in[0] : NULL;
+                if (producer && graph->layer[producer->subgraph_idx]->type == CSINN_SUBGRAPH &&
+                    !is_sim_session(producer_session(graph, producer))) {
                     /* nothing */
                 } else {
                     struct csinn_tensor *t = node->in[i]->data;
@@ -774,6 +812,14 @@ int shl_subgraph_run(struct shl_node *n)
     int ret = CSINN_TRUE;
 
     csinn_session_run(params->sess);
+#ifndef SHL_BUILD_RTOS
+    if (is_sim_session(params->sess)) {
+        struct shl_gref_target_data *td = params->sess->td;
+        if (td->sim_latency_us > 0) {
+            usleep(td->sim_latency_us);
+        }
+    }
+#endif
 
     return ret;
 }
@@ -2,7 +2,7 @@
 
 static char *alloc_name(char *name)
 {
-    char *ret = shl_mem_alloc(strlen(name));
+    char *ret = shl_mem_alloc(strlen(name) + 1);
     sprintf(ret, "%s", name);
     return ret;
 }
@@ -38,8 +38,8 @@ static struct csinn_tensor *alloc_weight_tensor(struct csinn_tensor *tensor,
     return ret;
 }
 
-static struct csinn_tensor *linear(struct csinn_session *sess, struct csinn_tensor *x,
-                                   struct csinn_tensor *y, char *name)
+static struct csinn_tensor *linear(struct shl_llm_ctx *ctx, struct csinn_session *sess,
+                                   struct csinn_tensor *x, struct csinn_tensor *y, char *name)
 {
     struct csinn_tensor *linear_output = csinn_alloc_tensor(sess);
     linear_output->name = concat_name(name, "output");
@@ -50,6 +50,7 @@ static struct csinn_tensor *linear(struct csinn_session *sess, struct csinn_tens
         csinn_alloc_params(sizeof(struct csinn_matmul_params), sess);
     linear_params->base.name = concat_name(name, "params");
     linear_params->trans_b = true;
+    linear_params->act_quant = ctx->act_quant;
     csinn_matmul_init(x, y, linear_output, linear_params);
     csinn_matmul(x, y, linear_output, linear_params);
     return linear_output;
@@ -106,23 +107,24 @@ static struct csinn_tensor *norm(struct csinn_session *sess, struct csinn_tensor
     return output;
 }
 
-static struct csinn_tensor *attention(struct shl_transformer_block *block, struct csinn_tensor *x,
-                                      struct shl_llm_layer *llayer, char *name)
+static struct csinn_tensor *attention(struct shl_llm_ctx *ctx, struct shl_transformer_block *block,
+                                      struct csinn_tensor *x, struct shl_llm_layer *llayer,
+                                      char *name)
 {
     struct csinn_session *sess = block->session;
 
     int bsz = x->dim[0];
     int seqlen = x->dim[1];
-    int n_heads = 32;
-    int head_dim = 128;
+    int n_heads = ctx->n_heads;
+    int head_dim = ctx->head_dim;
 
     // xk = linear(x)
     struct csinn_tensor *xk_weight = alloc_weight_tensor(llayer->wk, sess, concat_name(name, "wk"));
-    struct csinn_tensor *xk = linear(sess, x, xk_weight, concat_name(name, "xk_linear"));
+    struct csinn_tensor *xk = linear(ctx, sess, x, xk_weight, concat_name(name, "xk_linear"));
 
     // xq = linear(x)
     struct csinn_tensor *xq_weight = alloc_weight_tensor(llayer->wq, sess, concat_name(name, "wq"));
-    struct csinn_tensor *xq = linear(sess, x, xq_weight, concat_name(name, "xq_linear"));
+    struct csinn_tensor *xq = linear(ctx, sess, x, xq_weight, concat_name(name, "xq_linear"));
 
     // xk = xk.view(bsz, seqlen, self.n_local_kv_heads, self.head_dim)
     struct csinn_reshape_params *xk_reshape_params =
@@ -165,7 +167,10 @@ static struct csinn_tensor *attention(struct shl_transformer_block *block, struc
     rope_params->freq_scale = 1;
     rope_params->xpos_base = 0;
     rope_params->xpos_down = 0;
-    rope_params->n_dims = 128;
+    rope_params->n_dims = head_dim;
+    rope_params->use_rope_cache = true;
+    rope_params->rope_cache = ctx->rope_table;
+    rope_params->rope_cache_shared = true;
 
     csinn_rope_init(xq_reshape_output, xq_rope, rope_params);
     csinn_rope(xq_reshape_output, xq_rope, rope_params);
@@ -177,7 +182,7 @@ static struct csinn_tensor *attention(struct shl_transformer_block *block, struc
 
     // xv = linear(x)
     struct csinn_tensor *xv_weight = alloc_weight_tensor(llayer->wv, sess, concat_name(name, "wv"));
-    struct csinn_tensor *xv = linear(sess, x, xv_weight, concat_name(name, "xv_linear"));
+    struct csinn_tensor *xv = linear(ctx, sess, x, xv_weight, concat_name(name, "xv_linear"));
 
     // xv = xv.view(bsz, seqlen, self.n_local_kv_heads, self.head_dim)
     struct csinn_reshape_params *xv_reshape_params =
@@ -200,8 +205,8 @@ static struct csinn_tensor *attention(struct shl_transformer_block *block, struc
     cache_k->name = concat_name(name, "cache_k");
     cache_k->dtype = sess->base_dtype;
     cache_k->dim_count = 4;
-    cache_k->dim[0] = 1;
-    cache_k->dim[1] = 2048;  // max_seq_len
+    cache_k->dim[0] = ctx->max_batch;
+    cache_k->dim[1] = ctx->max_seq_len;
     cache_k->dim[2] = n_heads;
     cache_k->dim[3] = head_dim;
 
@@ -223,8 +228,8 @@ static struct csinn_tensor *attention(struct shl_transformer_block *block, struc
     cache_v->name = concat_name(name, "cache_v");
     cache_v->dtype = sess->base_dtype;
     cache_v->dim_count = 4;
-    cache_v->dim[0] = 1;
-    cache_v->dim[1] = 2048;  // max_seq_len
+    cache_v->dim[0] = ctx->max_batch;
+    cache_v->dim[1] = ctx->max_seq_len;
     cache_v->dim[2] = n_heads;
     cache_v->dim[3] = head_dim;
 
@@ -309,7 +314,7 @@ static struct csinn_tensor *attention(struct shl_transformer_block *block, struc
     scale->dim_count = 1;
     scale->dim[0] = 1;
     scale->data = shl_mem_alloc(csinn_tensor_byte_size(scale));
-    float scale_value = 0.088388347648318;
+    float scale_value = 1.0f / sqrtf(head_dim);
     if (sess->base_dtype == CSINN_DTYPE_FLOAT32) {
         float *scale_data = scale->data;
         scale_data[0] = scale_value;
@@ -423,20 +428,21 @@ static struct csinn_tensor *attention(struct shl_transformer_block *block, struc
 
     // return self.wo(output)
     struct csinn_tensor *xo_weight = alloc_weight_tensor(llayer->wo, sess, concat_name(name, "wo"));
-    struct csinn_tensor *output =
-        linear(sess, output_transpose_reshape_output, xo_weight, concat_name(name, "wo_linear"));
+    struct csinn_tensor *output = linear(ctx, sess, output_transpose_reshape_output, xo_weight,
+                                         concat_name(name, "wo_linear"));
     return output;
 }
 
-static struct csinn_tensor *feed_forward(struct csinn_session *sess, struct csinn_tensor *x,
-                                         struct csinn_tensor *w1, struct csinn_tensor *w2,
-                                         struct csinn_tensor *w3, char *name)
+static struct csinn_tensor *feed_forward(struct shl_llm_ctx *ctx, struct csinn_session *sess,
+                                         struct csinn_tensor *x, struct csinn_tensor *w1,
+                                         struct csinn_tensor *w2, struct csinn_tensor *w3,
+                                         char *name)
 {
     // x3 = linear(x, w3)
-    struct csinn_tensor *x3 = linear(sess, x, w3, concat_name(name, "x3_linear"));
+    struct csinn_tensor *x3 = linear(ctx, sess, x, w3, concat_name(name, "x3_linear"));
 
     // x1 = linear(x, w1)
-    struct csinn_tensor *x1 = linear(sess, x, w1, concat_name(name, "x1_linear"));
+    struct csinn_tensor *x1 = linear(ctx, sess, x, w1, concat_name(name, "x1_linear"));
     // x1 = silu(x1)
     struct csinn_tensor *silu_output = silu(sess, x1, concat_name(name, "x1_silu"));
 
@@ -450,7 +456,8 @@ static struct csinn_tensor *feed_forward(struct csinn_session *sess, struct csin
     csinn_mul(silu_output, x3, x2, x2_mul_params);
 
     // x2 = linear(x2, w2)
-    struct csinn_tensor *x2_linear_output = linear(sess, x2, w2, concat_name(name, "x2_linear"));
+    struct csinn_tensor *x2_linear_output =
+        linear(ctx, sess, x2, w2, concat_name(name, "x2_linear"));
     return x2_linear_output;
 }
 
@@ -489,7 +496,8 @@ static struct shl_transformer_block *layer(struct shl_llm_ctx *ctx, struct csinn
     char *norm_name = alloc_index_name(layer_id, "attention_norm");
     struct csinn_tensor *norm_output = norm(sess, x, attention_norm_weight, norm_name);
     char *attention_name = alloc_index_name(layer_id, "attention");
-    struct csinn_tensor *attention_output = attention(ret, norm_output, llayer, attention_name);
+    struct csinn_tensor *attention_output =
+        attention(ctx, ret, norm_output, llayer, attention_name);
 
     struct csinn_tensor *h_attention = csinn_alloc_tensor(sess);
     h_attention->name = alloc_index_name(layer_id, "h_attention");
@@ -511,7 +519,8 @@ static struct shl_transformer_block *layer(struct shl_llm_ctx *ctx, struct csinn
     struct csinn_tensor *ff_w3 =
         alloc_weight_tensor(llayer->w3, sess, alloc_index_name(layer_id, "ffn_w3"));
     char *ffn_name = alloc_index_name(layer_id, "ff");
-    struct csinn_tensor *ff_output = feed_forward(sess, ff_norm, ff_w1, ff_w2, ff_w3, ffn_name);
+    struct csinn_tensor *ff_output =
+        feed_forward(ctx, sess, ff_norm, ff_w1, ff_w2, ff_w3, ffn_name);
 
     struct csinn_tensor *h_ff = csinn_alloc_tensor(sess);
     h_ff->name = alloc_index_name(layer_id, "h_ff");
@@ -593,7 +602,7 @@ static struct csinn_session *llama2_output(struct shl_llm_ctx *ctx)
     sess->dynamic_shape = CSINN_FALSE;
     // sess->debug_level = CSINN_DEBUG_LEVEL_INFO;
     csinn_session_init(sess);
-    csinn_set_input_number(1, sess);
+    csinn_set_input_number(2, sess);
     csinn_set_output_number(1, sess);
 
     struct csinn_tensor *input = ctx->transformer_block[ctx->layers_num - 1]->session->output[0];
@@ -604,16 +613,36 @@ static struct csinn_session *llama2_output(struct shl_llm_ctx *ctx)
     csinn_set_tensor_entry(h_in, sess);
     csinn_set_input(0, h_in, sess);
 
+    // token indices of every sequence that need logits, filled by llm_run
+    struct csinn_tensor *logits_idx = csinn_alloc_tensor(sess);
+    logits_idx->name = alloc_name("logits_idx");
+    logits_idx->dtype = CSINN_DTYPE_INT64;
+    logits_idx->dim_count = 1;
+    logits_idx->dim[0] = 1;
+    csinn_set_tensor_entry(logits_idx, sess);
+    csinn_set_input(1, logits_idx, sess);
+
+    // h = h[:, logits_idx], the other positions skip norm and the vocab projection
+    struct csinn_tensor *h_gather = csinn_alloc_tensor(sess);
+    h_gather->name = alloc_name("h_gather");
+    h_gather->dtype = sess->base_dtype;
+    struct csinn_gather_params *gather_params =
+        csinn_alloc_params(sizeof(struct csinn_gather_params), sess);
+    gather_params->base.name = alloc_name("h_gather_params");
+    gather_params->axis = 1;
+    csinn_gather_init(h_in, logits_idx, h_gather, gather_params);
+    csinn_gather(h_in, logits_idx, h_gather, gather_params);
+
     // h = norm(h)
     struct csinn_tensor *h_weight =
         alloc_weight_tensor(ctx->shl_model->output_norm, sess, alloc_name("output_norm_weight"));
-    struct csinn_tensor *h_norm_output = norm(sess, h_in, h_weight, alloc_name("output_norm"));
+    struct csinn_tensor *h_norm_output = norm(sess, h_gather, h_weight, alloc_name("output_norm"));
 
     // output = linear(h)
     struct csinn_tensor *linear_weight =
         alloc_weight_tensor(ctx->shl_model->output, sess, alloc_name("output_weight"));
     struct csinn_tensor *linear_output =
-        linear(sess, h_norm_output, linear_weight, "linear_output");
+        linear(ctx, sess, h_norm_output, linear_weight, "linear_output");
 
     csinn_set_output(0, linear_output, sess);
 
@@ -629,6 +658,13 @@ struct shl_llm_ctx *llama2_build(struct llama_config *config)
     ctx->base_dtype = config->base_dtype;
     ctx->base_quant_type = config->base_quant_type;
     ctx->shl_model = config->shl_model;
+    ctx->max_batch = config->max_batch > 0 ? config->max_batch : 1;
+    ctx->prefill_chunk = config->prefill_chunk;
+    ctx->act_quant = config->act_quant;
+    ctx->max_seq_len = config->max_seq_len > 0 ? config->max_seq_len : 2048;
+    ctx->n_heads = config->n_heads;
+    ctx->head_dim = config->dim / config->n_heads;
+    ctx->rope_table = shl_llm_rope_table(&config->rope, ctx->head_dim, ctx->max_seq_len);
 
     // h = tok_embedding(tokens)
     ctx->embeding_session = tok_embedding(config->shl_model, ctx);
@@ -1,5 +1,10 @@
 #include "llm/shl_llm.h"
 
+static inline int llm_input_seqs(struct shl_llm_input *embd)
+{
+    return embd->n_seqs > 0 ? embd->n_seqs : 1;
+}
+
 static void llm_session_dynamic_infer_shape(struct csinn_session *sess, struct shl_llm_input *embd)
 {
     // shl_debug_set_level(-1);
@@ -74,7 +79,7 @@ static void llm_session_dynamic_infer_shape(struct csinn_session *sess, struct s
                 break;
             case CSINN_OP_RESHAPE:
                 reshape_params = (struct csinn_reshape_params *)params;
-                reshape_params->shape[0] = 1;
+                reshape_params->shape[0] = llm_input_seqs(embd);
                 reshape_params->shape[1] = embd->n_tokens;
                 shl_gref_reshape_infer_shape(n->in[0]->data, n->out[0]->data, reshape_params);
                 break;
@@ -116,7 +121,8 @@ static void llm_session_dynamic_infer_shape(struct csinn_session *sess, struct s
             case CSINN_OP_LLM_POS:
                 pos_params = (struct csinn_llm_pos_params *)params;
                 pos_params->pos = embd->pos;
-                pos_params->bsz = 1;
+                pos_params->bsz = llm_input_seqs(embd);
+                pos_params->slot = embd->slot;
                 pos_params->seqlen = embd->n_tokens;
                 shl_gref_llm_pos_infer_shape(n->in[0]->data, n->out[0]->data, pos_params);
                 break;
@@ -149,34 +155,178 @@ static void update_input(struct csinn_session *curr, struct csinn_session *prev)
     }
 }
 
-int llm_run(struct shl_llm_ctx *ctx, struct shl_llm_input *embd)
+/* embedding and transformer blocks, the hidden state ends in the last block's output */
+static void llm_run_blocks(struct shl_llm_ctx *ctx, struct shl_llm_input *embd)
 {
+    int n_seqs = llm_input_seqs(embd);
     struct csinn_tensor *input = csinn_alloc_tensor(NULL);
     input->dim_count = 1;
-    input->dim[0] = embd->n_tokens;
+    input->dim[0] = n_seqs * embd->n_tokens;
     input->data = embd->token;
     input->dtype = CSINN_DTYPE_INT32;
 
+    /* weights of layer i + 1 are read ahead while layer i runs */
+    struct shl_llm_model *model = ctx->shl_model;
+    bool prefetch = model && model->prefetch;
+    if (prefetch) {
+        shl_llm_model_advise(model, 0);
+    }
+
+    struct shl_llm_stats *stats = ctx->stats;
+    uint64_t start = stats ? shl_get_timespec() : 0;
     csinn_update_input(0, input, ctx->embeding_session);
     csinn_session_run(ctx->embeding_session);
+    csinn_free_tensor(input);
+    if (stats) {
+        uint64_t end = shl_get_timespec();
+        stats->embedding_ns += end - start;
+        start = end;
+    }
 
     struct csinn_session *cur_sess = ctx->transformer_block[0]->session;
     update_input(cur_sess, ctx->embeding_session);
+    /* [n_seqs * n_tokens, dim] -> [n_seqs, n_tokens, dim] */
+    struct csinn_tensor *h = cur_sess->input[0];
+    h->dim_count = 3;
+    h->dim[2] = h->dim[1];
+    h->dim[0] = n_seqs;
+    h->dim[1] = embd->n_tokens;
 
     llm_session_dynamic_infer_shape(cur_sess, embd);
+    if (prefetch) {
+        shl_llm_model_advise(model, 1);
+    }
     csinn_session_run(cur_sess);
+    /* session outputs are not released by the graph, drop each one once consumed */
+    shl_mem_free(ctx->embeding_session->output[0]->data);
+    if (stats) {
+        uint64_t end = shl_get_timespec();
+        stats->layer_ns[0] += end - start;
+        start = end;
+    }
     for (int i = 1; i < ctx->layers_num; i++) {
         cur_sess = ctx->transformer_block[i]->session;
         update_input(cur_sess, ctx->transformer_block[i - 1]->session);
 
         llm_session_dynamic_infer_shape(cur_sess, embd);
+        if (prefetch) {
+            shl_llm_model_advise(model, i + 1);
+        }
         csinn_session_run(cur_sess);
+        shl_mem_free(ctx->transformer_block[i - 1]->session->output[0]->data);
+        if (stats) {
+            uint64_t end = shl_get_timespec();
+            stats->layer_ns[i] += end - start;
+            start = end;
+        }
     }
+}
+
+/*
+ * Run the input chunk by chunk along the token axis, every chunk goes through all
+ * layers and appends to the kv cache before the next one starts, so activations
+ * scale with the chunk instead of the input. The hidden rows of logits_idx are
+ * collected into rows ([n_seqs, n_logits, dim]) for the output session.
+ */
+static void llm_run_chunked(struct shl_llm_ctx *ctx, struct shl_llm_input *embd, int chunk,
+                            int64_t *logits_idx, int n_logits, struct csinn_tensor *rows)
+{
+    int n_seqs = llm_input_seqs(embd);
+    int n_tokens = embd->n_tokens;
+    int32_t *token = shl_mem_alloc(n_seqs * chunk * sizeof(int32_t));
+    int32_t *pos = shl_mem_alloc(n_seqs * chunk * sizeof(int32_t));
+    struct csinn_tensor *last = ctx->transformer_block[ctx->layers_num - 1]->session->output[0];
+
+    for (int start = 0; start < n_tokens; start += chunk) {
+        int n = n_tokens - start < chunk ? n_tokens - start : chunk;
+        for (int s = 0; s < n_seqs; s++) {
+            memcpy(token + s * n, embd->token + s * n_tokens + start, n * sizeof(int32_t));
+            memcpy(pos + s * n, embd->pos + s * n_tokens + start, n * sizeof(int32_t));
+        }
+        struct shl_llm_input sub = *embd;
+        sub.n_tokens = n;
+        sub.token = token;
+        sub.pos = pos;
+        llm_run_blocks(ctx, &sub);
 
-    cur_sess = ctx->output_session;
-    update_input(cur_sess, ctx->transformer_block[ctx->layers_num - 1]->session);
+        /* keep the requested rows of this chunk */
+        int row_size = csinn_tensor_byte_size(last) / (n_seqs * n);
+        for (int j = 0; j < n_logits; j++) {
+            int t = logits_idx[j] - start;
+            if (t < 0 || t >= n) {
+                continue;
+            }
+            for (int s = 0; s < n_seqs; s++) {
+                memcpy((char *)rows->data + (s * n_logits + j) * row_size,
+                       (char *)last->data + (s * n + t) * row_size, row_size);
+            }
+        }
+        shl_mem_free(last->data);
+    }
+    shl_mem_free(token);
+    shl_mem_free(pos);
+}
+
+int llm_run(struct shl_llm_ctx *ctx, struct shl_llm_input *embd)
+{
+    int n_seqs = llm_input_seqs(embd);
+    if (n_seqs > ctx->max_batch) {
+        shl_debug_error("llm_run: %d sequences exceed max_batch %d\n", n_seqs, ctx->max_batch);
+        return CSINN_FALSE;
+    }
+    for (int i = 0; embd->slot && i < n_seqs; i++) {
+        if (embd->slot[i] < 0 || embd->slot[i] >= ctx->max_batch) {
+            shl_debug_error("llm_run: invalid kv slot %d\n", embd->slot[i]);
+            return CSINN_FALSE;
+        }
+    }
+    int n_logits = embd->logits_idx && embd->n_logits > 0 ? embd->n_logits : 1;
+    for (int i = 0; embd->logits_idx && i < n_logits; i++) {
+        if (embd->logits_idx[i] < 0 || embd->logits_idx[i] >= embd->n_tokens) {
+            shl_debug_error("llm_run: invalid logits index %d\n", embd->logits_idx[i]);
+            return CSINN_FALSE;
+        }
+    }
+    int64_t *logits_idx = shl_mem_alloc(n_logits * sizeof(int64_t));
+    for (int i = 0; i < n_logits; i++) {
+        logits_idx[i] = embd->logits_idx ? embd->logits_idx[i] : embd->n_tokens - 1;
+    }
+
+    struct csinn_session *cur_sess = ctx->output_session;
+    struct csinn_tensor *h = cur_sess->input[0];
+    int chunk = ctx->prefill_chunk;
+    if (chunk > 0 && embd->n_tokens > chunk) {
+        /* the output session gathers rows 0..n_logits-1 of the collected rows */
+        h->dim_count = 3;
+        h->dim[0] = n_seqs;
+        h->dim[1] = n_logits;
+        h->dim[2] = ctx->shl_model->output->dim[1];
+        h->data = shl_mem_alloc(csinn_tensor_byte_size(h));
+        llm_run_chunked(ctx, embd, chunk, logits_idx, n_logits, h);
+        for (int i = 0; i < n_logits; i++) {
+            logits_idx[i] = i;
+        }
+    } else {
+        llm_run_blocks(ctx, embd);
+        update_input(cur_sess, ctx->transformer_block[ctx->layers_num - 1]->session);
+    }
+
+    /* gather the requested rows before norm + linear, by default the last token */
+    struct csinn_tensor *idx = cur_sess->input[1];
+    idx->data = logits_idx;
+    idx->dim_count = 1;
+    idx->dim[0] = n_logits;
+    uint64_t start = ctx->stats ? shl_get_timespec() : 0;
     llm_session_dynamic_infer_shape(cur_sess, embd);
     csinn_session_run(ctx->output_session);
+    if (ctx->stats) {
+        ctx->stats->output_ns += shl_get_timespec() - start;
+        ctx->stats->n_runs++;
+    }
+    idx->data = NULL;
+    shl_mem_free(logits_idx);
+    shl_mem_free(h->data);
+    h->data = NULL;
 
     return CSINN_TRUE;
 }
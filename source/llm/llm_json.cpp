@@ -23,19 +23,74 @@ using json = nlohmann::json;
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <fstream>
 #include <iomanip>
-static void *shl_llm_mmap(std::string path)
+/*
+ * Map the weight file. With hugepage the file is copied into MAP_HUGETLB memory,
+ * which needs hugepages reserved in /proc/sys/vm/nr_hugepages; hugetlb does not
+ * back file mappings, so without a reservation the file mapping is kept and
+ * marked for transparent hugepages instead.
+ */
+static void *shl_llm_mmap(std::string path, size_t *size, struct shl_llm_load_options *opt)
 {
-    int fd = open(path.c_str(), O_RDWR);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        shl_debug_error("open %s failed\n", path.c_str());
+        return NULL;
+    }
     struct stat sb;
     fstat(fd, &sb);
-    void *addr = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    *size = sb.st_size;
+
+    void *addr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (opt->hugepage) {
+        addr = mmap(NULL, sb.st_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED) {
+            size_t done = 0;
+            while (done < (size_t)sb.st_size) {
+                ssize_t n = pread(fd, (char *)addr + done, sb.st_size - done, done);
+                if (n <= 0) {
+                    break;
+                }
+                done += n;
+            }
+            if (done < (size_t)sb.st_size) {
+                munmap(addr, sb.st_size);
+                addr = MAP_FAILED;
+            } else {
+                mprotect(addr, sb.st_size, PROT_READ);
+            }
+        }
+    }
+#endif
     if (addr == MAP_FAILED) {
-        printf("mmap error\n");
-        return NULL;
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (opt->populate) {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        addr = mmap(NULL, sb.st_size, PROT_READ, flags, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            shl_debug_error("mmap error\n");
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        if (opt->hugepage) {
+            madvise(addr, sb.st_size, MADV_HUGEPAGE);
+        }
+#endif
+        if (opt->willneed) {
+            madvise(addr, sb.st_size, MADV_WILLNEED);
+        }
     }
+    /* the mapping holds its own reference to the file */
+    close(fd);
     return addr;
 }
 
@@ -86,23 +141,44 @@ static void load_shl_model(struct shl_llm_model *model, char *base, json &jdata)
     }
 }
 
-struct shl_llm_model *shl_llm_load_json(char *dir_path)
+struct shl_llm_model *shl_llm_load_json_opt(char *dir_path, struct shl_llm_load_options *opt)
 {
-    struct shl_llm_model *model =
-        (struct shl_llm_model *)shl_mem_alloc(sizeof(struct shl_llm_model));
+    struct shl_llm_load_options none = {};
+    if (opt == NULL) {
+        opt = &none;
+    }
     std::string model_dir = dir_path;
     std::ifstream json_file(model_dir + "shl.llm.json");
+    if (!json_file.is_open()) {
+        shl_debug_error("open %sshl.llm.json failed\n", dir_path);
+        return NULL;
+    }
     std::string weight_path = model_dir + "shl.llm.weight.bm";
     json data = json::parse(json_file);
-    if (data["config"]["shl_model_type"] == "weight_only") {
-        void *base_addr = shl_llm_mmap(weight_path);
-        load_shl_model(model, (char *)base_addr, data["model"]);
-    } else {
+    if (data["config"]["shl_model_type"] != "weight_only") {
         shl_debug_error("Unsupport json model file\n");
+        return NULL;
     }
+    size_t size;
+    void *base_addr = shl_llm_mmap(weight_path, &size, opt);
+    if (base_addr == NULL) {
+        return NULL;
+    }
+    struct shl_llm_model *model =
+        (struct shl_llm_model *)shl_mem_alloc(sizeof(struct shl_llm_model));
+    load_shl_model(model, (char *)base_addr, data["model"]);
+    model->mmap_addr = base_addr;
+    model->mmap_size = size;
+    model->prefetch = opt->prefetch;
+    shl_llm_model_lock(model, opt->mlock);
     return model;
 }
 
+struct shl_llm_model *shl_llm_load_json(char *dir_path)
+{
+    return shl_llm_load_json_opt(dir_path, NULL);
+}
+
 static int save_csinn_tensor(struct csinn_tensor *tensor, int64_t offset, json &jdata,
                              std::string name)
 {
@@ -121,14 +197,10 @@ static int save_csinn_tensor(struct csinn_tensor *tensor, int64_t offset, json &
 static int64_t dump_data(std::ofstream &file, struct csinn_tensor *tensor)
 {
     int64_t size = 0;
-    if (tensor->dtype == CSINN_DTYPE_FLOAT16) {
-        size = csinn_tensor_byte_size(tensor);
-    } else if (tensor->dtype == CSINN_DTYPE_FLOAT32) {
-        size = csinn_tensor_byte_size(tensor);
-    } else if (tensor->dtype == CSINN_DTYPE_INT8 && tensor->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0) {
-        size = csinn_tensor_size(tensor) + csinn_tensor_size(tensor) / 32 * sizeof(int16_t);
-    } else if (tensor->dtype == CSINN_DTYPE_INT4 && tensor->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0) {
-        size = csinn_tensor_size(tensor) / 2 + csinn_tensor_size(tensor) / 32 * sizeof(int16_t);
+    if (tensor->dtype == CSINN_DTYPE_FLOAT16 || tensor->dtype == CSINN_DTYPE_FLOAT32 ||
+        (tensor->dtype == CSINN_DTYPE_INT8 && tensor->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0) ||
+        (tensor->dtype == CSINN_DTYPE_INT4 && tensor->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0)) {
+        size = shl_llm_weight_size(tensor);
     } else {
         shl_debug_error("unsupport dump data type\n");
     }
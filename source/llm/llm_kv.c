@@ -0,0 +1,198 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "llm/shl_llm.h"
+
+/*
+ * KV cache snapshots: a slot keeps positions contiguously as
+ * [max_seq_len, n_heads, head_dim], so the prefix [0, n) of every layer is one
+ * memcpy in each direction. Restoring a prompt prefix costs a copy of its
+ * keys/values instead of the whole prefill.
+ *
+ * File layout: struct kv_file_header, the tokens, then the data from a page
+ * aligned offset so that a mapped file is used in place.
+ */
+
+#define KV_FILE_MAGIC 0x564b4853  // "SHKV"
+#define KV_FILE_VERSION 1
+#define KV_FILE_ALIGN 4096
+
+struct kv_file_header {
+    int32_t magic;
+    int32_t version;
+    int32_t layers_num;
+    int32_t n_tokens;
+    int32_t dtype;
+    int32_t row_size;
+    int64_t data_offset;
+};
+
+static int kv_row_size(struct csinn_tensor *cache)
+{
+    return csinn_tensor_byte_size(cache) / (cache->dim[0] * cache->dim[1]);
+}
+
+/* start of slot in a [max_batch, max_seq_len, ...] cache buffer */
+static char *kv_slot_base(struct csinn_tensor *cache, void *buffer, int slot)
+{
+    return (char *)buffer + (size_t)slot * cache->dim[1] * kv_row_size(cache);
+}
+
+static size_t kv_layer_size(struct shl_llm_kv_snapshot *snap)
+{
+    return (size_t)snap->n_tokens * snap->row_size;
+}
+
+struct shl_llm_kv_snapshot *shl_llm_kv_snapshot_take(struct shl_llm_ctx *ctx, int slot,
+                                                     const int32_t *tokens, int n_tokens)
+{
+    struct shl_transformer_block *block = ctx->transformer_block[0];
+    if (slot < 0 || slot >= ctx->max_batch || n_tokens <= 0 ||
+        n_tokens > block->cache_k->dim[1]) {
+        shl_debug_error("%s: invalid slot %d or length %d\n", __func__, slot, n_tokens);
+        return NULL;
+    }
+
+    struct shl_llm_kv_snapshot *snap = shl_mem_alloc(sizeof(struct shl_llm_kv_snapshot));
+    snap->layers_num = ctx->layers_num;
+    snap->n_tokens = n_tokens;
+    snap->dtype = block->cache_k->dtype;
+    snap->row_size = kv_row_size(block->cache_k);
+    snap->tokens = shl_mem_alloc(n_tokens * sizeof(int32_t));
+    memcpy(snap->tokens, tokens, n_tokens * sizeof(int32_t));
+
+    size_t size = kv_layer_size(snap);
+    snap->data = shl_mem_alloc(2 * size * ctx->layers_num);
+    char *dst = snap->data;
+    for (int i = 0; i < ctx->layers_num; i++) {
+        block = ctx->transformer_block[i];
+        memcpy(dst, kv_slot_base(block->cache_k, block->cache_k_buffer, slot), size);
+        dst += size;
+        memcpy(dst, kv_slot_base(block->cache_v, block->cache_v_buffer, slot), size);
+        dst += size;
+    }
+    return snap;
+}
+
+int shl_llm_kv_snapshot_restore(struct shl_llm_ctx *ctx, int slot,
+                                struct shl_llm_kv_snapshot *snap, int n_tokens)
+{
+    struct shl_transformer_block *block = ctx->transformer_block[0];
+    if (snap->layers_num != ctx->layers_num || snap->dtype != block->cache_k->dtype ||
+        snap->row_size != kv_row_size(block->cache_k)) {
+        shl_debug_error("%s: snapshot does not match the model\n", __func__);
+        return CSINN_FALSE;
+    }
+    if (slot < 0 || slot >= ctx->max_batch || n_tokens < 0 || n_tokens > snap->n_tokens ||
+        n_tokens > block->cache_k->dim[1]) {
+        shl_debug_error("%s: invalid slot %d or length %d\n", __func__, slot, n_tokens);
+        return CSINN_FALSE;
+    }
+
+    size_t stride = kv_layer_size(snap);
+    size_t size = (size_t)n_tokens * snap->row_size;
+    const char *src = snap->data;
+    for (int i = 0; i < ctx->layers_num; i++) {
+        block = ctx->transformer_block[i];
+        memcpy(kv_slot_base(block->cache_k, block->cache_k_buffer, slot), src, size);
+        src += stride;
+        memcpy(kv_slot_base(block->cache_v, block->cache_v_buffer, slot), src, size);
+        src += stride;
+    }
+    return CSINN_TRUE;
+}
+
+/* length of the common prefix of the snapshot tokens and tokens */
+int shl_llm_kv_snapshot_match(struct shl_llm_kv_snapshot *snap, const int32_t *tokens,
+                              int n_tokens)
+{
+    int n = n_tokens < snap->n_tokens ? n_tokens : snap->n_tokens;
+    int i = 0;
+    while (i < n && snap->tokens[i] == tokens[i]) {
+        i++;
+    }
+    return i;
+}
+
+int shl_llm_kv_snapshot_save(struct shl_llm_kv_snapshot *snap, const char *path)
+{
+    struct kv_file_header header = {0};
+    header.magic = KV_FILE_MAGIC;
+    header.version = KV_FILE_VERSION;
+    header.layers_num = snap->layers_num;
+    header.n_tokens = snap->n_tokens;
+    header.dtype = snap->dtype;
+    header.row_size = snap->row_size;
+    size_t tokens_end = sizeof(header) + snap->n_tokens * sizeof(int32_t);
+    header.data_offset = (tokens_end + KV_FILE_ALIGN - 1) / KV_FILE_ALIGN * KV_FILE_ALIGN;
+    size_t data_size = 2 * kv_layer_size(snap) * snap->layers_num;
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        shl_debug_error("%s: cannot open %s\n", __func__, path);
+        return CSINN_FALSE;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             fwrite(snap->tokens, sizeof(int32_t), snap->n_tokens, fp) == snap->n_tokens &&
+             fseek(fp, header.data_offset, SEEK_SET) == 0 &&
+             fwrite(snap->data, 1, data_size, fp) == data_size;
+    if (fclose(fp) != 0 || !ok) {
+        shl_debug_error("%s: failed to write %s\n", __func__, path);
+        return CSINN_FALSE;
+    }
+    return CSINN_TRUE;
+}
+
+struct shl_llm_kv_snapshot *shl_llm_kv_snapshot_load(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        shl_debug_error("%s: cannot open %s\n", __func__, path);
+        return NULL;
+    }
+    struct stat sb;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &sb) == 0 && sb.st_size >= sizeof(struct kv_file_header)) {
+        addr = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        shl_debug_error("%s: cannot map %s\n", __func__, path);
+        return NULL;
+    }
+
+    struct kv_file_header *header = addr;
+    size_t data_size = 2 * (size_t)header->n_tokens * header->row_size * header->layers_num;
+    if (header->magic != KV_FILE_MAGIC || header->version != KV_FILE_VERSION ||
+        header->n_tokens <= 0 || header->row_size <= 0 ||
+        header->data_offset < sizeof(*header) + header->n_tokens * sizeof(int32_t) ||
+        header->data_offset + data_size > sb.st_size) {
+        shl_debug_error("%s: %s is not a kv snapshot\n", __func__, path);
+        munmap(addr, sb.st_size);
+        return NULL;
+    }
+
+    struct shl_llm_kv_snapshot *snap = shl_mem_alloc(sizeof(struct shl_llm_kv_snapshot));
+    snap->layers_num = header->layers_num;
+    snap->n_tokens = header->n_tokens;
+    snap->dtype = header->dtype;
+    snap->row_size = header->row_size;
+    snap->tokens = (int32_t *)(header + 1);
+    snap->data = (char *)addr + header->data_offset;
+    snap->mmap_addr = addr;
+    snap->mmap_size = sb.st_size;
+    return snap;
+}
+
+void shl_llm_kv_snapshot_free(struct shl_llm_kv_snapshot *snap)
+{
+    if (snap->mmap_addr) {
+        munmap(snap->mmap_addr, snap->mmap_size);
+    } else {
+        shl_mem_free(snap->tokens);
+        shl_mem_free(snap->data);
+    }
+    shl_mem_free(snap);
+}
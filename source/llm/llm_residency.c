@@ -0,0 +1,123 @@
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "llm/shl_llm.h"
+
+/*
+ * Residency of weights that point into the loader's file mapping. Pages come
+ * in on first touch otherwise, one fault per page in the first forward, and
+ * may be evicted again between tokens when memory is short.
+ */
+
+int64_t shl_llm_weight_size(struct csinn_tensor *tensor)
+{
+    int64_t size = csinn_tensor_size(tensor);
+    if (tensor->dtype == CSINN_DTYPE_INT8 && tensor->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0) {
+        return size + size / 32 * sizeof(int16_t);
+    } else if (tensor->dtype == CSINN_DTYPE_INT4 && tensor->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0) {
+        return size / 2 + size / 32 * sizeof(int16_t);
+    }
+    return csinn_tensor_byte_size(tensor);
+}
+
+/* page aligned span of a tensor if it lies in the mapping */
+static int weight_span(struct shl_llm_model *model, struct csinn_tensor *tensor, char **addr,
+                       size_t *len)
+{
+    if (tensor == NULL || tensor->data == NULL) {
+        return CSINN_FALSE;
+    }
+    char *map = model->mmap_addr;
+    char *data = tensor->data;
+    if (data < map || data >= map + model->mmap_size) {
+        return CSINN_FALSE;
+    }
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    char *end = data + shl_llm_weight_size(tensor);
+    if (end > map + model->mmap_size) {
+        end = map + model->mmap_size;
+    }
+    *addr = (char *)((uintptr_t)data & ~(page - 1));
+    *len = end - *addr;
+    return CSINN_TRUE;
+}
+
+/* tensors read by layer i, i == layers_num stands for the output head */
+static int layer_weights(struct shl_llm_model *model, int layer, struct csinn_tensor **w)
+{
+    if (layer == model->layers_num) {
+        w[0] = model->output_norm;
+        w[1] = model->output;
+        return 2;
+    }
+    struct shl_llm_layer *l = &model->layers[layer];
+    w[0] = l->attn_norm;
+    w[1] = l->wq;
+    w[2] = l->wk;
+    w[3] = l->wv;
+    w[4] = l->wqkv;
+    w[5] = l->wo;
+    w[6] = l->ffn_norm;
+    w[7] = l->w1;
+    w[8] = l->w3;
+    w[9] = l->w2;
+    return 10;
+}
+
+/*
+ * Start reading the weights of one layer in the background, MADV_WILLNEED
+ * queues readahead and returns without waiting for the pages.
+ */
+int shl_llm_model_advise(struct shl_llm_model *model, int layer)
+{
+    if (model == NULL || model->mmap_addr == NULL || layer < 0 || layer > model->layers_num) {
+        return CSINN_FALSE;
+    }
+    struct csinn_tensor *w[10];
+    int n = layer_weights(model, layer, w);
+    for (int i = 0; i < n; i++) {
+        char *addr;
+        size_t len;
+        if (weight_span(model, w[i], &addr, &len)) {
+            madvise(addr, len, MADV_WILLNEED);
+        }
+    }
+    return CSINN_TRUE;
+}
+
+/*
+ * Pin weights so that they survive memory pressure. The lock is bounded by
+ * RLIMIT_MEMLOCK, a failure leaves the pages evictable and is not fatal.
+ */
+int shl_llm_model_lock(struct shl_llm_model *model, int32_t level)
+{
+    if (model == NULL || model->mmap_addr == NULL || level == SHL_LLM_MLOCK_NONE) {
+        return CSINN_FALSE;
+    }
+    if (level == SHL_LLM_MLOCK_ALL) {
+        if (mlock(model->mmap_addr, model->mmap_size) != 0) {
+            shl_debug_warning("mlock of %zu bytes of weights failed\n", model->mmap_size);
+            return CSINN_FALSE;
+        }
+        return CSINN_TRUE;
+    }
+
+    struct csinn_tensor *hot[2 + 2 * sizeof(model->layers) / sizeof(model->layers[0])];
+    int n = 0;
+    hot[n++] = model->output_norm;
+    hot[n++] = model->output;
+    for (int i = 0; i < model->layers_num; i++) {
+        hot[n++] = model->layers[i].attn_norm;
+        hot[n++] = model->layers[i].ffn_norm;
+    }
+    int ret = CSINN_TRUE;
+    for (int i = 0; i < n; i++) {
+        char *addr;
+        size_t len;
+        if (weight_span(model, hot[i], &addr, &len) && mlock(addr, len) != 0) {
+            shl_debug_warning("mlock of %s failed\n", hot[i]->name);
+            ret = CSINN_FALSE;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,59 @@
+#include "llm/shl_llm.h"
+
+/*
+ * Rotary table for every position, built once per context so the rope kernels
+ * only multiply-add against it. Scaling follows the usual context extension
+ * recipes: linear interpolation, NTK-aware base change and YaRN.
+ */
+
+static double rope_yarn_corr_dim(int head_dim, int orig_ctx, float rotations, double base)
+{
+    return head_dim * log(orig_ctx / (rotations * 2 * M_PI)) / (2 * log(base));
+}
+
+float *shl_llm_rope_table(struct shl_llm_rope_config *rope, int head_dim, int max_seq_len)
+{
+    double base = rope->theta > 0 ? rope->theta : 10000.0;
+    double factor = rope->factor > 0 ? rope->factor : 1.0;
+    int n_pairs = head_dim / 2;
+    double *inv_freq = shl_mem_alloc(n_pairs * sizeof(double));
+    /* weight of the unscaled frequency, 1 keeps extrapolating, 0 interpolates */
+    double *extrap = shl_mem_alloc(n_pairs * sizeof(double));
+    double mscale = 1.0;
+
+    if (rope->scaling == SHL_LLM_ROPE_SCALING_NTK) {
+        base *= pow(factor, (double)head_dim / (head_dim - 2));
+    }
+    for (int i = 0; i < n_pairs; i++) {
+        inv_freq[i] = pow(base, -2.0 * i / head_dim);
+        extrap[i] = rope->scaling == SHL_LLM_ROPE_SCALING_LINEAR ? 0.0 : 1.0;
+    }
+    if (rope->scaling == SHL_LLM_ROPE_SCALING_YARN) {
+        int orig_ctx = rope->orig_ctx > 0 ? rope->orig_ctx : max_seq_len / factor;
+        float beta_fast = rope->beta_fast > 0 ? rope->beta_fast : 32.0f;
+        float beta_slow = rope->beta_slow > 0 ? rope->beta_slow : 1.0f;
+        double low = floor(rope_yarn_corr_dim(head_dim, orig_ctx, beta_fast, base));
+        double high = ceil(rope_yarn_corr_dim(head_dim, orig_ctx, beta_slow, base));
+        low = fmax(low, 0);
+        high = fmin(high, head_dim - 1);
+        for (int i = 0; i < n_pairs; i++) {
+            double y = (i - low) / fmax(0.001, high - low);
+            extrap[i] = 1.0 - fmin(1.0, fmax(0.0, y));
+        }
+        mscale = 1.0 + 0.1 * log(factor);
+    }
+
+    float *table = shl_mem_alloc((size_t)max_seq_len * head_dim * sizeof(float));
+    for (int p = 0; p < max_seq_len; p++) {
+        float *row = table + (size_t)p * head_dim;
+        for (int i = 0; i < n_pairs; i++) {
+            double theta = p * inv_freq[i];
+            theta = theta / factor * (1.0 - extrap[i]) + theta * extrap[i];
+            row[2 * i] = sin(theta) * mscale;
+            row[2 * i + 1] = cos(theta) * mscale;
+        }
+    }
+    shl_mem_free(inv_freq);
+    shl_mem_free(extrap);
+    return table;
+}
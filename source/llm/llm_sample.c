@@ -0,0 +1,316 @@
+#include "llm/shl_llm.h"
+#ifdef SHL_BUILD_RVV
+#include "rvv/rvv.h"
+#endif
+
+/*
+ * Token sampling: penalties -> candidates -> temperature softmax -> min-p -> top-p
+ * -> draw. The only passes over the whole vocabulary are the candidate scan and,
+ * without top_k, the max; both run on RVV when built for it. The scan keeps a
+ * min-heap of the k best logits and only stops on tokens at or above the current
+ * k-th best, so after the first few hundred tokens it is a plain vector compare.
+ */
+
+/* without top_k, tokens this many temperature-scaled nats below the max are dropped:
+ * each has p < 2e-9 * p_max */
+#define SAMPLE_LOGIT_RANGE 20.0f
+
+static float sample_max(const float *x, int n)
+{
+#ifdef SHL_BUILD_RVV
+    return shl_rvv_reduce_max_fp32(x, n);
+#else
+    float max = -FLT_MAX;
+    for (int i = 0; i < n; i++) {
+        max = fmax(max, x[i]);
+    }
+    return max;
+#endif
+}
+
+/* index of the first x[i] >= thr, -1 if none */
+static int sample_find_ge(const float *x, int n, float thr)
+{
+#ifdef SHL_BUILD_RVV
+    return shl_rvv_find_ge_fp32(x, n, thr);
+#else
+    for (int i = 0; i < n; i++) {
+        if (x[i] >= thr) {
+            return i;
+        }
+    }
+    return -1;
+#endif
+}
+
+/* xorshift64* seeded through splitmix64 */
+static uint64_t sample_seed(uint64_t seed)
+{
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return z ? z : 0x9e3779b97f4a7c15ULL;
+}
+
+static float sample_rand(struct shl_llm_sampler *s)
+{
+    s->rng ^= s->rng >> 12;
+    s->rng ^= s->rng << 25;
+    s->rng ^= s->rng >> 27;
+    uint64_t r = s->rng * 0x2545f4914f6cdd1dULL;
+    return (r >> 40) * (1.0f / 16777216.0f);
+}
+
+struct shl_llm_sampler *shl_llm_sampler_init(struct shl_llm_sampler_params *params,
+                                             int vocab_size)
+{
+    struct shl_llm_sampler *s = shl_mem_alloc(sizeof(struct shl_llm_sampler));
+    s->params = *params;
+    s->vocab_size = vocab_size;
+    s->rng = sample_seed(params->seed);
+    if (s->params.top_k > vocab_size) {
+        s->params.top_k = vocab_size;
+    }
+    int n_cand = s->params.top_k > 0 ? s->params.top_k : vocab_size;
+    s->cand = shl_mem_alloc(n_cand * sizeof(struct shl_llm_candidate));
+    if (params->penalty_last_n > 0) {
+        s->history = shl_mem_alloc(params->penalty_last_n * sizeof(int32_t));
+        s->penalty = shl_mem_alloc(params->penalty_last_n * sizeof(struct shl_llm_candidate));
+    }
+    return s;
+}
+
+void shl_llm_sampler_free(struct shl_llm_sampler *sampler)
+{
+    shl_mem_free(sampler->cand);
+    shl_mem_free(sampler->history);
+    shl_mem_free(sampler->penalty);
+    shl_mem_free(sampler);
+}
+
+void shl_llm_sampler_accept(struct shl_llm_sampler *sampler, int32_t token)
+{
+    int last_n = sampler->params.penalty_last_n;
+    if (last_n <= 0) {
+        return;
+    }
+    sampler->history[sampler->history_pos] = token;
+    sampler->history_pos = (sampler->history_pos + 1) % last_n;
+    if (sampler->n_history < last_n) {
+        sampler->n_history++;
+    }
+}
+
+static int sample_cmp_id(const void *a, const void *b)
+{
+    const struct shl_llm_candidate *ca = a;
+    const struct shl_llm_candidate *cb = b;
+    return (ca->id > cb->id) - (ca->id < cb->id);
+}
+
+static int sample_cmp_logit(const void *a, const void *b)
+{
+    const struct shl_llm_candidate *ca = a;
+    const struct shl_llm_candidate *cb = b;
+    return (ca->logit < cb->logit) - (ca->logit > cb->logit);
+}
+
+/* apply the penalties in place, the original logits are kept in sampler->penalty */
+static int sample_apply_penalties(struct shl_llm_sampler *s, float *logits)
+{
+    struct shl_llm_sampler_params *p = &s->params;
+    bool repeat = p->repeat_penalty > 0.0f && p->repeat_penalty != 1.0f;
+    if (s->n_history == 0 ||
+        (!repeat && p->presence_penalty == 0.0f && p->frequency_penalty == 0.0f)) {
+        return 0;
+    }
+
+    /* sort a copy of the history, equal tokens give the count */
+    struct shl_llm_candidate *seen = s->penalty;
+    for (int i = 0; i < s->n_history; i++) {
+        seen[i].id = s->history[i];
+    }
+    qsort(seen, s->n_history, sizeof(struct shl_llm_candidate), sample_cmp_id);
+
+    int n = 0;
+    for (int i = 0; i < s->n_history;) {
+        int32_t id = seen[i].id;
+        int count = 0;
+        while (i < s->n_history && seen[i].id == id) {
+            count++;
+            i++;
+        }
+        if (id < 0 || id >= s->vocab_size) {
+            continue;
+        }
+        float logit = logits[id];
+        seen[n].id = id;
+        seen[n].logit = logit;
+        n++;
+        if (repeat) {
+            logit = logit > 0.0f ? logit / p->repeat_penalty : logit * p->repeat_penalty;
+        }
+        logit -= count * p->frequency_penalty + p->presence_penalty;
+        logits[id] = logit;
+    }
+    return n;
+}
+
+static void sample_heap_down(struct shl_llm_candidate *heap, int n, int i)
+{
+    while (1) {
+        int min = i;
+        int l = 2 * i + 1;
+        int r = l + 1;
+        if (l < n && heap[l].logit < heap[min].logit) min = l;
+        if (r < n && heap[r].logit < heap[min].logit) min = r;
+        if (min == i) {
+            return;
+        }
+        struct shl_llm_candidate t = heap[i];
+        heap[i] = heap[min];
+        heap[min] = t;
+        i = min;
+    }
+}
+
+static void sample_heap_up(struct shl_llm_candidate *heap, int i)
+{
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap[parent].logit <= heap[i].logit) {
+            return;
+        }
+        struct shl_llm_candidate t = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = t;
+        i = parent;
+    }
+}
+
+/* the top_k largest logits, unordered, in one scan of the vocabulary */
+static int sample_top_k(struct shl_llm_sampler *s, const float *logits, int k)
+{
+    struct shl_llm_candidate *heap = s->cand;
+    int n = s->vocab_size;
+    int m = 0;
+    float thr = -FLT_MAX;
+    int i = 0;
+    while (i < n) {
+        int found = sample_find_ge(logits + i, n - i, thr);
+        if (found < 0) {
+            break;
+        }
+        i += found;
+        if (m < k) {
+            heap[m].id = i;
+            heap[m].logit = logits[i];
+            sample_heap_up(heap, m);
+            m++;
+        } else if (logits[i] > heap[0].logit) {
+            heap[0].id = i;
+            heap[0].logit = logits[i];
+            sample_heap_down(heap, m, 0);
+        }
+        if (m == k) {
+            thr = heap[0].logit;
+        }
+        i++;
+    }
+    return m;
+}
+
+/* every logit >= thr */
+static int sample_above(struct shl_llm_sampler *s, const float *logits, float thr)
+{
+    int n = s->vocab_size;
+    int m = 0;
+    int i = 0;
+    while (i < n) {
+        int found = sample_find_ge(logits + i, n - i, thr);
+        if (found < 0) {
+            break;
+        }
+        i += found;
+        s->cand[m].id = i;
+        s->cand[m].logit = logits[i];
+        m++;
+        i++;
+    }
+    return m;
+}
+
+static int32_t sample_candidates(struct shl_llm_sampler *s, const float *logits)
+{
+    struct shl_llm_sampler_params *p = &s->params;
+    int m;
+    if (p->top_k > 0) {
+        m = sample_top_k(s, logits, p->top_k);
+    } else {
+        float max = sample_max(logits, s->vocab_size);
+        m = sample_above(s, logits, max - p->temperature * SAMPLE_LOGIT_RANGE);
+    }
+    if (m == 0) {
+        return -1;
+    }
+    qsort(s->cand, m, sizeof(struct shl_llm_candidate), sample_cmp_logit);
+
+    /* probabilities relative to the best candidate, reuse logit for them */
+    struct shl_llm_candidate *c = s->cand;
+    float inv_t = 1.0f / p->temperature;
+    float max = c[0].logit;
+    float sum = 0.0f;
+    int kept = m;
+    for (int i = 0; i < m; i++) {
+        float prob = expf((c[i].logit - max) * inv_t);
+        if (p->min_p > 0.0f && prob < p->min_p) {
+            kept = i;
+            break;
+        }
+        c[i].logit = prob;
+        sum += prob;
+    }
+    if (p->top_p > 0.0f && p->top_p < 1.0f) {
+        float limit = p->top_p * sum;
+        float cum = 0.0f;
+        for (int i = 0; i < kept; i++) {
+            cum += c[i].logit;
+            if (cum >= limit) {
+                kept = i + 1;
+                sum = cum;
+                break;
+            }
+        }
+    }
+
+    float r = sample_rand(s) * sum;
+    for (int i = 0; i < kept; i++) {
+        r -= c[i].logit;
+        if (r < 0.0f) {
+            return c[i].id;
+        }
+    }
+    return c[kept - 1].id;
+}
+
+int32_t shl_llm_sampler_sample(struct shl_llm_sampler *sampler, float *logits)
+{
+    int n_penalty = sample_apply_penalties(sampler, logits);
+
+    int32_t token;
+    if (sampler->params.temperature <= 0.0f) {
+        float max = sample_max(logits, sampler->vocab_size);
+        token = sample_find_ge(logits, sampler->vocab_size, max);
+    } else {
+        token = sample_candidates(sampler, logits);
+    }
+
+    for (int i = 0; i < n_penalty; i++) {
+        logits[sampler->penalty[i].id] = sampler->penalty[i].logit;
+    }
+    if (token >= 0) {
+        shl_llm_sampler_accept(sampler, token);
+    }
+    return token;
+}
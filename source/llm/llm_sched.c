@@ -0,0 +1,325 @@
+#include "llm/shl_llm.h"
+
+/*
+ * Continuous batching on top of llm_run: every admitted sequence owns one kv cache
+ * slot, prompts are prefilled on admission and the decode tokens of all active
+ * sequences are merged into one batched forward, so the weights are read once per
+ * step whatever the number of users.
+ */
+
+struct shl_llm_sched *shl_llm_sched_init(struct shl_llm_ctx *ctx)
+{
+    struct shl_llm_sched *sched = shl_mem_alloc(sizeof(struct shl_llm_sched));
+    sched->ctx = ctx;
+    sched->max_seqs = ctx->max_batch;
+    sched->max_seq_len = ctx->transformer_block[0]->cache_k->dim[1];
+    sched->vocab_size = ctx->shl_model->output->dim[0];
+    sched->seqs = shl_mem_alloc(sched->max_seqs * sizeof(struct shl_llm_seq));
+    sched->logits = shl_mem_alloc(sched->max_seqs * sched->vocab_size * sizeof(float));
+    sched->token = shl_mem_alloc(sched->max_seqs * sizeof(int32_t));
+    sched->pos = shl_mem_alloc(sched->max_seqs * sizeof(int32_t));
+    sched->slot = shl_mem_alloc(sched->max_seqs * sizeof(int32_t));
+    sched->sampler = shl_mem_alloc(sched->max_seqs * sizeof(struct shl_llm_sampler *));
+    return sched;
+}
+
+void shl_llm_sched_free(struct shl_llm_sched *sched)
+{
+    shl_mem_free(sched->seqs);
+    shl_mem_free(sched->logits);
+    shl_mem_free(sched->token);
+    shl_mem_free(sched->pos);
+    shl_mem_free(sched->slot);
+    for (int s = 0; s < sched->max_seqs; s++) {
+        if (sched->sampler[s]) {
+            shl_llm_sampler_free(sched->sampler[s]);
+        }
+    }
+    shl_mem_free(sched->sampler);
+    shl_mem_free(sched);
+}
+
+/* copy the logits of batch row (last token only, see llm_run) into the slot's logits */
+static int sched_save_logits(struct shl_llm_sched *sched, int row, int slot)
+{
+    struct csinn_tensor *out = sched->ctx->output_session->output[0];
+    int vocab = sched->vocab_size;
+    int offset = row * vocab;
+    float *dst = sched->logits + slot * vocab;
+
+    if (out->dtype == CSINN_DTYPE_FLOAT32) {
+        memcpy(dst, (float *)out->data + offset, vocab * sizeof(float));
+    } else if (out->dtype == CSINN_DTYPE_FLOAT16) {
+        int16_t *src = (int16_t *)out->data + offset;
+        for (int i = 0; i < vocab; i++) {
+            dst[i] = shl_ref_float16_to_float32(src[i]);
+        }
+    } else {
+        shl_debug_error("%s: unsupported logits dtype %d\n", __func__, out->dtype);
+        return CSINN_FALSE;
+    }
+    return CSINN_TRUE;
+}
+
+static int sched_free_slot(struct shl_llm_sched *sched)
+{
+    int32_t slot = 0;
+    while (slot < sched->max_seqs && sched->seqs[slot].active) {
+        slot++;
+    }
+    return slot == sched->max_seqs ? -1 : slot;
+}
+
+/* prefill prompt[start:] into slot, positions [0, start) are already in the cache */
+static int sched_prefill(struct shl_llm_sched *sched, int32_t slot, int32_t *prompt,
+                         int n_prompt, int start)
+{
+    int n_tokens = n_prompt - start;
+    int32_t *pos = shl_mem_alloc(n_tokens * sizeof(int32_t));
+    for (int i = 0; i < n_tokens; i++) {
+        pos[i] = start + i;
+    }
+    struct shl_llm_input embd = {0};
+    embd.n_tokens = n_tokens;
+    embd.token = prompt + start;
+    embd.pos = pos;
+    embd.n_seqs = 1;
+    embd.slot = &slot;
+    int ret = llm_run(sched->ctx, &embd);
+    shl_mem_free(pos);
+    if (ret != CSINN_TRUE || sched_save_logits(sched, 0, slot) != CSINN_TRUE) {
+        return -1;
+    }
+
+    sched->seqs[slot].active = true;
+    sched->seqs[slot].n_past = n_prompt;
+    sched->n_active++;
+    return slot;
+}
+
+int shl_llm_sched_admit(struct shl_llm_sched *sched, int32_t *prompt, int n_prompt)
+{
+    if (n_prompt <= 0 || n_prompt > sched->max_seq_len) {
+        shl_debug_error("%s: invalid prompt length %d\n", __func__, n_prompt);
+        return -1;
+    }
+
+    int slot = sched_free_slot(sched);
+    if (slot < 0) {
+        return -1;
+    }
+    return sched_prefill(sched, slot, prompt, n_prompt, 0);
+}
+
+/* admit restoring the longest prefix the snapshot shares with the prompt, the last
+ * prompt token is always run to get its logits */
+int shl_llm_sched_admit_prefix(struct shl_llm_sched *sched, struct shl_llm_kv_snapshot *snap,
+                               int32_t *prompt, int n_prompt)
+{
+    if (n_prompt <= 0 || n_prompt > sched->max_seq_len) {
+        shl_debug_error("%s: invalid prompt length %d\n", __func__, n_prompt);
+        return -1;
+    }
+
+    int slot = sched_free_slot(sched);
+    if (slot < 0) {
+        return -1;
+    }
+    int n_reuse = shl_llm_kv_snapshot_match(snap, prompt, n_prompt);
+    if (n_reuse == n_prompt) {
+        n_reuse--;
+    }
+    if (n_reuse > 0 && shl_llm_kv_snapshot_restore(sched->ctx, slot, snap, n_reuse) != CSINN_TRUE) {
+        return -1;
+    }
+    return sched_prefill(sched, slot, prompt, n_prompt, n_reuse);
+}
+
+void shl_llm_sched_retire(struct shl_llm_sched *sched, int slot)
+{
+    if (slot < 0 || slot >= sched->max_seqs || !sched->seqs[slot].active) {
+        return;
+    }
+    /* stale keys/values stay in the slot, the next prefill starts at pos 0 and the
+     * causal mask hides everything beyond the current position */
+    sched->seqs[slot].active = false;
+    sched->seqs[slot].n_past = 0;
+    sched->n_active--;
+    if (sched->sampler[slot]) {
+        shl_llm_sampler_free(sched->sampler[slot]);
+        sched->sampler[slot] = NULL;
+    }
+}
+
+int shl_llm_sched_step(struct shl_llm_sched *sched, const int32_t *tokens)
+{
+    int n_seqs = 0;
+    for (int s = 0; s < sched->max_seqs; s++) {
+        struct shl_llm_seq *seq = &sched->seqs[s];
+        if (!seq->active) {
+            continue;
+        }
+        if (seq->n_past >= sched->max_seq_len) {
+            shl_debug_error("%s: sequence in slot %d is full\n", __func__, s);
+            return -1;
+        }
+        sched->token[n_seqs] = tokens[s];
+        sched->pos[n_seqs] = seq->n_past;
+        sched->slot[n_seqs] = s;
+        n_seqs++;
+    }
+    if (n_seqs == 0) {
+        return 0;
+    }
+
+    struct shl_llm_input embd = {0};
+    embd.n_tokens = 1;
+    embd.token = sched->token;
+    embd.pos = sched->pos;
+    embd.n_seqs = n_seqs;
+    embd.slot = sched->slot;
+    if (llm_run(sched->ctx, &embd) != CSINN_TRUE) {
+        return -1;
+    }
+
+    for (int i = 0; i < n_seqs; i++) {
+        if (sched_save_logits(sched, i, sched->slot[i]) != CSINN_TRUE) {
+            return -1;
+        }
+        sched->seqs[sched->slot[i]].n_past++;
+    }
+    return n_seqs;
+}
+
+float *shl_llm_sched_logits(struct shl_llm_sched *sched, int slot)
+{
+    return sched->logits + slot * sched->vocab_size;
+}
+
+/* sampling settings of an active sequence, NULL params go back to greedy */
+int shl_llm_sched_set_sampler(struct shl_llm_sched *sched, int slot,
+                              struct shl_llm_sampler_params *params)
+{
+    if (slot < 0 || slot >= sched->max_seqs || !sched->seqs[slot].active) {
+        shl_debug_error("%s: slot %d is not active\n", __func__, slot);
+        return CSINN_FALSE;
+    }
+    if (sched->sampler[slot]) {
+        shl_llm_sampler_free(sched->sampler[slot]);
+        sched->sampler[slot] = NULL;
+    }
+    if (params) {
+        sched->sampler[slot] = shl_llm_sampler_init(params, sched->vocab_size);
+    }
+    return CSINN_TRUE;
+}
+
+/* next token of the sequence from its latest logits */
+int32_t shl_llm_sched_sample(struct shl_llm_sched *sched, int slot)
+{
+    if (slot < 0 || slot >= sched->max_seqs || !sched->seqs[slot].active) {
+        shl_debug_error("%s: slot %d is not active\n", __func__, slot);
+        return -1;
+    }
+    if (sched->sampler[slot] == NULL) {
+        struct shl_llm_sampler_params greedy = {0};
+        sched->sampler[slot] = shl_llm_sampler_init(&greedy, sched->vocab_size);
+    }
+    return shl_llm_sampler_sample(sched->sampler[slot], shl_llm_sched_logits(sched, slot));
+}
+
+int shl_llm_sched_verify(struct shl_llm_sched *sched, int slot, int32_t token,
+                         const int32_t *draft, int n_draft, int32_t *out)
+{
+    if (slot < 0 || slot >= sched->max_seqs || !sched->seqs[slot].active) {
+        shl_debug_error("%s: slot %d is not active\n", __func__, slot);
+        return -1;
+    }
+    struct shl_llm_seq *seq = &sched->seqs[slot];
+    int n_tokens = n_draft + 1;
+    if (n_draft < 0 || seq->n_past + n_tokens > sched->max_seq_len) {
+        shl_debug_error("%s: %d draft tokens do not fit in slot %d\n", __func__, n_draft, slot);
+        return -1;
+    }
+
+    int32_t *buf = shl_mem_alloc(3 * n_tokens * sizeof(int32_t));
+    int32_t *tokens = buf;
+    int32_t *pos = buf + n_tokens;
+    int32_t *idx = buf + 2 * n_tokens;
+    tokens[0] = token;
+    memcpy(tokens + 1, draft, n_draft * sizeof(int32_t));
+    for (int i = 0; i < n_tokens; i++) {
+        pos[i] = seq->n_past + i;
+        idx[i] = i;
+    }
+    struct shl_llm_input embd = {0};
+    embd.n_tokens = n_tokens;
+    embd.token = tokens;
+    embd.pos = pos;
+    embd.n_seqs = 1;
+    embd.slot = &slot;
+    embd.n_logits = n_tokens;
+    embd.logits_idx = idx;
+    int ret = llm_run(sched->ctx, &embd);
+    shl_mem_free(buf);
+    if (ret != CSINN_TRUE) {
+        return -1;
+    }
+
+    /* every emitted token is a sample of the target model given the accepted prefix */
+    int n_out = 0;
+    for (int i = 0; i < n_tokens; i++) {
+        if (sched_save_logits(sched, i, slot) != CSINN_TRUE) {
+            return -1;
+        }
+        int32_t next = shl_llm_sched_sample(sched, slot);
+        if (next < 0) {
+            /* n_past is left alone, the whole forward is dropped like a rollback */
+            return -1;
+        }
+        out[n_out++] = next;
+        if (i == n_draft || next != draft[i]) {
+            break;
+        }
+    }
+    /* the pending token and the accepted drafts stay in the cache */
+    seq->n_past += n_out;
+    return n_out;
+}
+
+int shl_llm_sched_rollback(struct shl_llm_sched *sched, int slot, int n_past)
+{
+    if (slot < 0 || slot >= sched->max_seqs || !sched->seqs[slot].active) {
+        shl_debug_error("%s: slot %d is not active\n", __func__, slot);
+        return CSINN_FALSE;
+    }
+    /* 0 drops the whole sequence, the slot stays admitted for a new prompt */
+    if (n_past < 0 || n_past > sched->seqs[slot].n_past) {
+        shl_debug_error("%s: cannot roll slot %d back to %d\n", __func__, slot, n_past);
+        return CSINN_FALSE;
+    }
+    /* like retire, keys/values past n_past are masked out and overwritten by the next
+     * forward, the slot logits are stale until then */
+    sched->seqs[slot].n_past = n_past;
+    return CSINN_TRUE;
+}
+
+/* prompt lookup drafting: propose what followed the latest earlier occurrence of the
+ * last ngram tokens */
+int shl_llm_draft_lookup(const int32_t *tokens, int n_tokens, int ngram, int32_t *draft,
+                         int max_draft)
+{
+    if (ngram <= 0 || n_tokens <= ngram) {
+        return 0;
+    }
+    const int32_t *tail = tokens + n_tokens - ngram;
+    for (int start = n_tokens - ngram - 1; start >= 0; start--) {
+        if (memcmp(tokens + start, tail, ngram * sizeof(int32_t)) == 0) {
+            int n = n_tokens - start - ngram;
+            n = n < max_draft ? n : max_draft;
+            memcpy(draft, tokens + start + ngram, n * sizeof(int32_t));
+            return n;
+        }
+    }
+    return 0;
+}
@@ -32,11 +32,8 @@ int csinn_deconv2d_init(struct csinn_tensor *input, struct csinn_tensor *output,
     } else if ((params->group == input->dim[1] && params->base.layout == CSINN_LAYOUT_NCHW) ||
                (params->group == input->dim[3] && params->base.layout == CSINN_LAYOUT_NHWC)) {
         shl_op_callback_map(&params->base, CSINN_OP_DEPTHWISE_DECONV2D, input->dtype);
-    } else if ((params->group == output->dim[1] && params->base.layout == CSINN_LAYOUT_NCHW) ||
-               (params->group == output->dim[3] && params->base.layout == CSINN_LAYOUT_NHWC)) {
-        shl_op_callback_map(&params->base, CSINN_OP_GROUP_DECONV2D, input->dtype);
     } else {
-        return CSINN_FALSE;
+        shl_op_callback_map(&params->base, CSINN_OP_GROUP_DECONV2D, input->dtype);
     }
     int (*func)() = shl_get_init_cb(&params->base);
     if (func != NULL) {
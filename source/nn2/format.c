@@ -430,7 +430,8 @@ static char *layer_data_dump(struct shl_node *layer, int *size)
     *size = extend_size;
 
     if (layer->type == CSINN_OP_CONV2D || layer->type == CSINN_OP_DEPTHWISE_CONV2D ||
-        layer->type == CSINN_OP_GROUP_CONV2D) {
+        layer->type == CSINN_OP_GROUP_CONV2D || layer->type == CSINN_OP_DECONV2D ||
+        layer->type == CSINN_OP_GROUP_DECONV2D) {
         struct csinn_conv2d_params *conv2d_params = layer->data;
         if (conv2d_params->conv_extra.kernel_tm != NULL) {
             int kernel_tm_size;
@@ -584,7 +585,8 @@ static void layer_data_load(struct shl_node *dest, struct shl_node *src)
     // struct csinn_tensor *input = dest->in[0]->data;
     // shl_op_callback_map(ret, src->type, input->dtype);
     if (src->type == CSINN_OP_CONV2D || src->type == CSINN_OP_DEPTHWISE_CONV2D ||
-        src->type == CSINN_OP_GROUP_CONV2D) {
+        src->type == CSINN_OP_GROUP_CONV2D || src->type == CSINN_OP_DECONV2D ||
+        src->type == CSINN_OP_GROUP_DECONV2D) {
         struct csinn_conv2d_params *src_conv2d_params = ptr_offset_to_addr(src, src->data);
         struct csinn_conv2d_params *conv2d_params = (struct csinn_conv2d_params *)ret;
         if (src_conv2d_params->conv_extra.kernel_tm != NULL) {
@@ -593,6 +595,11 @@ static void layer_data_load(struct shl_node *dest, struct shl_node *src)
                 conv2d_params->conv_extra.kernel_tm,
                 ptr_offset_to_addr(src_conv2d_params, src_conv2d_params->conv_extra.kernel_tm));
         }
+    } else if (src->type == CSINN_OP_SIGMOID || src->type == CSINN_OP_SILU) {
+        /* the lookup table is rebuilt by the op init */
+        ((struct csinn_sigmoid_params *)ret)->lut = NULL;
+    } else if (src->type == CSINN_OP_ERF || src->type == CSINN_OP_TANH) {
+        ((struct csinn_siso_params *)ret)->lut = NULL;
     } else if (src->type == CSINN_OP_RESHAPE) {
         struct csinn_reshape_params *reshape_params = (struct csinn_reshape_params *)ret;
         char *shape_addr =
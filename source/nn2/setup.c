@@ -195,6 +195,7 @@ void csinn_session_deinit(struct csinn_session *sess)
     if (func != NULL) {
         func(sess);
     }
+    shl_multithread_session_free(sess);
 
     SHL_TRACE_CALL(shl_trace_duration_end(sess->trace, __func__, SHL_TRACE_EVENT_RUNTIME, NULL));
 
@@ -498,6 +499,7 @@ int csinn_session_run(struct csinn_session *sess)
     int (*func)();
     func = shl_get_runtime_callback(sess, CSINN_SESSION_RUN);
     if (func != NULL) {
+        void *thread_ctx = shl_multithread_session_begin(sess);
         if (sess->profiler_level == CSINN_PROFILER_LEVEL_TIMER) {
             uint64_t start = shl_get_timespec();
             ret = func(sess);
@@ -506,6 +508,7 @@ int csinn_session_run(struct csinn_session *sess)
         } else {
             ret = func(sess);
         }
+        shl_multithread_session_end(thread_ctx);
     }
 
     SHL_TRACE_CALL(shl_trace_duration_end(sess->trace, __func__, SHL_TRACE_EVENT_RUNTIME, NULL));
@@ -568,3 +571,187 @@ int csinn_load_binary_model(struct csinn_session *sess)
 /**
  * @}
  */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+int csinn_get_state_number(struct csinn_session *sess)
+{
+    int ret = 0;
+    int (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_GET_STATE_NUMBER);
+    if (func != NULL) {
+        ret = func(sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+int csinn_get_state(int index, struct csinn_tensor *state, struct csinn_session *sess)
+{
+    int ret = CSINN_FALSE;
+    int (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_GET_STATE);
+    if (func != NULL) {
+        ret = func(index, state, sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+struct csinn_session_state *csinn_alloc_session_state(struct csinn_session *sess)
+{
+    struct csinn_session_state *ret = NULL;
+    void *(*func)();
+    func = shl_get_runtime_callback(sess, CSINN_ALLOC_STATE);
+    if (func != NULL) {
+        ret = func(sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+void csinn_free_session_state(struct csinn_session_state *state)
+{
+    if (state == NULL) {
+        return;
+    }
+    for (int i = 0; i < state->state_num; i++) {
+        if (state->own_data) {
+            shl_mem_free(state->state[i]->data);
+        }
+        csinn_free_tensor(state->state[i]);
+    }
+    shl_mem_free(state->state);
+    shl_mem_free(state->asr_buffer);
+    shl_mem_free(state);
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+int csinn_session_save_state(struct csinn_session_state *state, struct csinn_session *sess)
+{
+    int ret = CSINN_FALSE;
+    int (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_SAVE_STATE);
+    if (func != NULL) {
+        ret = func(state, sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+int csinn_session_restore_state(struct csinn_session_state *state, struct csinn_session *sess)
+{
+    int ret = CSINN_FALSE;
+    int (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_RESTORE_STATE);
+    if (func != NULL) {
+        ret = func(state, sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+int csinn_session_reset_state(struct csinn_session *sess)
+{
+    int ret = CSINN_FALSE;
+    int (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_RESET_STATE);
+    if (func != NULL) {
+        ret = func(sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+int csinn_session_bind_state(struct csinn_session_state *state, struct csinn_session *sess)
+{
+    int ret = CSINN_FALSE;
+    int (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_BIND_STATE);
+    if (func != NULL) {
+        ret = func(state, sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+struct csinn_session *csinn_session_clone(struct csinn_session *sess)
+{
+    struct csinn_session *ret = NULL;
+    void *(*func)();
+    func = shl_get_runtime_callback(sess, CSINN_SESSION_CLONE);
+    if (func != NULL) {
+        ret = func(sess);
+    }
+    return ret;
+}
+/**
+ * @}
+ */
+
+/**
+ * @addtogroup SESSION
+ * @{
+ */
+void csinn_free_session_clone(struct csinn_session *sess)
+{
+    shl_multithread_session_free(sess);
+    void (*func)();
+    func = shl_get_runtime_callback(sess, CSINN_FREE_SESSION_CLONE);
+    if (func != NULL) {
+        func(sess);
+    }
+}
+/**
+ * @}
+ */
@@ -60,7 +60,7 @@ static struct csinn_enum_map csinn_api_map[] = {
     {CSINN_C908, "CSINN_C908"},     {CSINN_TVMGEN, "CSINN_TVMGEN"},
     {CSINN_ASP, "CSINN_ASP"},       {CSINN_RVV, "CSINN_RVV"},
     {CSINN_RVM, "CSINN_RVM"},       {CSINN_E907, "CSINN_E907"},
-    {CSINN_C920V2, "CSINN_C920V2"},
+    {CSINN_C920V2, "CSINN_C920V2"}, {CSINN_NPU_SIM, "CSINN_NPU_SIM"},
 };
 
 static struct csinn_enum_map csinn_rmod_map[] = {
@@ -2313,6 +2313,34 @@ struct csinn_callback *shl_cb_list_match(struct shl_cb_op_list *list, enum csinn
     return ret;
 }
 
+struct csinn_callback *shl_cb_op_map_add(struct shl_cb_op_map *map, enum csinn_dtype_enum dtype,
+                                         enum csinn_op_enum op_name)
+{
+    if ((unsigned)op_name >= CSINN_OP_AND_UTILS_SIZE || (unsigned)dtype >= CSINN_DTYPE_SIZE) {
+        shl_debug_error("%s: invalid op %d dtype %d\n", __func__, op_name, dtype);
+        return NULL;
+    }
+    if (map->op[op_name] == NULL) {
+        map->op[op_name] = shl_mem_alloc(CSINN_DTYPE_SIZE * sizeof(struct csinn_callback));
+    }
+    return &map->op[op_name][dtype];
+}
+
+struct csinn_callback *shl_cb_op_map_match(struct shl_cb_op_map *map, enum csinn_dtype_enum dtype,
+                                           enum csinn_op_enum op_name)
+{
+    if ((unsigned)op_name >= CSINN_OP_AND_UTILS_SIZE || (unsigned)dtype >= CSINN_DTYPE_SIZE ||
+        map->op[op_name] == NULL) {
+        return NULL;
+    }
+    struct csinn_callback *cb = &map->op[op_name][dtype];
+    if (cb->init == NULL && cb->exec == NULL && cb->est == NULL && cb->caps == NULL &&
+        cb->perf == NULL) {
+        return NULL;
+    }
+    return cb;
+}
+
 void *shl_get_init_cb(struct csinn_params_base *base)
 {
     struct csinn_callback *cb = base->cb;
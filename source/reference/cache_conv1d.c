@@ -24,7 +24,7 @@ int shl_ref_cache_conv1d_init(struct csinn_tensor *input, struct csinn_tensor *o
 {
     size_t data_size =
         output->dim[0] * output->dim[1] * output->dim[2] * sizeof(float);  // 512*13*2
-    asr_buffer_init(&params->asr_buffer, 2 * data_size, data_size);
+    asr_buffer_init(&params->asr_buffer, data_size);
 
     struct csinn_callback *cb = params->base.cb;
     cb->exec = shl_ref_cache_conv1d_quant;
@@ -57,16 +57,20 @@ int shl_ref_cache_conv1d_f32(struct csinn_tensor *input, struct csinn_tensor *ou
         }
     }
     size_t insert_lenth = output->dim[1] * input->dim[1];
-    float *output_from_buffer;
-    output_from_buffer =
-        asr_buffer_insert_back(&params->asr_buffer, output_data, insert_lenth * sizeof(float));
-    size_t output_lenth = output->dim[0] * output->dim[1] * output->dim[2];
+    asr_buffer_insert_back(&params->asr_buffer, output_data, insert_lenth * sizeof(float));
     int32_t *shape = output->dim;
     for (int i = 0; i < shape[2]; i++) {
         int j = 0;
-        for (; j < shape[1]; j++) {
-            int out_pos = j * shape[2] + i;
-            output_data[out_pos] = output_from_buffer[i * shape[1] + j];
+        while (j < shape[1]) {
+            size_t contig;
+            float *output_from_buffer = asr_buffer_get_data(
+                &params->asr_buffer, (i * shape[1] + j) * sizeof(float), &contig);
+            int end = j + contig / sizeof(float);
+            end = end < shape[1] ? end : shape[1];
+            for (; j < end; j++) {
+                int out_pos = j * shape[2] + i;
+                output_data[out_pos] = *output_from_buffer++;
+            }
         }
     }
     return CSINN_TRUE;
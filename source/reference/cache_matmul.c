@@ -18,88 +18,13 @@
 
 #include "reference/ref.h"
 
-// asr data buffer
-void asr_buffer_init(struct csinn_asr_buffer_t *buffer, size_t buffer_size, size_t data_lenth)
-{
-    buffer->buffer = shl_mem_alloc(buffer_size);
-    buffer->buffer_lenth = buffer_size;
-    buffer->data_lenth = data_lenth;
-    buffer->writer_index = buffer_size - data_lenth;
-    buffer->flag = 0;  //用来记录有没有经过位置0.有的话置为1.
-}
-
-// insert front
-void *asr_buffer_insert_front(struct csinn_asr_buffer_t *buffer, void *input, size_t len)
-{
-    int start_position = buffer->writer_index - len;
-    uint8_t *p = NULL;
-    if (buffer->flag == 0) {
-        if (start_position < 0) {
-            buffer->flag = 1;
-        }
-    }
-    if (start_position >= 0) {
-        p = &buffer->buffer[start_position];
-        memcpy(p, input, len);
-        buffer->writer_index = start_position;
-        if (buffer->flag == 0) {
-            return (void *)&buffer->buffer[0];
-        } else {
-            return (void *)p;
-        }
-    } else {
-        start_position = buffer->buffer_lenth - buffer->data_lenth;
-        p = &buffer->buffer[start_position];
-        memcpy(p, input, len);
-        memcpy(p + len, &buffer->buffer[buffer->writer_index], buffer->data_lenth - len);
-        buffer->writer_index = start_position;
-        return (void *)p;
-    }
-}
-
-void *asr_buffer_insert_back(struct csinn_asr_buffer_t *buffer, void *input, size_t len)
-{
-    int end_position = buffer->writer_index + len;
-    uint8_t *p = NULL;
-    if (end_position <= buffer->buffer_lenth) {
-        p = &buffer->buffer[buffer->writer_index];
-        memcpy(p, input, len);
-        buffer->writer_index += len;
-        p -= (buffer->data_lenth - len);
-    } else {
-        p = &buffer->buffer[buffer->writer_index + len - buffer->data_lenth];
-        memcpy(&buffer->buffer[0], p, buffer->data_lenth - len);
-        buffer->writer_index = buffer->data_lenth;
-        memcpy(&buffer->buffer[buffer->data_lenth - len], input, len);
-        p = &buffer->buffer[0];
-    }
-    return (void *)p;
-}
-
-// get buffer
-void *asr_buffer_get_buffer(struct csinn_asr_buffer_t *buffer)
-{
-    return asr_buffer_insert_back(buffer, NULL, 0);
-}
-
-// reset buffer
-void asr_buffer_reset(struct csinn_asr_buffer_t *buffer)
-{
-    free(buffer->buffer);
-    buffer->writer_index = 0;
-    buffer->buffer = NULL;
-    buffer->buffer_lenth = 0;
-    buffer->data_lenth = 0;
-    buffer->flag = 0;
-}
-
 int shl_ref_cache_matmul_init(struct csinn_tensor *input, struct csinn_tensor *output,
                               struct csinn_tensor *weight, struct csinn_tensor *bias,
                               struct csinn_cache_matmul_params *params)
 {
     size_t data_size =
         params->shape[0] * params->shape[1] * params->shape[2] * params->shape[3] * sizeof(float);
-    asr_buffer_init(&params->asr_buffer, 2 * data_size, data_size);
+    asr_buffer_init(&params->asr_buffer, data_size);
 
     struct csinn_callback *cb = params->base.cb;
     cb->exec = shl_ref_cache_matmul_quant;
@@ -136,13 +61,10 @@ int shl_ref_cache_matmul_f32(struct csinn_tensor *input, struct csinn_tensor *ou
     float judge =
         bias_data[0] + bias_data[1] + bias_data[2] + bias_data[3] + bias_data[4] + bias_data[5];
     size_t insert_lenth = output_depth * batches;
-    float *output_from_buffer;
     if (fabs(judge) < 0.01) {
-        output_from_buffer =
-            asr_buffer_insert_front(&params->asr_buffer, output_data, insert_lenth * sizeof(float));
+        asr_buffer_insert_front(&params->asr_buffer, output_data, insert_lenth * sizeof(float));
     } else {
-        output_from_buffer =
-            asr_buffer_insert_back(&params->asr_buffer, output_data, insert_lenth * sizeof(float));
+        asr_buffer_insert_back(&params->asr_buffer, output_data, insert_lenth * sizeof(float));
     }
     // deal with reshape & transpose
     int32_t *shape = output->dim;
@@ -154,9 +76,17 @@ int shl_ref_cache_matmul_f32(struct csinn_tensor *input, struct csinn_tensor *ou
         int shape3 = shape[2];
         int flatten_shape = shape[1] * shape[2];
         for (int i = 0; i < batch; i++) {
-            for (int j = 0; j < flatten_shape; j++) {
-                int out_pos = j * batch + i;
-                output_data[out_pos] = output_from_buffer[i * flatten_shape + j];
+            int j = 0;
+            while (j < flatten_shape) {
+                size_t contig;
+                float *output_from_buffer = asr_buffer_get_data(
+                    &params->asr_buffer, (i * flatten_shape + j) * sizeof(float), &contig);
+                int end = j + contig / sizeof(float);
+                end = end < flatten_shape ? end : flatten_shape;
+                for (; j < end; j++) {
+                    int out_pos = j * batch + i;
+                    output_data[out_pos] = *output_from_buffer++;
+                }
             }
         }
     } else  // 0,2,1,3
@@ -165,9 +95,17 @@ int shl_ref_cache_matmul_f32(struct csinn_tensor *input, struct csinn_tensor *ou
         int shape3 = shape[3];
         int flatten_shape = shape[1] * shape[3];
         for (int i = 0; i < batch; i++) {
-            for (int j = 0; j < flatten_shape; j++) {
-                int out_pos = i * shape3 + j % shape3 + batch * shape3 * (j / shape3);
-                output_data[out_pos] = output_from_buffer[i * flatten_shape + j];
+            int j = 0;
+            while (j < flatten_shape) {
+                size_t contig;
+                float *output_from_buffer = asr_buffer_get_data(
+                    &params->asr_buffer, (i * flatten_shape + j) * sizeof(float), &contig);
+                int end = j + contig / sizeof(float);
+                end = end < flatten_shape ? end : flatten_shape;
+                for (; j < end; j++) {
+                    int out_pos = i * shape3 + j % shape3 + batch * shape3 * (j / shape3);
+                    output_data[out_pos] = *output_from_buffer++;
+                }
             }
         }
     }
@@ -25,11 +25,9 @@ int shl_ref_fsmn_f32(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
                      struct csinn_tensor *frame_counter, struct csinn_tensor *output,
                      struct csinn_fsmn_params *params)
 {
-    float *last_frame = frame->data;
     float *past_filter = l_filter->data;
     float *future_filter = r_filter->data;
     float *sequence_frame = frame_sequence->data;
-    int32_t *frame_count = frame_counter->data;
     float *output_data = output->data;
 
     int len_order = frame_sequence->dim[0];
@@ -37,45 +35,34 @@ int shl_ref_fsmn_f32(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
 
     for (int i = 0; i < length; i++) output_data[i] = 0.0;
 
-    frame_count[0]++;
     // set last frame to sequence tail.
-    if (frame_count[0] > params->unavailable_frames) {
-        for (int i = 0; i < len_order; i++) {
-            for (int j = 0; j < length; j++) {
-                int new_index = i * length + j;
-                if (i == (len_order - 1)) {
-                    sequence_frame[new_index] = last_frame[j];
-                } else {
-                    int original_index = (i + 1) * length + j;
-                    sequence_frame[new_index] = sequence_frame[original_index];
-                }
-            }
-        }
-    }
+    int head = shl_ref_fsmn_push_frame(frame, frame_sequence, frame_counter, params);
 
     // past frame
     for (int k = 0; k < params->l_order; k++) {
+        float *in_frame = sequence_frame + ((head + k * params->l_stride) % len_order) * length;
         for (int l = 0; l < length; l++) {
-            int in_index = k * params->l_stride * length + l;
             int filter_index = (params->l_order - k - 1) * length + l;
-            output_data[l] = past_filter[filter_index] * sequence_frame[in_index] + output_data[l];
+            output_data[l] = past_filter[filter_index] * in_frame[l] + output_data[l];
         }
     }
 
     //  current frame
+    float *cur_frame =
+        sequence_frame + ((head + (params->l_order - 1) * params->l_stride) % len_order) * length;
     for (int m = 0; m < length; m++) {
-        int in_index = (params->l_order - 1) * length * params->l_stride + m;
-        output_data[m] = sequence_frame[in_index] + output_data[m];
+        output_data[m] = cur_frame[m] + output_data[m];
     }
 
     // future frame
     for (int m = 0; m < params->r_order; m++) {
+        float *in_frame =
+            sequence_frame +
+            ((head + params->l_order * params->l_stride + m * params->r_stride) % len_order) *
+                length;
         for (int n = 0; n < length; n++) {
-            int in_index =
-                m * params->r_stride * length + n + params->l_order * params->l_stride * length;
             int filter_index = m * length + n;
-            output_data[n] =
-                future_filter[filter_index] * sequence_frame[in_index] + output_data[n];
+            output_data[n] = future_filter[filter_index] * in_frame[n] + output_data[n];
         }
     }
 
@@ -119,6 +119,20 @@ int shl_ref_matmul_f32(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                     }
                 }
             }
+        } else if (!params->trans_a && params->trans_b) {
+            for (int b = 0; b < batches_a; ++b) {
+                for (int i = 0; i < dim_i; ++i) {
+                    for (int j = 0; j < dim_j; ++j) {
+                        float total = 0.f;
+                        for (int k = 0; k < dim_k; ++k) {
+                            int offset0 = mat0_offset * b + i * dim_k + k;
+                            int offset1 = j * dim_k + k;
+                            total += mat0_data[offset0] * mat1_data[offset1];
+                        }
+                        output_data[b * out_offset + i * dim_j + j] = total;
+                    }
+                }
+            }
         } else {
             shl_debug_error("matmul unsupport this broadcast\n");
             return CSINN_FALSE;
@@ -131,8 +145,119 @@ int shl_ref_matmul_f32(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
     return CSINN_TRUE;
 }
 
+static void quantize_row_int8(const float *src, int8_t *dst, float *scale, int K, int32_t mode)
+{
+    const int block_size = 32;
+    float row_max = 0.0f;
+    if (mode == CSINN_ACT_QUANT_TOKEN) {
+        for (int k = 0; k < K; k++) {
+            row_max = fmaxf(row_max, fabsf(src[k]));
+        }
+    }
+    for (int b = 0; b < K / block_size; b++) {
+        const float *in = src + b * block_size;
+        float abs_max = row_max;
+        if (mode != CSINN_ACT_QUANT_TOKEN) {
+            for (int k = 0; k < block_size; k++) {
+                abs_max = fmaxf(abs_max, fabsf(in[k]));
+            }
+        }
+        scale[b] = abs_max / 127.0f;
+        float inv = abs_max > 0.0f ? 127.0f / abs_max : 0.0f;
+        for (int k = 0; k < block_size; k++) {
+            float q = nearbyintf(in[k] * inv);
+            dst[b * block_size + k] = (int8_t)fmaxf(-127.0f, fminf(127.0f, q));
+        }
+    }
+}
+
+/*
+ * mat1 is [N, K] block q8_0/q4_0. Every row of mat0 is quantized to int8 on the fly
+ * and each block of 32 is an integer dot product scaled by the two block scales.
+ */
+int shl_ref_matmul_a0b1_dynamic_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
+                                      struct csinn_tensor *output,
+                                      struct csinn_matmul_params *params)
+{
+    const int block_size = 32;
+    const int dims_count = mat0->dim_count;
+    int batches_a = 1;
+    int batches_b = 1;
+    for (int i = 0; i < dims_count - 2; i++) {
+        batches_a *= mat0->dim[i];
+    }
+    for (int i = 0; i < mat1->dim_count - 2; i++) {
+        batches_b *= mat1->dim[i];
+    }
+    const int dim_m = mat0->dim[dims_count - 2];
+    const int dim_k = mat0->dim[dims_count - 1];
+    const int dim_n = mat1->dim[mat1->dim_count - 2];
+    if (dim_k % block_size != 0 || (batches_a != batches_b && batches_b != 1)) {
+        shl_debug_error("%s: unsupported shape\n", __func__);
+        return CSINN_FALSE;
+    }
+
+    bool q4 = mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0;
+    int8_t *mat1_data = mat1->data;
+    int64_t weight_size = q4 ? csinn_tensor_size(mat1) / 2 : csinn_tensor_size(mat1);
+    int16_t *mat1_scale = (int16_t *)(mat1_data + weight_size);
+    int row_bytes = q4 ? dim_k / 2 : dim_k;
+    int blocks = dim_k / block_size;
+
+    struct csinn_tensor *finput = shl_ref_tensor_transform_f32(mat0);
+    struct csinn_tensor *foutput = shl_ref_tensor_transform_f32(output);
+    float *input_data = finput->data;
+    float *output_data = foutput->data;
+    int8_t *qa = shl_mem_alloc(dim_k);
+    float *qa_scale = shl_mem_alloc(blocks * sizeof(float));
+    int8_t w[32];
+
+    for (int b = 0; b < batches_a; b++) {
+        int wb = batches_b == 1 ? 0 : b;
+        for (int i = 0; i < dim_m; i++) {
+            quantize_row_int8(input_data + (b * dim_m + i) * dim_k, qa, qa_scale, dim_k,
+                              params->act_quant);
+            for (int j = 0; j < dim_n; j++) {
+                int64_t row = (int64_t)wb * dim_n + j;
+                const int8_t *wrow = mat1_data + row * row_bytes;
+                const int16_t *wscale = mat1_scale + row * blocks;
+                float total = 0.0f;
+                for (int k = 0; k < blocks; k++) {
+                    if (q4) {
+                        /* byte t holds element t in the low and t + 16 in the high nibble */
+                        for (int t = 0; t < block_size / 2; t++) {
+                            uint8_t v = wrow[k * block_size / 2 + t];
+                            w[t] = (v & 0xf) - 8;
+                            w[t + block_size / 2] = (v >> 4) - 8;
+                        }
+                    } else {
+                        memcpy(w, wrow + k * block_size, block_size);
+                    }
+                    int32_t dot = 0;
+                    for (int t = 0; t < block_size; t++) {
+                        dot += qa[k * block_size + t] * w[t];
+                    }
+                    total += dot * qa_scale[k] * shl_ref_float16_to_float32(wscale[k]);
+                }
+                output_data[(b * dim_m + i) * dim_n + j] = total;
+            }
+        }
+    }
+
+    csinn_tensor_data_convert(output, foutput);
+    shl_ref_tensor_transform_free_f32(finput);
+    shl_ref_tensor_transform_free_f32(foutput);
+    shl_mem_free(qa);
+    shl_mem_free(qa_scale);
+    return CSINN_TRUE;
+}
+
 int shl_ref_matmul_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                          struct csinn_tensor *output, struct csinn_matmul_params *params)
 {
+    if (params->act_quant != CSINN_ACT_QUANT_NONE && !params->trans_a && params->trans_b &&
+        (mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0 || mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0)) {
+        return shl_ref_matmul_a0b1_dynamic_quant(mat0, mat1, output, params);
+    }
     return shl_ref_diso_callback_base(mat0, mat1, output, params, shl_ref_matmul_f32);
 }
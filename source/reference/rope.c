@@ -36,7 +36,7 @@ int shl_ref_rope_f32(struct csinn_tensor *input, struct csinn_tensor *output,
     if (!params->use_rope_cache) {
         for (int i3 = 0; i3 < input->dim[0]; i3++) {
             for (int i2 = 0; i2 < input->dim[1]; i2++) {
-                int p = pos[i2];
+                int p = pos[i3 * input->dim[1] + i2];
                 for (int i1 = 0; i1 < input->dim[2]; i1++) {
                     float theta = freq_scale * (float)p;
 
@@ -66,21 +66,23 @@ int shl_ref_rope_f32(struct csinn_tensor *input, struct csinn_tensor *output,
             }
         }
     } else {
-        float *rope_cache = &((float *)params->rope_cache)[pos[0] * input->dim[2] * input->dim[3]];
+        float *rope_cache = (float *)params->rope_cache;
+        int head_stride = params->rope_cache_shared ? 0 : input->dim[3];
+        int pos_stride = params->rope_cache_shared ? input->dim[3] : input->dim[3] * input->dim[2];
         for (int i3 = 0; i3 < input->dim[0]; i3++) {
             for (int i2 = 0; i2 < input->dim[1]; i2++) {
+                int p = pos[i3 * input->dim[1] + i2];
                 for (int i1 = 0; i1 < input->dim[2]; i1++) {
                     for (int i0 = 0; i0 < input->dim[3]; i0 += 2) {
                         int index = i3 * (input->dim[3] * input->dim[2] * input->dim[1]) +
                                     i2 * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
 
-                        int rope_cache_index =
-                            i2 * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
+                        int rope_cache_index = p * pos_stride + i1 * head_stride + i0;
 
                         float x0 = src_data[index];
                         float x1 = src_data[index + 1];
-                        float sin_theta = rope_cache[index];
-                        float cos_theta = rope_cache[index + 1];
+                        float sin_theta = rope_cache[rope_cache_index];
+                        float cos_theta = rope_cache[rope_cache_index + 1];
 
                         dst_data[index] = x0 * cos_theta - x1 * sin_theta;
                         dst_data[index + 1] = x0 * sin_theta + x1 * cos_theta;
@@ -34,7 +34,7 @@ int shl_ref_scaled_dot_product_attention_f32(struct csinn_tensor *query, struct
     // np: number of heads
     // sk: sequence number of kv
     // sq: sequence number of q
-    int32_t batch = query->dim[0];  // batch = 1 only
+    int32_t batch = query->dim[0];
     int32_t np = query->dim[1];
     int32_t sk = key->dim[2];
     int32_t sq = query->dim[2];
@@ -43,21 +43,20 @@ int shl_ref_scaled_dot_product_attention_f32(struct csinn_tensor *query, struct
 
     // deal with transpose_v first
     // batch,np,sq,sk * batch,np,sk,dim_head
+    float *value_transpose = value_data;
     if (!params->transpose_v)  // if value is [batch,np,sk,dim_head],do transpose(-2,-1)
     {
-        float *value_transpose_tmp = shl_mem_alloc(batch * np * sk * head_dim * sizeof(float));
-        memcpy(value_transpose_tmp, value_data, batch * np * sk * head_dim * sizeof(float));
-        for (int i = 0; i < np; i++) {
+        // into a copy, the value tensor is often the caller's kv cache
+        value_transpose = shl_mem_alloc(batch * np * sk * head_dim * sizeof(float));
+        for (int i = 0; i < batch * np; i++) {
             for (int j = 0; j < head_dim; j++) {
                 for (int k = 0; k < sk; k++) {
                     int dim1 = i * head_dim * sk + j * sk + k,
                         dim2 = i * head_dim * sk + head_dim * k + j;
-                    value_data[dim1] = value_transpose_tmp[dim2];
+                    value_transpose[dim1] = value_data[dim2];
                 }
             }
         }
-
-        shl_mem_free(value_transpose_tmp);
     }
 
     // matmul_result = torch.matmul(query_layer, key_layer.transpose(-1, -2))
@@ -65,7 +64,7 @@ int shl_ref_scaled_dot_product_attention_f32(struct csinn_tensor *query, struct
     size_t matmul_res_size = batch * np * sq * sk * sizeof(float);
     float *matmul_res_data = shl_mem_alloc(matmul_res_size);
     memset(matmul_res_data, 0, matmul_res_size);
-    for (int i = 0; i < np; i++)  // split into multiple threads from here.
+    for (int i = 0; i < batch * np; i++)  // split into multiple threads from here.
     {
         float *mat_input1 = query_data + i * sq * head_dim;
         float *mat_input2 = key_data + i * sk * head_dim;
@@ -100,7 +99,7 @@ int shl_ref_scaled_dot_product_attention_f32(struct csinn_tensor *query, struct
         // context_layer = torch.matmul(attention_probs, value_layer)
 
         mat_input1 = matmul_res_data + i * sq * sk;
-        mat_input2 = value_data + i * head_dim * sk;
+        mat_input2 = value_transpose + i * head_dim * sk;
 
         for (int j = 0; j < sq; j++) {
             for (int k = 0; k < head_dim; k++) {
@@ -113,6 +112,9 @@ int shl_ref_scaled_dot_product_attention_f32(struct csinn_tensor *query, struct
         }
     }
     shl_mem_free(matmul_res_data);
+    if (value_transpose != value_data) {
+        shl_mem_free(value_transpose);
+    }
 
     return CSINN_TRUE;
 }
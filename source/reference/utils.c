@@ -805,3 +805,106 @@ bool shl_is_first_layer_input(struct csinn_tensor *input, struct csinn_session *
     }
     return false;
 }
+
+/*
+ * asr data buffer
+ *
+ * The cached frames live in a ring of data_lenth bytes. Inserting a frame writes only
+ * the new bytes at writer_index, the window is read back through asr_buffer_get_data,
+ * so the cost of an insertion does not depend on the history length.
+ */
+void asr_buffer_init(struct csinn_asr_buffer_t *buffer, size_t data_lenth)
+{
+    buffer->buffer = shl_mem_alloc(data_lenth);
+    buffer->buffer_lenth = data_lenth;
+    buffer->data_lenth = data_lenth;
+    buffer->writer_index = data_lenth;
+    buffer->flag = 0;
+}
+
+static void asr_buffer_write(struct csinn_asr_buffer_t *buffer, size_t pos, void *input,
+                             size_t len)
+{
+    size_t first = buffer->buffer_lenth - pos;
+    if (len <= first) {
+        memcpy(buffer->buffer + pos, input, len);
+    } else {
+        memcpy(buffer->buffer + pos, input, first);
+        memcpy(buffer->buffer, (uint8_t *)input + first, len - first);
+    }
+}
+
+// the newest frame is at the window head, the oldest frames drop out of the tail
+void asr_buffer_insert_front(struct csinn_asr_buffer_t *buffer, void *input, size_t len)
+{
+    int64_t start_position = (int64_t)buffer->writer_index - (int64_t)len;
+    if (start_position < 0) {
+        /* until the first wrap the window is the buffer itself, padded with zeros at the head */
+        buffer->flag = 1;
+        start_position += buffer->buffer_lenth;
+    }
+    buffer->writer_index = start_position;
+    asr_buffer_write(buffer, buffer->writer_index, input, len);
+}
+
+// the newest frame is at the window tail, the oldest frames drop out of the head
+void asr_buffer_insert_back(struct csinn_asr_buffer_t *buffer, void *input, size_t len)
+{
+    size_t pos = buffer->writer_index % buffer->buffer_lenth;
+    asr_buffer_write(buffer, pos, input, len);
+    buffer->writer_index = (pos + len) % buffer->buffer_lenth;
+    buffer->flag = 1;
+}
+
+/*
+ * Map byte offset of the window to the ring, contig_lenth returns how many bytes can be
+ * read from the returned pointer before the ring wraps.
+ */
+void *asr_buffer_get_data(struct csinn_asr_buffer_t *buffer, size_t offset, size_t *contig_lenth)
+{
+    size_t start = buffer->flag ? buffer->writer_index : 0;
+    size_t pos = (start + offset) % buffer->buffer_lenth;
+    if (contig_lenth != NULL) {
+        size_t to_wrap = buffer->buffer_lenth - pos;
+        size_t to_end = buffer->data_lenth - offset;
+        *contig_lenth = to_wrap < to_end ? to_wrap : to_end;
+    }
+    return buffer->buffer + pos;
+}
+
+// reset buffer
+void asr_buffer_reset(struct csinn_asr_buffer_t *buffer)
+{
+    shl_mem_free(buffer->buffer);
+    buffer->writer_index = 0;
+    buffer->buffer = NULL;
+    buffer->buffer_lenth = 0;
+    buffer->data_lenth = 0;
+    buffer->flag = 0;
+}
+
+/*
+ * frame_sequence holds len_order frames as a ring, the oldest frame is at the returned row.
+ * The new frame is written over the oldest one instead of shifting the whole sequence.
+ */
+int shl_ref_fsmn_push_frame(struct csinn_tensor *frame, struct csinn_tensor *frame_sequence,
+                            struct csinn_tensor *frame_counter, struct csinn_fsmn_params *params)
+{
+    int32_t *frame_count = frame_counter->data;
+    int len_order = frame_sequence->dim[0];
+    int row_size = csinn_tensor_byte_size(frame_sequence) / len_order;
+
+    frame_count[0]++;
+    int pushed = frame_count[0] - params->unavailable_frames;
+    if (pushed <= 0) {
+        return 0;
+    }
+    /* keep the counter bounded for always-on streams, only its phase matters */
+    if (pushed > len_order) {
+        pushed = (pushed - 1) % len_order + 1;
+        frame_count[0] = params->unavailable_frames + pushed;
+    }
+    int row = (pushed - 1) % len_order;
+    memcpy((uint8_t *)frame_sequence->data + row * row_size, frame->data, row_size);
+    return pushed % len_order;
+}
@@ -17,34 +17,29 @@
  */
 
 #include "rvm/rvm.h"
+#include "rvv/cap.h"
+#include "rvv/perf.h"
 
-#define RVM_OP_PATTERN_MAX 60
-static struct shl_cb_table shl_rvm_cb_table[RVM_OP_PATTERN_MAX];
+static struct shl_cb_op_map shl_rvm_cb_op_map;
 
 void shl_rvm_reg_op(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *init, void *exec,
-                    void *est)
+                    void *est, void *cap, void *perf)
 {
-    static int i = 0;
-    if (i >= RVM_OP_PATTERN_MAX) {
-        shl_debug_error("RVM callback length is greater than RVM_OP_PATTERN_MAX!\n");
+    struct csinn_callback *cb = shl_cb_op_map_add(&shl_rvm_cb_op_map, dtype, op_name);
+    if (cb == NULL) {
+        return;
     }
-    shl_rvm_cb_table[i].shl_cb_key = op_name * CSINN_DTYPE_SIZE + dtype;
-    shl_rvm_cb_table[i].shl_cb_value.init = init;
-    shl_rvm_cb_table[i].shl_cb_value.exec = exec;
-    shl_rvm_cb_table[i].shl_cb_value.est = est;
-    i++;
+    cb->init = init;
+    cb->exec = exec;
+    cb->est = est;
+    cb->caps = cap;
+    cb->perf = perf;
 }
 
 struct csinn_callback *shl_cb_map_rvv(int op, int dtype);
 struct csinn_callback *shl_cb_map_rvm(int op, int dtype)
 {
-    struct csinn_callback *cb = NULL;
-    for (int i = 0; i < RVM_OP_PATTERN_MAX; i++) {
-        if (shl_rvm_cb_table[i].shl_cb_key == (op * CSINN_DTYPE_SIZE + dtype)) {
-            cb = &(shl_rvm_cb_table[i].shl_cb_value);
-            break;
-        }
-    }
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_rvm_cb_op_map, dtype, op);
     if ((cb == NULL) || (cb->est == NULL && (cb->init == NULL || cb->exec == NULL))) {
         cb = shl_cb_map_rvv(op, dtype);
     }
@@ -76,6 +71,7 @@ void shl_rvm_session_init(struct csinn_session *sess)
 void shl_rvm_session_deinit(struct csinn_session *sess)
 {
     struct shl_ref_graph *graph = shl_gref_get_graph(sess);
+    shl_gref_free_layer_buffers(graph);
     shl_mem_free(graph->input);
     shl_mem_free(graph->output);
     shl_mem_free(graph->layer);
@@ -314,6 +310,15 @@ void *shl_rvm_runtime_callback(int api)
         case CSINN_GET_INPUT:
         case CSINN_GET_OUTPUT:
         case CSINN_TENSOR_ENTRY:
+        case CSINN_GET_STATE_NUMBER:
+        case CSINN_GET_STATE:
+        case CSINN_ALLOC_STATE:
+        case CSINN_SAVE_STATE:
+        case CSINN_RESTORE_STATE:
+        case CSINN_RESET_STATE:
+        case CSINN_BIND_STATE:
+        case CSINN_SESSION_CLONE:
+        case CSINN_FREE_SESSION_CLONE:
             return shl_gref_runtime_callback(api);
             break;
         default:
@@ -326,33 +331,58 @@ void *shl_rvm_runtime_callback(int api)
 void shl_target_init_rvm()
 {
     shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_CONV2D, shl_rvm_conv2d_init_fp16, NULL,
-                   shl_gref_conv2d);
+                   shl_gref_conv2d, NULL, NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_CONV2D, shl_rvm_conv2d_init_int8, NULL,
-                   shl_gref_conv2d);
+                   shl_gref_conv2d, NULL, NULL);
 
     shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_DEPTHWISE_CONV2D,
-                   shl_rvm_depthwise_conv2d_init_fp16, NULL, shl_gref_depthwise_conv2d);
+                   shl_rvm_depthwise_conv2d_init_fp16, NULL, shl_gref_depthwise_conv2d, NULL,
+                   NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_DEPTHWISE_CONV2D, shl_rvm_depthwise_conv2d_init_int8,
-                   NULL, shl_gref_depthwise_conv2d);
+                   NULL, shl_gref_depthwise_conv2d, NULL, NULL);
 
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_CONV2D_RELU, shl_rvm_conv2d_init_int8, NULL,
-                   shl_gref_conv2d_relu);
+                   shl_gref_conv2d_relu, NULL, NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_DEPTHWISE_CONV2D_RELU,
-                   shl_rvm_depthwise_conv2d_init_int8, NULL, shl_gref_depthwise_conv2d_relu);
+                   shl_rvm_depthwise_conv2d_init_int8, NULL, shl_gref_depthwise_conv2d_relu, NULL,
+                   NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_CONV2D_RELU6, shl_rvm_conv2d_init_int8, NULL,
-                   shl_gref_conv2d_relu6);
+                   shl_gref_conv2d_relu6, NULL, NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_DEPTHWISE_CONV2D_RELU6,
-                   shl_rvm_depthwise_conv2d_init_int8, NULL, shl_gref_depthwise_conv2d_relu6);
+                   shl_rvm_depthwise_conv2d_init_int8, NULL, shl_gref_depthwise_conv2d_relu6, NULL,
+                   NULL);
 
     shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_FULLYCONNECTED, shl_rvm_fullyconnected_init_fp16,
-                   NULL, shl_gref_fullyconnected);
+                   NULL, shl_gref_fullyconnected, NULL, NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_FULLYCONNECTED, shl_rvm_fullyconnected_init_int8,
-                   NULL, shl_gref_fullyconnected);
+                   NULL, shl_gref_fullyconnected, NULL, NULL);
 
     shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_MATMUL, shl_rvm_matmul_init_fp16, NULL,
-                   shl_gref_matmul);
+                   shl_gref_matmul, NULL, NULL);
     shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_MATMUL, shl_rvm_matmul_init_int8, NULL,
-                   shl_gref_matmul);
+                   shl_gref_matmul, NULL, NULL);
+
+    /* the pooling inits run the rvv nhwc kernels, so the rvv caps and perf describe them */
+    shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_AVGPOOL2D, shl_rvm_avgpool2d_init_fp16, NULL,
+                   shl_gref_avgpool2d, shl_rvv_avgpool2d_cap, shl_rvv_avgpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_AVGPOOL2D, shl_rvm_avgpool2d_init_int8, NULL,
+                   shl_gref_avgpool2d, shl_rvv_avgpool2d_cap, shl_rvv_avgpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_MAXPOOL2D, shl_rvm_maxpool2d_init_fp16, NULL,
+                   shl_gref_maxpool2d, shl_rvv_maxpool2d_cap, shl_rvv_maxpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_MAXPOOL2D, shl_rvm_maxpool2d_init_int8, NULL,
+                   shl_gref_maxpool2d, shl_rvv_maxpool2d_cap, shl_rvv_maxpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_GLOBAL_AVGPOOL2D, shl_rvm_global_avgpool2d_init,
+                   NULL, shl_gref_global_avgpool2d, shl_rvv_global_avgpool2d_cap,
+                   shl_rvv_global_avgpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_GLOBAL_AVGPOOL2D, shl_rvm_global_avgpool2d_init,
+                   NULL, shl_gref_global_avgpool2d, shl_rvv_global_avgpool2d_cap,
+                   shl_rvv_global_avgpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_GLOBAL_MAXPOOL2D, shl_rvm_global_maxpool2d_init,
+                   NULL, shl_gref_global_maxpool2d, shl_rvv_global_maxpool2d_cap,
+                   shl_rvv_global_maxpool2d_perf);
+    shl_rvm_reg_op(CSINN_DTYPE_INT8, CSINN_OP_GLOBAL_MAXPOOL2D, shl_rvm_global_maxpool2d_init,
+                   NULL, shl_gref_global_maxpool2d, shl_rvv_global_maxpool2d_cap,
+                   shl_rvv_global_maxpool2d_perf);
 
     shl_register_op_callback(CSINN_RVM, shl_cb_map_rvm);
     shl_register_runtime_callback(CSINN_RVM, shl_rvm_runtime_callback);
@@ -124,6 +124,133 @@ static int broadcast_get_index(int32_t *dim, int32_t *idx, int32_t dim_count)
     return res;
 }
 
+struct binary_op_task {
+    void (*binary_op)();
+    int8_t *input0;
+    int8_t *input1;
+    int8_t *output;
+    int elem_size;
+    float *scale;
+    int32_t *zero_point;
+    /* broadcast rows */
+    int32_t *in0_dim;
+    int32_t *in1_dim;
+    int32_t *out_dim;
+    int32_t dim_count;
+    int parts; /* pieces each row of the last dimension is cut into */
+    /* flat data */
+    int64_t size;
+    int64_t chunk;
+    int mode;
+};
+
+static inline void binary_op_call(struct binary_op_task *t, int8_t *in0, int8_t *in1, int8_t *out,
+                                  int32_t size)
+{
+    if (t->scale != NULL) {
+        t->binary_op(in0, in1, out, size, t->scale, t->zero_point);
+    } else {
+        t->binary_op(in0, in1, out, size);
+    }
+}
+
+static void binary_op_rows(void *arg, int start, int end)
+{
+    struct binary_op_task *t = arg;
+    int32_t dim_count = t->dim_count;
+    int32_t len = t->out_dim[dim_count - 1];
+    int32_t chunk = (len + t->parts - 1) / t->parts;
+    int32_t idx[MAX_DIM];
+
+    for (int u = start; u < end; u++) {
+        int row = u / t->parts;
+        int32_t begin = (u % t->parts) * chunk;
+        int32_t size = len - begin < chunk ? len - begin : chunk;
+        if (size <= 0) {
+            continue;
+        }
+        idx[dim_count - 1] = 0;
+        for (int i = dim_count - 2; i >= 0; i--) {
+            idx[i] = row % t->out_dim[i];
+            row /= t->out_dim[i];
+        }
+        int64_t in0_off = broadcast_get_index(t->in0_dim, idx, dim_count);
+        int64_t in1_off = broadcast_get_index(t->in1_dim, idx, dim_count);
+        int64_t out_off = broadcast_get_index(t->out_dim, idx, dim_count) + begin;
+        if (t->in0_dim[dim_count - 1] != 1) {
+            in0_off += begin;
+        }
+        if (t->in1_dim[dim_count - 1] != 1) {
+            in1_off += begin;
+        }
+        binary_op_call(t, t->input0 + in0_off * t->elem_size, t->input1 + in1_off * t->elem_size,
+                       t->output + out_off * t->elem_size, size);
+    }
+}
+
+/* rows of the last dimension go to the threads, long rows are cut when rows are few */
+static void binary_op_broadcast_run(struct binary_op_task *t)
+{
+    int32_t len = t->out_dim[t->dim_count - 1];
+    int64_t total = 1;
+    for (int i = 0; i < t->dim_count; i++) {
+        total *= t->out_dim[i];
+    }
+    if (total == 0) {
+        return;
+    }
+    int rows = total / len;
+    int split = shl_rvv_parallel_split(total);
+    t->parts = rows < split ? (split + rows - 1) / rows : 1;
+    shl_rvv_parallel_for(rows * t->parts, total, binary_op_rows, t);
+}
+
+static void binary_op_flat(void *arg, int start, int end)
+{
+    struct binary_op_task *t = arg;
+    for (int i = start; i < end; i++) {
+        int64_t begin = i * t->chunk;
+        int64_t size = t->size - begin < t->chunk ? t->size - begin : t->chunk;
+        int8_t *in0 = t->input0;
+        int8_t *in1 = t->input1;
+        if (t->mode != CSINN_BROADCAST_SV) {
+            in0 += begin * t->elem_size;
+        }
+        if (t->mode != CSINN_BROADCAST_VS) {
+            in1 += begin * t->elem_size;
+        }
+        binary_op_call(t, in0, in1, t->output + begin * t->elem_size, size);
+    }
+}
+
+/*
+ * Elementwise (VV) or single-scalar (VS/SV) binary op over flat data, cut into
+ * contiguous chunks over the threads. scale/zero_point are only passed to the
+ * quantized callbacks.
+ */
+void shl_rvv_binary_op_flat(void *input0, void *input1, void *output, int64_t size,
+                            int elem_size, int mode, void *binary_op, float *scale,
+                            int32_t *zero_point)
+{
+    if (size <= 0) {
+        return;
+    }
+    struct binary_op_task t = {0};
+    t.binary_op = binary_op;
+    t.input0 = input0;
+    t.input1 = input1;
+    t.output = output;
+    t.elem_size = elem_size;
+    t.scale = scale;
+    t.zero_point = zero_point;
+    t.size = size;
+    t.mode = mode;
+    int parts = shl_rvv_parallel_split(size);
+    /* keep the chunks cache line aligned */
+    t.chunk = ((size + parts - 1) / parts + 63) / 64 * 64;
+    shl_rvv_parallel_for((size + t.chunk - 1) / t.chunk, size, binary_op_flat, &t);
+}
+
 static int layout_try_ndarray_to_nc1xc0(struct csinn_tensor *t, int packn)
 {
     if (t->layout >= CSINN_LAYOUT_NC && t->layout <= CSINN_LAYOUT_NCDHW) {
@@ -354,10 +481,6 @@ int shl_rvv_binary_op_broadcast_fp32(struct csinn_tensor *input0, struct csinn_t
     int32_t *out_dim = output->dim;
     int32_t dim_count = output->dim_count;
 
-    // Mark an index that traverses each dimension.
-    int32_t *idx = (int32_t *)shl_mem_alloc(dim_count * sizeof(int32_t));
-    int cur = 0;
-
     void (*binary_op)();
     if (in0_dim[dim_count - 1] == in1_dim[dim_count - 1]) {
         binary_op = binary_op_callback[CSINN_BROADCAST_VV];
@@ -367,34 +490,18 @@ int shl_rvv_binary_op_broadcast_fp32(struct csinn_tensor *input0, struct csinn_t
         binary_op = binary_op_callback[CSINN_BROADCAST_SV];
     }
 
-    // Work like a stack, "push" the higher dimension until reach the last dimension,
-    // "pop" when done traversing current dimension.
-    while (idx[0] < out_dim[0]) {
-        if (cur == dim_count - 1) {
-            // Do broadcast in the last dimension
-            float *in0_ptr = input0_data + broadcast_get_index(in0_dim, idx, dim_count);
-            float *in1_ptr = input1_data + broadcast_get_index(in1_dim, idx, dim_count);
-            float *out_ptr = output_data + broadcast_get_index(out_dim, idx, dim_count);
-            binary_op(in0_ptr, in1_ptr, out_ptr, out_dim[cur]);
-            if (cur == 0) {
-                break;
-            }
-            cur -= 1;
-            idx[cur] += 1;
-        } else {
-            // If the current index is less than the current dim size, traverse the next dimension;
-            // Otherwise, set the index to 0, and return to the previous dimension.
-            if (idx[cur] < out_dim[cur]) {
-                cur += 1;
-            } else {
-                idx[cur] = 0;
-                cur -= 1;
-                idx[cur] += 1;
-            }
-        }
-    }
+    struct binary_op_task task = {0};
+    task.binary_op = binary_op;
+    task.input0 = (int8_t *)input0_data;
+    task.input1 = (int8_t *)input1_data;
+    task.output = (int8_t *)output_data;
+    task.elem_size = sizeof(float);
+    task.in0_dim = in0_dim;
+    task.in1_dim = in1_dim;
+    task.out_dim = out_dim;
+    task.dim_count = dim_count;
+    binary_op_broadcast_run(&task);
 
-    shl_mem_free(idx);
     if (in1_extra_flag) {
         shl_mem_free(in1_extra->data);
         csinn_free_tensor(in1_extra);
@@ -460,9 +567,6 @@ int shl_rvv_binary_op_broadcast_fp16(struct csinn_tensor *input0, struct csinn_t
     int32_t *out_dim = output->dim;
     int32_t dim_count = output->dim_count;
 
-    int32_t *idx = (int32_t *)shl_mem_alloc(dim_count * sizeof(int32_t));
-    int cur = 0;
-
     void (*binary_op)();
     if (in0_dim[dim_count - 1] == in1_dim[dim_count - 1]) {
         binary_op = binary_op_callback[CSINN_BROADCAST_VV];
@@ -472,29 +576,18 @@ int shl_rvv_binary_op_broadcast_fp16(struct csinn_tensor *input0, struct csinn_t
         binary_op = binary_op_callback[CSINN_BROADCAST_SV];
     }
 
-    while (idx[0] < out_dim[0]) {
-        if (cur == dim_count - 1) {
-            __fp16 *in0_ptr = input0_data + broadcast_get_index(in0_dim, idx, dim_count);
-            __fp16 *in1_ptr = input1_data + broadcast_get_index(in1_dim, idx, dim_count);
-            __fp16 *out_ptr = output_data + broadcast_get_index(out_dim, idx, dim_count);
-            binary_op(in0_ptr, in1_ptr, out_ptr, out_dim[cur]);
-            if (cur == 0) {
-                break;
-            }
-            cur -= 1;
-            idx[cur] += 1;
-        } else {
-            if (idx[cur] < out_dim[cur]) {
-                cur += 1;
-            } else {
-                idx[cur] = 0;
-                cur -= 1;
-                idx[cur] += 1;
-            }
-        }
-    }
+    struct binary_op_task task = {0};
+    task.binary_op = binary_op;
+    task.input0 = (int8_t *)input0_data;
+    task.input1 = (int8_t *)input1_data;
+    task.output = (int8_t *)output_data;
+    task.elem_size = sizeof(__fp16);
+    task.in0_dim = in0_dim;
+    task.in1_dim = in1_dim;
+    task.out_dim = out_dim;
+    task.dim_count = dim_count;
+    binary_op_broadcast_run(&task);
 
-    shl_mem_free(idx);
     if (in1_extra_flag) {
         shl_mem_free(in1_extra->data);
         csinn_free_tensor(in1_extra);
@@ -560,9 +653,6 @@ int shl_rvv_binary_op_broadcast_int8(struct csinn_tensor *input0, struct csinn_t
     int32_t *out_dim = output->dim;
     int32_t dim_count = output->dim_count;
 
-    int32_t *idx = (int32_t *)shl_mem_alloc(dim_count * sizeof(int32_t));
-    int cur = 0;
-
     void (*binary_op)();
     if (in0_dim[dim_count - 1] == in1_dim[dim_count - 1]) {
         binary_op = binary_op_callback[CSINN_BROADCAST_VV];
@@ -576,29 +666,20 @@ int shl_rvv_binary_op_broadcast_int8(struct csinn_tensor *input0, struct csinn_t
     int32_t zero_point[3] = {input0->qinfo->zero_point, input1->qinfo->zero_point,
                              output->qinfo->zero_point};
 
-    while (idx[0] < out_dim[0]) {
-        if (cur == dim_count - 1) {
-            int8_t *in0_ptr = input0_data + broadcast_get_index(in0_dim, idx, dim_count);
-            int8_t *in1_ptr = input1_data + broadcast_get_index(in1_dim, idx, dim_count);
-            int8_t *out_ptr = output_data + broadcast_get_index(out_dim, idx, dim_count);
-            binary_op(in0_ptr, in1_ptr, out_ptr, out_dim[cur], scale, zero_point);
-            if (cur == 0) {
-                break;
-            }
-            cur -= 1;
-            idx[cur] += 1;
-        } else {
-            if (idx[cur] < out_dim[cur]) {
-                cur += 1;
-            } else {
-                idx[cur] = 0;
-                cur -= 1;
-                idx[cur] += 1;
-            }
-        }
-    }
+    struct binary_op_task task = {0};
+    task.binary_op = binary_op;
+    task.input0 = (int8_t *)input0_data;
+    task.input1 = (int8_t *)input1_data;
+    task.output = (int8_t *)output_data;
+    task.elem_size = sizeof(int8_t);
+    task.scale = scale;
+    task.zero_point = zero_point;
+    task.in0_dim = in0_dim;
+    task.in1_dim = in1_dim;
+    task.out_dim = out_dim;
+    task.dim_count = dim_count;
+    binary_op_broadcast_run(&task);
 
-    shl_mem_free(idx);
     if (in1_extra_flag) {
         shl_mem_free(in1_extra->data);
         csinn_free_tensor(in1_extra);
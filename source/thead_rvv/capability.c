@@ -179,6 +179,12 @@ int shl_rvv_deconv2d_cap(struct csinn_tensor *input, struct csinn_tensor *output
         return CSINN_OPT_INTRINSIC;
     } else if (input->dtype == CSINN_DTYPE_FLOAT16) {
         return CSINN_OPT_INTRINSIC;
+    } else if (input->dtype == CSINN_DTYPE_INT8 || input->dtype == CSINN_DTYPE_INT4) {
+        /* per input channel weight scales run on the reference */
+        if (kernel->quant_channel > 1 || params->base.layout != CSINN_LAYOUT_NCHW) {
+            return CSINN_OPT_C_REFERENCE;
+        }
+        return CSINN_OPT_INTRINSIC;
     } else {
         return CSINN_OPT_UNSUPPORTED;
     }
@@ -745,6 +751,28 @@ int shl_rvv_scaled_dot_product_attention_cap(struct csinn_tensor *query, struct
     return float_all_support(query, &(params->base));
 }
 
+int shl_rvv_fsmn_cap(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                     struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                     struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                     struct csinn_fsmn_params *params)
+{
+    return float_all_support(frame, &(params->base));
+}
+
+int shl_rvv_cache_matmul_cap(struct csinn_tensor *input, struct csinn_tensor *output,
+                             struct csinn_tensor *weight, struct csinn_tensor *bias,
+                             struct csinn_cache_matmul_params *params)
+{
+    return float_all_support(input, &(params->base));
+}
+
+int shl_rvv_cache_conv1d_cap(struct csinn_tensor *input, struct csinn_tensor *output,
+                             struct csinn_tensor *weight, struct csinn_tensor *bias,
+                             struct csinn_cache_conv1d_params *params)
+{
+    return float_all_support(input, &(params->base));
+}
+
 int shl_rvv_llm_pos_cap(struct csinn_tensor *input, struct csinn_tensor *output,
                         struct csinn_llm_pos_params *params)
 {
@@ -107,13 +107,23 @@ static void avgpool_border_fp16_nhwc(const __fp16 *src, __fp16 *dst,
     }
 }
 
-int shl_rvv_avgpool_nhwc_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                              struct csinn_pool_params *params)
+/* border / center / border location of the output rows above, inside and below the input */
+static const enum avgpool_loc_enum avgpool_nhwc_loc[3][3] = {
+    {AVGPOOL_LEFT_TOP, AVGPOOL_TOP, AVGPOOL_RIGHT_TOP},
+    {AVGPOOL_LEFT, AVGPOOL_CENTER, AVGPOOL_RIGHT},
+    {AVGPOOL_LEFT_BOTTOM, AVGPOOL_BOTTOM, AVGPOOL_RIGHT_BOTTOM},
+};
+
+static void avgpool_nhwc_fp16_rows(void *arg, int start, int end)
 {
+    struct shl_rvv_pool_task *t = (struct shl_rvv_pool_task *)arg;
+    struct csinn_tensor *input = t->input;
+    struct csinn_tensor *output = t->output;
+    struct csinn_pool_params *params = t->params;
+
     __fp16 *input_data = (__fp16 *)input->data;
     __fp16 *output_data = (__fp16 *)output->data;
 
-    int batch = input->dim[0];
     int in_h = input->dim[1];
     int in_w = input->dim[2];
     int in_c = input->dim[3];
@@ -135,70 +145,40 @@ int shl_rvv_avgpool_nhwc_fp16(struct csinn_tensor *input, struct csinn_tensor *o
     int dst_1x8_start_w = max((pad_left + stride_w - 1) / stride_w, 0);
     int dst_1x8_end_w = min((in_w + pad_left - kernel_w) / stride_w + 1, out_w);
 
-    for (int b = 0; b < batch; b++) {
+    for (int r = start; r < end; r++) {
+        int b = r / out_h;
+        int oh = r % out_h;
         const __fp16 *in_ptr = input_data + b * in_h * in_w * in_c;
         __fp16 *out_ptr = output_data + b * out_h * out_w * out_c;
-
-        int oh = 0;
-        for (; oh < dst_start_h; oh++) {
-            int in_h_start = -pad_top + oh * stride_h;
-            int in_h_end = in_h_start + kernel_h;
-            const int idx_h_start = max(in_h_start, 0);
-            const int idx_h_end = min(in_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_LEFT_TOP);
-            }
-            for (; ow + 7 < dst_1x8_end_w; ow += 8) {
-                avgpool_w8_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
-                                     out_w, in_c, AVGPOOL_TOP);
-            }
-            for (; ow < out_w; ow++) {
-                avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_RIGHT_TOP);
-            }
+        const enum avgpool_loc_enum *loc =
+            avgpool_nhwc_loc[oh < dst_start_h ? 0 : (oh < dst_end_h ? 1 : 2)];
+
+        int in_h_start = -pad_top + oh * stride_h;
+        int in_h_end = in_h_start + kernel_h;
+        const int idx_h_start = max(in_h_start, 0);
+        const int idx_h_end = min(in_h_end, in_h);
+        int ow = 0;
+        for (; ow < dst_1x8_start_w; ow++) {
+            avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                     out_w, in_c, loc[0]);
         }
-        for (; oh < dst_end_h; oh++) {
-            int in_h_start = -pad_top + oh * stride_h;
-            int in_h_end = in_h_start + kernel_h;
-            const int idx_h_start = max(in_h_start, 0);
-            const int idx_h_end = min(in_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_LEFT);
-            }
-            for (; ow + 7 < dst_1x8_end_w; ow += 8) {
-                avgpool_w8_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
-                                     out_w, in_c, AVGPOOL_CENTER);
-            }
-            for (; ow < out_w; ow++) {
-                avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_RIGHT);
-            }
+        for (; ow + 7 < dst_1x8_end_w; ow += 8) {
+            avgpool_w8_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                 out_w, in_c, loc[1]);
         }
-        for (; oh < out_h; oh++) {
-            int in_h_start = -pad_top + oh * stride_h;
-            int in_h_end = in_h_start + kernel_h;
-            const int idx_h_start = max(in_h_start, 0);
-            const int idx_h_end = min(in_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_LEFT_BOTTOM);
-            }
-            for (; ow + 7 < dst_1x8_end_w; ow += 8) {
-                avgpool_w8_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
-                                     out_w, in_c, AVGPOOL_BOTTOM);
-            }
-            for (; ow < out_w; ow++) {
-                avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_RIGHT_BOTTOM);
-            }
+        for (; ow < out_w; ow++) {
+            avgpool_border_fp16_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                     out_w, in_c, loc[2]);
         }
     }
-    // requantize
-    shl_rvv_siso_op_requantize_fp16(input, output);
+}
+
+/* output rows of all batches are independent, split them over the threads */
+int shl_rvv_avgpool_nhwc_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
+{
+    struct shl_rvv_pool_task task = {input, output, params};
+    shl_rvv_parallel_for(input->dim[0] * output->dim[1], csinn_tensor_size(input),
+                         avgpool_nhwc_fp16_rows, &task);
     return CSINN_TRUE;
 }
@@ -102,8 +102,8 @@ static void avgpool_border_fp16_packn(const __fp16 *src, __fp16 *dst,
     vse16_v_f16m1(out_ptr, vfmul_vf_f16m1(_acc, ratio, vl), vl);
 }
 
-int shl_rvv_avgpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                               struct csinn_pool_params *params)
+static int avgpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp16(input);
@@ -208,3 +208,9 @@ int shl_rvv_avgpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *
     shl_rvv_siso_op_requantize_fp16(input, output);
     return CSINN_TRUE;
 }
+
+int shl_rvv_avgpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool_packn_fp16);
+}
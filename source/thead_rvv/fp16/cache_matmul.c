@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+int shl_rvv_cache_matmul_init_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *weight, struct csinn_tensor *bias,
+                                   struct csinn_cache_matmul_params *params)
+{
+    size_t data_size =
+        params->shape[0] * params->shape[1] * params->shape[2] * params->shape[3] * sizeof(__fp16);
+    asr_buffer_init(&params->asr_buffer, data_size);
+
+    struct csinn_session *sess = params->base.sess;
+    bool binary_model_op_init = shl_rvv_get_binary_model_op_init(sess);
+    if (!binary_model_op_init) {
+        /* weight data is [output_depth, accum_depth] */
+        struct csinn_tensor weight_nk = *weight;
+        weight_nk.dim[0] = weight->dim[1];
+        weight_nk.dim[1] = weight->dim[0];
+        shl_rvv_fc_gemm_reorder_weight_fp16(&weight_nk);
+    }
+    params->base.cb->exec = shl_rvv_cache_matmul_fp16;
+    return CSINN_TRUE;
+}
+
+/*************************************************************
+ * Insert the new frame into the asr ring buffer and write the whole
+ * cached window to output with reshape & transpose.
+ * transpose can only be 0,2,3,1 or 0,2,1,3
+ ************************************************************/
+void shl_rvv_cache_matmul_push_fp16(__fp16 *frame, int frame_size, __fp16 *bias_data,
+                                    struct csinn_tensor *output,
+                                    struct csinn_cache_matmul_params *params)
+{
+    struct csinn_asr_buffer_t *asr_buffer = &params->asr_buffer;
+    __fp16 *output_data = (__fp16 *)output->data;
+    int32_t *shape = output->dim;
+
+    __fp16 judge =
+        bias_data[0] + bias_data[1] + bias_data[2] + bias_data[3] + bias_data[4] + bias_data[5];
+    if (fabs(judge) < 0.01) {
+        asr_buffer_insert_front(asr_buffer, frame, frame_size * sizeof(__fp16));
+    } else {
+        asr_buffer_insert_back(asr_buffer, frame, frame_size * sizeof(__fp16));
+    }
+
+    if (params->axes[2] == 3) {
+        // 0,2,3,1
+        int batch = shape[3];
+        int flatten_shape = shape[1] * shape[2];
+        for (int i = 0; i < batch; i++) {
+            int j = 0;
+            while (j < flatten_shape) {
+                size_t contig;
+                __fp16 *in_ptr = (__fp16 *)asr_buffer_get_data(
+                    asr_buffer, (i * flatten_shape + j) * sizeof(__fp16), &contig);
+                int size = contig / sizeof(__fp16);
+                size = size < flatten_shape - j ? size : flatten_shape - j;
+                while (size > 0) {
+                    int vl = vsetvl_e16m4(size);
+                    vfloat16m4_t _in = vle16_v_f16m4(in_ptr, vl);
+                    vsse16_v_f16m4(output_data + j * batch + i, batch * sizeof(__fp16), _in, vl);
+                    in_ptr += vl;
+                    j += vl;
+                    size -= vl;
+                }
+            }
+        }
+    } else {
+        // 0,2,1,3
+        int batch = shape[2];
+        int shape3 = shape[3];
+        int flatten_shape = shape[1] * shape[3];
+        for (int i = 0; i < batch; i++) {
+            int j = 0;
+            while (j < flatten_shape) {
+                size_t contig;
+                __fp16 *in_ptr = (__fp16 *)asr_buffer_get_data(
+                    asr_buffer, (i * flatten_shape + j) * sizeof(__fp16), &contig);
+                int size = contig / sizeof(__fp16);
+                size = size < shape3 - j % shape3 ? size : shape3 - j % shape3;
+                int out_pos = i * shape3 + j % shape3 + batch * shape3 * (j / shape3);
+                memcpy(output_data + out_pos, in_ptr, size * sizeof(__fp16));
+                j += size;
+            }
+        }
+    }
+}
+
+int shl_rvv_cache_matmul_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_matmul_params *params)
+{
+    __fp16 *input_data = (__fp16 *)input->data;
+    __fp16 *output_data = (__fp16 *)output->data;
+    __fp16 *weight_data = (__fp16 *)weight->data;
+    __fp16 *bias_data = (__fp16 *)bias->data;
+
+    int m = input->dim[1];   // batches
+    int k = weight->dim[0];  // accum_depth
+    int n = weight->dim[1];  // output_depth
+
+    /* the new frame is staged in output, then overwritten by the cached window */
+    __fp16 *input_reorder = (__fp16 *)shl_mem_alloc(m * k * sizeof(__fp16));
+    shl_rvv_reorder_a_block_12xk_fp16(input_data, input_reorder, m, k, m, k);
+    shl_rvv_gemm_a0b1_12xpack2n_fp16(output_data, input_reorder, weight_data, bias_data, m, k, n);
+
+    shl_rvv_cache_matmul_push_fp16(output_data, m * n, bias_data, output, params);
+
+    shl_mem_free(input_reorder);
+    // requantize
+    shl_rvv_sidcso_op_requantize_fp16(input, output, weight);
+    return CSINN_TRUE;
+}
@@ -46,7 +46,7 @@ int shl_rvv_common_conv1x1_gemm_fp16(struct csinn_tensor *input, struct csinn_te
     __fp16 *bias_data = (__fp16 *)bias->data;
 
     int32_t group = params->group;
-    int32_t batch = input->dim[0];  // assert(batch == 1);
+    int32_t batch = input->dim[0];
     int32_t in_ch = input->dim[1];
     int32_t out_ch = kernel->dim[0];
     int32_t out_h = output->dim[2];
@@ -55,6 +55,8 @@ int shl_rvv_common_conv1x1_gemm_fp16(struct csinn_tensor *input, struct csinn_te
     int32_t m = out_ch / group;
     int32_t k = in_ch / group;
     int32_t n = out_h * out_w;
+    // batch is folded into the gemm column dimension, kernel panels are streamed once per group
+    int32_t bn = batch * n;
 
     __fp16 *kernel_fp16 = NULL;
     if (kernel->is_const && kernel->dtype == CSINN_DTYPE_INT8) {
@@ -76,23 +78,40 @@ int shl_rvv_common_conv1x1_gemm_fp16(struct csinn_tensor *input, struct csinn_te
         return CSINN_FALSE;
     }
 
-    __fp16 *pb_reorder = (__fp16 *)shl_mem_alloc(k * n * sizeof(__fp16));
+    __fp16 *pb_reorder = (__fp16 *)shl_mem_alloc(k * bn * sizeof(__fp16));
+    __fp16 *in_fold = NULL;
+    __fp16 *out_fold = NULL;
+    if (batch > 1) {
+        in_fold = (__fp16 *)shl_mem_alloc(k * bn * sizeof(__fp16));
+        out_fold = (__fp16 *)shl_mem_alloc(m * bn * sizeof(__fp16));
+    }
 
-    for (int i = 0; i < batch; i++) {
-        for (int g = 0; g < group; g++) {
-            __fp16 *pa = kernel_data + g * m * k;
-            __fp16 *pb = pb_reorder;
-            __fp16 *pc = output_data;
+    for (int g = 0; g < group; g++) {
+        __fp16 *pa = kernel_data + g * m * k;
+        __fp16 *pb = pb_reorder;
+        __fp16 *in_ptr = input_data + g * k * n;
+        __fp16 *pc = output_data + g * m * n;
 
-            // pack
-            reorder_input(input_data, pb, k, n, n);
-            // GEMM
-            gemm(pc, pa, pb, bias_data + g * m, m, k, n, n);
+        if (batch > 1) {
+            shl_rvv_batch_fold(in_fold, in_ptr, batch, k, n * sizeof(__fp16),
+                               in_ch * n * sizeof(__fp16));
+            in_ptr = in_fold;
+            pc = out_fold;
+        }
+        // pack
+        reorder_input(in_ptr, pb, k, bn, bn);
+        // GEMM
+        gemm(pc, pa, pb, bias_data + g * m, m, k, bn, bn);
 
-            input_data += k * n;
-            output_data += m * n;
+        if (batch > 1) {
+            shl_rvv_batch_unfold(output_data + g * m * n, out_fold, batch, m, n * sizeof(__fp16),
+                                 out_ch * n * sizeof(__fp16));
         }
     }
+    if (batch > 1) {
+        shl_mem_free(in_fold);
+        shl_mem_free(out_fold);
+    }
     shl_mem_free(pb_reorder);
     if (kernel->is_const && kernel->dtype == CSINN_DTYPE_INT8) {
         shl_mem_free(kernel_fp16);
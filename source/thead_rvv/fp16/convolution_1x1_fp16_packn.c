@@ -53,7 +53,7 @@ int shl_rvv_common_conv1x1_gemm_packn_fp16(struct csinn_tensor *input, struct cs
     __fp16 *bias_data = (__fp16 *)bias->data;
 
     int32_t group = params->group;
-    int32_t batch = input->dim[0];  // assert(batch == 1);
+    int32_t batch = input->dim[0];
     int32_t in_ch = input->dim[1] * input->dim[4];
     int32_t out_ch = kernel->dim[0];
     int32_t out_h = output->dim[2];
@@ -62,6 +62,8 @@ int shl_rvv_common_conv1x1_gemm_packn_fp16(struct csinn_tensor *input, struct cs
     int32_t m = out_ch / group;
     int32_t k = in_ch / group;
     int32_t n = out_h * out_w;
+    // batch is folded into the gemm column dimension, kernel panels are streamed once per group
+    int32_t bn = batch * n;
 
     __fp16 *kernel_fp16 = NULL;
     if (kernel->is_const && kernel->dtype == CSINN_DTYPE_INT8) {
@@ -84,24 +86,42 @@ int shl_rvv_common_conv1x1_gemm_packn_fp16(struct csinn_tensor *input, struct cs
         return CSINN_FALSE;
     }
 
-    __fp16 *pb_reorder = (__fp16 *)shl_mem_alloc(k * n * sizeof(__fp16));
+    const int packn = csrr_vlenb() / sizeof(__fp16);
+    __fp16 *pb_reorder = (__fp16 *)shl_mem_alloc(k * bn * sizeof(__fp16));
+    __fp16 *in_fold = NULL;
+    __fp16 *out_fold = NULL;
+    if (batch > 1) {
+        in_fold = (__fp16 *)shl_mem_alloc(k * bn * sizeof(__fp16));
+        out_fold = (__fp16 *)shl_mem_alloc(m * bn * sizeof(__fp16));
+    }
 
-    for (int i = 0; i < batch; i++) {
-        for (int g = 0; g < group; g++) {
-            __fp16 *kernel_ptr = kernel_data + g * m * k;
-            __fp16 *in_ptr = pb_reorder;
-            __fp16 *out_ptr = output_data;
-            __fp16 *bias_ptr = bias_data ? (bias_data + g * m) : NULL;
+    for (int g = 0; g < group; g++) {
+        __fp16 *kernel_ptr = kernel_data + g * m * k;
+        __fp16 *in_ptr = input_data + g * k * n;
+        __fp16 *out_ptr = output_data + g * m * n;
+        __fp16 *bias_ptr = bias_data ? (bias_data + g * m) : NULL;
 
-            // pack
-            reorder_input(input_data, in_ptr, k, n, n);
-            // GEMM
-            gemm(out_ptr, kernel_ptr, in_ptr, bias_ptr, m, k, n, false);
+        if (batch > 1) {
+            // [k/packn, n, packn] per sample -> [k/packn, batch * n, packn]
+            shl_rvv_batch_fold(in_fold, in_ptr, batch, k / packn, n * packn * sizeof(__fp16),
+                               in_ch * n * sizeof(__fp16));
+            in_ptr = in_fold;
+            out_ptr = out_fold;
+        }
+        // pack
+        reorder_input(in_ptr, pb_reorder, k, bn, bn);
+        // GEMM
+        gemm(out_ptr, kernel_ptr, pb_reorder, bias_ptr, m, k, bn, false);
 
-            input_data += k * n;
-            output_data += m * n;
+        if (batch > 1) {
+            shl_rvv_batch_unfold(output_data + g * m * n, out_fold, batch, m / packn,
+                                 n * packn * sizeof(__fp16), out_ch * n * sizeof(__fp16));
         }
     }
+    if (batch > 1) {
+        shl_mem_free(in_fold);
+        shl_mem_free(out_fold);
+    }
     shl_mem_free(pb_reorder);
     if (kernel->is_const && kernel->dtype == CSINN_DTYPE_INT8) {
         shl_mem_free(kernel_fp16);
@@ -177,6 +177,8 @@ int shl_rvv_common_conv_gemm_fp16(struct csinn_tensor *input, struct csinn_tenso
     int32_t m = out_ch / group;
     int32_t k = in_ch / group * ksize_h * ksize_w;
     int32_t n = out_height * out_width;
+    // batch is folded into the gemm column dimension, kernel panels are streamed once per group
+    int32_t bn = batch * n;
 
     __fp16 *kernel_fp16 = NULL;
     if (kernel->is_const && kernel->dtype == CSINN_DTYPE_INT8) {
@@ -198,14 +200,19 @@ int shl_rvv_common_conv_gemm_fp16(struct csinn_tensor *input, struct csinn_tenso
         return CSINN_FALSE;
     }
 
-    __fp16 *im2col_data = (__fp16 *)shl_mem_alloc(k * n * sizeof(__fp16));
-    __fp16 *pb_reorder = (__fp16 *)shl_mem_alloc(k * n * sizeof(__fp16));
+    __fp16 *im2col_data = (__fp16 *)shl_mem_alloc(k * bn * sizeof(__fp16));
+    __fp16 *pb_reorder = (__fp16 *)shl_mem_alloc(k * bn * sizeof(__fp16));
+    __fp16 *out_fold = NULL;
+    if (batch > 1) {
+        out_fold = (__fp16 *)shl_mem_alloc(m * bn * sizeof(__fp16));
+    }
 
-    for (int i = 0; i < batch; i++) {
-        for (int g = 0; g < group; g++) {
-            // im2col
-            __fp16 *data_col = im2col_data;
-            __fp16 *channel_data = input_data;
+    for (int g = 0; g < group; g++) {
+        // im2col, samples are placed side by side: [k, batch * n]
+        for (int i = 0; i < batch; i++) {
+            __fp16 *data_col = im2col_data + i * n;
+            __fp16 *channel_data =
+                input_data + (i * group + g) * (in_ch / group) * in_height * in_width;
             for (int c = 0; c < in_ch / group; c++) {
                 for (int kh = 0; kh < ksize_h; kh++) {
                     for (int kw = 0; kw < ksize_w; kw++) {
@@ -218,7 +225,6 @@ int shl_rvv_common_conv_gemm_fp16(struct csinn_tensor *input, struct csinn_tenso
                             } else {
                                 int in_col = -pad_left + kw * dilation_w;
                                 for (int ow1 = 0; ow1 < out_width; ow1++) {
-                                    int col_idx = (c * out_height + oh) * out_width + ow1;
                                     if (in_col < in_width && in_col >= 0) {
                                         *data_col++ = channel_data[in_row * in_width + in_col];
                                     } else {
@@ -229,24 +235,30 @@ int shl_rvv_common_conv_gemm_fp16(struct csinn_tensor *input, struct csinn_tenso
                             }
                             in_row += stride_h;
                         }
+                        data_col += bn - n;
                     }
                 }
                 channel_data += in_height * in_width;
             }
+        }
 
-            __fp16 *pa = kernel_data + g * m * k;
-            __fp16 *pb = pb_reorder;
-            __fp16 *pc = output_data;
+        __fp16 *pa = kernel_data + g * m * k;
+        __fp16 *pb = pb_reorder;
+        __fp16 *pc = batch > 1 ? out_fold : output_data + g * m * n;
 
-            // pack
-            reorder_input(im2col_data, pb, k, n, n);
-            // GEMM
-            gemm(pc, pa, pb, bias_data + g * m, m, k, n, n);
+        // pack
+        reorder_input(im2col_data, pb, k, bn, bn);
+        // GEMM
+        gemm(pc, pa, pb, bias_data + g * m, m, k, bn, bn);
 
-            input_data += in_ch / group * in_height * in_width;
-            output_data += m * n;
+        if (batch > 1) {
+            shl_rvv_batch_unfold(output_data + g * m * n, out_fold, batch, m, n * sizeof(__fp16),
+                                 out_ch * n * sizeof(__fp16));
         }
     }
+    if (batch > 1) {
+        shl_mem_free(out_fold);
+    }
     shl_mem_free(pb_reorder);
     shl_mem_free(im2col_data);
     if (kernel->is_const && kernel->dtype == CSINN_DTYPE_INT8) {
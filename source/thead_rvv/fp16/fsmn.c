@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+/*************************************************************
+ * frame_sequence: [len_order, length] ring of frames, the new frame
+ * overwrites the oldest row, no frame is moved.
+ * output[l] = sum_k(l_filter * past) + current + sum_m(r_filter * future)
+ ************************************************************/
+int shl_rvv_fsmn_fp16(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                      struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                      struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                      struct csinn_fsmn_params *params)
+{
+    __fp16 *past_filter = (__fp16 *)l_filter->data;
+    __fp16 *future_filter = (__fp16 *)r_filter->data;
+    __fp16 *sequence_frame = (__fp16 *)frame_sequence->data;
+    __fp16 *output_data = (__fp16 *)output->data;
+
+    int len_order = frame_sequence->dim[0];
+    int length = frame_sequence->dim[1];
+    int l_order = params->l_order;
+    int r_order = params->r_order;
+
+    int head = shl_ref_fsmn_push_frame(frame, frame_sequence, frame_counter, params);
+    int cur_row = (head + (l_order - 1) * params->l_stride) % len_order;
+    int future_row = head + l_order * params->l_stride;
+
+    int i = 0;
+    while (i < length) {
+        int vl = vsetvl_e16m4(length - i);
+        vfloat16m4_t _acc = vle16_v_f16m4(sequence_frame + cur_row * length + i, vl);
+        // past frame
+        for (int k = 0; k < l_order; k++) {
+            int row = (head + k * params->l_stride) % len_order;
+            vfloat16m4_t _in = vle16_v_f16m4(sequence_frame + row * length + i, vl);
+            vfloat16m4_t _w = vle16_v_f16m4(past_filter + (l_order - k - 1) * length + i, vl);
+            _acc = vfmacc_vv_f16m4(_acc, _in, _w, vl);
+        }
+        // future frame
+        for (int m = 0; m < r_order; m++) {
+            int row = (future_row + m * params->r_stride) % len_order;
+            vfloat16m4_t _in = vle16_v_f16m4(sequence_frame + row * length + i, vl);
+            vfloat16m4_t _w = vle16_v_f16m4(future_filter + m * length + i, vl);
+            _acc = vfmacc_vv_f16m4(_acc, _in, _w, vl);
+        }
+        vse16_v_f16m4(output_data + i, _acc, vl);
+        i += vl;
+    }
+
+    return CSINN_TRUE;
+}
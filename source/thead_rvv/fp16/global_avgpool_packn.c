@@ -18,8 +18,8 @@
 
 #include "rvv/rvv.h"
 
-int shl_rvv_global_avgpool2d_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                                        struct csinn_pool_params *params)
+static int global_avgpool2d_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                       struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp16(input);
@@ -72,3 +72,9 @@ int shl_rvv_global_avgpool2d_packn_fp16(struct csinn_tensor *input, struct csinn
     shl_rvv_siso_op_requantize_fp16(input, output);
     return CSINN_TRUE;
 }
+
+int shl_rvv_global_avgpool2d_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                        struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, global_avgpool2d_packn_fp16);
+}
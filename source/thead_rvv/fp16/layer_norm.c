@@ -21,44 +21,27 @@
 /*************************************************************
     note: support flexible vlen
 *************************************************************/
-int shl_rvv_layer_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                            struct csinn_tensor *gamma, struct csinn_tensor *beta,
-                            struct csinn_layer_norm_params *params)
-{
-    /* TODO: fp16 quantize */
-    if (fabs(input->qinfo->scale - 1) > FLT_EPSILON ||
-        fabs(gamma->qinfo->scale - 1) > FLT_EPSILON ||
-        fabs(output->qinfo->scale - 1) > FLT_EPSILON) {
-        shl_debug_error("unsupport fp16 quantization of layer_norm op\n");
-        return CSINN_FALSE;
-    }
+struct layer_norm_fp16_task {
+    __fp16 *input_data;
+    __fp16 *output_data;
+    __fp16 *gamma_data;
+    __fp16 *beta_data;
+    int32_t norm_size;
+    float epsilon;
+};
 
-    if (params->center == false || params->scale == false) {
-        shl_debug_error("Layer norm only support center & scale == true\n");
-        return CSINN_FALSE;
-    }
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(input);
-    }
-    __fp16 *input_data = (__fp16 *)input->data;
-    __fp16 *output_data = (__fp16 *)output->data;
-    __fp16 *gamma_data = (__fp16 *)gamma->data;
-    __fp16 *beta_data = (__fp16 *)beta->data;
-
-    /* support negative axis */
-    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
-
-    int32_t batches = 1;
-    for (int i = 0; i < axis; i++) {
-        batches *= input->dim[i];
-    }
-    int32_t norm_size = 1;
-    for (int i = axis; i < input->dim_count; i++) {
-        norm_size *= input->dim[i];
-    }
+/* rows are normalized independently, every thread keeps its own centered copy */
+static void layer_norm_fp16_rows(void *arg, int start, int end)
+{
+    struct layer_norm_fp16_task *t = (struct layer_norm_fp16_task *)arg;
+    __fp16 *input_data = t->input_data;
+    __fp16 *output_data = t->output_data;
+    __fp16 *gamma_data = t->gamma_data;
+    __fp16 *beta_data = t->beta_data;
+    int32_t norm_size = t->norm_size;
 
     __fp16 *tmp = (__fp16 *)shl_mem_alloc(norm_size * sizeof(__fp16));
-    for (int b = 0; b < batches; b++) {
+    for (int b = start; b < end; b++) {
         __fp16 *input_ptr = input_data + b * norm_size;
         __fp16 *output_ptr = output_data + b * norm_size;
 
@@ -93,7 +76,7 @@ int shl_rvv_layer_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *out
             size -= vl;
         }
         float var = vfmv_f_s_f32m1_f32(_sum2);
-        __fp16 std = sqrt(var + params->epsilon);
+        __fp16 std = sqrt(var + t->epsilon);
 
         __fp16 *g0 = gamma_data;
         __fp16 *b0 = beta_data;
@@ -115,6 +98,47 @@ int shl_rvv_layer_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *out
         }
     }
     shl_mem_free(tmp);
+}
+
+int shl_rvv_layer_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_tensor *gamma, struct csinn_tensor *beta,
+                            struct csinn_layer_norm_params *params)
+{
+    /* TODO: fp16 quantize */
+    if (fabs(input->qinfo->scale - 1) > FLT_EPSILON ||
+        fabs(gamma->qinfo->scale - 1) > FLT_EPSILON ||
+        fabs(output->qinfo->scale - 1) > FLT_EPSILON) {
+        shl_debug_error("unsupport fp16 quantization of layer_norm op\n");
+        return CSINN_FALSE;
+    }
+
+    if (params->center == false || params->scale == false) {
+        shl_debug_error("Layer norm only support center & scale == true\n");
+        return CSINN_FALSE;
+    }
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(input);
+    }
+    __fp16 *input_data = (__fp16 *)input->data;
+    __fp16 *output_data = (__fp16 *)output->data;
+    __fp16 *gamma_data = (__fp16 *)gamma->data;
+    __fp16 *beta_data = (__fp16 *)beta->data;
+
+    /* support negative axis */
+    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
+
+    int32_t batches = 1;
+    for (int i = 0; i < axis; i++) {
+        batches *= input->dim[i];
+    }
+    int32_t norm_size = 1;
+    for (int i = axis; i < input->dim_count; i++) {
+        norm_size *= input->dim[i];
+    }
+
+    struct layer_norm_fp16_task task = {input_data, output_data, gamma_data, beta_data, norm_size,
+                                        params->epsilon};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, layer_norm_fp16_rows, &task);
 
     return CSINN_TRUE;
 }
@@ -26,11 +26,15 @@ int shl_rvv_llm_pos_fp16(struct csinn_tensor *input, struct csinn_tensor *output
 
     int batch = params->bsz;
     int seqlen = params->seqlen;
-    int start_pos = params->pos[0];
+    int32_t *pos = params->pos;
     int inner_size = input->dim[2] * input->dim[3];
+    /* every sequence of the batch has its own positions pos[i * seqlen + j] and kv slot */
+    int32_t *slot = params->slot;
     if (params->mode == CSINN_LLM_POS_CACHE_COPY_IN) {
         for (int i = 0; i < batch; i++) {
-            int output_index = i * output->dim[1] * inner_size + start_pos * inner_size;
+            int start_pos = pos[i * seqlen];
+            int s = slot ? slot[i] : i;
+            int output_index = s * output->dim[1] * inner_size + start_pos * inner_size;
             int input_index = i * input->dim[1] * inner_size;
             int cpy_size = seqlen * inner_size * sizeof(__fp16);
 
@@ -38,22 +42,28 @@ int shl_rvv_llm_pos_fp16(struct csinn_tensor *input, struct csinn_tensor *output
             memcpy(output_data + output_index, input_data + input_index, cpy_size);
         }
     } else if (params->mode == CSINN_LLM_POS_CACHE_COPY_OUT) {
+        /* output is sized for the longest sequence, shorter ones are masked out later */
         for (int i = 0; i < batch; i++) {
+            int s = slot ? slot[i] : i;
             int output_index = i * output->dim[1] * inner_size;
-            int input_index = i * input->dim[1] * inner_size;
-            int cpy_size = (start_pos + seqlen) * inner_size * sizeof(__fp16);
+            int input_index = s * input->dim[1] * inner_size;
+            int cpy_size = output->dim[1] * inner_size * sizeof(__fp16);
             input_data = params->cache_buffer;
 
             memcpy(output_data + output_index, input_data + input_index, cpy_size);
         }
     } else if (params->mode == CSINN_LLM_POS_MASK) {
+        // scores: [bsz, n_heads, seqlen, kv_len]
+        int heads = input->dim[1];
+        int kv_len = input->dim[3];
         memcpy(output->data, input->data, csinn_tensor_byte_size(output));
-        for (int i = 0; i < input->dim[0] * input->dim[1]; i++) {
-            for (int j = 0; j < seqlen; ++j) {
-                int32_t *pos = params->pos;
-                for (int k = pos[j] + 1; k < seqlen; k++) {
-                    int output_index = i * seqlen * seqlen + j * seqlen + k;
-                    output_data[output_index] = (__fp16)-INFINITY;
+        for (int i = 0; i < batch; i++) {
+            for (int h = 0; h < heads; h++) {
+                __fp16 *out_ptr = output_data + (i * heads + h) * seqlen * kv_len;
+                for (int j = 0; j < seqlen; ++j) {
+                    for (int k = pos[i * seqlen + j] + 1; k < kv_len; k++) {
+                        out_ptr[j * kv_len + k] = (__fp16)-INFINITY;
+                    }
                 }
             }
         }
@@ -84,7 +84,7 @@ int shl_rvv_matmul_block_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
             // requantize
             shl_rvv_sidcso_op_requantize_fp16(mat0, output, mat1);
         } else if (batches_a > 1 && batches_b == 1) {
-            __fp16 *in0 = (__fp16 *)shl_mem_alloc(dim_m * dim_k * sizeof(__fp16));
+            __fp16 *in0 = (__fp16 *)shl_mem_alloc(batches_a * dim_m * dim_k * sizeof(__fp16));
             __fp16 *in1;
             if (!(mat1->is_const)) {
                 in1 = (__fp16 *)shl_mem_alloc(dim_k * dim_n * sizeof(__fp16));
@@ -93,15 +93,12 @@ int shl_rvv_matmul_block_fp16(struct csinn_tensor *mat0, struct csinn_tensor *ma
                 in1 = mat1_data;
             }
 
-            for (int b = 0; b < batches_a; b++) {
-                shl_rvv_reorder_a_block_12xk_fp16(mat0_data, in0, dim_m, dim_k, M_BLK, K_BLK);
-
-                shl_rvv_gemm_block_12xpack2n_fp16(output_data, in0, in1, NULL, dim_m, dim_k, dim_n,
-                                                  M_BLK, K_BLK, N_BLK);
-
-                mat0_data += dim_m * dim_k;
-                output_data += dim_m * dim_n;
-            }
+            /* mat1 is shared by every batch, fold the batches into the rows of a single gemm
+             * so that packed mat1 is streamed once instead of once per batch */
+            const int fold_m = batches_a * dim_m;
+            shl_rvv_reorder_a_block_12xk_fp16(mat0_data, in0, fold_m, dim_k, M_BLK, K_BLK);
+            shl_rvv_gemm_block_12xpack2n_fp16(output_data, in0, in1, NULL, fold_m, dim_k, dim_n,
+                                              M_BLK, K_BLK, N_BLK);
             shl_mem_free(in0);
             if (!(mat1->is_const)) {
                 shl_mem_free(in1);
@@ -170,19 +167,16 @@ int shl_rvv_matmul_block_fp16_w_int8(struct csinn_tensor *mat0, struct csinn_ten
             shl_mem_free(in0);
             shl_mem_free(in1);
         } else if (batches_a > 1 && batches_b == 1) {
-            __fp16 *in0 = (__fp16 *)shl_mem_alloc(dim_m * dim_k * sizeof(__fp16));
+            __fp16 *in0 = (__fp16 *)shl_mem_alloc(batches_a * dim_m * dim_k * sizeof(__fp16));
             __fp16 *in1 = (__fp16 *)shl_mem_alloc(size1 * sizeof(__fp16));
             shl_rvv_dequantize_i8_to_f16(mat1_data, in1, size1, zp, scale);
 
-            for (int b = 0; b < batches_a; b++) {
-                shl_rvv_reorder_a_block_12xk_fp16(mat0_data, in0, dim_m, dim_k, M_BLK, K_BLK);
-
-                shl_rvv_gemm_block_12xpack2n_fp16(output_data, in0, in1, NULL, dim_m, dim_k, dim_n,
-                                                  M_BLK, K_BLK, N_BLK);
-
-                mat0_data += dim_m * dim_k;
-                output_data += dim_m * dim_n;
-            }
+            /* mat1 is shared by every batch, fold the batches into the rows of a single gemm
+             * so that packed mat1 is streamed once instead of once per batch */
+            const int fold_m = batches_a * dim_m;
+            shl_rvv_reorder_a_block_12xk_fp16(mat0_data, in0, fold_m, dim_k, M_BLK, K_BLK);
+            shl_rvv_gemm_block_12xpack2n_fp16(output_data, in0, in1, NULL, fold_m, dim_k, dim_n,
+                                              M_BLK, K_BLK, N_BLK);
             shl_mem_free(in0);
             shl_mem_free(in1);
         } else {
@@ -346,6 +340,10 @@ int shl_rvv_matmul_init_fp16(struct csinn_tensor *mat0, struct csinn_tensor *mat
             cb->exec = shl_rvv_matmul_fp16;
         }
     }
+    if (!params->trans_a && params->trans_b && params->act_quant != CSINN_ACT_QUANT_NONE &&
+        (mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0 || mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0)) {
+        cb->exec = shl_rvv_matmul_a0b1_dynamic_quant;
+    }
     if (cb->exec == NULL) {
         shl_debug_warning(
             "matmul is not optimized to achieve under this condition on RVV, call reference func "
@@ -21,8 +21,8 @@
 /*************************************************************
  * note: support flexible vlen
  *************************************************************/
-int shl_rvv_maxpool2x2s2_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                                    struct csinn_pool_params *params)
+static int maxpool2x2s2_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp16(input);
@@ -91,3 +91,9 @@ int shl_rvv_maxpool2x2s2_packn_fp16(struct csinn_tensor *input, struct csinn_ten
     shl_rvv_siso_op_requantize_fp16(input, output);
     return CSINN_TRUE;
 }
+
+int shl_rvv_maxpool2x2s2_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                                    struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, maxpool2x2s2_packn_fp16);
+}
@@ -96,8 +96,8 @@ static void maxpool_border_fp16_packn(const __fp16 *src, __fp16 *dst,
     vse16_v_f16m1(out_ptr, _max, vl);
 }
 
-int shl_rvv_maxpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                               struct csinn_pool_params *params)
+static int maxpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp16(input);
@@ -159,3 +159,9 @@ int shl_rvv_maxpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *
     shl_rvv_siso_op_requantize_fp16(input, output);
     return CSINN_TRUE;
 }
+
+int shl_rvv_maxpool_packn_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, maxpool_packn_fp16);
+}
@@ -18,28 +18,25 @@
 
 #include "rvv/rvv.h"
 
-static int rms_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *weight,
-                         struct csinn_tensor *output, struct csinn_rms_norm_params *params)
+struct rms_norm_fp16_task {
+    __fp16 *input_data;
+    __fp16 *output_data;
+    __fp16 *weight_data;
+    int32_t norm_size;
+    float eps;
+};
+
+/* rows are normalized independently */
+static void rms_norm_fp16_rows(void *arg, int start, int end)
 {
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(input);
-    }
-    __fp16 *input_data = (__fp16 *)input->data;
-    __fp16 *output_data = (__fp16 *)output->data;
-    __fp16 *weight_data = (__fp16 *)weight->data;
-    float eps = params->epsilon;
-    /* support negative axis */
-    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
-    int32_t batches = 1;
-    for (int i = 0; i < axis; i++) {
-        batches *= input->dim[i];
-    }
-    int32_t norm_size = 1;
-    for (int i = axis; i < input->dim_count; i++) {
-        norm_size *= input->dim[i];
-    }
+    struct rms_norm_fp16_task *t = (struct rms_norm_fp16_task *)arg;
+    __fp16 *input_data = t->input_data;
+    __fp16 *output_data = t->output_data;
+    __fp16 *weight_data = t->weight_data;
+    int32_t norm_size = t->norm_size;
+    float eps = t->eps;
 
-    for (int b = 0; b < batches; b++) {
+    for (int b = start; b < end; b++) {
         __fp16 *input_ptr = input_data + b * norm_size;
         __fp16 *output_ptr = output_data + b * norm_size;
 
@@ -71,11 +68,9 @@ static int rms_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *weight
             i += vl;
         }
     }
-
-    return CSINN_TRUE;
 }
 
-int rms_norm_fp16_w_fp32(struct csinn_tensor *input, struct csinn_tensor *weight,
+static int rms_norm_fp16(struct csinn_tensor *input, struct csinn_tensor *weight,
                          struct csinn_tensor *output, struct csinn_rms_norm_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NC1HWC0) {
@@ -83,7 +78,7 @@ int rms_norm_fp16_w_fp32(struct csinn_tensor *input, struct csinn_tensor *weight
     }
     __fp16 *input_data = (__fp16 *)input->data;
     __fp16 *output_data = (__fp16 *)output->data;
-    float *weight_data = (float *)weight->data;
+    __fp16 *weight_data = (__fp16 *)weight->data;
     float eps = params->epsilon;
     /* support negative axis */
     int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
@@ -96,7 +91,31 @@ int rms_norm_fp16_w_fp32(struct csinn_tensor *input, struct csinn_tensor *weight
         norm_size *= input->dim[i];
     }
 
-    for (int b = 0; b < batches; b++) {
+    struct rms_norm_fp16_task task = {input_data, output_data, weight_data, norm_size, eps};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, rms_norm_fp16_rows, &task);
+
+    return CSINN_TRUE;
+}
+
+struct rms_norm_fp16_w_fp32_task {
+    __fp16 *input_data;
+    __fp16 *output_data;
+    float *weight_data;
+    int32_t norm_size;
+    float eps;
+};
+
+/* rows are normalized independently */
+static void rms_norm_fp16_w_fp32_rows(void *arg, int start, int end)
+{
+    struct rms_norm_fp16_w_fp32_task *t = (struct rms_norm_fp16_w_fp32_task *)arg;
+    __fp16 *input_data = t->input_data;
+    __fp16 *output_data = t->output_data;
+    float *weight_data = t->weight_data;
+    int32_t norm_size = t->norm_size;
+    float eps = t->eps;
+
+    for (int b = start; b < end; b++) {
         __fp16 *input_ptr = input_data + b * norm_size;
         __fp16 *output_ptr = output_data + b * norm_size;
 
@@ -127,6 +146,31 @@ int rms_norm_fp16_w_fp32(struct csinn_tensor *input, struct csinn_tensor *weight
             i += vl;
         }
     }
+}
+
+int rms_norm_fp16_w_fp32(struct csinn_tensor *input, struct csinn_tensor *weight,
+                         struct csinn_tensor *output, struct csinn_rms_norm_params *params)
+{
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(input);
+    }
+    __fp16 *input_data = (__fp16 *)input->data;
+    __fp16 *output_data = (__fp16 *)output->data;
+    float *weight_data = (float *)weight->data;
+    float eps = params->epsilon;
+    /* support negative axis */
+    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
+    int32_t batches = 1;
+    for (int i = 0; i < axis; i++) {
+        batches *= input->dim[i];
+    }
+    int32_t norm_size = 1;
+    for (int i = axis; i < input->dim_count; i++) {
+        norm_size *= input->dim[i];
+    }
+
+    struct rms_norm_fp16_w_fp32_task task = {input_data, output_data, weight_data, norm_size, eps};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, rms_norm_fp16_w_fp32_rows, &task);
 
     return CSINN_TRUE;
 }
@@ -18,6 +18,29 @@
 
 #include "rvv/rvv.h"
 
+/* one head: (x0, x1) pairs rotated by the fp32 (sin, cos) pairs of table */
+static void rope_row_fp16(const __fp16 *src, const float *table, __fp16 *dst, int n_pairs)
+{
+    while (n_pairs > 0) {
+        size_t vl = vsetvl_e16m1(n_pairs);
+        vfloat16m1_t _x0_f16, _x1_f16;
+        vfloat32m2_t _sin, _cos;
+        vlseg2e16_v_f16m1(&_x0_f16, &_x1_f16, src, vl);
+        vlseg2e32_v_f32m2(&_sin, &_cos, table, vl);
+        vfloat32m2_t _x0 = vfwcvt_f_f_v_f32m2(_x0_f16, vl);
+        vfloat32m2_t _x1 = vfwcvt_f_f_v_f32m2(_x1_f16, vl);
+        vfloat32m2_t _y0 = vfmul_vv_f32m2(_x0, _cos, vl);
+        _y0 = vfnmsac_vv_f32m2(_y0, _x1, _sin, vl);
+        vfloat32m2_t _y1 = vfmul_vv_f32m2(_x0, _sin, vl);
+        _y1 = vfmacc_vv_f32m2(_y1, _x1, _cos, vl);
+        vsseg2e16_v_f16m1(dst, vfncvt_f_f_w_f16m1(_y0, vl), vfncvt_f_f_w_f16m1(_y1, vl), vl);
+        src += 2 * vl;
+        table += 2 * vl;
+        dst += 2 * vl;
+        n_pairs -= vl;
+    }
+}
+
 int shl_rvv_rope_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                       struct csinn_rope_params *params)
 {
@@ -36,7 +59,7 @@ int shl_rvv_rope_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
     if (!params->use_rope_cache) {
         for (int i3 = 0; i3 < input->dim[0]; i3++) {
             for (int i2 = 0; i2 < input->dim[1]; i2++) {
-                int p = pos[i2];
+                int p = pos[i3 * input->dim[1] + i2];
                 for (int i1 = 0; i1 < input->dim[2]; i1++) {
                     float theta = freq_scale * (float)p;
 
@@ -66,23 +89,36 @@ int shl_rvv_rope_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                 }
             }
         }
+    } else if (params->rope_cache_shared) {
+        float *rope_cache = (float *)params->rope_cache;
+        int head_dim = input->dim[3];
+        for (int i3 = 0; i3 < input->dim[0]; i3++) {
+            for (int i2 = 0; i2 < input->dim[1]; i2++) {
+                int p = pos[i3 * input->dim[1] + i2];
+                for (int i1 = 0; i1 < input->dim[2]; i1++) {
+                    int index = ((i3 * input->dim[1] + i2) * input->dim[2] + i1) * head_dim;
+                    rope_row_fp16(src_data + index, rope_cache + p * head_dim, dst_data + index,
+                                  head_dim / 2);
+                }
+            }
+        }
     } else {
-        __fp16 *rope_cache =
-            &((__fp16 *)params->rope_cache)[pos[0] * input->dim[2] * input->dim[3]];
+        __fp16 *rope_cache = (__fp16 *)params->rope_cache;
         for (int i3 = 0; i3 < input->dim[0]; i3++) {
             for (int i2 = 0; i2 < input->dim[1]; i2++) {
+                int p = pos[i3 * input->dim[1] + i2];
                 for (int i1 = 0; i1 < input->dim[2]; i1++) {
                     for (int i0 = 0; i0 < input->dim[3]; i0 += 2) {
                         int index = i3 * (input->dim[3] * input->dim[2] * input->dim[1]) +
                                     i2 * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
 
                         int rope_cache_index =
-                            i2 * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
+                            p * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
 
                         __fp16 x0 = src_data[index];
                         __fp16 x1 = src_data[index + 1];
-                        __fp16 sin_theta = rope_cache[index];
-                        __fp16 cos_theta = rope_cache[index + 1];
+                        __fp16 sin_theta = rope_cache[rope_cache_index];
+                        __fp16 cos_theta = rope_cache[rope_cache_index + 1];
 
                         dst_data[index] = x0 * cos_theta - x1 * sin_theta;
                         dst_data[index + 1] = x0 * sin_theta + x1 * cos_theta;
@@ -19,20 +19,11 @@
 #include "rvv/rvv.h"
 #include "rvv_mathfun_fp16.h"
 
-int shl_rvv_sigmoid_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                         struct csinn_sigmoid_params *params)
+static void sigmoid_fp16(void *input, void *output, int32_t size, void *arg)
 {
-    /* TODO: fp16 quantize */
-    if (fabs(input->qinfo->scale - 1) > FLT_EPSILON ||
-        fabs(output->qinfo->scale - 1) > FLT_EPSILON) {
-        shl_debug_error("unsupport fp16 quantization of sigmoid op\n");
-        return CSINN_FALSE;
-    }
-
-    __fp16 *input_data = (__fp16 *)input->data;
-    __fp16 *output_data = (__fp16 *)output->data;
+    __fp16 *input_data = (__fp16 *)input;
+    __fp16 *output_data = (__fp16 *)output;
 
-    int size = csinn_tensor_size(input);
     while (size > 0) {
         size_t vl = vsetvl_e16m2(size);
 
@@ -47,6 +38,20 @@ int shl_rvv_sigmoid_fp16(struct csinn_tensor *input, struct csinn_tensor *output
         output_data += vl;
         size -= vl;
     }
+}
+
+int shl_rvv_sigmoid_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                         struct csinn_sigmoid_params *params)
+{
+    /* TODO: fp16 quantize */
+    if (fabs(input->qinfo->scale - 1) > FLT_EPSILON ||
+        fabs(output->qinfo->scale - 1) > FLT_EPSILON) {
+        shl_debug_error("unsupport fp16 quantization of sigmoid op\n");
+        return CSINN_FALSE;
+    }
+
+    shl_rvv_unary_op_flat(input->data, output->data, csinn_tensor_size(input), sizeof(__fp16),
+                          sigmoid_fp16, NULL);
     output->layout = input->layout;
     output->dim_count = input->dim_count;
     for (int i = 0; i < output->dim_count; i++) {
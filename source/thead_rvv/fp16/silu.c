@@ -19,13 +19,11 @@
 #include "rvv/rvv.h"
 #include "rvv_mathfun_fp16.h"
 
-int shl_rvv_silu_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                      struct csinn_sigmoid_params *params)
+static void silu_fp16(void *input, void *output, int32_t size, void *arg)
 {
-    __fp16 *input_data = (__fp16 *)input->data;
-    __fp16 *output_data = (__fp16 *)output->data;
+    __fp16 *input_data = (__fp16 *)input;
+    __fp16 *output_data = (__fp16 *)output;
 
-    int size = csinn_tensor_size(input);
     int i = 0;
     while (i < size) {
         size_t vl = vsetvl_e16m2(size - i);
@@ -37,6 +35,13 @@ int shl_rvv_silu_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
         vse16_v_f16m2(output_data + i, _res, vl);
         i += vl;
     }
+}
+
+int shl_rvv_silu_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                      struct csinn_sigmoid_params *params)
+{
+    shl_rvv_unary_op_flat(input->data, output->data, csinn_tensor_size(input), sizeof(__fp16),
+                          silu_fp16, NULL);
 
     output->layout = input->layout;
     output->dim_count = input->dim_count;
@@ -31,39 +31,28 @@ static inline __fp16 fast_exp16(__fp16 y)
     return data.d;
 }
 
-int shl_rvv_softmax_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
-                         struct csinn_softmax_params *params)
-{
-    /* TODO: fp16 quantize */
-    if (fabs(input->qinfo->scale - 1) > FLT_EPSILON ||
-        fabs(output->qinfo->scale - 1) > FLT_EPSILON) {
-        shl_debug_error("unsupport fp16 quantization of softmax op\n");
-        return CSINN_FALSE;
-    }
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(input);
-    }
-
-    __fp16 *input_data = (__fp16 *)input->data;
-    __fp16 *output_data = (__fp16 *)output->data;
-
-    int axis = params->axis;
-    axis = axis < 0 ? axis + input->dim_count : axis;
-    // FlatSize() = outer_size * inner_size * cnt;
-    int64_t outer_size = 1;
-    for (int i = 0; i < axis; i++) {
-        outer_size *= input->dim[i];
-    }
+struct softmax_fp16_task {
+    __fp16 *input_data;
+    __fp16 *output_data;
+    int64_t inner_size;
+    int cnt;
+    int pack2n;
+};
 
-    int64_t inner_size = 1;
-    for (int i = axis + 1; i < input->dim_count; i++) {
-        inner_size *= input->dim[i];
-    }
+/* every outer slice is an independent softmax */
+static void softmax_fp16_rows(void *arg, int start, int end)
+{
+    struct softmax_fp16_task *t = (struct softmax_fp16_task *)arg;
+    __fp16 *input_data = t->input_data;
+    __fp16 *output_data = t->output_data;
+    int64_t inner_size = t->inner_size;
+    int cnt = t->cnt;
+    int pack2n = t->pack2n;
 
-    int cnt = input->dim[axis];
-    int pack2n = csrr_vlenb() / sizeof(__fp16) * 2;
+    input_data += start * inner_size * cnt;
+    output_data += start * inner_size * cnt;
     __fp16 *exp_buffer = (__fp16 *)shl_mem_alloc(inner_size * cnt * sizeof(__fp16));
-    for (int i = 0; i < outer_size; i++) {
+    for (int i = start; i < end; i++) {
         for (int k = 0; k < inner_size; k++) {
             __fp16 acc_exp = 0.0f;
             __fp16 max = -65504;
@@ -128,5 +117,40 @@ int shl_rvv_softmax_fp16(struct csinn_tensor *input, struct csinn_tensor *output
         output_data += inner_size * cnt;
     }
     shl_mem_free(exp_buffer);
+}
+
+int shl_rvv_softmax_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
+                         struct csinn_softmax_params *params)
+{
+    /* TODO: fp16 quantize */
+    if (fabs(input->qinfo->scale - 1) > FLT_EPSILON ||
+        fabs(output->qinfo->scale - 1) > FLT_EPSILON) {
+        shl_debug_error("unsupport fp16 quantization of softmax op\n");
+        return CSINN_FALSE;
+    }
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(input);
+    }
+
+    __fp16 *input_data = (__fp16 *)input->data;
+    __fp16 *output_data = (__fp16 *)output->data;
+
+    int axis = params->axis;
+    axis = axis < 0 ? axis + input->dim_count : axis;
+    // FlatSize() = outer_size * inner_size * cnt;
+    int64_t outer_size = 1;
+    for (int i = 0; i < axis; i++) {
+        outer_size *= input->dim[i];
+    }
+
+    int64_t inner_size = 1;
+    for (int i = axis + 1; i < input->dim_count; i++) {
+        inner_size *= input->dim[i];
+    }
+
+    int cnt = input->dim[axis];
+    int pack2n = csrr_vlenb() / sizeof(__fp16) * 2;
+    struct softmax_fp16_task task = {input_data, output_data, inner_size, cnt, pack2n};
+    shl_rvv_parallel_for(outer_size, outer_size * inner_size * cnt, softmax_fp16_rows, &task);
     return CSINN_TRUE;
 }
@@ -18,25 +18,43 @@
 
 #include "rvv/rvv.h"
 
-static void transpose_021_fp16(__fp16 *src, __fp16 *dst, int batch, int inner_size, int outer_size)
+struct transpose_021_fp16_task {
+    __fp16 *src;
+    __fp16 *dst;
+    int inner_size;
+    int outer_size;
+};
+
+/* every (batch, outer) row is scattered into its own output column */
+static void transpose_021_fp16_rows(void *arg, int start, int end)
 {
-    for (int b = 0; b < batch; b++) {
-        for (int i = 0; i < outer_size; i++) {
-            int size = inner_size;
-            __fp16 *d_ptr = dst + i;
-            while (size > 0) {
-                int vl = vsetvl_e16m4(size);
-                vfloat16m4_t _in = vle16_v_f16m4(src, vl);
-                src += vl;
-                vsse16_v_f16m4(d_ptr, outer_size * sizeof(__fp16), _in, vl);
-                d_ptr += vl * outer_size;
-                size -= vl;
-            }
+    struct transpose_021_fp16_task *t = (struct transpose_021_fp16_task *)arg;
+    int inner_size = t->inner_size;
+    int outer_size = t->outer_size;
+    for (int r = start; r < end; r++) {
+        int b = r / outer_size;
+        int i = r % outer_size;
+        __fp16 *src = t->src + (int64_t)r * inner_size;
+        __fp16 *d_ptr = t->dst + (int64_t)b * inner_size * outer_size + i;
+        int size = inner_size;
+        while (size > 0) {
+            int vl = vsetvl_e16m4(size);
+            vfloat16m4_t _in = vle16_v_f16m4(src, vl);
+            src += vl;
+            vsse16_v_f16m4(d_ptr, outer_size * sizeof(__fp16), _in, vl);
+            d_ptr += vl * outer_size;
+            size -= vl;
         }
-        dst += inner_size * outer_size;
     }
 }
 
+static void transpose_021_fp16(__fp16 *src, __fp16 *dst, int batch, int inner_size, int outer_size)
+{
+    struct transpose_021_fp16_task task = {src, dst, inner_size, outer_size};
+    shl_rvv_parallel_for(batch * outer_size, (int64_t)batch * outer_size * inner_size,
+                         transpose_021_fp16_rows, &task);
+}
+
 static int transpose_tail_coincide_fp16(struct csinn_tensor *input, struct csinn_tensor *output,
                                         struct csinn_transpose_params *params, int tail)
 {
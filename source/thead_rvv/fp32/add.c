@@ -21,46 +21,6 @@
 /*************************************************************
     note: VLEN = 128/256
 *************************************************************/
-static void elementwise_add_fp32(struct csinn_tensor *input0, struct csinn_tensor *input1,
-                                 struct csinn_tensor *output)
-{
-    float *input0_data = (float *)input0->data;
-    float *input1_data = (float *)input1->data;
-    float *output_data = (float *)output->data;
-
-    int64_t size = csinn_tensor_size(output);
-    while (size > 0) {
-        int vl = vsetvl_e32m2(size);
-        vfloat32m2_t _in0 = vle32_v_f32m2(input0_data, vl);
-        vfloat32m2_t _in1 = vle32_v_f32m2(input1_data, vl);
-        vfloat32m2_t _sum = vfadd_vv_f32m2(_in0, _in1, vl);
-        vse32_v_f32m2(output_data, _sum, vl);
-        input0_data += vl;
-        input1_data += vl;
-        output_data += vl;
-        size -= vl;
-    }
-}
-
-static void broadcast_single_1_add_fp32(struct csinn_tensor *input0, struct csinn_tensor *input1,
-                                        struct csinn_tensor *output)
-{
-    float *input0_data = (float *)input0->data;
-    float *input1_data = (float *)input1->data;
-    float *output_data = (float *)output->data;
-
-    int64_t size = csinn_tensor_size(output);
-    while (size > 0) {
-        int vl = vsetvl_e32m2(size);
-        vfloat32m2_t _in0 = vle32_v_f32m2(input0_data, vl);
-        vfloat32m2_t _sum = vfadd_vf_f32m2(_in0, input1_data[0], vl);
-        vse32_v_f32m2(output_data, _sum, vl);
-        input0_data += vl;
-        output_data += vl;
-        size -= vl;
-    }
-}
-
 static inline void add_vv_f32m4(float *in0, float *in1, float *out, int32_t size)
 {
     while (size > 0) {
@@ -116,14 +76,18 @@ int shl_rvv_add_fp32(struct csinn_tensor *input0, struct csinn_tensor *input1,
         for (int i = 0; i < output->dim_count; i++) {
             output->dim[i] = input0->dim[i];
         }
-        elementwise_add_fp32(input0, input1, output);
+        shl_rvv_binary_op_flat(input0->data, input1->data, output->data, out_size,
+                               sizeof(float), CSINN_BROADCAST_VV,
+                               add_cb_fp32[CSINN_BROADCAST_VV], NULL, NULL);
     } else if (in_size1 == 1) {
         output->layout = input0->layout;
         output->dim_count = input0->dim_count;
         for (int i = 0; i < output->dim_count; i++) {
             output->dim[i] = input0->dim[i];
         }
-        broadcast_single_1_add_fp32(input0, input1, output);
+        shl_rvv_binary_op_flat(input0->data, input1->data, output->data, out_size,
+                               sizeof(float), CSINN_BROADCAST_VS,
+                               add_cb_fp32[CSINN_BROADCAST_VS], NULL, NULL);
     } else {
         return shl_rvv_binary_op_broadcast_fp32(input0, input1, output, add_cb_fp32);
     }
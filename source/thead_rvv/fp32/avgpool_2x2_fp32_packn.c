@@ -22,8 +22,8 @@
  * note: support flexible vlen
  *************************************************************/
 // TODO: consider params->count_include_pad
-int shl_rvv_avgpool2x2s2_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                                    struct csinn_pool_params *params)
+static int avgpool2x2s2_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
@@ -89,3 +89,9 @@ int shl_rvv_avgpool2x2s2_packn_fp32(struct csinn_tensor *input, struct csinn_ten
     shl_mem_free(input_ncxhwx);
     return CSINN_TRUE;
 }
+
+int shl_rvv_avgpool2x2s2_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                    struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool2x2s2_packn_fp32);
+}
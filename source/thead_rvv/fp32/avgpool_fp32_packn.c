@@ -102,8 +102,8 @@ static void avgpool_border_fp32_packn(const float *src, float *dst,
     vse32_v_f32m1(out_ptr, vfmul_vf_f32m1(_acc, ratio, vl), vl);
 }
 
-int shl_rvv_avgpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                               struct csinn_pool_params *params)
+static int avgpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
@@ -206,3 +206,9 @@ int shl_rvv_avgpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *
     }
     return CSINN_TRUE;
 }
+
+int shl_rvv_avgpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool_packn_fp32);
+}
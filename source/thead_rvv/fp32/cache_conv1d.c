@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+int shl_rvv_cache_conv1d_init_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_tensor *weight, struct csinn_tensor *bias,
+                                   struct csinn_cache_conv1d_params *params)
+{
+    size_t data_size = output->dim[0] * output->dim[1] * output->dim[2] * sizeof(float);
+    asr_buffer_init(&params->asr_buffer, data_size);
+
+    struct csinn_session *sess = params->base.sess;
+    bool binary_model_op_init = shl_rvv_get_binary_model_op_init(sess);
+    if (!binary_model_op_init) {
+        /* weight is [output_depth, accum_depth, 1] */
+        struct csinn_tensor weight_nk = *weight;
+        weight_nk.dim[0] = weight->dim[weight->dim_count - 3];
+        weight_nk.dim[1] = weight->dim[weight->dim_count - 2];
+        shl_rvv_fc_gemm_reorder_weight_fp32(&weight_nk);
+    }
+    params->base.cb->exec = shl_rvv_cache_conv1d_fp32;
+    return CSINN_TRUE;
+}
+
+/*************************************************************
+ * Append the new frame to the asr ring buffer and write the whole
+ * cached window [dim1, dim2] to output, transposed from [dim2, dim1].
+ ************************************************************/
+void shl_rvv_cache_conv1d_push_fp32(float *frame, int frame_size, struct csinn_tensor *output,
+                                    struct csinn_cache_conv1d_params *params)
+{
+    struct csinn_asr_buffer_t *asr_buffer = &params->asr_buffer;
+    float *output_data = (float *)output->data;
+    int32_t *shape = output->dim;
+
+    asr_buffer_insert_back(asr_buffer, frame, frame_size * sizeof(float));
+
+    for (int i = 0; i < shape[2]; i++) {
+        int j = 0;
+        while (j < shape[1]) {
+            size_t contig;
+            float *in_ptr = (float *)asr_buffer_get_data(
+                asr_buffer, (i * shape[1] + j) * sizeof(float), &contig);
+            int size = contig / sizeof(float);
+            size = size < shape[1] - j ? size : shape[1] - j;
+            while (size > 0) {
+                int vl = vsetvl_e32m4(size);
+                vfloat32m4_t _in = vle32_v_f32m4(in_ptr, vl);
+                vsse32_v_f32m4(output_data + j * shape[2] + i, shape[2] * sizeof(float), _in, vl);
+                in_ptr += vl;
+                j += vl;
+                size -= vl;
+            }
+        }
+    }
+}
+
+int shl_rvv_cache_conv1d_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_conv1d_params *params)
+{
+    float *input_data = (float *)input->data;
+    float *output_data = (float *)output->data;
+    float *weight_data = (float *)weight->data;
+    float *bias_data = bias->dim_count != 0 ? (float *)bias->data : NULL;
+
+    int m = input->dim[1];                       // batches
+    int n = weight->dim[weight->dim_count - 3];  // output_depth
+    int k = weight->dim[weight->dim_count - 2];  // accum_depth
+
+    /* the new frame is staged in output, then overwritten by the cached window */
+    float *input_reorder = (float *)shl_mem_alloc(m * k * sizeof(float));
+    shl_rvv_reorder_a_block_12xk_fp32(input_data, input_reorder, m, k, m, k);
+    shl_rvv_gemm_a0b1_12xpack2n_fp32(output_data, input_reorder, weight_data, bias_data, m, k, n);
+
+    shl_rvv_cache_conv1d_push_fp32(output_data, m * n, output, params);
+
+    shl_mem_free(input_reorder);
+    return CSINN_TRUE;
+}
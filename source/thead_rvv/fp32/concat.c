@@ -17,6 +17,42 @@
  */
 #include "rvv/rvv.h"
 
+struct concat_ndarray_fp32_task {
+    struct csinn_tensor **input;
+    struct csinn_tensor *output;
+    struct csinn_concat_params *params;
+    int64_t base_inner_size;
+};
+
+/* every outer slice gathers its own part of all inputs */
+static void concat_ndarray_fp32_rows(void *arg, int start, int end)
+{
+    struct concat_ndarray_fp32_task *t = (struct concat_ndarray_fp32_task *)arg;
+    struct csinn_tensor **input = t->input;
+    struct csinn_tensor *output = t->output;
+    struct csinn_concat_params *params = t->params;
+    int64_t base_inner_size = t->base_inner_size;
+
+    int64_t slice_size = output->dim[params->axis] * base_inner_size;
+    float *output_ptr = (float *)output->data + start * slice_size;
+    for (int k = start; k < end; k++) {
+        for (int i = 0; i < params->inputs_count; ++i) {
+            struct csinn_tensor *input_item = input[i];
+            float *input_item_data = input_item->data;
+            int copy_size = input_item->dim[params->axis] * base_inner_size;
+            const float *input_ptr = input_item_data + k * copy_size;
+            while (copy_size > 0) {
+                int vl = vsetvl_e32m2(copy_size);
+                vfloat32m2_t _input = vle32_v_f32m2(input_ptr, vl);
+                input_ptr += vl;
+                vse32_v_f32m2(output_ptr, _input, vl);
+                output_ptr += vl;
+                copy_size -= vl;
+            }
+        }
+    }
+}
+
 static int shl_rvv_concat_ndarray_fp32(struct csinn_tensor **input, struct csinn_tensor *output,
                                        struct csinn_concat_params *params)
 {
@@ -41,24 +77,9 @@ static int shl_rvv_concat_ndarray_fp32(struct csinn_tensor **input, struct csinn
     for (int i = params->axis + 1; i < output->dim_count; ++i) {
         base_inner_size *= output->dim[i];
     }
-    int vl;
-    float *output_ptr = output->data;
-    for (int k = 0; k < outer_size; k++) {
-        for (int i = 0; i < params->inputs_count; ++i) {
-            struct csinn_tensor *input_item = input[i];
-            float *input_item_data = input_item->data;
-            int copy_size = input_item->dim[params->axis] * base_inner_size;
-            const float *input_ptr = input_item_data + k * copy_size;
-            while (copy_size > 0) {
-                vl = vsetvl_e32m2(copy_size);
-                vfloat32m2_t _input = vle32_v_f32m2(input_ptr, vl);
-                input_ptr += vl;
-                vse32_v_f32m2(output_ptr, _input, vl);
-                output_ptr += vl;
-                copy_size -= vl;
-            }
-        }
-    }
+    struct concat_ndarray_fp32_task task = {input, output, params, base_inner_size};
+    shl_rvv_parallel_for(outer_size, outer_size * output->dim[params->axis] * base_inner_size,
+                         concat_ndarray_fp32_rows, &task);
     return CSINN_TRUE;
 }
 
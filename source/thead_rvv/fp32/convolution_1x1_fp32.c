@@ -51,7 +51,7 @@ int shl_rvv_common_conv1x1_gemm_fp32(struct csinn_tensor *input, struct csinn_te
     float *bias_data = (float *)bias->data;
 
     int32_t group = params->group;
-    int32_t batch = input->dim[0];  // assert(batch == 1);
+    int32_t batch = input->dim[0];
     int32_t in_ch = input->dim[1];
     int32_t out_ch = kernel->dim[0];
     int32_t out_h = output->dim[2];
@@ -60,25 +60,43 @@ int shl_rvv_common_conv1x1_gemm_fp32(struct csinn_tensor *input, struct csinn_te
     int32_t m = out_ch / group;
     int32_t k = in_ch / group;
     int32_t n = out_h * out_w;
+    // batch is folded into the gemm column dimension, kernel panels are streamed once per group
+    int32_t bn = batch * n;
 
-    float *pb_reorder = (float *)shl_mem_alloc(k * n * sizeof(float));
-    const int vlen = csrr_vlenb() * 8;
+    float *pb_reorder = (float *)shl_mem_alloc(k * bn * sizeof(float));
+    float *in_fold = NULL;
+    float *out_fold = NULL;
+    if (batch > 1) {
+        in_fold = (float *)shl_mem_alloc(k * bn * sizeof(float));
+        out_fold = (float *)shl_mem_alloc(m * bn * sizeof(float));
+    }
 
-    for (int i = 0; i < batch; i++) {
-        for (int g = 0; g < group; g++) {
-            float *pa = kernel_data + g * m * k;
-            float *pb = pb_reorder;
-            float *pc = output_data;
+    for (int g = 0; g < group; g++) {
+        float *pa = kernel_data + g * m * k;
+        float *pb = pb_reorder;
+        float *in_ptr = input_data + g * k * n;
+        float *pc = output_data + g * m * n;
 
-            // pack
-            reorder_input(input_data, pb, k, n, n);
-            // GEMM
-            gemm(pc, pa, pb, bias_data + g * m, m, k, n, n);
+        if (batch > 1) {
+            shl_rvv_batch_fold(in_fold, in_ptr, batch, k, n * sizeof(float),
+                               in_ch * n * sizeof(float));
+            in_ptr = in_fold;
+            pc = out_fold;
+        }
+        // pack
+        reorder_input(in_ptr, pb, k, bn, bn);
+        // GEMM
+        gemm(pc, pa, pb, bias_data + g * m, m, k, bn, bn);
 
-            input_data += k * n;
-            output_data += m * n;
+        if (batch > 1) {
+            shl_rvv_batch_unfold(output_data + g * m * n, out_fold, batch, m, n * sizeof(float),
+                                 out_ch * n * sizeof(float));
         }
     }
+    if (batch > 1) {
+        shl_mem_free(in_fold);
+        shl_mem_free(out_fold);
+    }
     shl_mem_free(pb_reorder);
     return CSINN_TRUE;
 }
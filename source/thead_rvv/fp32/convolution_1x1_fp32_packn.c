@@ -47,7 +47,7 @@ int shl_rvv_common_conv1x1_gemm_packn_fp32(struct csinn_tensor *input, struct cs
     float *bias_data = (float *)bias->data;
 
     int32_t group = params->group;
-    int32_t batch = input->dim[0];  // assert(batch == 1);
+    int32_t batch = input->dim[0];
     int32_t in_ch = input->dim[1] * input->dim[4];
     int32_t out_ch = kernel->dim[0];
     int32_t out_h = output->dim[2];
@@ -56,25 +56,45 @@ int shl_rvv_common_conv1x1_gemm_packn_fp32(struct csinn_tensor *input, struct cs
     int32_t m = out_ch / group;
     int32_t k = in_ch / group;
     int32_t n = out_h * out_w;
+    // batch is folded into the gemm column dimension, kernel panels are streamed once per group
+    int32_t bn = batch * n;
 
-    float *pb_reorder = (float *)shl_mem_alloc(k * n * sizeof(float));
+    const int packn = csrr_vlenb() / sizeof(float);
+    float *pb_reorder = (float *)shl_mem_alloc(k * bn * sizeof(float));
+    float *in_fold = NULL;
+    float *out_fold = NULL;
+    if (batch > 1) {
+        in_fold = (float *)shl_mem_alloc(k * bn * sizeof(float));
+        out_fold = (float *)shl_mem_alloc(m * bn * sizeof(float));
+    }
 
-    for (int i = 0; i < batch; i++) {
-        for (int g = 0; g < group; g++) {
-            float *kernel_ptr = kernel_data + g * m * k;
-            float *in_ptr = pb_reorder;
-            float *out_ptr = output_data;
-            float *bias_ptr = bias_data ? (bias_data + g * m) : NULL;
+    for (int g = 0; g < group; g++) {
+        float *kernel_ptr = kernel_data + g * m * k;
+        float *in_ptr = input_data + g * k * n;
+        float *out_ptr = output_data + g * m * n;
+        float *bias_ptr = bias_data ? (bias_data + g * m) : NULL;
 
-            // pack
-            reorder_input(input_data, in_ptr, k, n, n);
-            // GEMM
-            gemm(out_ptr, kernel_ptr, in_ptr, bias_ptr, m, k, n, false);
+        if (batch > 1) {
+            // [k/packn, n, packn] per sample -> [k/packn, batch * n, packn]
+            shl_rvv_batch_fold(in_fold, in_ptr, batch, k / packn, n * packn * sizeof(float),
+                               in_ch * n * sizeof(float));
+            in_ptr = in_fold;
+            out_ptr = out_fold;
+        }
+        // pack
+        reorder_input(in_ptr, pb_reorder, k, bn, bn);
+        // GEMM
+        gemm(out_ptr, kernel_ptr, pb_reorder, bias_ptr, m, k, bn, false);
 
-            input_data += k * n;
-            output_data += m * n;
+        if (batch > 1) {
+            shl_rvv_batch_unfold(output_data + g * m * n, out_fold, batch, m / packn,
+                                 n * packn * sizeof(float), out_ch * n * sizeof(float));
         }
     }
+    if (batch > 1) {
+        shl_mem_free(in_fold);
+        shl_mem_free(out_fold);
+    }
     shl_mem_free(pb_reorder);
     return CSINN_TRUE;
 }
@@ -74,16 +74,23 @@ int shl_rvv_common_conv_gemm_fp32(struct csinn_tensor *input, struct csinn_tenso
     int32_t m = out_ch / group;
     int32_t k = in_ch / group * ksize_h * ksize_w;
     int32_t n = out_height * out_width;
+    // batch is folded into the gemm column dimension, kernel panels are streamed once per group
+    int32_t bn = batch * n;
 
-    float *im2col_data = (float *)shl_mem_alloc(k * n * sizeof(float));
-    float *pb_reorder = (float *)shl_mem_alloc(k * n * sizeof(float));
+    float *im2col_data = (float *)shl_mem_alloc(k * bn * sizeof(float));
+    float *pb_reorder = (float *)shl_mem_alloc(k * bn * sizeof(float));
+    float *out_fold = NULL;
+    if (batch > 1) {
+        out_fold = (float *)shl_mem_alloc(m * bn * sizeof(float));
+    }
     const int vlen = csrr_vlenb() * 8;
 
-    for (int i = 0; i < batch; i++) {
-        for (int g = 0; g < group; g++) {
-            // im2col
-            float *data_col = im2col_data;
-            float *channel_data = input_data;
+    for (int g = 0; g < group; g++) {
+        // im2col, samples are placed side by side: [k, batch * n]
+        for (int i = 0; i < batch; i++) {
+            float *data_col = im2col_data + i * n;
+            float *channel_data =
+                input_data + (i * group + g) * (in_ch / group) * in_height * in_width;
             for (int c = 0; c < in_ch / group; c++) {
                 for (int kh = 0; kh < ksize_h; kh++) {
                     for (int kw = 0; kw < ksize_w; kw++) {
@@ -96,7 +103,6 @@ int shl_rvv_common_conv_gemm_fp32(struct csinn_tensor *input, struct csinn_tenso
                             } else {
                                 int in_col = -pad_left + kw * dilation_w;
                                 for (int ow1 = 0; ow1 < out_width; ow1++) {
-                                    int col_idx = (c * out_height + oh) * out_width + ow1;
                                     if (in_col < in_width && in_col >= 0) {
                                         *data_col++ = channel_data[in_row * in_width + in_col];
                                     } else {
@@ -107,24 +113,30 @@ int shl_rvv_common_conv_gemm_fp32(struct csinn_tensor *input, struct csinn_tenso
                             }
                             in_row += stride_h;
                         }
+                        data_col += bn - n;
                     }
                 }
                 channel_data += in_height * in_width;
             }
+        }
 
-            float *pa = kernel_data + g * m * k;
-            float *pb = pb_reorder;
-            float *pc = output_data;
+        float *pa = kernel_data + g * m * k;
+        float *pb = pb_reorder;
+        float *pc = batch > 1 ? out_fold : output_data + g * m * n;
 
-            // pack
-            reorder_input(im2col_data, pb, k, n, n);
-            // GEMM
-            gemm(pc, pa, pb, bias_data + g * m, m, k, n, n);
+        // pack
+        reorder_input(im2col_data, pb, k, bn, bn);
+        // GEMM
+        gemm(pc, pa, pb, bias_data + g * m, m, k, bn, bn);
 
-            input_data += in_ch / group * in_height * in_width;
-            output_data += m * n;
+        if (batch > 1) {
+            shl_rvv_batch_unfold(output_data + g * m * n, out_fold, batch, m, n * sizeof(float),
+                                 out_ch * n * sizeof(float));
         }
     }
+    if (batch > 1) {
+        shl_mem_free(out_fold);
+    }
     shl_mem_free(pb_reorder);
     shl_mem_free(im2col_data);
     return CSINN_TRUE;
@@ -21,8 +21,8 @@
 /*************************************************************
  * note: VLEN = 128/256 ... flexible vlen
  *************************************************************/
-int shl_rvv_global_maxpool2d_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                                        struct csinn_pool_params *params)
+static int global_maxpool2d_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                       struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
@@ -59,3 +59,9 @@ int shl_rvv_global_maxpool2d_packn_fp32(struct csinn_tensor *input, struct csinn
     }
     return CSINN_TRUE;
 }
+
+int shl_rvv_global_maxpool2d_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                        struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, global_maxpool2d_packn_fp32);
+}
@@ -21,36 +21,27 @@
 /*************************************************************
     note: support flexible vlen
 *************************************************************/
-int shl_rvv_layer_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                            struct csinn_tensor *gamma, struct csinn_tensor *beta,
-                            struct csinn_layer_norm_params *params)
-{
-    if (params->center == false || params->scale == false) {
-        shl_debug_error("Layer norm only support center & scale == true\n");
-        return CSINN_FALSE;
-    }
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(input);
-    }
-    float *input_data = (float *)input->data;
-    float *output_data = (float *)output->data;
-    float *gamma_data = (float *)gamma->data;
-    float *beta_data = (float *)beta->data;
+struct layer_norm_fp32_task {
+    float *input_data;
+    float *output_data;
+    float *gamma_data;
+    float *beta_data;
+    int32_t norm_size;
+    float epsilon;
+};
 
-    /* support negative axis */
-    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
-
-    int32_t batches = 1;
-    for (int i = 0; i < axis; i++) {
-        batches *= input->dim[i];
-    }
-    int32_t norm_size = 1;
-    for (int i = axis; i < input->dim_count; i++) {
-        norm_size *= input->dim[i];
-    }
+/* rows are normalized independently, every thread keeps its own centered copy */
+static void layer_norm_fp32_rows(void *arg, int start, int end)
+{
+    struct layer_norm_fp32_task *t = (struct layer_norm_fp32_task *)arg;
+    float *input_data = t->input_data;
+    float *output_data = t->output_data;
+    float *gamma_data = t->gamma_data;
+    float *beta_data = t->beta_data;
+    int32_t norm_size = t->norm_size;
 
     float *tmp = (float *)shl_mem_alloc(norm_size * sizeof(float));
-    for (int b = 0; b < batches; b++) {
+    for (int b = start; b < end; b++) {
         float *input_ptr = input_data + b * norm_size;
         float *output_ptr = output_data + b * norm_size;
 
@@ -84,7 +75,7 @@ int shl_rvv_layer_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *out
         }
         float sum2 = vfmv_f_s_f32m1_f32(_sum2);
         float var = sum2 / norm_size;
-        float std = sqrt(var + params->epsilon);
+        float std = sqrt(var + t->epsilon);
 
         float *g0 = gamma_data;
         float *b0 = beta_data;
@@ -106,6 +97,39 @@ int shl_rvv_layer_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *out
         }
     }
     shl_mem_free(tmp);
+}
+
+int shl_rvv_layer_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                            struct csinn_tensor *gamma, struct csinn_tensor *beta,
+                            struct csinn_layer_norm_params *params)
+{
+    if (params->center == false || params->scale == false) {
+        shl_debug_error("Layer norm only support center & scale == true\n");
+        return CSINN_FALSE;
+    }
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(input);
+    }
+    float *input_data = (float *)input->data;
+    float *output_data = (float *)output->data;
+    float *gamma_data = (float *)gamma->data;
+    float *beta_data = (float *)beta->data;
+
+    /* support negative axis */
+    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
+
+    int32_t batches = 1;
+    for (int i = 0; i < axis; i++) {
+        batches *= input->dim[i];
+    }
+    int32_t norm_size = 1;
+    for (int i = axis; i < input->dim_count; i++) {
+        norm_size *= input->dim[i];
+    }
+
+    struct layer_norm_fp32_task task = {input_data, output_data, gamma_data, beta_data, norm_size,
+                                        params->epsilon};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, layer_norm_fp32_rows, &task);
 
     return CSINN_TRUE;
 }
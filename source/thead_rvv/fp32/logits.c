@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+/*************************************************************
+ * Whole-row scans over fp32 logits used by the llm sampler.
+ *************************************************************/
+float shl_rvv_reduce_max_fp32(const float *x, int n)
+{
+    if (n <= 0) {
+        return -FLT_MAX;
+    }
+    size_t vlmax = vsetvl_e32m4(n);
+    vfloat32m4_t _max = vfmv_v_f_f32m4(-FLT_MAX, vlmax);
+    int i = 0;
+    for (; i + vlmax <= n; i += vlmax) {
+        vfloat32m4_t _x = vle32_v_f32m4(x + i, vlmax);
+        _max = vfmax_vv_f32m4(_x, _max, vlmax);
+    }
+    vfloat32m1_t _res = vfmv_v_f_f32m1(-FLT_MAX, 1);
+    _res = vfredmax_vs_f32m4_f32m1(vundefined_f32m1(), _max, _res, vlmax);
+    if (i < n) {
+        size_t vl = vsetvl_e32m4(n - i);
+        vfloat32m4_t _x = vle32_v_f32m4(x + i, vl);
+        _res = vfredmax_vs_f32m4_f32m1(vundefined_f32m1(), _x, _res, vl);
+    }
+    return vfmv_f_s_f32m1_f32(_res);
+}
+
+/* index of the first x[i] >= thr, -1 if none */
+int shl_rvv_find_ge_fp32(const float *x, int n, float thr)
+{
+    int i = 0;
+    while (i < n) {
+        size_t vl = vsetvl_e32m4(n - i);
+        vfloat32m4_t _x = vle32_v_f32m4(x + i, vl);
+        vbool8_t _mask = vmfge_vf_f32m4_b8(_x, thr, vl);
+        long first = vfirst_m_b8(_mask, vl);
+        if (first >= 0) {
+            return i + first;
+        }
+        i += vl;
+    }
+    return -1;
+}
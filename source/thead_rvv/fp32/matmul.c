@@ -82,7 +82,7 @@ int shl_rvv_matmul_block_fp32(struct csinn_tensor *mat0, struct csinn_tensor *ma
                 shl_mem_free(in1);
             }
         } else if (batches_a > 1 && batches_b == 1) {
-            float *in0 = (float *)shl_mem_alloc(dim_m * dim_k * sizeof(float));
+            float *in0 = (float *)shl_mem_alloc(batches_a * dim_m * dim_k * sizeof(float));
             float *in1;
             if (!(mat1->is_const)) {
                 in1 = (float *)shl_mem_alloc(dim_k * dim_n * sizeof(float));
@@ -91,15 +91,12 @@ int shl_rvv_matmul_block_fp32(struct csinn_tensor *mat0, struct csinn_tensor *ma
                 in1 = mat1_data;
             }
 
-            for (int b = 0; b < batches_a; b++) {
-                shl_rvv_reorder_a_block_12xk_fp32(mat0_data, in0, dim_m, dim_k, M_BLK, K_BLK);
-
-                shl_rvv_gemm_block_12xpack2n_fp32(output_data, in0, in1, NULL, dim_m, dim_k, dim_n,
-                                                  M_BLK, K_BLK, N_BLK);
-
-                mat0_data += dim_m * dim_k;
-                output_data += dim_m * dim_n;
-            }
+            /* mat1 is shared by every batch, fold the batches into the rows of a single gemm
+             * so that packed mat1 is streamed once instead of once per batch */
+            const int fold_m = batches_a * dim_m;
+            shl_rvv_reorder_a_block_12xk_fp32(mat0_data, in0, fold_m, dim_k, M_BLK, K_BLK);
+            shl_rvv_gemm_block_12xpack2n_fp32(output_data, in0, in1, NULL, fold_m, dim_k, dim_n,
+                                              M_BLK, K_BLK, N_BLK);
             shl_mem_free(in0);
             if (!(mat1->is_const)) {
                 shl_mem_free(in1);
@@ -166,6 +163,10 @@ int shl_rvv_matmul_init_fp32(struct csinn_tensor *mat0, struct csinn_tensor *mat
             cb->exec = shl_rvv_matmul_fp32;
         }
     }
+    if (!params->trans_a && params->trans_b && params->act_quant != CSINN_ACT_QUANT_NONE &&
+        (mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q8_0 || mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0)) {
+        cb->exec = shl_rvv_matmul_a0b1_dynamic_quant;
+    }
     if (cb->exec == NULL) {
         shl_debug_warning(
             "matmul is not optimized to achieve under this condition on RVV, call reference func "
@@ -21,8 +21,8 @@
 /*************************************************************
  * note: support flexible vlen
  *************************************************************/
-int shl_rvv_maxpool3x3s2_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                                    struct csinn_pool_params *params)
+static int maxpool3x3s2_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
@@ -96,8 +96,14 @@ int shl_rvv_maxpool3x3s2_packn_fp32(struct csinn_tensor *input, struct csinn_ten
     return CSINN_TRUE;
 }
 
-int shl_rvv_maxpool3x3s1_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+int shl_rvv_maxpool3x3s2_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                                     struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, maxpool3x3s2_packn_fp32);
+}
+
+static int maxpool3x3s1_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
@@ -170,3 +176,9 @@ int shl_rvv_maxpool3x3s1_packn_fp32(struct csinn_tensor *input, struct csinn_ten
     shl_mem_free(input_ncxhwx);
     return CSINN_TRUE;
 }
+
+int shl_rvv_maxpool3x3s1_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                                    struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, maxpool3x3s1_packn_fp32);
+}
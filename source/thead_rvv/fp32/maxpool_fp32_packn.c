@@ -96,8 +96,8 @@ static void maxpool_border_fp32_packn(const float *src, float *dst,
     vse32_v_f32m1(out_ptr, _max, vl);
 }
 
-int shl_rvv_maxpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                               struct csinn_pool_params *params)
+static int maxpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
@@ -157,3 +157,9 @@ int shl_rvv_maxpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *
     }
     return CSINN_TRUE;
 }
+
+int shl_rvv_maxpool_packn_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, maxpool_packn_fp32);
+}
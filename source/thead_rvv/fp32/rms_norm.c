@@ -18,28 +18,25 @@
 
 #include "rvv/rvv.h"
 
-int shl_rvv_rms_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *weight,
-                          struct csinn_tensor *output, struct csinn_rms_norm_params *params)
+struct rms_norm_fp32_task {
+    float *input_data;
+    float *output_data;
+    float *weight_data;
+    int32_t norm_size;
+    float eps;
+};
+
+/* rows are normalized independently */
+static void rms_norm_fp32_rows(void *arg, int start, int end)
 {
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(input);
-    }
-    float *input_data = (float *)input->data;
-    float *output_data = (float *)output->data;
-    float *weight_data = (float *)weight->data;
-    float eps = params->epsilon;
-    /* support negative axis */
-    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
-    int32_t batches = 1;
-    for (int i = 0; i < axis; i++) {
-        batches *= input->dim[i];
-    }
-    int32_t norm_size = 1;
-    for (int i = axis; i < input->dim_count; i++) {
-        norm_size *= input->dim[i];
-    }
+    struct rms_norm_fp32_task *t = (struct rms_norm_fp32_task *)arg;
+    float *input_data = t->input_data;
+    float *output_data = t->output_data;
+    float *weight_data = t->weight_data;
+    int32_t norm_size = t->norm_size;
+    float eps = t->eps;
 
-    for (int b = 0; b < batches; b++) {
+    for (int b = start; b < end; b++) {
         float *input_ptr = input_data + b * norm_size;
         float *output_ptr = output_data + b * norm_size;
 
@@ -67,6 +64,31 @@ int shl_rvv_rms_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *weigh
             i += vl;
         }
     }
+}
+
+int shl_rvv_rms_norm_fp32(struct csinn_tensor *input, struct csinn_tensor *weight,
+                          struct csinn_tensor *output, struct csinn_rms_norm_params *params)
+{
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(input);
+    }
+    float *input_data = (float *)input->data;
+    float *output_data = (float *)output->data;
+    float *weight_data = (float *)weight->data;
+    float eps = params->epsilon;
+    /* support negative axis */
+    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
+    int32_t batches = 1;
+    for (int i = 0; i < axis; i++) {
+        batches *= input->dim[i];
+    }
+    int32_t norm_size = 1;
+    for (int i = axis; i < input->dim_count; i++) {
+        norm_size *= input->dim[i];
+    }
+
+    struct rms_norm_fp32_task task = {input_data, output_data, weight_data, norm_size, eps};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, rms_norm_fp32_rows, &task);
 
     return CSINN_TRUE;
 }
@@ -18,6 +18,26 @@
 
 #include "rvv/rvv.h"
 
+/* one head: (x0, x1) pairs rotated by the (sin, cos) pairs of table */
+static void rope_row_fp32(const float *src, const float *table, float *dst, int n_pairs)
+{
+    while (n_pairs > 0) {
+        size_t vl = vsetvl_e32m2(n_pairs);
+        vfloat32m2_t _x0, _x1, _sin, _cos;
+        vlseg2e32_v_f32m2(&_x0, &_x1, src, vl);
+        vlseg2e32_v_f32m2(&_sin, &_cos, table, vl);
+        vfloat32m2_t _y0 = vfmul_vv_f32m2(_x0, _cos, vl);
+        _y0 = vfnmsac_vv_f32m2(_y0, _x1, _sin, vl);
+        vfloat32m2_t _y1 = vfmul_vv_f32m2(_x0, _sin, vl);
+        _y1 = vfmacc_vv_f32m2(_y1, _x1, _cos, vl);
+        vsseg2e32_v_f32m2(dst, _y0, _y1, vl);
+        src += 2 * vl;
+        table += 2 * vl;
+        dst += 2 * vl;
+        n_pairs -= vl;
+    }
+}
+
 int shl_rvv_rope_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                       struct csinn_rope_params *params)
 {
@@ -36,7 +56,7 @@ int shl_rvv_rope_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
     if (!params->use_rope_cache) {
         for (int i3 = 0; i3 < input->dim[0]; i3++) {
             for (int i2 = 0; i2 < input->dim[1]; i2++) {
-                int p = pos[i2];
+                int p = pos[i3 * input->dim[1] + i2];
                 for (int i1 = 0; i1 < input->dim[2]; i1++) {
                     float theta = freq_scale * (float)p;
 
@@ -65,22 +85,36 @@ int shl_rvv_rope_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                 }
             }
         }
+    } else if (params->rope_cache_shared) {
+        float *rope_cache = (float *)params->rope_cache;
+        int head_dim = input->dim[3];
+        for (int i3 = 0; i3 < input->dim[0]; i3++) {
+            for (int i2 = 0; i2 < input->dim[1]; i2++) {
+                int p = pos[i3 * input->dim[1] + i2];
+                for (int i1 = 0; i1 < input->dim[2]; i1++) {
+                    int index = ((i3 * input->dim[1] + i2) * input->dim[2] + i1) * head_dim;
+                    rope_row_fp32(src_data + index, rope_cache + p * head_dim, dst_data + index,
+                                  head_dim / 2);
+                }
+            }
+        }
     } else {
-        float *rope_cache = &((float *)params->rope_cache)[pos[0] * input->dim[2] * input->dim[3]];
+        float *rope_cache = (float *)params->rope_cache;
         for (int i3 = 0; i3 < input->dim[0]; i3++) {
             for (int i2 = 0; i2 < input->dim[1]; i2++) {
+                int p = pos[i3 * input->dim[1] + i2];
                 for (int i1 = 0; i1 < input->dim[2]; i1++) {
                     for (int i0 = 0; i0 < input->dim[3]; i0 += 2) {
                         int index = i3 * (input->dim[3] * input->dim[2] * input->dim[1]) +
                                     i2 * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
 
                         int rope_cache_index =
-                            i2 * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
+                            p * (input->dim[3] * input->dim[2]) + i1 * input->dim[3] + i0;
 
                         float x0 = src_data[index];
                         float x1 = src_data[index + 1];
-                        float sin_theta = rope_cache[index];
-                        float cos_theta = rope_cache[index + 1];
+                        float sin_theta = rope_cache[rope_cache_index];
+                        float cos_theta = rope_cache[rope_cache_index + 1];
 
                         dst_data[index] = x0 * cos_theta - x1 * sin_theta;
                         dst_data[index + 1] = x0 * sin_theta + x1 * cos_theta;
@@ -19,13 +19,11 @@
 #include "rvv/rvv.h"
 #include "rvv_mathfun_fp32.h"
 
-int shl_rvv_sigmoid_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                         struct csinn_sigmoid_params *params)
+static void sigmoid_fp32(void *input, void *output, int32_t size, void *arg)
 {
-    float *input_data = (float *)input->data;
-    float *output_data = (float *)output->data;
+    float *input_data = (float *)input;
+    float *output_data = (float *)output;
 
-    int size = csinn_tensor_size(input);
     while (size > 0) {
         size_t vl = vsetvl_e32m2(size);
 
@@ -40,6 +38,13 @@ int shl_rvv_sigmoid_fp32(struct csinn_tensor *input, struct csinn_tensor *output
         output_data += vl;
         size -= vl;
     }
+}
+
+int shl_rvv_sigmoid_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                         struct csinn_sigmoid_params *params)
+{
+    shl_rvv_unary_op_flat(input->data, output->data, csinn_tensor_size(input), sizeof(float),
+                          sigmoid_fp32, NULL);
     output->layout = input->layout;
     output->dim_count = input->dim_count;
     for (int i = 0; i < output->dim_count; i++) {
@@ -23,13 +23,11 @@
  * silu(x) = x * sigmoid(x)
  *         = x / (1 + exp(-x))
  **************************************************************************************/
-int shl_rvv_silu_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                      struct csinn_sigmoid_params *params)
+static void silu_fp32(void *input, void *output, int32_t size, void *arg)
 {
-    float *input_data = (float *)input->data;
-    float *output_data = (float *)output->data;
+    float *input_data = (float *)input;
+    float *output_data = (float *)output;
 
-    int size = csinn_tensor_size(input);
     int i = 0;
     while (i < size) {
         size_t vl = vsetvl_e32m2(size - i);
@@ -41,6 +39,13 @@ int shl_rvv_silu_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
         vse32_v_f32m2(output_data + i, _res, vl);
         i += vl;
     }
+}
+
+int shl_rvv_silu_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                      struct csinn_sigmoid_params *params)
+{
+    shl_rvv_unary_op_flat(input->data, output->data, csinn_tensor_size(input), sizeof(float),
+                          silu_fp32, NULL);
 
     output->layout = input->layout;
     output->dim_count = input->dim_count;
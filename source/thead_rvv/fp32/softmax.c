@@ -31,32 +31,28 @@ static inline float fast_exp32(float y)
     return data.d;
 }
 
-int shl_rvv_softmax_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
-                         struct csinn_softmax_params *params)
-{
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(input);
-    }
-    float *input_data = (float *)input->data;
-    float *output_data = (float *)output->data;
+struct softmax_fp32_task {
+    float *input_data;
+    float *output_data;
+    int64_t inner_size;
+    int cnt;
+    int pack2n;
+};
 
-    int axis = params->axis;
-    axis = axis < 0 ? axis + input->dim_count : axis;
-    // FlatSize() = outer_size * inner_size * cnt;
-    int64_t outer_size = 1;
-    for (int i = 0; i < axis; i++) {
-        outer_size *= input->dim[i];
-    }
-
-    int64_t inner_size = 1;
-    for (int i = axis + 1; i < input->dim_count; i++) {
-        inner_size *= input->dim[i];
-    }
+/* every outer slice is an independent softmax */
+static void softmax_fp32_rows(void *arg, int start, int end)
+{
+    struct softmax_fp32_task *t = (struct softmax_fp32_task *)arg;
+    float *input_data = t->input_data;
+    float *output_data = t->output_data;
+    int64_t inner_size = t->inner_size;
+    int cnt = t->cnt;
+    int pack2n = t->pack2n;
 
-    int cnt = input->dim[axis];
-    int pack2n = csrr_vlenb() / sizeof(float) * 2;
+    input_data += start * inner_size * cnt;
+    output_data += start * inner_size * cnt;
     float *exp_buffer = (float *)shl_mem_alloc(inner_size * cnt * sizeof(float));
-    for (int i = 0; i < outer_size; i++) {
+    for (int i = start; i < end; i++) {
         for (int k = 0; k < inner_size; k++) {
             float acc_exp = 0.0f;
             float max = -FLT_MAX;
@@ -106,5 +102,33 @@ int shl_rvv_softmax_fp32(struct csinn_tensor *input, struct csinn_tensor *output
         output_data += inner_size * cnt;
     }
     shl_mem_free(exp_buffer);
+}
+
+int shl_rvv_softmax_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
+                         struct csinn_softmax_params *params)
+{
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(input);
+    }
+    float *input_data = (float *)input->data;
+    float *output_data = (float *)output->data;
+
+    int axis = params->axis;
+    axis = axis < 0 ? axis + input->dim_count : axis;
+    // FlatSize() = outer_size * inner_size * cnt;
+    int64_t outer_size = 1;
+    for (int i = 0; i < axis; i++) {
+        outer_size *= input->dim[i];
+    }
+
+    int64_t inner_size = 1;
+    for (int i = axis + 1; i < input->dim_count; i++) {
+        inner_size *= input->dim[i];
+    }
+
+    int cnt = input->dim[axis];
+    int pack2n = csrr_vlenb() / sizeof(float) * 2;
+    struct softmax_fp32_task task = {input_data, output_data, inner_size, cnt, pack2n};
+    shl_rvv_parallel_for(outer_size, outer_size * inner_size * cnt, softmax_fp32_rows, &task);
     return CSINN_TRUE;
 }
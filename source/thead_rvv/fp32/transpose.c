@@ -18,25 +18,43 @@
 
 #include "rvv/rvv.h"
 
-static void transpose_021_fp32(float *src, float *dst, int batch, int inner_size, int outer_size)
+struct transpose_021_fp32_task {
+    float *src;
+    float *dst;
+    int inner_size;
+    int outer_size;
+};
+
+/* every (batch, outer) row is scattered into its own output column */
+static void transpose_021_fp32_rows(void *arg, int start, int end)
 {
-    for (int b = 0; b < batch; b++) {
-        for (int i = 0; i < outer_size; i++) {
-            int size = inner_size;
-            float *d_ptr = dst + i;
-            while (size > 0) {
-                int vl = vsetvl_e32m4(size);
-                vfloat32m4_t _in = vle32_v_f32m4(src, vl);
-                src += vl;
-                vsse32_v_f32m4(d_ptr, outer_size * sizeof(float), _in, vl);
-                d_ptr += vl * outer_size;
-                size -= vl;
-            }
+    struct transpose_021_fp32_task *t = (struct transpose_021_fp32_task *)arg;
+    int inner_size = t->inner_size;
+    int outer_size = t->outer_size;
+    for (int r = start; r < end; r++) {
+        int b = r / outer_size;
+        int i = r % outer_size;
+        float *src = t->src + (int64_t)r * inner_size;
+        float *d_ptr = t->dst + (int64_t)b * inner_size * outer_size + i;
+        int size = inner_size;
+        while (size > 0) {
+            int vl = vsetvl_e32m4(size);
+            vfloat32m4_t _in = vle32_v_f32m4(src, vl);
+            src += vl;
+            vsse32_v_f32m4(d_ptr, outer_size * sizeof(float), _in, vl);
+            d_ptr += vl * outer_size;
+            size -= vl;
         }
-        dst += inner_size * outer_size;
     }
 }
 
+static void transpose_021_fp32(float *src, float *dst, int batch, int inner_size, int outer_size)
+{
+    struct transpose_021_fp32_task task = {src, dst, inner_size, outer_size};
+    shl_rvv_parallel_for(batch * outer_size, (int64_t)batch * outer_size * inner_size,
+                         transpose_021_fp32_rows, &task);
+}
+
 static int transpose_tail_coincide_fp32(struct csinn_tensor *input, struct csinn_tensor *output,
                                         struct csinn_transpose_params *params, int tail)
 {
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+#ifdef SHL_USE_DOT_INT4
+void shl_rvv_deconv2d_gemm_col2im_reorder_kernel_int4(struct csinn_tensor *kernel,
+                                                      struct csinn_conv2d_params *params)
+{
+    shl_rvv_deconv2d_gemm_col2im_reorder_kernel_common_int8(kernel, params, true);
+}
+
+int shl_rvv_deconv2d_gemm_col2im_int4(struct csinn_tensor *input, struct csinn_tensor *output,
+                                      struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                      struct csinn_conv2d_params *params)
+{
+    return shl_rvv_deconv2d_gemm_col2im_common_int8(input, output, kernel, bias, params, true);
+}
+
+int shl_rvv_deconv2d_init_int4(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                               struct csinn_conv2d_params *params)
+{
+    struct csinn_callback *cb = params->base.cb;
+    struct csinn_session *sess = params->base.sess;
+
+    /* int4 values are unpacked to int16 and run through the int8 kernel */
+    if (kernel->quant_channel > 1 || params->base.layout != CSINN_LAYOUT_NCHW) {
+        cb->exec = params->group > 1 ? shl_ref_group_deconv2d_quant : shl_ref_deconv2d_quant;
+        return CSINN_TRUE;
+    }
+
+    bool binary_model_op_init = shl_rvv_get_binary_model_op_init(sess);
+
+    params->conv_extra.conv_mode = CSINN_GEMM;
+    if (!binary_model_op_init) {
+        params->conv_extra.kernel_tm = csinn_alloc_tensor(NULL);
+        shl_rvv_deconv2d_gemm_col2im_reorder_kernel_int4(kernel, params);
+    }
+    float real_scale = input->qinfo->scale * kernel->qinfo->scale / output->qinfo->scale;
+    shl_quantize_multiplier(real_scale, &(kernel->qinfo->multiplier), &(kernel->qinfo->shift));
+    cb->exec = shl_rvv_deconv2d_gemm_col2im_int4;
+
+    return CSINN_TRUE;
+}
+#endif
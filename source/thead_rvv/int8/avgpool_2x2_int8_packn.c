@@ -23,8 +23,8 @@
  * q2 = s1/s2 * (∑(q1 - z1))/4 + z2
  * constrain: input channel % packn = 0
  *************************************************************/
-int shl_rvv_avgpool2x2s2_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                                    struct csinn_pool_params *params)
+static int avgpool2x2s2_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
@@ -114,3 +114,9 @@ int shl_rvv_avgpool2x2s2_packn_int8(struct csinn_tensor *input, struct csinn_ten
     shl_mem_free(input_ncxhwx);
     return CSINN_TRUE;
 }
+
+int shl_rvv_avgpool2x2s2_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                    struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool2x2s2_packn_int8);
+}
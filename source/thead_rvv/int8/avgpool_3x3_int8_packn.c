@@ -23,8 +23,8 @@
  * q2 = s1/s2 * (∑(q1 - z1))/9 + z2
  * constrain: input channel % packn = 0
  *************************************************************/
-int shl_rvv_avgpool3x3s2_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                                    struct csinn_pool_params *params)
+static int avgpool3x3s2_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
@@ -128,8 +128,14 @@ int shl_rvv_avgpool3x3s2_packn_int8(struct csinn_tensor *input, struct csinn_ten
     return CSINN_TRUE;
 }
 
-int shl_rvv_avgpool3x3s1_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+int shl_rvv_avgpool3x3s2_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                                     struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool3x3s2_packn_int8);
+}
+
+static int avgpool3x3s1_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                   struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
@@ -230,4 +236,10 @@ int shl_rvv_avgpool3x3s1_packn_int8(struct csinn_tensor *input, struct csinn_ten
     }
     shl_mem_free(input_ncxhwx);
     return CSINN_TRUE;
+}
+
+int shl_rvv_avgpool3x3s1_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                    struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool3x3s1_packn_int8);
 }
\ No newline at end of file
@@ -169,13 +169,23 @@ static void avgpool_border_int8_nhwc(const int8_t *src, int8_t *dst,
     }
 }
 
-int shl_rvv_avgpool_nhwc_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                              struct csinn_pool_params *params)
+/* border / center / border location of the output rows above, inside and below the input */
+static const enum avgpool_loc_enum avgpool_nhwc_loc[3][3] = {
+    {AVGPOOL_LEFT_TOP, AVGPOOL_TOP, AVGPOOL_RIGHT_TOP},
+    {AVGPOOL_LEFT, AVGPOOL_CENTER, AVGPOOL_RIGHT},
+    {AVGPOOL_LEFT_BOTTOM, AVGPOOL_BOTTOM, AVGPOOL_RIGHT_BOTTOM},
+};
+
+static void avgpool_nhwc_int8_rows(void *arg, int start, int end)
 {
+    struct shl_rvv_pool_task *t = (struct shl_rvv_pool_task *)arg;
+    struct csinn_tensor *input = t->input;
+    struct csinn_tensor *output = t->output;
+    struct csinn_pool_params *params = t->params;
+
     int8_t *input_data = (int8_t *)input->data;
     int8_t *output_data = (int8_t *)output->data;
 
-    int batch = input->dim[0];
     int in_h = input->dim[1];
     int in_w = input->dim[2];
     int in_c = input->dim[3];
@@ -201,70 +211,40 @@ int shl_rvv_avgpool_nhwc_int8(struct csinn_tensor *input, struct csinn_tensor *o
     int z1 = input->qinfo->zero_point;
     int z2 = output->qinfo->zero_point;
 
-    for (int b = 0; b < batch; b++) {
+    for (int r = start; r < end; r++) {
+        int b = r / out_h;
+        int oh = r % out_h;
         const int8_t *in_ptr = input_data + b * in_h * in_w * in_c;
         int8_t *out_ptr = output_data + b * out_h * out_w * out_c;
-
-        int oh = 0;
-        for (; oh < dst_start_h; oh++) {
-            int in_h_start = -pad_top + oh * stride_h;
-            int in_h_end = in_h_start + kernel_h;
-            const int idx_h_start = max(in_h_start, 0);
-            const int idx_h_end = min(in_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_LEFT_TOP, real_scale, z1, z2);
-            }
-            for (; ow + 7 < dst_1x8_end_w; ow += 8) {
-                avgpool_w8_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
-                                     out_w, in_c, AVGPOOL_TOP, real_scale, z1, z2);
-            }
-            for (; ow < out_w; ow++) {
-                avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_RIGHT_TOP, real_scale, z1, z2);
-            }
+        const enum avgpool_loc_enum *loc =
+            avgpool_nhwc_loc[oh < dst_start_h ? 0 : (oh < dst_end_h ? 1 : 2)];
+
+        int in_h_start = -pad_top + oh * stride_h;
+        int in_h_end = in_h_start + kernel_h;
+        const int idx_h_start = max(in_h_start, 0);
+        const int idx_h_end = min(in_h_end, in_h);
+        int ow = 0;
+        for (; ow < dst_1x8_start_w; ow++) {
+            avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                     out_w, in_c, loc[0], real_scale, z1, z2);
         }
-        for (; oh < dst_end_h; oh++) {
-            int in_h_start = -pad_top + oh * stride_h;
-            int in_h_end = in_h_start + kernel_h;
-            const int idx_h_start = max(in_h_start, 0);
-            const int idx_h_end = min(in_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_LEFT, real_scale, z1, z2);
-            }
-            for (; ow + 7 < dst_1x8_end_w; ow += 8) {
-                avgpool_w8_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
-                                     out_w, in_c, AVGPOOL_CENTER, real_scale, z1, z2);
-            }
-            for (; ow < out_w; ow++) {
-                avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_RIGHT, real_scale, z1, z2);
-            }
+        for (; ow + 7 < dst_1x8_end_w; ow += 8) {
+            avgpool_w8_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                 out_w, in_c, loc[1], real_scale, z1, z2);
         }
-        for (; oh < out_h; oh++) {
-            int in_h_start = -pad_top + oh * stride_h;
-            int in_h_end = in_h_start + kernel_h;
-            const int idx_h_start = max(in_h_start, 0);
-            const int idx_h_end = min(in_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_LEFT_BOTTOM, real_scale, z1,
-                                         z2);
-            }
-            for (; ow + 7 < dst_1x8_end_w; ow += 8) {
-                avgpool_w8_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
-                                     out_w, in_c, AVGPOOL_BOTTOM, real_scale, z1, z2);
-            }
-            for (; ow < out_w; ow++) {
-                avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c, AVGPOOL_RIGHT_BOTTOM, real_scale, z1,
-                                         z2);
-            }
+        for (; ow < out_w; ow++) {
+            avgpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                     out_w, in_c, loc[2], real_scale, z1, z2);
         }
     }
+}
+
+/* output rows of all batches are independent, split them over the threads */
+int shl_rvv_avgpool_nhwc_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
+{
+    struct shl_rvv_pool_task task = {input, output, params};
+    shl_rvv_parallel_for(input->dim[0] * output->dim[1], csinn_tensor_size(input),
+                         avgpool_nhwc_int8_rows, &task);
     return CSINN_TRUE;
 }
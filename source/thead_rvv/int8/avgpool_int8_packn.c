@@ -155,8 +155,8 @@ static void avgpool_border_int8_packn(const int8_t *src, int8_t *dst,
     vse8_v_i8m1(out_ptr, vnclip_wx_i8m1(_res, 0, vl), vl);
 }
 
-int shl_rvv_avgpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                               struct csinn_pool_params *params)
+static int avgpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
@@ -263,3 +263,9 @@ int shl_rvv_avgpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *
     }
     return CSINN_TRUE;
 }
+
+int shl_rvv_avgpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, avgpool_packn_int8);
+}
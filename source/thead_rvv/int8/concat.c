@@ -17,37 +17,25 @@
  */
 #include "rvv/rvv.h"
 
-static int shl_rvv_concat_ndarray_int8(struct csinn_tensor **input, struct csinn_tensor *output,
-                                       struct csinn_concat_params *params)
+struct concat_ndarray_int8_task {
+    struct csinn_tensor **input;
+    struct csinn_tensor *output;
+    struct csinn_concat_params *params;
+    int64_t base_inner_size;
+};
+
+/* every outer slice gathers its own part of all inputs */
+static void concat_ndarray_int8_rows(void *arg, int start, int end)
 {
-    /* update output tensor */
-    output->layout = input[0]->layout;
-    output->dim_count = input[0]->dim_count;
-    for (int i = 0; i < output->dim_count; i++) {
-        output->dim[i] = input[0]->dim[i];
-    }
-    int axis_shape = 0;
-    for (int i = 0; i < params->inputs_count; i++) {
-        axis_shape += input[i]->dim[params->axis];
-    }
-    output->dim[params->axis] = axis_shape;
+    struct concat_ndarray_int8_task *t = (struct concat_ndarray_int8_task *)arg;
+    struct csinn_tensor **input = t->input;
+    struct csinn_tensor *output = t->output;
+    struct csinn_concat_params *params = t->params;
+    int64_t base_inner_size = t->base_inner_size;
 
-    int64_t outer_size = 1;
-    for (int i = 0; i < params->axis; ++i) {
-        outer_size *= output->dim[i];
-    }
-    int64_t base_inner_size = 1;
-    for (int i = params->axis + 1; i < output->dim_count; ++i) {
-        base_inner_size *= output->dim[i];
-    }
-    for (int q = 0; q < params->inputs_count; q++) {
-        struct csinn_tensor *input_item = input[q];
-        shl_quantize_multiplier(input_item->qinfo->scale / output->qinfo->scale,
-                                &input_item->qinfo->multiplier, &input_item->qinfo->shift);
-    }
-    int vl;
-    int8_t *output_ptr = (int8_t *)output->data;
-    for (int k = 0; k < outer_size; k++) {
+    int64_t slice_size = output->dim[params->axis] * base_inner_size;
+    int8_t *output_ptr = (int8_t *)output->data + start * slice_size;
+    for (int k = start; k < end; k++) {
         for (int i = 0; i < params->inputs_count; ++i) {
             struct csinn_tensor *input_item = input[i];
             int8_t *input_item_data = (int8_t *)input_item->data;
@@ -56,7 +44,7 @@ static int shl_rvv_concat_ndarray_int8(struct csinn_tensor **input, struct csinn
             /* input has same quant_info with output */
             if (memcmp(input_item->qinfo, output->qinfo, sizeof(struct csinn_quant_info)) == 0) {
                 while (copy_size > 0) {
-                    vl = vsetvl_e8m2(copy_size);
+                    int vl = vsetvl_e8m2(copy_size);
                     vint8m2_t _input = vle8_v_i8m2(input_ptr, vl);
                     input_ptr += vl;
                     vse8_v_i8m2(output_ptr, _input, vl);
@@ -66,7 +54,7 @@ static int shl_rvv_concat_ndarray_int8(struct csinn_tensor **input, struct csinn
             } else {
                 /*
                 while (copy_size > 0) {
-                    vl = vsetvl_e8m1(copy_size);
+                    int vl = vsetvl_e8m1(copy_size);
                     vint8m1_t _input = vle8_v_i8m1(input_ptr, vl);
                     vint16m2_t _input1 = vwsub_vx_i16m2(_input, input_item->qinfo->zero_point, vl);
                     vint32m4_t _input2 = vwadd_vx_i32m4(_input1, 0, vl);  // widden 16->32
@@ -88,7 +76,7 @@ static int shl_rvv_concat_ndarray_int8(struct csinn_tensor **input, struct csinn
                 }
                 */
                 while (copy_size > 0) {
-                    vl = vsetvl_e8m1(copy_size);
+                    int vl = vsetvl_e8m1(copy_size);
                     vint8m1_t _input = vle8_v_i8m1(input_ptr, vl);
                     vint16m2_t _input1 = vwsub_vx_i16m2(_input, input_item->qinfo->zero_point, vl);
                     vfloat16m2_t _inputf = vfcvt_f_x_v_f16m2(_input1, vl);
@@ -104,6 +92,39 @@ static int shl_rvv_concat_ndarray_int8(struct csinn_tensor **input, struct csinn
             }
         }
     }
+}
+
+static int shl_rvv_concat_ndarray_int8(struct csinn_tensor **input, struct csinn_tensor *output,
+                                       struct csinn_concat_params *params)
+{
+    /* update output tensor */
+    output->layout = input[0]->layout;
+    output->dim_count = input[0]->dim_count;
+    for (int i = 0; i < output->dim_count; i++) {
+        output->dim[i] = input[0]->dim[i];
+    }
+    int axis_shape = 0;
+    for (int i = 0; i < params->inputs_count; i++) {
+        axis_shape += input[i]->dim[params->axis];
+    }
+    output->dim[params->axis] = axis_shape;
+
+    int64_t outer_size = 1;
+    for (int i = 0; i < params->axis; ++i) {
+        outer_size *= output->dim[i];
+    }
+    int64_t base_inner_size = 1;
+    for (int i = params->axis + 1; i < output->dim_count; ++i) {
+        base_inner_size *= output->dim[i];
+    }
+    for (int q = 0; q < params->inputs_count; q++) {
+        struct csinn_tensor *input_item = input[q];
+        shl_quantize_multiplier(input_item->qinfo->scale / output->qinfo->scale,
+                                &input_item->qinfo->multiplier, &input_item->qinfo->shift);
+    }
+    struct concat_ndarray_int8_task task = {input, output, params, base_inner_size};
+    shl_rvv_parallel_for(outer_size, outer_size * output->dim[params->axis] * base_inner_size,
+                         concat_ndarray_int8_rows, &task);
     return CSINN_TRUE;
 }
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+/*
+ * int8/int4 deconvolution without the col buffer: for every (kh, kw) tap the products of a
+ * block of 4 output channels with one input row are accumulated in int32 registers and added
+ * straight into the output rows they land on, so the m * n col matrix of the fp32/fp16 path
+ * is never written. Output channel blocks of a group are independent and run in parallel.
+ */
+
+/* int4 little endian, two values per byte */
+static inline int32_t deconv_load_q(const int8_t *src, int64_t idx, bool int4)
+{
+    if (!int4) {
+        return src[idx];
+    }
+    int8_t tmp = src[idx / 2];
+    return idx % 2 ? tmp >> 4 : (int8_t)(tmp << 4) >> 4;
+}
+
+/* Kernel:[IC,OC/g,KH,KW] --> [g][OC/g/4][KH][KW][IC/g][4] int16, zero point removed */
+void shl_rvv_deconv2d_gemm_col2im_reorder_kernel_common_int8(struct csinn_tensor *kernel,
+                                                             struct csinn_conv2d_params *params,
+                                                             bool int4)
+{
+    int8_t *kernel_data = (int8_t *)kernel->data;
+    int32_t kernel_zp = kernel->qinfo->zero_point;
+    int group = params->group;
+    int k = kernel->dim[0] / group;
+    int m = kernel->dim[1];
+    int maxk = kernel->dim[2] * kernel->dim[3];
+    int m_block = (m + 3) / 4;
+
+    struct csinn_tensor *kernel_tm = params->conv_extra.kernel_tm;
+    csinn_tensor_copy(kernel_tm, kernel);
+    kernel_tm->dtype = CSINN_DTYPE_INT16;
+    /* output channels padded to the 4 lane blocks, so the byte size covers the whole buffer */
+    kernel_tm->dim[1] = m_block * 4;
+    kernel_tm->data = shl_mem_alloc(group * m_block * maxk * k * 4 * sizeof(int16_t));
+    int16_t *dst = (int16_t *)kernel_tm->data;
+
+    for (int g = 0; g < group; g++) {
+        for (int mb = 0; mb < m_block; mb++) {
+            for (int t = 0; t < maxk; t++) {
+                for (int ic = 0; ic < k; ic++) {
+                    for (int j = 0; j < 4; j++) {
+                        int oc = mb * 4 + j;
+                        int64_t idx = ((int64_t)(g * k + ic) * m + oc) * maxk + t;
+                        *dst++ = oc < m ? deconv_load_q(kernel_data, idx, int4) - kernel_zp : 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void shl_rvv_deconv2d_gemm_col2im_reorder_kernel_int8(struct csinn_tensor *kernel,
+                                                      struct csinn_conv2d_params *params)
+{
+    shl_rvv_deconv2d_gemm_col2im_reorder_kernel_common_int8(kernel, params, false);
+}
+
+struct deconv_int8_task {
+    int16_t *input;
+    int16_t *kernel;
+    int32_t *bias;
+    int32_t *acc;
+    int8_t *output;
+    struct csinn_tensor *in;
+    struct csinn_tensor *out;
+    struct csinn_conv2d_params *params;
+    int32_t m_block;
+    int32_t m;
+    int32_t k;
+    int32_t multiplier;
+    int32_t shift;
+    int32_t out_zp;
+    int32_t out_min;
+    int32_t out_max;
+};
+
+static inline void deconv_scatter_add(int32_t *dst, vint32m2_t _acc, int stride_w, int vl)
+{
+    if (stride_w == 1) {
+        vint32m2_t _dst = vle32_v_i32m2(dst, vl);
+        vse32_v_i32m2(dst, vadd_vv_i32m2(_dst, _acc, vl), vl);
+    } else {
+        vint32m2_t _dst = vlse32_v_i32m2(dst, stride_w * sizeof(int32_t), vl);
+        vsse32_v_i32m2(dst, stride_w * sizeof(int32_t), vadd_vv_i32m2(_dst, _acc, vl), vl);
+    }
+}
+
+/* accumulate the output channels [oc, oc + 4) of one group and requantize them */
+static void deconv_int8_block(struct deconv_int8_task *t, int g, int mb)
+{
+    struct csinn_conv2d_params *params = t->params;
+    int32_t in_h = t->in->dim[2];
+    int32_t in_w = t->in->dim[3];
+    int32_t out_h = t->out->dim[2];
+    int32_t out_w = t->out->dim[3];
+    int32_t kernel_h = params->conv_extra.kernel_tm->dim[2];
+    int32_t kernel_w = params->conv_extra.kernel_tm->dim[3];
+    int32_t stride_h = params->stride_height;
+    int32_t stride_w = params->stride_width;
+    int32_t dilation_h = params->dilation_height;
+    int32_t dilation_w = params->dilation_width;
+    int32_t k = t->k;
+    int32_t n = in_h * in_w;
+    int32_t out_hw = out_h * out_w;
+
+    int oc = g * t->m + mb * 4;
+    int oc_tail = t->m - mb * 4 < 4 ? t->m - mb * 4 : 4;
+    int32_t *acc = t->acc + (int64_t)oc * out_hw;
+    for (int j = 0; j < oc_tail; j++) {
+        int32_t bias = t->bias ? t->bias[oc + j] : 0;
+        for (int i = 0; i < out_hw; i++) {
+            acc[j * out_hw + i] = bias;
+        }
+    }
+
+    const int16_t *input = t->input + (int64_t)g * k * n;
+    const int16_t *kernel =
+        t->kernel + ((int64_t)g * t->m_block + mb) * kernel_h * kernel_w * k * 4;
+    for (int kh = 0; kh < kernel_h; kh++) {
+        for (int kw = 0; kw < kernel_w; kw++) {
+            const int16_t *kernel_ptr = kernel + (kh * kernel_w + kw) * k * 4;
+            /* ow = iw * stride_w + off_w must fall in [0, out_w) */
+            int off_w = kw * dilation_w - params->pad_left;
+            int iw_start = off_w >= 0 ? 0 : (stride_w - 1 - off_w) / stride_w;
+            int iw_end = out_w - 1 - off_w < 0 ? 0 : (out_w - 1 - off_w) / stride_w + 1;
+            iw_end = iw_end < in_w ? iw_end : in_w;
+            if (iw_start >= iw_end) {
+                continue;
+            }
+            for (int ih = 0; ih < in_h; ih++) {
+                int oh = ih * stride_h - params->pad_top + kh * dilation_h;
+                if (oh < 0 || oh >= out_h) {
+                    continue;
+                }
+                int32_t *out_row = acc + oh * out_w + iw_start * stride_w + off_w;
+                const int16_t *in_row = input + ih * in_w + iw_start;
+                int size = iw_end - iw_start;
+                while (size > 0) {
+                    int vl = vsetvl_e16m1(size);
+                    vint32m2_t _acc0 = vmv_v_x_i32m2(0, vl);
+                    vint32m2_t _acc1 = vmv_v_x_i32m2(0, vl);
+                    vint32m2_t _acc2 = vmv_v_x_i32m2(0, vl);
+                    vint32m2_t _acc3 = vmv_v_x_i32m2(0, vl);
+                    const int16_t *w = kernel_ptr;
+                    for (int c = 0; c < k; c++) {
+                        vint16m1_t _x = vle16_v_i16m1(in_row + c * n, vl);
+                        _acc0 = vwmacc_vx_i32m2(_acc0, w[0], _x, vl);
+                        _acc1 = vwmacc_vx_i32m2(_acc1, w[1], _x, vl);
+                        _acc2 = vwmacc_vx_i32m2(_acc2, w[2], _x, vl);
+                        _acc3 = vwmacc_vx_i32m2(_acc3, w[3], _x, vl);
+                        w += 4;
+                    }
+                    deconv_scatter_add(out_row, _acc0, stride_w, vl);
+                    if (oc_tail > 1) {
+                        deconv_scatter_add(out_row + out_hw, _acc1, stride_w, vl);
+                    }
+                    if (oc_tail > 2) {
+                        deconv_scatter_add(out_row + 2 * out_hw, _acc2, stride_w, vl);
+                    }
+                    if (oc_tail > 3) {
+                        deconv_scatter_add(out_row + 3 * out_hw, _acc3, stride_w, vl);
+                    }
+                    in_row += vl;
+                    out_row += vl * stride_w;
+                    size -= vl;
+                }
+            }
+        }
+    }
+
+    int8_t *output = t->output + (int64_t)oc * out_hw;
+    int size = oc_tail * out_hw;
+    while (size > 0) {
+        int vl = vsetvl_e32m4(size);
+        vint32m4_t _acc = vle32_v_i32m4(acc, vl);
+        _acc = shl_rvv_requantize_i32m4(_acc, t->multiplier, t->shift, vl);
+        _acc = vadd_vx_i32m4(_acc, t->out_zp, vl);
+        _acc = vmax_vx_i32m4(_acc, t->out_min, vl);
+        _acc = vmin_vx_i32m4(_acc, t->out_max, vl);
+        vint16m2_t _res16 = vnclip_wx_i16m2(_acc, 0, vl);
+        vse8_v_i8m1(output, vnclip_wx_i8m1(_res16, 0, vl), vl);
+        acc += vl;
+        output += vl;
+        size -= vl;
+    }
+}
+
+static void deconv_int8_blocks(void *arg, int start, int end)
+{
+    struct deconv_int8_task *t = (struct deconv_int8_task *)arg;
+    for (int i = start; i < end; i++) {
+        deconv_int8_block(t, i / t->m_block, i % t->m_block);
+    }
+}
+
+// Data format : NCHW  Input:[N,IC,IH,IW] Kernel:[g][OC/g/4][KH][KW][IC/g][4] Output:[N,OC,OH,OW]
+int shl_rvv_deconv2d_gemm_col2im_common_int8(struct csinn_tensor *input,
+                                             struct csinn_tensor *output,
+                                             struct csinn_tensor *kernel,
+                                             struct csinn_tensor *bias,
+                                             struct csinn_conv2d_params *params, bool int4)
+{
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_debug_info("Data Format: NC1HWC0\n");
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_int8(input);
+    } else if (input->layout != CSINN_LAYOUT_NCHW) {
+        shl_debug_error("Unsupported data format\n");
+        return CSINN_FALSE;
+    }
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+    int32_t batch = input->dim[0];
+    int32_t in_c = input->dim[1];
+    int32_t out_c = output->dim[1];
+    int32_t group = params->group;
+    int64_t in_size = (int64_t)in_c * input->dim[2] * input->dim[3];
+    int64_t out_size = (int64_t)out_c * output->dim[2] * output->dim[3];
+    int32_t input_zp = input->qinfo->zero_point;
+
+    struct deconv_int8_task task = {
+        .input = (int16_t *)shl_mem_alloc(in_size * sizeof(int16_t)),
+        .kernel = (int16_t *)params->conv_extra.kernel_tm->data,
+        .bias = bias->data ? (int32_t *)bias->data : NULL,
+        .acc = (int32_t *)shl_mem_alloc(out_size * sizeof(int32_t)),
+        .output = int4 ? (int8_t *)shl_mem_alloc(out_size) : output_data,
+        .in = input,
+        .out = output,
+        .params = params,
+        .m = out_c / group,
+        .k = in_c / group,
+        .multiplier = kernel->qinfo->multiplier,
+        .shift = kernel->qinfo->shift,
+        .out_zp = output->qinfo->zero_point,
+        .out_min = int4 ? -8 : -128,
+        .out_max = int4 ? 7 : 127,
+    };
+    task.m_block = (task.m + 3) / 4;
+    int64_t work = out_size * params->conv_extra.kernel_tm->dim[2] *
+                   params->conv_extra.kernel_tm->dim[3] * task.k;
+
+    for (int b = 0; b < batch; b++) {
+        if (int4) {
+            for (int64_t i = 0; i < in_size; i++) {
+                task.input[i] = deconv_load_q(input_data, b * in_size + i, true) - input_zp;
+            }
+        } else {
+            int8_t *in_ptr = input_data + b * in_size;
+            int16_t *dst = task.input;
+            int64_t size = in_size;
+            while (size > 0) {
+                int vl = vsetvl_e8m1(size);
+                vint8m1_t _in = vle8_v_i8m1(in_ptr, vl);
+                vse16_v_i16m2(dst, vwsub_vx_i16m2(_in, input_zp, vl), vl);
+                in_ptr += vl;
+                dst += vl;
+                size -= vl;
+            }
+            task.output = output_data + b * out_size;
+        }
+
+        shl_rvv_parallel_for(group * task.m_block, work, deconv_int8_blocks, &task);
+
+        if (int4) {
+            for (int64_t i = 0; i < out_size; i++) {
+                int64_t idx = b * out_size + i;
+                int8_t tmp = task.output[i] & 0xf;
+                int8_t *dst = output_data + idx / 2;
+                *dst = idx % 2 ? (*dst & 0xf) | (tmp << 4) : (*dst & 0xf0) | tmp;
+            }
+        }
+    }
+
+    shl_mem_free(task.input);
+    shl_mem_free(task.acc);
+    if (int4) {
+        shl_mem_free(task.output);
+    }
+    return CSINN_TRUE;
+}
+
+int shl_rvv_deconv2d_gemm_col2im_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                      struct csinn_tensor *kernel, struct csinn_tensor *bias,
+                                      struct csinn_conv2d_params *params)
+{
+    return shl_rvv_deconv2d_gemm_col2im_common_int8(input, output, kernel, bias, params, false);
+}
@@ -18,8 +18,27 @@
 
 #include "rvv/rvv.h"
 
+int shl_rvv_erf_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                          struct csinn_siso_params *params)
+{
+    if (input->quant_channel == 1 && output->quant_channel == 1) {
+        params->lut = shl_mem_alloc(256);
+        shl_rvv_int8_lut_init(params->lut, input, output, erff);
+    }
+    return CSINN_TRUE;
+}
+
 int shl_rvv_erf_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                      struct csinn_siso_params *params)
 {
-    return shl_rvv_siso_callback_dtype_only(input, output, params, shl_rvv_erf_fp32);
+    if (input->quant_channel != 1 || output->quant_channel != 1) {
+        return shl_rvv_siso_callback_dtype_only(input, output, params, shl_rvv_erf_fp32);
+    }
+    output->layout = input->layout;
+    output->dim_count = input->dim_count;
+    for (int i = 0; i < output->dim_count; i++) {
+        output->dim[i] = input->dim[i];
+    }
+    shl_rvv_int8_lut(input->data, output->data, params->lut, csinn_tensor_size(input));
+    return CSINN_TRUE;
 }
@@ -23,8 +23,8 @@
  *************************************************************/
 
 /* int8 --> fp16 acc --> int8 */
-int shl_rvv_global_avgpool2d_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                                        struct csinn_pool_params *params)
+static int global_avgpool2d_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                       struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
@@ -72,3 +72,9 @@ int shl_rvv_global_avgpool2d_packn_int8(struct csinn_tensor *input, struct csinn
     }
     return CSINN_TRUE;
 }
+
+int shl_rvv_global_avgpool2d_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                                        struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, global_avgpool2d_packn_int8);
+}
@@ -22,154 +22,172 @@
     note: support flexible vlen
 *************************************************************/
 
-#if 0
-// FIXME: precision loss
-int layer_norm_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                    struct csinn_tensor *gamma, struct csinn_tensor *beta,
-                    struct csinn_layer_norm_params *params)
+/************************************************************************************
+ * s3(q3 - z3) = (s1 * q1 - mean) / std * s2(q2 - z2) + s4(q4 - z4)
+ *
+ * the statistics stay in integers: with d = 16 * q1 - round(16 * mean(q1)) and
+ * var = sum(d^2) / n + 256 * eps / s1^2, q3 = d * (q2 - z2) * s2/s3 / sqrt(var)
+ * + (q4 - z4) * s4/s3 + z3, where 1/sqrt(var) is a fixed-point rsqrt per row.
+ ************************************************************************************/
+struct layer_norm_int8_native_task {
+    int8_t *input_data;
+    int8_t *output_data;
+    int8_t *gamma_data;
+    int8_t *beta_data;
+    int32_t norm_size;
+    int32_t z2;
+    int32_t z3;
+    int32_t z4;
+    int32_t g_multiplier;
+    int32_t g_shift;
+    int32_t b_multiplier;
+    int32_t b_shift;
+    uint64_t eps_n;
+};
+
+/* rows are normalized independently */
+static void layer_norm_int8_native_rows(void *arg, int start, int end)
 {
-    if (params->center == false || params->scale == false) {
-        shl_debug_error("Layer norm only support center & scale == true\n");
-        return CSINN_FALSE;
-    }
-    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
-        shl_rvv_tensor_nc1xc0_to_ndarray_replace_int8(input);
-    }
-    int8_t *input_data = (int8_t *)input->data;
-    int8_t *output_data = (int8_t *)output->data;
-    int8_t *gamma_data = (int8_t *)gamma->data;
-    int8_t *beta_data = (int8_t *)beta->data;
-
-    /* support negative axis */
-    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
-
-    int32_t batches = 1;
-    for (int i = 0; i < axis; i++) {
-        batches *= input->dim[i];
-    }
-    int32_t norm_size = 1;
-    for (int i = axis; i < input->dim_count; i++) {
-        norm_size *= input->dim[i];
-    }
-    int32_t z1 = input->qinfo->zero_point;
-    int32_t z3 = output->qinfo->zero_point;
-    float s1 = input->qinfo->scale;
-    float s2 = gamma->qinfo->scale;
-    float s3 = output->qinfo->scale;
-    int32_t multiplier;
-    int32_t shift;
-    float real_scale = s1 * s2 / s3;
-    shl_quantize_multiplier(real_scale, &multiplier, &shift);
-
-    int32_t *qbeta = (int32_t *)shl_mem_alloc(norm_size * sizeof(int32_t));
-    int32_t *qb = qbeta;
-    int size = norm_size;
-    while (size > 0) {
-        int vl = vsetvl_e8m1(size);
-        vint8m1_t _beta = vle8_v_i8m1(beta_data, vl);
-        vint16m2_t _b_w = vwadd_vx_i16m2(_beta, 0, vl);
-        vint32m4_t _b_ww = vwadd_vx_i32m4(_b_w, 0, vl);
-        vint32m4_t _mulh = vmulh_vx_i32m4(_b_ww, multiplier, vl);
-        if (shift < 0) {
-            _mulh = vssra_vx_i32m4(_mulh, -shift - 1, vl);
-        } else {
-            _mulh = vsll_vx_i32m4(_mulh, shift + 1, vl);
-        }
-        _mulh = vadd_vx_i32m4(_mulh, z3, vl);
-        vse32_v_i32m4(qb, _mulh, vl);
-        beta_data += vl;
-        qb += vl;
-        size -= vl;
-    }
-
-    for (int b = 0; b < batches; b++) {
+    struct layer_norm_int8_native_task *t = (struct layer_norm_int8_native_task *)arg;
+    int8_t *input_data = t->input_data;
+    int8_t *output_data = t->output_data;
+    int8_t *gamma_data = t->gamma_data;
+    int8_t *beta_data = t->beta_data;
+    int32_t norm_size = t->norm_size;
+    int32_t z2 = t->z2;
+    int32_t z3 = t->z3;
+    int32_t z4 = t->z4;
+    int32_t g_multiplier = t->g_multiplier;
+    int32_t g_shift = t->g_shift;
+    int32_t b_multiplier = t->b_multiplier;
+    int32_t b_shift = t->b_shift;
+    uint64_t eps_n = t->eps_n;
+
+    for (int b = start; b < end; b++) {
         int8_t *input_ptr = input_data + b * norm_size;
         int8_t *output_ptr = output_data + b * norm_size;
-        int16_t *tmp = (int16_t *)shl_mem_alloc(norm_size * sizeof(int16_t));
 
         vint32m1_t _sum1 = vmv_v_x_i32m1(0, 1);
         int8_t *in0 = input_ptr;
-        size = norm_size;
+        int size = norm_size;
         while (size > 0) {
             int vl = vsetvl_e8m1(size);
             vint8m1_t _in = vle8_v_i8m1(in0, vl);
-            in0 += vl;
             vint16m2_t _in_w = vwadd_vx_i16m2(_in, 0, vl);
-            vint32m4_t _in_ww = vwadd_vx_i32m4(_in_w, 0, vl);
-            _sum1 = vredsum_vs_i32m4_i32m1(vundefined_i32m1(), _in_ww, _sum1, vl);
+            _sum1 = vwredsum_vs_i16m2_i32m1(vundefined_i32m1(), _in_w, _sum1, vl);
+            in0 += vl;
             size -= vl;
         }
-        int32_t sum1 = vmv_x_s_i32m1_i32(_sum1);
-        int8_t mean = sum1 / norm_size;
+        int64_t sum1 = (int64_t)vmv_x_s_i32m1_i32(_sum1) * 32;
+        int32_t mean16 = (sum1 + (sum1 >= 0 ? norm_size : -norm_size)) / (2 * norm_size);
 
-        vint32m1_t _sum2 = vmv_v_x_i32m1(0, 1);
-        int16_t *t0 = tmp;
+        vint64m1_t _sum2 = vmv_v_x_i64m1(0, 1);
         in0 = input_ptr;
         size = norm_size;
         while (size > 0) {
             int vl = vsetvl_e8m1(size);
             vint8m1_t _in = vle8_v_i8m1(in0, vl);
+            vint16m2_t _d = vwadd_vx_i16m2(_in, 0, vl);
+            _d = vsub_vx_i16m2(vsll_vx_i16m2(_d, 4, vl), mean16, vl);
+            vint32m4_t _d2 = vwmul_vv_i32m4(_d, _d, vl);
+            _sum2 = vwredsum_vs_i32m4_i64m1(vundefined_i64m1(), _d2, _sum2, vl);
             in0 += vl;
-            vint16m2_t _in_w = vwadd_vx_i16m2(_in, 0, vl);
-            vint16m2_t _tmp = vsub_vx_i16m2(_in_w, mean, vl);
-            vse16_v_i16m2(t0, _tmp, vl);
-            t0 += vl;
-            vint32m4_t _mul = vwmul_vv_i32m4(_tmp, _tmp, vl);
-            _sum2 = vredsum_vs_i32m4_i32m1(vundefined_i32m1(), _mul, _sum2, vl);
             size -= vl;
         }
-        int32_t sum2 = vmv_x_s_i32m1_i32(_sum2);
-        __fp16 var = s1 * s1 * sum2 / norm_size;
-        __fp16 std = sqrt(var + params->epsilon);
-
-        int32_t multiplier2;
-        int32_t shift2;
-        float real_scale2 = real_scale / std;
-        shl_quantize_multiplier(real_scale2, &multiplier2, &shift2);
+        /* var << 16, so 1/sqrt(var) = 2^8 * rsqrt(var << 16) */
+        uint64_t var16 = (((uint64_t)vmv_x_s_i64m1_i64(_sum2) + eps_n) << 16) / norm_size;
+        int32_t r_exp;
+        int32_t r_mult = shl_rvv_rsqrt_fixed(var16 ? var16 : 1, &r_exp);
+        int32_t multiplier = ((int64_t)g_multiplier * r_mult) >> 31;
+        int32_t shift = g_shift + 9 - r_exp;
 
+        in0 = input_ptr;
         int8_t *g0 = gamma_data;
-        t0 = tmp;
-        qb = qbeta;
+        int8_t *b0 = beta_data;
         size = norm_size;
         while (size > 0) {
-            int vl = vsetvl_e32m1(size);
-            vint16m2_t _tmp = vle16_v_i16m2(t0, vl);
-            vint32m4_t _tmp_w = vwadd_vx_i32m4(_tmp, 0, vl);
-            t0 += vl;
+            int vl = vsetvl_e8m1(size);
+            vint8m1_t _in = vle8_v_i8m1(in0, vl);
+            vint16m2_t _d = vwadd_vx_i16m2(_in, 0, vl);
+            _d = vsub_vx_i16m2(vsll_vx_i16m2(_d, 4, vl), mean16, vl);
             vint8m1_t _gamma = vle8_v_i8m1(g0, vl);
-            vint16m2_t _g_w = vwadd_vx_i16m2(_gamma, 0, vl);
-            vint32m4_t _g_ww = vwadd_vx_i32m4(_g_w, 0, vl);
-            g0 += vl;
-            vint32m4_t _mul = vmul_vv_i32m4(_tmp_w, _g_ww, vl);
-
-            if (shift2 < 0) {
-                _mul = vssra_vx_i32m4(_mul, -shift2 - 1, vl);
-            } else {
-                _mul = vsll_vx_i32m4(_mul, shift2 + 1, vl);
-            }
-            vint32m4_t _mulh = vmulh_vx_i32m4(_mul, multiplier2, vl);
-
-            vint32m4_t _beta = vle32_v_i32m4(qb, vl);
-            qb += vl;
-            vint32m4_t _res0 = vadd_vv_i32m4(_mulh, _beta, vl);
+            vint16m2_t _g = vwadd_vx_i16m2(_gamma, 0, vl);
+            _g = vsub_vx_i16m2(_g, z2, vl);
+            vint32m4_t _mul = vwmul_vv_i32m4(_d, _g, vl);
+            vint32m4_t _res0 = shl_rvv_requantize_i32m4(_mul, multiplier, shift, vl);
+
+            vint8m1_t _beta = vle8_v_i8m1(b0, vl);
+            vint16m2_t _b_w = vwadd_vx_i16m2(_beta, 0, vl);
+            vint32m4_t _b_ww = vwadd_vx_i32m4(_b_w, 0, vl);
+            _b_ww = vsub_vx_i32m4(_b_ww, z4, vl);
+            _b_ww = shl_rvv_requantize_i32m4(_b_ww, b_multiplier, b_shift, vl);
+
+            _res0 = vadd_vv_i32m4(_res0, _b_ww, vl);
+            _res0 = vadd_vx_i32m4(_res0, z3, vl);
             vint16m2_t _res1 = vnclip_wx_i16m2(_res0, 0, vl);
             vint8m1_t _res2 = vnclip_wx_i8m1(_res1, 0, vl);
             vse8_v_i8m1(output_ptr, _res2, vl);
+            in0 += vl;
+            g0 += vl;
+            b0 += vl;
             output_ptr += vl;
             size -= vl;
         }
-        shl_mem_free(tmp);
     }
-    shl_mem_free(qbeta);
+}
 
+static int layer_norm_int8_native(struct csinn_tensor *input, struct csinn_tensor *output,
+                                  struct csinn_tensor *gamma, struct csinn_tensor *beta,
+                                  struct csinn_layer_norm_params *params)
+{
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_int8(input);
+    }
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+    int8_t *gamma_data = (int8_t *)gamma->data;
+    int8_t *beta_data = (int8_t *)beta->data;
+    /* support negative axis */
+    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
+    int32_t batches = 1;
+    for (int i = 0; i < axis; i++) {
+        batches *= input->dim[i];
+    }
+    int32_t norm_size = 1;
+    for (int i = axis; i < input->dim_count; i++) {
+        norm_size *= input->dim[i];
+    }
+
+    float s1 = input->qinfo->scale;
+    float s3 = output->qinfo->scale;
+    int32_t z2 = gamma->qinfo->zero_point;
+    int32_t z3 = output->qinfo->zero_point;
+    int32_t z4 = beta->qinfo->zero_point;
+    int32_t g_multiplier, g_shift, b_multiplier, b_shift;
+    shl_quantize_multiplier(gamma->qinfo->scale / s3, &g_multiplier, &g_shift);
+    shl_quantize_multiplier(beta->qinfo->scale / s3, &b_multiplier, &b_shift);
+    double eps_q = (double)params->epsilon * 256 / ((double)s1 * s1);
+    uint64_t eps_n = eps_q * norm_size > (double)((uint64_t)1 << 44)
+                         ? (uint64_t)1 << 44
+                         : (uint64_t)(eps_q * norm_size + 0.5);
+
+    struct layer_norm_int8_native_task task = {input_data, output_data, gamma_data, beta_data,
+                                               norm_size, z2, z3, z4, g_multiplier, g_shift,
+                                               b_multiplier, b_shift, eps_n};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, layer_norm_int8_native_rows, &task);
     return CSINN_TRUE;
 }
-#endif
 
 int shl_rvv_layer_norm_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                             struct csinn_tensor *gamma, struct csinn_tensor *beta,
                             struct csinn_layer_norm_params *params)
 {
+    if (params->center && params->scale && gamma->dtype == CSINN_DTYPE_INT8 &&
+        beta->dtype == CSINN_DTYPE_INT8 && input->quant_channel == 1 &&
+        output->quant_channel == 1 && gamma->quant_channel == 1 && beta->quant_channel == 1) {
+        return layer_norm_int8_native(input, output, gamma, beta, params);
+    }
+
     struct csinn_tensor *float_input = shl_rvv_tensor_transform_f32(input);
     struct csinn_tensor *float_output = shl_rvv_tensor_transform_f32(output);
     struct csinn_tensor *float_gamma = shl_rvv_tensor_transform_f32(gamma);
@@ -89,7 +89,7 @@ int shl_rvv_matmul_common_int8(struct csinn_tensor *mat0, struct csinn_tensor *m
                 shl_mem_free(in1);
             }
         } else if (batches_a > 1 && batches_b == 1) {
-            int8_t *in0 = (int8_t *)shl_mem_alloc(dim_m * dim_k * sizeof(int8_t));
+            int8_t *in0 = (int8_t *)shl_mem_alloc(batches_a * dim_m * dim_k * sizeof(int8_t));
             int8_t *in1;
             if (!(mat1->is_const)) {
                 in1 = (int8_t *)shl_mem_alloc(dim_k * dim_n * sizeof(int8_t));
@@ -98,14 +98,12 @@ int shl_rvv_matmul_common_int8(struct csinn_tensor *mat0, struct csinn_tensor *m
                 in1 = mat1_data;
             }
 
-            for (int b = 0; b < batches_a; b++) {
-                reorder_mat0(mat0_data, in0, dim_m, dim_k, dim_k);
-                matmul(output_data, in0, in1, dim_m, dim_k, dim_n, dim_n, z1, z2, z3, multiplier,
-                       shift);
-
-                mat0_data += dim_m * dim_k;
-                output_data += dim_m * dim_n;
-            }
+            /* mat1 is shared by every batch, fold the batches into the rows of a single gemm
+             * so that packed mat1 is streamed once instead of once per batch */
+            const int fold_m = batches_a * dim_m;
+            reorder_mat0(mat0_data, in0, fold_m, dim_k, dim_k);
+            matmul(output_data, in0, in1, fold_m, dim_k, dim_n, dim_n, z1, z2, z3, multiplier,
+                   shift);
             shl_mem_free(in0);
             if (!(mat1->is_const)) {
                 shl_mem_free(in1);
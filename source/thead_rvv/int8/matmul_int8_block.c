@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rvv/rvv.h"
+
+/*************************************************************
+ * W8A8 matmul against block quantized weights: every row of mat0 is
+ * quantized to int8 on the fly, one scale per 32 values (or per row),
+ * and each 32-block is an int8 x int8 dot product in int32 rescaled by
+ * the activation scale and the fp16 weight scale.
+ * mat1 keeps the q8_0/q4_0 layout [N, K] + scales [N, K / 32], the
+ * words of one k position of vl rows are gathered with strided loads,
+ * so a mapped model is used in place.
+ *************************************************************/
+
+#define BLOCK_SIZE 32
+
+static float absmax_fp32(const float *src, int size)
+{
+    vfloat32m1_t _max = vfmv_v_f_f32m1(0.0f, 1);
+    while (size > 0) {
+        int vl = vsetvl_e32m8(size);
+        vfloat32m8_t _in = vle32_v_f32m8(src, vl);
+        _max = vfredmax_vs_f32m8_f32m1(vundefined_f32m1(), vfabs_v_f32m8(_in, vl), _max, vl);
+        src += vl;
+        size -= vl;
+    }
+    return vfmv_f_s_f32m1_f32(_max);
+}
+
+static void quantize_fp32(const float *src, int8_t *dst, float inv, int size)
+{
+    while (size > 0) {
+        int vl = vsetvl_e32m8(size);
+        vfloat32m8_t _in = vle32_v_f32m8(src, vl);
+        _in = vfmul_vf_f32m8(_in, inv, vl);
+        vint16m4_t _i16 = vfncvt_x_f_w_i16m4(_in, vl);
+        vse8_v_i8m2(dst, vnclip_wx_i8m2(_i16, 0, vl), vl);
+        src += vl;
+        dst += vl;
+        size -= vl;
+    }
+}
+
+static float absmax_fp16(const __fp16 *src, int size)
+{
+    vfloat16m1_t _max = vfmv_v_f_f16m1(0.0f, 1);
+    while (size > 0) {
+        int vl = vsetvl_e16m4(size);
+        vfloat16m4_t _in = vle16_v_f16m4(src, vl);
+        _max = vfredmax_vs_f16m4_f16m1(vundefined_f16m1(), vfabs_v_f16m4(_in, vl), _max, vl);
+        src += vl;
+        size -= vl;
+    }
+    return vfmv_f_s_f16m1_f16(_max);
+}
+
+static void quantize_fp16(const __fp16 *src, int8_t *dst, float inv, int size)
+{
+    while (size > 0) {
+        int vl = vsetvl_e16m4(size);
+        vfloat16m4_t _in = vle16_v_f16m4(src, vl);
+        vfloat32m8_t _f32 = vfwcvt_f_f_v_f32m8(_in, vl);
+        _f32 = vfmul_vf_f32m8(_f32, inv, vl);
+        vint16m4_t _i16 = vfncvt_x_f_w_i16m4(_f32, vl);
+        vse8_v_i8m2(dst, vnclip_wx_i8m2(_i16, 0, vl), vl);
+        src += vl;
+        dst += vl;
+        size -= vl;
+    }
+}
+
+/*************************************************************
+ * src: [M, K], K % 32 == 0
+ * dst: [M, K] int8, scale: [M, K / 32]
+ *************************************************************/
+void shl_rvv_quantize_block_q8_fp32(const float *src, int8_t *dst, float *scale, int M, int K,
+                                    bool per_token)
+{
+    const int blocks = K / BLOCK_SIZE;
+    for (int i = 0; i < M; i++) {
+        float row_max = per_token ? absmax_fp32(src, K) : 0.0f;
+        for (int b = 0; b < blocks; b++) {
+            float abs_max = per_token ? row_max : absmax_fp32(src, BLOCK_SIZE);
+            float inv = abs_max > 0.0f ? 127.0f / abs_max : 0.0f;
+            scale[b] = abs_max / 127.0f;
+            quantize_fp32(src, dst, inv, BLOCK_SIZE);
+            src += BLOCK_SIZE;
+            dst += BLOCK_SIZE;
+        }
+        scale += blocks;
+    }
+}
+
+void shl_rvv_quantize_block_q8_fp16(const __fp16 *src, int8_t *dst, float *scale, int M, int K,
+                                    bool per_token)
+{
+    const int blocks = K / BLOCK_SIZE;
+    for (int i = 0; i < M; i++) {
+        float row_max = per_token ? absmax_fp16(src, K) : 0.0f;
+        for (int b = 0; b < blocks; b++) {
+            float abs_max = per_token ? row_max : absmax_fp16(src, BLOCK_SIZE);
+            float inv = abs_max > 0.0f ? 127.0f / abs_max : 0.0f;
+            scale[b] = abs_max / 127.0f;
+            quantize_fp16(src, dst, inv, BLOCK_SIZE);
+            src += BLOCK_SIZE;
+            dst += BLOCK_SIZE;
+        }
+        scale += blocks;
+    }
+}
+
+/* weight scales of block k of vl rows, widened to fp32 */
+static inline vfloat32m2_t load_scale_m2(const __fp16 *scale, int blocks, int vl)
+{
+    vfloat16m1_t _s = vlse16_v_f16m1(scale, blocks * sizeof(__fp16), vl);
+    return vfwcvt_f_f_v_f32m2(_s, vl);
+}
+
+#ifdef SHL_USE_DOT_INT8
+/* q4_0 byte t of a block holds element t in the low and t + 16 in the high nibble */
+static inline vint8m2_t q4_low_m2(vint8m2_t _b, int vl)
+{
+    return vsub_vx_i8m2(vand_vx_i8m2(_b, 0x0f, vl), 8, vl);
+}
+
+static inline vint8m2_t q4_high_m2(vint8m2_t _b, int vl)
+{
+    return vsub_vx_i8m2(vand_vx_i8m2(vsra_vx_i8m2(_b, 4, vl), 0x0f, vl), 8, vl);
+}
+
+/*************************************************************
+ * m2 = vlenb / sizeof(int32_t) * 2 columns per step
+ * dst - output: [M, ldc] fp32
+ * sa - mat0: [M, K] int8, sa_scale: [M, K / 32]
+ * sb - mat1: [N, K] q8_0, sb_scale: [N, K / 32] fp16
+ *************************************************************/
+static void gemm_q8_4xm2_dot(float *dst, const int8_t *sa, const float *sa_scale,
+                             const int8_t *sb, const __fp16 *sb_scale, int K, int N, int ldc)
+{
+    const int blocks = K / BLOCK_SIZE;
+    const int32_t *a0 = (const int32_t *)sa;
+    const int32_t *a1 = a0 + K / 4;
+    const int32_t *a2 = a1 + K / 4;
+    const int32_t *a3 = a2 + K / 4;
+    const float *s0 = sa_scale;
+    const float *s1 = s0 + blocks;
+    const float *s2 = s1 + blocks;
+    const float *s3 = s2 + blocks;
+
+    int j = 0;
+    while (j < N) {
+        int vl = vsetvl_e32m2(N - j);
+        vfloat32m2_t _acc0 = vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t _acc1 = vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t _acc2 = vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t _acc3 = vfmv_v_f_f32m2(0.0f, vl);
+
+        for (int k = 0; k < blocks; k++) {
+            const int8_t *b_ptr = sb + j * K + k * BLOCK_SIZE;
+            vint32m2_t _dot0 = vmv_v_x_i32m2(0, vl);
+            vint32m2_t _dot1 = vmv_v_x_i32m2(0, vl);
+            vint32m2_t _dot2 = vmv_v_x_i32m2(0, vl);
+            vint32m2_t _dot3 = vmv_v_x_i32m2(0, vl);
+            for (int c = 0; c < BLOCK_SIZE / 4; c++) {
+                vint32m2_t _w = vlse32_v_i32m2((const int32_t *)(b_ptr + c * 4), K, vl);
+                vint8m2_t _b = vreinterpret_v_i32m2_i8m2(_w);
+                int idx = k * BLOCK_SIZE / 4 + c;
+                _dot0 = vmaqa_vx_i32m2(_dot0, a0[idx], _b, vl);
+                _dot1 = vmaqa_vx_i32m2(_dot1, a1[idx], _b, vl);
+                _dot2 = vmaqa_vx_i32m2(_dot2, a2[idx], _b, vl);
+                _dot3 = vmaqa_vx_i32m2(_dot3, a3[idx], _b, vl);
+            }
+            vfloat32m2_t _sb = load_scale_m2(sb_scale + j * blocks + k, blocks, vl);
+            _acc0 = vfmacc_vf_f32m2(_acc0, s0[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot0, vl), _sb, vl), vl);
+            _acc1 = vfmacc_vf_f32m2(_acc1, s1[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot1, vl), _sb, vl), vl);
+            _acc2 = vfmacc_vf_f32m2(_acc2, s2[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot2, vl), _sb, vl), vl);
+            _acc3 = vfmacc_vf_f32m2(_acc3, s3[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot3, vl), _sb, vl), vl);
+        }
+        vse32_v_f32m2(dst + j, _acc0, vl);
+        vse32_v_f32m2(dst + ldc + j, _acc1, vl);
+        vse32_v_f32m2(dst + 2 * ldc + j, _acc2, vl);
+        vse32_v_f32m2(dst + 3 * ldc + j, _acc3, vl);
+        j += vl;
+    }
+}
+
+static void gemm_q8_1xm2_dot(float *dst, const int8_t *sa, const float *sa_scale,
+                             const int8_t *sb, const __fp16 *sb_scale, int K, int N)
+{
+    const int blocks = K / BLOCK_SIZE;
+    const int32_t *a0 = (const int32_t *)sa;
+
+    int j = 0;
+    while (j < N) {
+        int vl = vsetvl_e32m2(N - j);
+        vfloat32m2_t _acc0 = vfmv_v_f_f32m2(0.0f, vl);
+
+        for (int k = 0; k < blocks; k++) {
+            const int8_t *b_ptr = sb + j * K + k * BLOCK_SIZE;
+            vint32m2_t _dot0 = vmv_v_x_i32m2(0, vl);
+            for (int c = 0; c < BLOCK_SIZE / 4; c++) {
+                vint32m2_t _w = vlse32_v_i32m2((const int32_t *)(b_ptr + c * 4), K, vl);
+                _dot0 = vmaqa_vx_i32m2(_dot0, a0[k * BLOCK_SIZE / 4 + c],
+                                       vreinterpret_v_i32m2_i8m2(_w), vl);
+            }
+            vfloat32m2_t _sb = load_scale_m2(sb_scale + j * blocks + k, blocks, vl);
+            _acc0 = vfmacc_vf_f32m2(_acc0, sa_scale[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot0, vl), _sb, vl), vl);
+        }
+        vse32_v_f32m2(dst + j, _acc0, vl);
+        j += vl;
+    }
+}
+
+/* as gemm_q8_4xm2_dot with sb in q4_0: [N, K / 2] */
+static void gemm_q4_4xm2_dot(float *dst, const int8_t *sa, const float *sa_scale,
+                             const int8_t *sb, const __fp16 *sb_scale, int K, int N, int ldc)
+{
+    const int blocks = K / BLOCK_SIZE;
+    const int32_t *a0 = (const int32_t *)sa;
+    const int32_t *a1 = a0 + K / 4;
+    const int32_t *a2 = a1 + K / 4;
+    const int32_t *a3 = a2 + K / 4;
+    const float *s0 = sa_scale;
+    const float *s1 = s0 + blocks;
+    const float *s2 = s1 + blocks;
+    const float *s3 = s2 + blocks;
+
+    int j = 0;
+    while (j < N) {
+        int vl = vsetvl_e32m2(N - j);
+        vfloat32m2_t _acc0 = vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t _acc1 = vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t _acc2 = vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t _acc3 = vfmv_v_f_f32m2(0.0f, vl);
+
+        for (int k = 0; k < blocks; k++) {
+            const int8_t *b_ptr = sb + j * K / 2 + k * BLOCK_SIZE / 2;
+            vint32m2_t _dot0 = vmv_v_x_i32m2(0, vl);
+            vint32m2_t _dot1 = vmv_v_x_i32m2(0, vl);
+            vint32m2_t _dot2 = vmv_v_x_i32m2(0, vl);
+            vint32m2_t _dot3 = vmv_v_x_i32m2(0, vl);
+            for (int c = 0; c < BLOCK_SIZE / 8; c++) {
+                vint32m2_t _w = vlse32_v_i32m2((const int32_t *)(b_ptr + c * 4), K / 2, vl);
+                vint8m2_t _b = vreinterpret_v_i32m2_i8m2(_w);
+                vint8m2_t _lo = q4_low_m2(_b, vl * 4);
+                vint8m2_t _hi = q4_high_m2(_b, vl * 4);
+                int lo = k * BLOCK_SIZE / 4 + c;
+                int hi = lo + BLOCK_SIZE / 8;
+                _dot0 = vmaqa_vx_i32m2(_dot0, a0[lo], _lo, vl);
+                _dot0 = vmaqa_vx_i32m2(_dot0, a0[hi], _hi, vl);
+                _dot1 = vmaqa_vx_i32m2(_dot1, a1[lo], _lo, vl);
+                _dot1 = vmaqa_vx_i32m2(_dot1, a1[hi], _hi, vl);
+                _dot2 = vmaqa_vx_i32m2(_dot2, a2[lo], _lo, vl);
+                _dot2 = vmaqa_vx_i32m2(_dot2, a2[hi], _hi, vl);
+                _dot3 = vmaqa_vx_i32m2(_dot3, a3[lo], _lo, vl);
+                _dot3 = vmaqa_vx_i32m2(_dot3, a3[hi], _hi, vl);
+            }
+            vfloat32m2_t _sb = load_scale_m2(sb_scale + j * blocks + k, blocks, vl);
+            _acc0 = vfmacc_vf_f32m2(_acc0, s0[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot0, vl), _sb, vl), vl);
+            _acc1 = vfmacc_vf_f32m2(_acc1, s1[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot1, vl), _sb, vl), vl);
+            _acc2 = vfmacc_vf_f32m2(_acc2, s2[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot2, vl), _sb, vl), vl);
+            _acc3 = vfmacc_vf_f32m2(_acc3, s3[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot3, vl), _sb, vl), vl);
+        }
+        vse32_v_f32m2(dst + j, _acc0, vl);
+        vse32_v_f32m2(dst + ldc + j, _acc1, vl);
+        vse32_v_f32m2(dst + 2 * ldc + j, _acc2, vl);
+        vse32_v_f32m2(dst + 3 * ldc + j, _acc3, vl);
+        j += vl;
+    }
+}
+
+static void gemm_q4_1xm2_dot(float *dst, const int8_t *sa, const float *sa_scale,
+                             const int8_t *sb, const __fp16 *sb_scale, int K, int N)
+{
+    const int blocks = K / BLOCK_SIZE;
+    const int32_t *a0 = (const int32_t *)sa;
+
+    int j = 0;
+    while (j < N) {
+        int vl = vsetvl_e32m2(N - j);
+        vfloat32m2_t _acc0 = vfmv_v_f_f32m2(0.0f, vl);
+
+        for (int k = 0; k < blocks; k++) {
+            const int8_t *b_ptr = sb + j * K / 2 + k * BLOCK_SIZE / 2;
+            vint32m2_t _dot0 = vmv_v_x_i32m2(0, vl);
+            for (int c = 0; c < BLOCK_SIZE / 8; c++) {
+                vint32m2_t _w = vlse32_v_i32m2((const int32_t *)(b_ptr + c * 4), K / 2, vl);
+                vint8m2_t _b = vreinterpret_v_i32m2_i8m2(_w);
+                int lo = k * BLOCK_SIZE / 4 + c;
+                _dot0 = vmaqa_vx_i32m2(_dot0, a0[lo], q4_low_m2(_b, vl * 4), vl);
+                _dot0 = vmaqa_vx_i32m2(_dot0, a0[lo + BLOCK_SIZE / 8], q4_high_m2(_b, vl * 4), vl);
+            }
+            vfloat32m2_t _sb = load_scale_m2(sb_scale + j * blocks + k, blocks, vl);
+            _acc0 = vfmacc_vf_f32m2(_acc0, sa_scale[k],
+                                    vfmul_vv_f32m2(vfcvt_f_x_v_f32m2(_dot0, vl), _sb, vl), vl);
+        }
+        vse32_v_f32m2(dst + j, _acc0, vl);
+        j += vl;
+    }
+}
+
+void shl_rvv_gemm_a0b1_int8_block_q8(float *dst, const int8_t *sa, const float *sa_scale,
+                                     const int8_t *sb, const __fp16 *sb_scale, int M, int K, int N,
+                                     int ldc)
+{
+    const int blocks = K / BLOCK_SIZE;
+    int i = 0;
+    for (; i + 3 < M; i += 4) {
+        gemm_q8_4xm2_dot(dst + i * ldc, sa + i * K, sa_scale + i * blocks, sb, sb_scale, K, N,
+                         ldc);
+    }
+    for (; i < M; i++) {
+        gemm_q8_1xm2_dot(dst + i * ldc, sa + i * K, sa_scale + i * blocks, sb, sb_scale, K, N);
+    }
+}
+
+void shl_rvv_gemm_a0b1_int8_block_q4(float *dst, const int8_t *sa, const float *sa_scale,
+                                     const int8_t *sb, const __fp16 *sb_scale, int M, int K, int N,
+                                     int ldc)
+{
+    const int blocks = K / BLOCK_SIZE;
+    int i = 0;
+    for (; i + 3 < M; i += 4) {
+        gemm_q4_4xm2_dot(dst + i * ldc, sa + i * K, sa_scale + i * blocks, sb, sb_scale, K, N,
+                         ldc);
+    }
+    for (; i < M; i++) {
+        gemm_q4_1xm2_dot(dst + i * ldc, sa + i * K, sa_scale + i * blocks, sb, sb_scale, K, N);
+    }
+}
+#else
+/* without the dot extension: widening multiply and reduction per block */
+static inline int32_t dot_block_i8(vint8m2_t _a, vint8m2_t _b, int vl)
+{
+    vint16m4_t _mul = vwmul_vv_i16m4(_a, _b, vl);
+    vint32m1_t _sum = vwredsum_vs_i16m4_i32m1(vundefined_i32m1(), _mul, vmv_v_x_i32m1(0, 1), vl);
+    return vmv_x_s_i32m1_i32(_sum);
+}
+
+void shl_rvv_gemm_a0b1_int8_block_q8(float *dst, const int8_t *sa, const float *sa_scale,
+                                     const int8_t *sb, const __fp16 *sb_scale, int M, int K, int N,
+                                     int ldc)
+{
+    const int blocks = K / BLOCK_SIZE;
+    int vl = vsetvl_e8m2(BLOCK_SIZE);
+    for (int i = 0; i < M; i++) {
+        const int8_t *a_ptr = sa + i * K;
+        for (int j = 0; j < N; j++) {
+            const int8_t *b_ptr = sb + j * K;
+            float acc = 0.0f;
+            for (int k = 0; k < blocks; k++) {
+                vint8m2_t _a = vle8_v_i8m2(a_ptr + k * BLOCK_SIZE, vl);
+                vint8m2_t _b = vle8_v_i8m2(b_ptr + k * BLOCK_SIZE, vl);
+                acc += dot_block_i8(_a, _b, vl) * sa_scale[i * blocks + k] *
+                       (float)sb_scale[j * blocks + k];
+            }
+            dst[i * ldc + j] = acc;
+        }
+    }
+}
+
+void shl_rvv_gemm_a0b1_int8_block_q4(float *dst, const int8_t *sa, const float *sa_scale,
+                                     const int8_t *sb, const __fp16 *sb_scale, int M, int K, int N,
+                                     int ldc)
+{
+    const int blocks = K / BLOCK_SIZE;
+    const int half = BLOCK_SIZE / 2;
+    int vl = vsetvl_e8m1(half);
+    for (int i = 0; i < M; i++) {
+        const int8_t *a_ptr = sa + i * K;
+        for (int j = 0; j < N; j++) {
+            const int8_t *b_ptr = sb + j * K / 2;
+            float acc = 0.0f;
+            for (int k = 0; k < blocks; k++) {
+                vint8m1_t _b = vle8_v_i8m1(b_ptr + k * half, vl);
+                vint8m1_t _lo = vsub_vx_i8m1(vand_vx_i8m1(_b, 0x0f, vl), 8, vl);
+                vint8m1_t _hi = vand_vx_i8m1(vsra_vx_i8m1(_b, 4, vl), 0x0f, vl);
+                _hi = vsub_vx_i8m1(_hi, 8, vl);
+                vint8m1_t _a0 = vle8_v_i8m1(a_ptr + k * BLOCK_SIZE, vl);
+                vint8m1_t _a1 = vle8_v_i8m1(a_ptr + k * BLOCK_SIZE + half, vl);
+                vint16m2_t _mul = vwmul_vv_i16m2(_a0, _lo, vl);
+                _mul = vwmacc_vv_i16m2(_mul, _a1, _hi, vl);
+                vint32m1_t _sum = vwredsum_vs_i16m2_i32m1(vundefined_i32m1(), _mul,
+                                                          vmv_v_x_i32m1(0, 1), vl);
+                acc += vmv_x_s_i32m1_i32(_sum) * sa_scale[i * blocks + k] *
+                       (float)sb_scale[j * blocks + k];
+            }
+            dst[i * ldc + j] = acc;
+        }
+    }
+}
+#endif  // SHL_USE_DOT_INT8
+
+/*************************************************************
+ * mat0: [..., M, K] fp32/fp16, mat1: [(batch,) N, K] q8_0/q4_0, trans_b
+ * gemm_q8/gemm_q4 run a slice of rows, a multi-threaded target passes
+ * wrappers that split the columns.
+ *************************************************************/
+int shl_rvv_matmul_a0b1_dynamic_quant_common(
+    struct csinn_tensor *mat0, struct csinn_tensor *mat1, struct csinn_tensor *output,
+    struct csinn_matmul_params *params,
+    void (*gemm_q8)(float *, const int8_t *, const float *, const int8_t *, const __fp16 *, int,
+                    int, int, int),
+    void (*gemm_q4)(float *, const int8_t *, const float *, const int8_t *, const __fp16 *, int,
+                    int, int, int))
+{
+    if (mat0->layout >= CSINN_LAYOUT_NC1C0 && mat0->layout <= CSINN_LAYOUT_NC1DHWC0) {
+        if (mat0->dtype == CSINN_DTYPE_FLOAT16) {
+            shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp16(mat0);
+        } else {
+            shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32(mat0);
+        }
+    }
+
+    const int dims_count = mat0->dim_count;
+    int batches_a = 1;
+    int batches_b = 1;
+    for (int i = 0; i < dims_count - 2; i++) {
+        batches_a *= mat0->dim[i];
+    }
+    for (int i = 0; i < mat1->dim_count - 2; i++) {
+        batches_b *= mat1->dim[i];
+    }
+    const int dim_m = mat0->dim[dims_count - 2];
+    const int dim_k = mat0->dim[dims_count - 1];
+    const int dim_n = mat1->dim[mat1->dim_count - 2];
+
+    /* strided word loads need 4 byte aligned weight rows */
+    if (dim_k % BLOCK_SIZE != 0 || ((uintptr_t)mat1->data & 3) ||
+        (batches_a != batches_b && batches_b != 1)) {
+        return shl_ref_matmul_a0b1_dynamic_quant(mat0, mat1, output, params);
+    }
+
+    bool q4 = mat1->mtype == CSINN_MEM_TYPE_BLOCK_Q4_0;
+    bool per_token = params->act_quant == CSINN_ACT_QUANT_TOKEN;
+    const int blocks = dim_k / BLOCK_SIZE;
+    const int row_bytes = q4 ? dim_k / 2 : dim_k;
+    int8_t *mat1_data = (int8_t *)mat1->data;
+    __fp16 *scale_data = (__fp16 *)(mat1_data + (int64_t)batches_b * dim_n * row_bytes);
+
+    /* a shared mat1 folds the batches of mat0 into the rows of one gemm */
+    const int loops = batches_b == 1 ? 1 : batches_a;
+    const int rows = batches_b == 1 ? batches_a * dim_m : dim_m;
+    int8_t *qa = (int8_t *)shl_mem_alloc(rows * dim_k);
+    float *qa_scale = (float *)shl_mem_alloc(rows * blocks * sizeof(float));
+    bool fp16 = output->dtype == CSINN_DTYPE_FLOAT16;
+    float *out_f32 = fp16 ? (float *)shl_mem_alloc(rows * dim_n * sizeof(float)) : output->data;
+
+    for (int b = 0; b < loops; b++) {
+        if (mat0->dtype == CSINN_DTYPE_FLOAT16) {
+            __fp16 *in = (__fp16 *)mat0->data + b * rows * dim_k;
+            shl_rvv_quantize_block_q8_fp16(in, qa, qa_scale, rows, dim_k, per_token);
+        } else {
+            float *in = (float *)mat0->data + b * rows * dim_k;
+            shl_rvv_quantize_block_q8_fp32(in, qa, qa_scale, rows, dim_k, per_token);
+        }
+        float *out = fp16 ? out_f32 : out_f32 + b * rows * dim_n;
+        const int8_t *sb = mat1_data + b * dim_n * row_bytes;
+        const __fp16 *sb_scale = scale_data + b * dim_n * blocks;
+        if (q4) {
+            gemm_q4(out, qa, qa_scale, sb, sb_scale, rows, dim_k, dim_n, dim_n);
+        } else {
+            gemm_q8(out, qa, qa_scale, sb, sb_scale, rows, dim_k, dim_n, dim_n);
+        }
+        if (fp16) {
+            float scale = 1.0f;
+            shl_rvv_f32_to_f16(out, (__fp16 *)output->data + b * rows * dim_n, &scale,
+                               rows * dim_n);
+        }
+    }
+
+    shl_mem_free(qa);
+    shl_mem_free(qa_scale);
+    if (fp16) {
+        shl_mem_free(out_f32);
+    }
+    return CSINN_TRUE;
+}
+
+int shl_rvv_matmul_a0b1_dynamic_quant(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
+                                      struct csinn_tensor *output,
+                                      struct csinn_matmul_params *params)
+{
+    return shl_rvv_matmul_a0b1_dynamic_quant_common(mat0, mat1, output, params,
+                                                    shl_rvv_gemm_a0b1_int8_block_q8,
+                                                    shl_rvv_gemm_a0b1_int8_block_q4);
+}
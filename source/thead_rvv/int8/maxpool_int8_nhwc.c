@@ -102,13 +102,16 @@ static void maxpool_border_int8_nhwc(const int8_t *src, int8_t *dst,
     }
 }
 
-int shl_rvv_maxpool_nhwc_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                              struct csinn_pool_params *params)
+static void maxpool_nhwc_int8_rows(void *arg, int start, int end)
 {
+    struct shl_rvv_pool_task *t = (struct shl_rvv_pool_task *)arg;
+    struct csinn_tensor *input = t->input;
+    struct csinn_tensor *output = t->output;
+    struct csinn_pool_params *params = t->params;
+
     int8_t *input_data = (int8_t *)input->data;
     int8_t *output_data = (int8_t *)output->data;
 
-    int batch = input->dim[0];
     int in_h = input->dim[1];
     int in_w = input->dim[2];
     int in_c = input->dim[3];
@@ -127,29 +130,38 @@ int shl_rvv_maxpool_nhwc_int8(struct csinn_tensor *input, struct csinn_tensor *o
     int dst_1x8_start_w = max((pad_left + stride_w - 1) / stride_w, 0);
     int dst_1x8_end_w = min((in_w + pad_left - kernel_w) / stride_w + 1, out_w);
 
-    for (int b = 0; b < batch; b++) {
-        int8_t *in_ptr = input_data + b * in_h * in_w;
-        int8_t *out_ptr = output_data + b * out_h * out_w;
-
-        for (int oh = 0; oh < out_h; oh++) {
-            int i_h_start = -pad_top + oh * stride_h;
-            int i_h_end = i_h_start + kernel_h;
-            const int idx_h_start = max(i_h_start, 0);
-            const int idx_h_end = min(i_h_end, in_h);
-            int ow = 0;
-            for (; ow < dst_1x8_start_w; ow++) {
-                maxpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c);
-            }
-            for (; ow + 8 <= dst_1x8_end_w; ow += 8) {
-                maxpool_w8_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+    for (int r = start; r < end; r++) {
+        int b = r / out_h;
+        int oh = r % out_h;
+        int8_t *in_ptr = input_data + b * in_h * in_w * in_c;
+        int8_t *out_ptr = output_data + b * out_h * out_w * out_c;
+
+        int i_h_start = -pad_top + oh * stride_h;
+        int i_h_end = i_h_start + kernel_h;
+        const int idx_h_start = max(i_h_start, 0);
+        const int idx_h_end = min(i_h_end, in_h);
+        int ow = 0;
+        for (; ow < dst_1x8_start_w; ow++) {
+            maxpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                     out_w, in_c);
+        }
+        for (; ow + 8 <= dst_1x8_end_w; ow += 8) {
+            maxpool_w8_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
+                                 out_w, in_c);
+        }
+        for (; ow < out_w; ow++) {
+            maxpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end, in_w,
                                      out_w, in_c);
-            }
-            for (; ow < out_w; ow++) {
-                maxpool_border_int8_nhwc(in_ptr, out_ptr, params, oh, ow, idx_h_start, idx_h_end,
-                                         in_w, out_w, in_c);
-            }
         }
     }
+}
+
+/* output rows of all batches are independent, split them over the threads */
+int shl_rvv_maxpool_nhwc_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
+{
+    struct shl_rvv_pool_task task = {input, output, params};
+    shl_rvv_parallel_for(input->dim[0] * output->dim[1], csinn_tensor_size(input),
+                         maxpool_nhwc_int8_rows, &task);
     return CSINN_TRUE;
 }
@@ -96,8 +96,8 @@ static void maxpool_border_int8_packn(const int8_t *src, int8_t *dst,
     vse8_v_i8m1(out_ptr, _max, vl);
 }
 
-int shl_rvv_maxpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
-                               struct csinn_pool_params *params)
+static int maxpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_pool_params *params)
 {
     if (input->layout == CSINN_LAYOUT_NCHW) {
         shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
@@ -157,3 +157,9 @@ int shl_rvv_maxpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *
     }
     return CSINN_TRUE;
 }
+
+int shl_rvv_maxpool_packn_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                               struct csinn_pool_params *params)
+{
+    return shl_rvv_pool_packn_parallel(input, output, params, maxpool_packn_int8);
+}
@@ -70,67 +70,30 @@ static void elementwise_mul_int8(struct csinn_tensor *input0, struct csinn_tenso
 }
 #endif
 
-static void elementwise_mul_int8_trans_fp16(struct csinn_tensor *input0,
-                                            struct csinn_tensor *input1,
-                                            struct csinn_tensor *output)
-{
-    int8_t *input0_data = (int8_t *)input0->data;
-    int8_t *input1_data = (int8_t *)input1->data;
-    int8_t *output_data = (int8_t *)output->data;
-    int32_t zero_point0 = input0->qinfo->zero_point;
-    int32_t zero_point1 = input1->qinfo->zero_point;
-    int32_t zero_point2 = output->qinfo->zero_point;
-    float real_scale = input0->qinfo->scale * input1->qinfo->scale / output->qinfo->scale;
-
-    int64_t size = csinn_tensor_size(output);
-    while (size > 0) {
-        int vl = vsetvl_e8m1(size);
-        vint8m1_t _in0 = vle8_v_i8m1(input0_data, vl);
-        vint8m1_t _in1 = vle8_v_i8m1(input1_data, vl);
-        vint16m2_t _in0w = vwsub_vx_i16m2(_in0, zero_point0, vl);
-        vint16m2_t _in1w = vwsub_vx_i16m2(_in1, zero_point1, vl);
-        vfloat16m2_t _in0f = vfcvt_f_x_v_f16m2(_in0w, vl);
-        vfloat16m2_t _in1f = vfcvt_f_x_v_f16m2(_in1w, vl);
-        vfloat16m2_t _mulf = vfmul_vv_f16m2(_in0f, _in1f, vl);
-        _mulf = vfmul_vf_f16m2(_mulf, real_scale, vl);
-        vint16m2_t _res = vfcvt_x_f_v_i16m2(_mulf, vl);
-        _res = vadd_vx_i16m2(_res, zero_point2, vl);
-        vse8_v_i8m1(output_data, vnclip_wx_i8m1(_res, 0, vl), vl);
-        input0_data += vl;
-        input1_data += vl;
-        output_data += vl;
-        size -= vl;
-    }
-}
-
 /************************************************************************************
  * (1) q2 = [ (q0-z0) * (q1-z1) * (s0*s1/s2) ] + z2
  * (2) q2 = (q0-z0) + z2
  * (3) ps: (q1-z1) * (s0*s1/s2) = 1(z1<0) or -1(z1>0)
  ***********************************************************************************/
-static void broadcast_single_1_mul_int8(struct csinn_tensor *input0, struct csinn_tensor *input1,
-                                        struct csinn_tensor *output)
+static void broadcast_single_1_mul_int8(int8_t *in0, int8_t *in1, int8_t *out, int32_t size,
+                                        float *scale, int32_t *zero_point)
 {
-    int8_t *input0_data = (int8_t *)input0->data;
-    int8_t *input1_data = (int8_t *)input1->data;
-    int8_t *output_data = (int8_t *)output->data;
-    int32_t zero_point0 = input0->qinfo->zero_point;
-    int32_t zero_point1 = input1->qinfo->zero_point;
-    int32_t zero_point2 = output->qinfo->zero_point;
+    int32_t zero_point0 = zero_point[0];
+    int32_t zero_point1 = zero_point[1];
+    int32_t zero_point2 = zero_point[2];
 
-    int64_t size = csinn_tensor_size(output);
     while (size > 0) {
         int vl = vsetvl_e8m1(size);
-        vint8m1_t _in0 = vle8_v_i8m1(input0_data, vl);
+        vint8m1_t _in0 = vle8_v_i8m1(in0, vl);
         vint16m2_t _q1_z1 = vwsub_vx_i16m2(_in0, zero_point0, vl);
         if (zero_point1 > 0) {
             _q1_z1 = vneg_v_i16m2(_q1_z1, vl);
         }
         vint16m2_t _res0 = vadd_vx_i16m2(_q1_z1, zero_point2, vl);
         vint8m1_t _res1 = vnclip_wx_i8m1(_res0, 0, vl);
-        vse8_v_i8m1(output_data, _res1, vl);
-        input0_data += vl;
-        output_data += vl;
+        vse8_v_i8m1(out, _res1, vl);
+        in0 += vl;
+        out += vl;
         size -= vl;
     }
 }
@@ -230,6 +193,10 @@ int shl_rvv_mul_int8(struct csinn_tensor *input0, struct csinn_tensor *input1,
     float real_scale = input0->qinfo->scale * input1->qinfo->scale / output->qinfo->scale;
     shl_quantize_multiplier(real_scale, &output->qinfo->multiplier, &output->qinfo->shift);
 
+    float scale[3] = {input0->qinfo->scale, input1->qinfo->scale, output->qinfo->scale};
+    int32_t zero_point[3] = {input0->qinfo->zero_point, input1->qinfo->zero_point,
+                             output->qinfo->zero_point};
+
     bool is_elementwise =
         (in_size0 == out_size) && (in_size1 == out_size) && (input0->layout == input1->layout);
 
@@ -239,14 +206,18 @@ int shl_rvv_mul_int8(struct csinn_tensor *input0, struct csinn_tensor *input1,
         for (int i = 0; i < output->dim_count; i++) {
             output->dim[i] = input0->dim[i];
         }
-        elementwise_mul_int8_trans_fp16(input0, input1, output);
+        shl_rvv_binary_op_flat(input0->data, input1->data, output->data, out_size,
+                               sizeof(int8_t), CSINN_BROADCAST_VV,
+                               mul_cb_int8[CSINN_BROADCAST_VV], scale, zero_point);
     } else if (in_size1 == 1) {
         output->layout = input0->layout;
         output->dim_count = input0->dim_count;
         for (int i = 0; i < output->dim_count; i++) {
             output->dim[i] = input0->dim[i];
         }
-        broadcast_single_1_mul_int8(input0, input1, output);
+        shl_rvv_binary_op_flat(input0->data, input1->data, output->data, out_size,
+                               sizeof(int8_t), CSINN_BROADCAST_VS,
+                               broadcast_single_1_mul_int8, scale, zero_point);
     } else {
         return shl_rvv_binary_op_broadcast_int8(input0, input1, output, mul_cb_int8);
     }
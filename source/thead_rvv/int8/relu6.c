@@ -18,8 +18,51 @@
 
 #include "rvv/rvv.h"
 
+/************************************************************************************
+ * s2(q2 - z2) = relu6{ s1(q1 - z1) }
+ * q2 = clip((q1 - z1) * s1/s2 + z2, z2, 6/s2 + z2)
+ ************************************************************************************/
 int shl_rvv_relu6_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                        struct csinn_relu_params *params)
 {
-    return shl_rvv_siso_callback_dtype_only(input, output, params, shl_rvv_relu6_fp32);
+    if (input->quant_channel != 1 || output->quant_channel != 1) {
+        return shl_rvv_siso_callback_dtype_only(input, output, params, shl_rvv_relu6_fp32);
+    }
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    int32_t z1 = input->qinfo->zero_point;
+    int32_t z2 = output->qinfo->zero_point;
+    int32_t multiplier, shift;
+    shl_quantize_multiplier(input->qinfo->scale / output->qinfo->scale, &multiplier, &shift);
+    int32_t q6 = (int32_t)roundf(6.0f / output->qinfo->scale) + z2;
+
+    int size = csinn_tensor_size(input);
+    while (size > 0) {
+        int vl = vsetvl_e8m1(size);
+
+        vint8m1_t _input = vle8_v_i8m1(input_data, vl);
+        vint16m2_t _input1 = vwadd_vx_i16m2(_input, 0, vl);   // widden 8->16
+        vint32m4_t _input2 = vwadd_vx_i32m4(_input1, 0, vl);  // widden 16->32
+
+        vint32m4_t _tmp = vsub_vx_i32m4(_input2, z1, vl);
+        _tmp = shl_rvv_requantize_i32m4(_tmp, multiplier, shift, vl);
+        _tmp = vadd_vx_i32m4(_tmp, z2, vl);
+        _tmp = vmax_vx_i32m4(_tmp, z2, vl);
+        _tmp = vmin_vx_i32m4(_tmp, q6, vl);
+
+        vint16m2_t _res1 = vnclip_wx_i16m2(_tmp, 0, vl);  // narrow 32->16
+        vint8m1_t _res2 = vnclip_wx_i8m1(_res1, 0, vl);   // narrow 16->8
+
+        vse8_v_i8m1(output_data, _res2, vl);
+        input_data += vl;
+        output_data += vl;
+        size -= vl;
+    }
+    output->layout = input->layout;
+    output->dim_count = input->dim_count;
+    for (int i = 0; i < output->dim_count; i++) {
+        output->dim[i] = input->dim[i];
+    }
+    return CSINN_TRUE;
 }
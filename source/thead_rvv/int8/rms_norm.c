@@ -18,9 +18,134 @@
 
 #include "rvv/rvv.h"
 
+/************************************************************************************
+ * s3(q3 - z3) = s1(q1 - z1) / rms * s2(q2 - z2)
+ *
+ * with d = q1 - z1 and ms = sum(d^2) / n + eps / s1^2,
+ * q3 = d * (q2 - z2) * s2/s3 / sqrt(ms) + z3, 1/sqrt(ms) is a fixed-point rsqrt per row.
+ ************************************************************************************/
+struct rms_norm_int8_native_task {
+    int8_t *input_data;
+    int8_t *output_data;
+    int8_t *weight_data;
+    int32_t norm_size;
+    int32_t z1;
+    int32_t z2;
+    int32_t z3;
+    int32_t w_multiplier;
+    int32_t w_shift;
+    uint64_t eps_n;
+};
+
+/* rows are normalized independently */
+static void rms_norm_int8_native_rows(void *arg, int start, int end)
+{
+    struct rms_norm_int8_native_task *t = (struct rms_norm_int8_native_task *)arg;
+    int8_t *input_data = t->input_data;
+    int8_t *output_data = t->output_data;
+    int8_t *weight_data = t->weight_data;
+    int32_t norm_size = t->norm_size;
+    int32_t z1 = t->z1;
+    int32_t z2 = t->z2;
+    int32_t z3 = t->z3;
+    int32_t w_multiplier = t->w_multiplier;
+    int32_t w_shift = t->w_shift;
+    uint64_t eps_n = t->eps_n;
+
+    for (int b = start; b < end; b++) {
+        int8_t *input_ptr = input_data + b * norm_size;
+        int8_t *output_ptr = output_data + b * norm_size;
+
+        vint64m1_t _sum = vmv_v_x_i64m1(0, 1);
+        int8_t *in0 = input_ptr;
+        int size = norm_size;
+        while (size > 0) {
+            int vl = vsetvl_e8m1(size);
+            vint8m1_t _in = vle8_v_i8m1(in0, vl);
+            vint16m2_t _d = vwadd_vx_i16m2(_in, 0, vl);
+            _d = vsub_vx_i16m2(_d, z1, vl);
+            vint32m4_t _d2 = vwmul_vv_i32m4(_d, _d, vl);
+            _sum = vwredsum_vs_i32m4_i64m1(vundefined_i64m1(), _d2, _sum, vl);
+            in0 += vl;
+            size -= vl;
+        }
+        /* ms << 16, so 1/sqrt(ms) = 2^8 * rsqrt(ms << 16) */
+        uint64_t ms16 = (((uint64_t)vmv_x_s_i64m1_i64(_sum) + eps_n) << 16) / norm_size;
+        int32_t r_exp;
+        int32_t r_mult = shl_rvv_rsqrt_fixed(ms16 ? ms16 : 1, &r_exp);
+        int32_t multiplier = ((int64_t)w_multiplier * r_mult) >> 31;
+        int32_t shift = w_shift + 9 - r_exp;
+
+        in0 = input_ptr;
+        int8_t *w0 = weight_data;
+        size = norm_size;
+        while (size > 0) {
+            int vl = vsetvl_e8m1(size);
+            vint8m1_t _in = vle8_v_i8m1(in0, vl);
+            vint16m2_t _d = vwadd_vx_i16m2(_in, 0, vl);
+            _d = vsub_vx_i16m2(_d, z1, vl);
+            vint8m1_t _weight = vle8_v_i8m1(w0, vl);
+            vint16m2_t _w = vwadd_vx_i16m2(_weight, 0, vl);
+            _w = vsub_vx_i16m2(_w, z2, vl);
+            vint32m4_t _mul = vwmul_vv_i32m4(_d, _w, vl);
+            vint32m4_t _res0 = shl_rvv_requantize_i32m4(_mul, multiplier, shift, vl);
+            _res0 = vadd_vx_i32m4(_res0, z3, vl);
+            vint16m2_t _res1 = vnclip_wx_i16m2(_res0, 0, vl);
+            vint8m1_t _res2 = vnclip_wx_i8m1(_res1, 0, vl);
+            vse8_v_i8m1(output_ptr, _res2, vl);
+            in0 += vl;
+            w0 += vl;
+            output_ptr += vl;
+            size -= vl;
+        }
+    }
+}
+
+static int rms_norm_int8_native(struct csinn_tensor *input, struct csinn_tensor *weight,
+                                struct csinn_tensor *output, struct csinn_rms_norm_params *params)
+{
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_int8(input);
+    }
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+    int8_t *weight_data = (int8_t *)weight->data;
+    /* support negative axis */
+    int axis = params->axis >= 0 ? params->axis : (params->axis + input->dim_count);
+    int32_t batches = 1;
+    for (int i = 0; i < axis; i++) {
+        batches *= input->dim[i];
+    }
+    int32_t norm_size = 1;
+    for (int i = axis; i < input->dim_count; i++) {
+        norm_size *= input->dim[i];
+    }
+
+    float s1 = input->qinfo->scale;
+    int32_t z1 = input->qinfo->zero_point;
+    int32_t z2 = weight->qinfo->zero_point;
+    int32_t z3 = output->qinfo->zero_point;
+    int32_t w_multiplier, w_shift;
+    shl_quantize_multiplier(weight->qinfo->scale / output->qinfo->scale, &w_multiplier, &w_shift);
+    double eps_q = (double)params->epsilon / ((double)s1 * s1);
+    uint64_t eps_n = eps_q * norm_size > (double)((uint64_t)1 << 44)
+                         ? (uint64_t)1 << 44
+                         : (uint64_t)(eps_q * norm_size + 0.5);
+
+    struct rms_norm_int8_native_task task = {input_data, output_data, weight_data, norm_size, z1,
+                                             z2, z3, w_multiplier, w_shift, eps_n};
+    shl_rvv_parallel_for(batches, (int64_t)batches * norm_size, rms_norm_int8_native_rows, &task);
+    return CSINN_TRUE;
+}
+
 int shl_rvv_rms_norm_int8(struct csinn_tensor *input, struct csinn_tensor *weight,
                           struct csinn_tensor *output, struct csinn_rms_norm_params *params)
 {
+    if (weight->dtype == CSINN_DTYPE_INT8 && input->quant_channel == 1 &&
+        weight->quant_channel == 1 && output->quant_channel == 1) {
+        return rms_norm_int8_native(input, weight, output, params);
+    }
+
     struct csinn_tensor *float_input = shl_rvv_tensor_transform_f32(input);
     struct csinn_tensor *float_output = shl_rvv_tensor_transform_f32(output);
     struct csinn_tensor *float_weight = shl_rvv_tensor_transform_f32(weight);
@@ -18,8 +18,32 @@
 
 #include "rvv/rvv.h"
 
+static float sigmoid(float x) { return 1.0f / (1.0f + expf(-x)); }
+
+int shl_rvv_sigmoid_init_int8(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_sigmoid_params *params)
+{
+    if (input->quant_channel == 1 && output->quant_channel == 1) {
+        params->lut = shl_mem_alloc(256);
+        shl_rvv_int8_lut_init(params->lut, input, output, sigmoid);
+    }
+    return CSINN_TRUE;
+}
+
+/************************************************************************************
+ * only 256 input codes exist: look the results up in the table built at init
+ ************************************************************************************/
 int shl_rvv_sigmoid_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_sigmoid_params *params)
 {
-    return shl_rvv_siso_callback_dtype_only(input, output, params, shl_rvv_sigmoid_fp32);
+    if (input->quant_channel != 1 || output->quant_channel != 1) {
+        return shl_rvv_siso_callback_dtype_only(input, output, params, shl_rvv_sigmoid_fp32);
+    }
+    output->layout = input->layout;
+    output->dim_count = input->dim_count;
+    for (int i = 0; i < output->dim_count; i++) {
+        output->dim[i] = input->dim[i];
+    }
+    shl_rvv_int8_lut(input->data, output->data, params->lut, csinn_tensor_size(input));
+    return CSINN_TRUE;
 }
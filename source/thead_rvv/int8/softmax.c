@@ -18,8 +18,147 @@
 
 #include "rvv/rvv.h"
 
+/************************************************************************************
+ * exp(s1 * (q - max)) = 2^-z with z = s1 * log2(e) * (max - q) >= 0, in Q16.
+ * 2^-z = 2^-n * 2^-f, n = floor(z), f in [0, 1) is approximated by a degree 4
+ * polynomial in Q15, so the result is in Q15 with exp(0) = 32768.
+ ************************************************************************************/
+static inline vint32m4_t exp_neg_q15(vint32m4_t _diff, int32_t mult, size_t vl)
+{
+    vint32m4_t _z = vmul_vx_i32m4(_diff, mult, vl);
+    vint32m4_t _n = vsra_vx_i32m4(_z, 16, vl);
+    vint32m4_t _f = vsra_vx_i32m4(vand_vx_i32m4(_z, 0xffff, vl), 1, vl);
+
+    vint32m4_t _p = vmv_v_x_i32m4(224, vl);
+    _p = vadd_vx_i32m4(vsra_vx_i32m4(vmul_vv_i32m4(_p, _f, vl), 15, vl), -1743, vl);
+    _p = vadd_vx_i32m4(vsra_vx_i32m4(vmul_vv_i32m4(_p, _f, vl), 15, vl), 7844, vl);
+    _p = vadd_vx_i32m4(vsra_vx_i32m4(vmul_vv_i32m4(_p, _f, vl), 15, vl), -22709, vl);
+    _p = vadd_vx_i32m4(vsra_vx_i32m4(vmul_vv_i32m4(_p, _f, vl), 15, vl), 32768, vl);
+
+    _n = vmin_vx_i32m4(_n, 31, vl);
+    return vsra_vv_i32m4(_p, vreinterpret_v_i32m4_u32m4(_n), vl);
+}
+
+/* widen int8 codes to (max - q) in int32 */
+static inline vint32m4_t load_diff(const int8_t *ptr, int stride, int32_t max, size_t vl)
+{
+    vint8m1_t _in = vlse8_v_i8m1(ptr, stride, vl);
+    vint16m2_t _in_w = vwadd_vx_i16m2(_in, 0, vl);
+    vint32m4_t _in_ww = vwadd_vx_i32m4(_in_w, 0, vl);
+    return vrsub_vx_i32m4(_in_ww, max, vl);
+}
+
+struct softmax_int8_task {
+    int8_t *input_data;
+    int8_t *output_data;
+    int64_t inner_size;
+    int cnt;
+    int32_t exp_mult;
+    float s2;
+    int32_t z2;
+};
+
+/* every outer slice is an independent softmax */
+static void softmax_int8_rows(void *arg, int start, int end)
+{
+    struct softmax_int8_task *t = (struct softmax_int8_task *)arg;
+    int8_t *input_data = t->input_data;
+    int8_t *output_data = t->output_data;
+    int64_t inner_size = t->inner_size;
+    int cnt = t->cnt;
+    int32_t exp_mult = t->exp_mult;
+    float s2 = t->s2;
+    int32_t z2 = t->z2;
+
+    input_data += start * inner_size * cnt;
+    output_data += start * inner_size * cnt;
+    for (int i = start; i < end; i++) {
+        for (int k = 0; k < inner_size; k++) {
+            int8_t *in_ptr = input_data + k;
+            int8_t *out_ptr = output_data + k;
+
+            vint8m1_t _max = vmv_v_x_i8m1(INT8_MIN, 1);
+            int8_t *ptr = in_ptr;
+            int n = cnt;
+            while (n > 0) {
+                int vl = vsetvl_e8m1(n);
+                vint8m1_t _in = vlse8_v_i8m1(ptr, inner_size, vl);
+                _max = vredmax_vs_i8m1_i8m1(vundefined_i8m1(), _in, _max, vl);
+                ptr += vl * inner_size;
+                n -= vl;
+            }
+            int32_t max = vmv_x_s_i8m1_i8(_max);
+
+            vint64m1_t _sum = vmv_v_x_i64m1(0, 1);
+            ptr = in_ptr;
+            n = cnt;
+            while (n > 0) {
+                int vl = vsetvl_e8m1(n);
+                vint32m4_t _exp = exp_neg_q15(load_diff(ptr, inner_size, max, vl), exp_mult, vl);
+                _sum = vwredsum_vs_i32m4_i64m1(vundefined_i64m1(), _exp, _sum, vl);
+                ptr += vl * inner_size;
+                n -= vl;
+            }
+            int64_t sum = vmv_x_s_i64m1_i64(_sum);
+
+            /* q2 = exp / sum / s2 + z2 */
+            int32_t multiplier, shift;
+            shl_quantize_multiplier(1.0 / ((double)sum * s2), &multiplier, &shift);
+            ptr = in_ptr;
+            n = cnt;
+            while (n > 0) {
+                int vl = vsetvl_e8m1(n);
+                vint32m4_t _exp = exp_neg_q15(load_diff(ptr, inner_size, max, vl), exp_mult, vl);
+                vint32m4_t _res0 = shl_rvv_requantize_i32m4(_exp, multiplier, shift, vl);
+                _res0 = vadd_vx_i32m4(_res0, z2, vl);
+                vint16m2_t _res1 = vnclip_wx_i16m2(_res0, 0, vl);
+                vint8m1_t _res2 = vnclip_wx_i8m1(_res1, 0, vl);
+                vsse8_v_i8m1(out_ptr, inner_size, _res2, vl);
+                ptr += vl * inner_size;
+                out_ptr += vl * inner_size;
+                n -= vl;
+            }
+        }
+        input_data += inner_size * cnt;
+        output_data += inner_size * cnt;
+    }
+}
+
+/************************************************************************************
+ * integer softmax: the exponentials are recomputed for the normalization pass
+ * instead of being stored, so no buffer is needed
+ ************************************************************************************/
 int shl_rvv_softmax_int8(struct csinn_tensor *input, struct csinn_tensor *output,
                          struct csinn_softmax_params *params)
 {
-    return shl_rvv_siso_callback_base(input, output, params, shl_rvv_softmax_fp32);
+    if (input->quant_channel != 1 || output->quant_channel != 1) {
+        return shl_rvv_siso_callback_base(input, output, params, shl_rvv_softmax_fp32);
+    }
+    if (input->layout == CSINN_LAYOUT_NC1HWC0) {
+        shl_rvv_tensor_nc1xc0_to_ndarray_replace_int8(input);
+    }
+    int8_t *input_data = (int8_t *)input->data;
+    int8_t *output_data = (int8_t *)output->data;
+
+    int axis = params->axis;
+    axis = axis < 0 ? axis + input->dim_count : axis;
+    int64_t outer_size = 1;
+    for (int i = 0; i < axis; i++) {
+        outer_size *= input->dim[i];
+    }
+    int64_t inner_size = 1;
+    for (int i = axis + 1; i < input->dim_count; i++) {
+        inner_size *= input->dim[i];
+    }
+    int cnt = input->dim[axis];
+
+    /* s1 * log2(e) in Q16, (max - q) <= 255 must not overflow */
+    float log2e_q16 = input->qinfo->scale * 1.442695041f * 65536.0f;
+    int32_t exp_mult = log2e_q16 > INT32_MAX / 256 ? INT32_MAX / 256 : (int32_t)roundf(log2e_q16);
+    float s2 = output->qinfo->scale;
+    int32_t z2 = output->qinfo->zero_point;
+
+    struct softmax_int8_task task = {input_data, output_data, inner_size, cnt, exp_mult, s2, z2};
+    shl_rvv_parallel_for(outer_size, outer_size * inner_size * cnt, softmax_int8_rows, &task);
+    return CSINN_TRUE;
 }
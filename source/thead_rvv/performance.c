@@ -411,6 +411,12 @@ static struct shl_function_map shl_rvv_kernel_map[] = {
     {shl_rvv_scaled_dot_product_attention_fp32, "shl_rvv_scaled_dot_product_attention_fp32"},
     {shl_rvv_scaled_dot_product_attention_fp16, "shl_rvv_scaled_dot_product_attention_fp16"},
     {shl_rvv_llm_pos_fp16, "shl_rvv_llm_pos_fp16"},
+    {shl_rvv_fsmn_fp32, "shl_rvv_fsmn_fp32"},
+    {shl_rvv_fsmn_fp16, "shl_rvv_fsmn_fp16"},
+    {shl_rvv_cache_matmul_fp32, "shl_rvv_cache_matmul_fp32"},
+    {shl_rvv_cache_matmul_fp16, "shl_rvv_cache_matmul_fp16"},
+    {shl_rvv_cache_conv1d_fp32, "shl_rvv_cache_conv1d_fp32"},
+    {shl_rvv_cache_conv1d_fp16, "shl_rvv_cache_conv1d_fp16"},
 #ifdef SHL_USE_DOT_INT4
     {shl_rvv_conv2d_init_int4, "shl_rvv_conv2d_init_int4"},
     {shl_rvv_conv_im2col_gemm_reorder_kernel_int4, "shl_rvv_conv_im2col_gemm_reorder_kernel_int4"},
@@ -721,3 +727,30 @@ int shl_rvv_llm_pos_perf(struct csinn_tensor *input, struct csinn_tensor *output
     perf_info->kernel_name = shl_rvv_get_kernel_name(params->base.cb->exec);
     return CSINN_TRUE;
 }
+
+int shl_rvv_fsmn_perf(struct csinn_tensor *frame, struct csinn_tensor *l_filter,
+                      struct csinn_tensor *r_filter, struct csinn_tensor *frame_sequence,
+                      struct csinn_tensor *frame_counter, struct csinn_tensor *output,
+                      struct csinn_fsmn_params *params, struct csinn_perf_info *perf_info)
+{
+    perf_info->kernel_name = shl_rvv_get_kernel_name(params->base.cb->exec);
+    return CSINN_TRUE;
+}
+
+int shl_rvv_cache_matmul_perf(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_matmul_params *params,
+                              struct csinn_perf_info *perf_info)
+{
+    perf_info->kernel_name = shl_rvv_get_kernel_name(params->base.cb->exec);
+    return CSINN_TRUE;
+}
+
+int shl_rvv_cache_conv1d_perf(struct csinn_tensor *input, struct csinn_tensor *output,
+                              struct csinn_tensor *weight, struct csinn_tensor *bias,
+                              struct csinn_cache_conv1d_params *params,
+                              struct csinn_perf_info *perf_info)
+{
+    perf_info->kernel_name = shl_rvv_get_kernel_name(params->base.cb->exec);
+    return CSINN_TRUE;
+}
@@ -20,35 +20,26 @@
 #include "rvv/perf.h"
 #include "rvv/rvv.h"
 
-#define RVV_OP_PATTERN_MAX 120
-static struct shl_cb_table shl_rvv_cb_table[RVV_OP_PATTERN_MAX];
+static struct shl_cb_op_map shl_rvv_cb_op_map;
 
 void shl_rvv_reg_op(enum csinn_dtype_enum dtype, enum csinn_op_enum op_name, void *init, void *exec,
                     void *est, void *cap, void *perf)
 {
-    static int i = 0;
-    if (i >= RVV_OP_PATTERN_MAX) {
-        shl_debug_error("RVV callback length is greater than RVV_OP_PATTERN_MAX!\n");
+    struct csinn_callback *cb = shl_cb_op_map_add(&shl_rvv_cb_op_map, dtype, op_name);
+    if (cb == NULL) {
+        return;
     }
-    shl_rvv_cb_table[i].shl_cb_key = op_name * CSINN_DTYPE_SIZE + dtype;
-    shl_rvv_cb_table[i].shl_cb_value.init = init;
-    shl_rvv_cb_table[i].shl_cb_value.exec = exec;
-    shl_rvv_cb_table[i].shl_cb_value.est = est;
-    shl_rvv_cb_table[i].shl_cb_value.caps = cap;
-    shl_rvv_cb_table[i].shl_cb_value.perf = perf;
-    i++;
+    cb->init = init;
+    cb->exec = exec;
+    cb->est = est;
+    cb->caps = cap;
+    cb->perf = perf;
 }
 
 struct csinn_callback *shl_cb_map_ref(int op, int dtype);
 struct csinn_callback *shl_cb_map_rvv(int op, int dtype)
 {
-    struct csinn_callback *cb = NULL;
-    for (int i = 0; i < RVV_OP_PATTERN_MAX; i++) {
-        if (shl_rvv_cb_table[i].shl_cb_key == (op * CSINN_DTYPE_SIZE + dtype)) {
-            cb = &(shl_rvv_cb_table[i].shl_cb_value);
-            break;
-        }
-    }
+    struct csinn_callback *cb = shl_cb_op_map_match(&shl_rvv_cb_op_map, dtype, op);
     if ((cb == NULL) || (cb->est == NULL && (cb->init == NULL || cb->exec == NULL))) {
         cb = shl_cb_map_ref(op, dtype);
     }
@@ -112,6 +103,12 @@ void __attribute__((weak)) shl_target_init_rvv()
     shl_rvv_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_GROUP_DECONV2D, shl_rvv_deconv2d_init_fp16, NULL,
                    shl_gref_group_deconv2d, shl_rvv_deconv2d_cap, shl_rvv_deconv2d_perf);
 #endif
+#ifndef CONFIG_THEAD_RVV_DECONVOLUTION_INT8_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_DECONV2D, shl_rvv_deconv2d_init_int8, NULL,
+                   shl_gref_deconv2d, shl_rvv_deconv2d_cap, shl_rvv_deconv2d_perf);
+    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_GROUP_DECONV2D, shl_rvv_deconv2d_init_int8, NULL,
+                   shl_gref_group_deconv2d, shl_rvv_deconv2d_cap, shl_rvv_deconv2d_perf);
+#endif
 #ifndef CONFIG_THEAD_RVV_MAXPOOL_FP32_DISABLED
     shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_MAXPOOL2D, shl_rvv_maxpool2d_init_fp32, NULL,
                    shl_gref_maxpool2d, shl_rvv_maxpool2d_cap, shl_rvv_maxpool2d_perf);
@@ -298,8 +295,9 @@ void __attribute__((weak)) shl_target_init_rvv()
                    shl_gref_sigmoid, shl_rvv_sigmoid_cap, shl_rvv_sigmoid_perf);
 #endif
 #ifndef CONFIG_THEAD_RVV_SIGMOID_INT8_DISABLED
-    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_SIGMOID, NULL, shl_rvv_sigmoid_int8, shl_gref_sigmoid,
-                   shl_rvv_sigmoid_cap, shl_rvv_sigmoid_perf);
+    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_SIGMOID, shl_rvv_sigmoid_init_int8,
+                   shl_rvv_sigmoid_int8, shl_gref_sigmoid, shl_rvv_sigmoid_cap,
+                   shl_rvv_sigmoid_perf);
 #endif
 #ifndef CONFIG_THEAD_RVV_SOFTMAX_FP32_DISABLED
     shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_SOFTMAX, NULL, shl_rvv_softmax_fp32,
@@ -431,8 +429,8 @@ void __attribute__((weak)) shl_target_init_rvv()
                    shl_rvv_erf_cap, shl_rvv_erf_perf);
 #endif
 #ifndef CONFIG_THEAD_RVV_ERF_INT8_DISABLED
-    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_ERF, NULL, shl_rvv_erf_int8, shl_gref_erf,
-                   shl_rvv_erf_cap, shl_rvv_erf_perf);
+    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_ERF, shl_rvv_erf_init_int8, shl_rvv_erf_int8,
+                   shl_gref_erf, shl_rvv_erf_cap, shl_rvv_erf_perf);
 #endif
 #ifndef CONFIG_THEAD_RVV_SPLIT_FP32_DISABLED
     shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_SPLIT, NULL, shl_rvv_split_fp32, shl_gref_split,
@@ -455,8 +453,8 @@ void __attribute__((weak)) shl_target_init_rvv()
                    shl_rvv_silu_cap, shl_rvv_silu_perf);
 #endif
 #ifndef CONFIG_THEAD_RVV_SILU_INT8_DISABLED
-    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_SILU, NULL, shl_rvv_silu_int8, shl_gref_silu,
-                   shl_rvv_silu_cap, shl_rvv_silu_perf);
+    shl_rvv_reg_op(CSINN_DTYPE_INT8, CSINN_OP_SILU, shl_rvv_silu_init_int8, shl_rvv_silu_int8,
+                   shl_gref_silu, shl_rvv_silu_cap, shl_rvv_silu_perf);
 #endif
 #ifndef CONFIG_THEAD_RVV_RMS_NORM_FP32_DISABLED
     shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_RMS_NORM, NULL, shl_rvv_rms_norm_fp32,
@@ -506,6 +504,34 @@ void __attribute__((weak)) shl_target_init_rvv()
     shl_rvv_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_LLM_POS, NULL, shl_rvv_llm_pos_fp16,
                    shl_gref_llm_pos, shl_rvv_llm_pos_cap, shl_rvv_llm_pos_perf);
 #endif
+#ifndef CONFIG_THEAD_RVV_FSMN_FP32_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_FSMN, NULL, shl_rvv_fsmn_fp32, shl_gref_fsmn,
+                   shl_rvv_fsmn_cap, shl_rvv_fsmn_perf);
+#endif
+#ifndef CONFIG_THEAD_RVV_FSMN_FP16_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_FSMN, NULL, shl_rvv_fsmn_fp16, shl_gref_fsmn,
+                   shl_rvv_fsmn_cap, shl_rvv_fsmn_perf);
+#endif
+#ifndef CONFIG_THEAD_RVV_CACHE_MATMUL_FP32_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_CACHE_MATMUL, shl_rvv_cache_matmul_init_fp32,
+                   NULL, shl_gref_cache_matmul, shl_rvv_cache_matmul_cap,
+                   shl_rvv_cache_matmul_perf);
+#endif
+#ifndef CONFIG_THEAD_RVV_CACHE_MATMUL_FP16_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_CACHE_MATMUL, shl_rvv_cache_matmul_init_fp16,
+                   NULL, shl_gref_cache_matmul, shl_rvv_cache_matmul_cap,
+                   shl_rvv_cache_matmul_perf);
+#endif
+#ifndef CONFIG_THEAD_RVV_CACHE_CONV1D_FP32_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_FLOAT32, CSINN_OP_CACHE_CONV1D, shl_rvv_cache_conv1d_init_fp32,
+                   NULL, shl_gref_cache_conv1d, shl_rvv_cache_conv1d_cap,
+                   shl_rvv_cache_conv1d_perf);
+#endif
+#ifndef CONFIG_THEAD_RVV_CACHE_CONV1D_FP16_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_FLOAT16, CSINN_OP_CACHE_CONV1D, shl_rvv_cache_conv1d_init_fp16,
+                   NULL, shl_gref_cache_conv1d, shl_rvv_cache_conv1d_cap,
+                   shl_rvv_cache_conv1d_perf);
+#endif
 
 #ifdef SHL_USE_DOT_INT4
 #ifndef CONFIG_THEAD_RVV_CONVOLUTION_INT4_DISABLED
@@ -524,6 +550,12 @@ void __attribute__((weak)) shl_target_init_rvv()
     shl_rvv_reg_op(CSINN_DTYPE_INT4, CSINN_OP_DEPTHWISE_CONV2D_RELU,
                    shl_rvv_depthwise_conv2d_init_int4, NULL, shl_gref_depthwise_conv2d_relu,
                    shl_rvv_conv2d_cap, shl_rvv_conv2d_perf);
+#endif
+#ifndef CONFIG_THEAD_RVV_DECONVOLUTION_INT4_DISABLED
+    shl_rvv_reg_op(CSINN_DTYPE_INT4, CSINN_OP_DECONV2D, shl_rvv_deconv2d_init_int4, NULL,
+                   shl_gref_deconv2d, shl_rvv_deconv2d_cap, shl_rvv_deconv2d_perf);
+    shl_rvv_reg_op(CSINN_DTYPE_INT4, CSINN_OP_GROUP_DECONV2D, shl_rvv_deconv2d_init_int4, NULL,
+                   shl_gref_group_deconv2d, shl_rvv_deconv2d_cap, shl_rvv_deconv2d_perf);
 #endif
     // shl_rvv_reg_op(CSINN_DTYPE_INT4, CSINN_OP_FULLYCONNECTED, shl_rvv_fullyconnected_init, NULL,
     //                shl_gref_fullyconnected);
@@ -17,6 +17,7 @@
  */
 
 #include "rvv/rvv.h"
+#include "shl_multithread.h"
 
 int csrr_vl()
 {
@@ -32,6 +33,37 @@ int csrr_vlenb()
     return a;
 }
 
+/* batch * c1 blocks of a layout conversion, each block is packn channels of one batch */
+struct layout_convert_task {
+    void *src;
+    void *dst;
+    int c1;
+    int batch_size;
+    int inner_size;
+    int packn;
+    int elempack;
+};
+
+static void ndarray_to_nc1xc0_fp32_blocks(void *arg, int start, int end)
+{
+    struct layout_convert_task *t = (struct layout_convert_task *)arg;
+    int inner_size = t->inner_size;
+    int packn = t->packn;
+    int vl = vsetvl_e32m1(packn);
+    for (int bc = start; bc < end; bc++) {
+        int b = bc / t->c1;
+        int c = bc % t->c1 * packn;
+        float *in_ptr = (float *)t->src + b * t->batch_size + c * inner_size;
+        float *out_ptr = (float *)t->dst + (int64_t)bc * inner_size * packn;
+        for (int i = 0; i < inner_size; i++) {
+            vfloat32m1_t _tmp = vlse32_v_f32m1(in_ptr, inner_size * sizeof(float), vl);
+            in_ptr++;
+            vse32_v_f32m1(out_ptr, _tmp, vl);
+            out_ptr += vl;
+        }
+    }
+}
+
 static float *rvv_tensor_ndarray_to_nc1xc0_fp32(struct csinn_tensor *t)
 {
     int batch = t->dim[0];
@@ -45,21 +77,12 @@ static float *rvv_tensor_ndarray_to_nc1xc0_fp32(struct csinn_tensor *t)
     float *dst = (float *)shl_mem_alloc(csinn_tensor_byte_size(t));
 
     const int packn = csrr_vlenb() / sizeof(float);
-    int vl = vsetvl_e32m1(packn);
     int batch_size = in_c * inner_size;
 
-    float *out_ptr = dst;
-    for (int b = 0; b < batch; b++) {
-        for (int c = 0; c + packn - 1 < in_c; c += packn) {
-            float *in_ptr = src + b * batch_size + c * inner_size;
-            for (int i = 0; i < inner_size; i++) {
-                vfloat32m1_t _tmp = vlse32_v_f32m1(in_ptr, inner_size * sizeof(float), vl);
-                in_ptr++;
-                vse32_v_f32m1(out_ptr, _tmp, vl);
-                out_ptr += vl;
-            }
-        }
-    }
+    struct layout_convert_task task = {src,        dst,   in_c / packn, batch_size,
+                                       inner_size, packn, packn};
+    shl_rvv_parallel_for(batch * (in_c / packn), (int64_t)batch * batch_size,
+                         ndarray_to_nc1xc0_fp32_blocks, &task);
     /* update tensor info to nc1hwc0 */
     t->dim[1] = in_c / packn;
     t->dim_count = t->dim_count + 1;
@@ -76,6 +99,26 @@ static float *rvv_tensor_ndarray_to_nc1xc0_fp32(struct csinn_tensor *t)
     return dst;
 }
 
+static void ndarray_to_nc1xc0_fp16_blocks(void *arg, int start, int end)
+{
+    struct layout_convert_task *t = (struct layout_convert_task *)arg;
+    int inner_size = t->inner_size;
+    int packn = t->packn;
+    int vl = vsetvl_e16m1(packn);
+    for (int bc = start; bc < end; bc++) {
+        int b = bc / t->c1;
+        int c = bc % t->c1 * packn;
+        __fp16 *in_ptr = (__fp16 *)t->src + b * t->batch_size + c * inner_size;
+        __fp16 *out_ptr = (__fp16 *)t->dst + (int64_t)bc * inner_size * packn;
+        for (int i = 0; i < inner_size; i++) {
+            vfloat16m1_t _tmp = vlse16_v_f16m1(in_ptr, inner_size * sizeof(__fp16), vl);
+            in_ptr++;
+            vse16_v_f16m1(out_ptr, _tmp, vl);
+            out_ptr += vl;
+        }
+    }
+}
+
 static __fp16 *rvv_tensor_ndarray_to_nc1xc0_fp16(struct csinn_tensor *t)
 {
     int batch = t->dim[0];
@@ -89,21 +132,12 @@ static __fp16 *rvv_tensor_ndarray_to_nc1xc0_fp16(struct csinn_tensor *t)
     __fp16 *dst = (__fp16 *)shl_mem_alloc(csinn_tensor_byte_size(t));
 
     const int packn = csrr_vlenb() / sizeof(__fp16);
-    int vl = vsetvl_e16m1(packn);
     int batch_size = in_c * inner_size;
 
-    __fp16 *out_ptr = dst;
-    for (int b = 0; b < batch; b++) {
-        for (int c = 0; c + packn - 1 < in_c; c += packn) {
-            __fp16 *in_ptr = src + b * batch_size + c * inner_size;
-            for (int i = 0; i < inner_size; i++) {
-                vfloat16m1_t _tmp = vlse16_v_f16m1(in_ptr, inner_size * sizeof(__fp16), vl);
-                in_ptr++;
-                vse16_v_f16m1(out_ptr, _tmp, vl);
-                out_ptr += vl;
-            }
-        }
-    }
+    struct layout_convert_task task = {src,        dst,   in_c / packn, batch_size,
+                                       inner_size, packn, packn};
+    shl_rvv_parallel_for(batch * (in_c / packn), (int64_t)batch * batch_size,
+                         ndarray_to_nc1xc0_fp16_blocks, &task);
     /* update tensor info to nc1hwc0 */
     t->dim[1] = in_c / packn;
     t->dim_count = t->dim_count + 1;
@@ -120,6 +154,26 @@ static __fp16 *rvv_tensor_ndarray_to_nc1xc0_fp16(struct csinn_tensor *t)
     return dst;
 }
 
+static void ndarray_to_nc1xc0_int8_blocks(void *arg, int start, int end)
+{
+    struct layout_convert_task *t = (struct layout_convert_task *)arg;
+    int inner_size = t->inner_size;
+    int packn = t->packn;
+    int vl = vsetvl_e8m1(packn);
+    for (int bc = start; bc < end; bc++) {
+        int b = bc / t->c1;
+        int c = bc % t->c1 * packn;
+        int8_t *in_ptr = (int8_t *)t->src + b * t->batch_size + c * inner_size;
+        int8_t *out_ptr = (int8_t *)t->dst + (int64_t)bc * inner_size * packn;
+        for (int i = 0; i < inner_size; i++) {
+            vint8m1_t _tmp = vlse8_v_i8m1(in_ptr, inner_size * sizeof(int8_t), vl);
+            in_ptr++;
+            vse8_v_i8m1(out_ptr, _tmp, vl);
+            out_ptr += vl;
+        }
+    }
+}
+
 static int8_t *rvv_tensor_ndarray_to_nc1xc0_int8(struct csinn_tensor *t)
 {
     int batch = t->dim[0];
@@ -133,21 +187,12 @@ static int8_t *rvv_tensor_ndarray_to_nc1xc0_int8(struct csinn_tensor *t)
     int8_t *dst = (int8_t *)shl_mem_alloc(csinn_tensor_byte_size(t));
 
     const int packn = csrr_vlenb() / sizeof(int8_t) / 2;
-    int vl = vsetvl_e8m1(packn);
     int batch_size = in_c * inner_size;
 
-    int8_t *out_ptr = dst;
-    for (int b = 0; b < batch; b++) {
-        for (int c = 0; c + packn - 1 < in_c; c += packn) {
-            int8_t *in_ptr = src + b * batch_size + c * inner_size;
-            for (int i = 0; i < inner_size; i++) {
-                vint8m1_t _tmp = vlse8_v_i8m1(in_ptr, inner_size * sizeof(int8_t), vl);
-                in_ptr++;
-                vse8_v_i8m1(out_ptr, _tmp, vl);
-                out_ptr += vl;
-            }
-        }
-    }
+    struct layout_convert_task task = {src,        dst,   in_c / packn, batch_size,
+                                       inner_size, packn, packn};
+    shl_rvv_parallel_for(batch * (in_c / packn), (int64_t)batch * batch_size,
+                         ndarray_to_nc1xc0_int8_blocks, &task);
     /* update tensor info to nc1hwc0 */
     t->dim[1] = in_c / packn;
     t->dim_count = t->dim_count + 1;
@@ -164,6 +209,25 @@ static int8_t *rvv_tensor_ndarray_to_nc1xc0_int8(struct csinn_tensor *t)
     return dst;
 }
 
+static void nc1xc0_to_ndarray_fp32_blocks(void *arg, int start, int end)
+{
+    struct layout_convert_task *t = (struct layout_convert_task *)arg;
+    int inner_size = t->inner_size;
+    int vl = vsetvl_e32m1(t->packn);
+    for (int bc = start; bc < end; bc++) {
+        int b = bc / t->c1;
+        int c = bc % t->c1;
+        float *src = (float *)t->src + (int64_t)bc * inner_size * vl;
+        float *out_ptr = (float *)t->dst + b * t->batch_size + c * inner_size * t->elempack;
+        for (int i = 0; i < inner_size; i++) {
+            vfloat32m1_t _tmp = vle32_v_f32m1(src, vl);
+            src += vl;
+            vsse32_v_f32m1(out_ptr, inner_size * sizeof(float), _tmp, vl);
+            out_ptr++;
+        }
+    }
+}
+
 static float *rvv_tensor_nc1xc0_to_ndarray_fp32(struct csinn_tensor *t)
 {
     int batch = t->dim[0];
@@ -178,20 +242,11 @@ static float *rvv_tensor_nc1xc0_to_ndarray_fp32(struct csinn_tensor *t)
     float *dst = (float *)shl_mem_alloc(csinn_tensor_byte_size(t));
 
     const int packn = csrr_vlenb() / sizeof(float);
-    int vl = vsetvl_e32m1(packn);
     int batch_size = in_c1 * inner_size * in_elempack;
 
-    for (int b = 0; b < batch; b++) {
-        for (int c = 0; c < in_c1; c++) {
-            float *out_ptr = dst + b * batch_size + c * inner_size * in_elempack;
-            for (int i = 0; i < inner_size; i++) {
-                vfloat32m1_t _tmp = vle32_v_f32m1(src, vl);
-                src += vl;
-                vsse32_v_f32m1(out_ptr, inner_size * sizeof(float), _tmp, vl);
-                out_ptr++;
-            }
-        }
-    }
+    struct layout_convert_task task = {src, dst, in_c1, batch_size, inner_size, packn, in_elempack};
+    shl_rvv_parallel_for(batch * in_c1, (int64_t)batch * batch_size, nc1xc0_to_ndarray_fp32_blocks,
+                         &task);
     /* update tensor info to nchw */
     t->dim[1] = in_c1 * packn;
     t->dim[t->dim_count - 1] = 0;
@@ -208,6 +263,25 @@ static float *rvv_tensor_nc1xc0_to_ndarray_fp32(struct csinn_tensor *t)
     return dst;
 }
 
+static void nc1xc0_to_ndarray_fp16_blocks(void *arg, int start, int end)
+{
+    struct layout_convert_task *t = (struct layout_convert_task *)arg;
+    int inner_size = t->inner_size;
+    int vl = vsetvl_e16m1(t->packn);
+    for (int bc = start; bc < end; bc++) {
+        int b = bc / t->c1;
+        int c = bc % t->c1;
+        __fp16 *src = (__fp16 *)t->src + (int64_t)bc * inner_size * vl;
+        __fp16 *out_ptr = (__fp16 *)t->dst + b * t->batch_size + c * inner_size * t->elempack;
+        for (int i = 0; i < inner_size; i++) {
+            vfloat16m1_t _tmp = vle16_v_f16m1(src, vl);
+            src += vl;
+            vsse16_v_f16m1(out_ptr, inner_size * sizeof(__fp16), _tmp, vl);
+            out_ptr++;
+        }
+    }
+}
+
 static __fp16 *rvv_tensor_nc1xc0_to_ndarray_fp16(struct csinn_tensor *t)
 {
     int batch = t->dim[0];
@@ -222,20 +296,11 @@ static __fp16 *rvv_tensor_nc1xc0_to_ndarray_fp16(struct csinn_tensor *t)
     __fp16 *dst = (__fp16 *)shl_mem_alloc(csinn_tensor_byte_size(t));
 
     const int packn = csrr_vlenb() / sizeof(__fp16);
-    int vl = vsetvl_e16m1(packn);
     int batch_size = in_c1 * inner_size * in_elempack;
 
-    for (int b = 0; b < batch; b++) {
-        for (int c = 0; c < in_c1; c++) {
-            __fp16 *out_ptr = dst + b * batch_size + c * inner_size * in_elempack;
-            for (int i = 0; i < inner_size; i++) {
-                vfloat16m1_t _tmp = vle16_v_f16m1(src, vl);
-                src += vl;
-                vsse16_v_f16m1(out_ptr, inner_size * sizeof(__fp16), _tmp, vl);
-                out_ptr++;
-            }
-        }
-    }
+    struct layout_convert_task task = {src, dst, in_c1, batch_size, inner_size, packn, in_elempack};
+    shl_rvv_parallel_for(batch * in_c1, (int64_t)batch * batch_size, nc1xc0_to_ndarray_fp16_blocks,
+                         &task);
     /* update tensor info to nchw */
     t->dim[1] = in_c1 * packn;
     t->dim[t->dim_count - 1] = 0;
@@ -252,6 +317,25 @@ static __fp16 *rvv_tensor_nc1xc0_to_ndarray_fp16(struct csinn_tensor *t)
     return dst;
 }
 
+static void nc1xc0_to_ndarray_int8_blocks(void *arg, int start, int end)
+{
+    struct layout_convert_task *t = (struct layout_convert_task *)arg;
+    int inner_size = t->inner_size;
+    int vl = vsetvl_e8m1(t->packn);
+    for (int bc = start; bc < end; bc++) {
+        int b = bc / t->c1;
+        int c = bc % t->c1;
+        int8_t *src = (int8_t *)t->src + (int64_t)bc * inner_size * vl;
+        int8_t *out_ptr = (int8_t *)t->dst + b * t->batch_size + c * inner_size * t->elempack;
+        for (int i = 0; i < inner_size; i++) {
+            vint8m1_t _tmp = vle8_v_i8m1(src, vl);
+            src += vl;
+            vsse8_v_i8m1(out_ptr, inner_size * sizeof(int8_t), _tmp, vl);
+            out_ptr++;
+        }
+    }
+}
+
 static int8_t *rvv_tensor_nc1xc0_to_ndarray_int8(struct csinn_tensor *t)
 {
     int batch = t->dim[0];
@@ -266,20 +350,11 @@ static int8_t *rvv_tensor_nc1xc0_to_ndarray_int8(struct csinn_tensor *t)
     int8_t *dst = (int8_t *)shl_mem_alloc(csinn_tensor_byte_size(t));
 
     const int packn = csrr_vlenb() / sizeof(int8_t) / 2;
-    int vl = vsetvl_e8m1(packn);
     int batch_size = in_c1 * inner_size * in_elempack;
 
-    for (int b = 0; b < batch; b++) {
-        for (int c = 0; c < in_c1; c++) {
-            int8_t *out_ptr = dst + b * batch_size + c * inner_size * in_elempack;
-            for (int i = 0; i < inner_size; i++) {
-                vint8m1_t _tmp = vle8_v_i8m1(src, vl);
-                src += vl;
-                vsse8_v_i8m1(out_ptr, inner_size * sizeof(int8_t), _tmp, vl);
-                out_ptr++;
-            }
-        }
-    }
+    struct layout_convert_task task = {src, dst, in_c1, batch_size, inner_size, packn, in_elempack};
+    shl_rvv_parallel_for(batch * in_c1, (int64_t)batch * batch_size, nc1xc0_to_ndarray_int8_blocks,
+                         &task);
     /* update tensor info to nchw */
     t->dim[1] = in_c1 * packn;
     t->dim[t->dim_count - 1] = 0;
@@ -1313,6 +1388,110 @@ int shl_rvv_transpose_get_out_index(int32_t *dim, int32_t *idx, int32_t *permute
     return res;
 }
 
+/*
+ * Gather the per-sample [rows, row_size] slabs of a batched tensor into one
+ * [rows, batch * row_size] matrix, so that a gemm can treat the batch as extra columns.
+ * row_size and batch_stride are in bytes.
+ */
+void shl_rvv_batch_fold(void *dst, const void *src, int batch, int rows, int row_size,
+                        int batch_stride)
+{
+    for (int r = 0; r < rows; r++) {
+        char *d = (char *)dst + (size_t)r * batch * row_size;
+        for (int b = 0; b < batch; b++) {
+            const char *s = (const char *)src + (size_t)b * batch_stride + (size_t)r * row_size;
+            memcpy(d, s, row_size);
+            d += row_size;
+        }
+    }
+}
+
+/* inverse of shl_rvv_batch_fold */
+void shl_rvv_batch_unfold(void *dst, const void *src, int batch, int rows, int row_size,
+                          int batch_stride)
+{
+    for (int r = 0; r < rows; r++) {
+        const char *s = (const char *)src + (size_t)r * batch * row_size;
+        for (int b = 0; b < batch; b++) {
+            char *d = (char *)dst + (size_t)b * batch_stride + (size_t)r * row_size;
+            memcpy(d, s, row_size);
+            s += row_size;
+        }
+    }
+}
+
+/*
+ * Tabulate an elementwise function over every int8 code of a per-tensor quantized input:
+ * lut[(uint8_t)q1] = q2 with s2(q2 - z2) = func(s1(q1 - z1)).
+ */
+void shl_rvv_int8_lut_init(int8_t *lut, struct csinn_tensor *input, struct csinn_tensor *output,
+                           float (*func)(float))
+{
+    float s1 = input->qinfo->scale;
+    int32_t z1 = input->qinfo->zero_point;
+    float s2 = output->qinfo->scale;
+    int32_t z2 = output->qinfo->zero_point;
+    for (int q = INT8_MIN; q <= INT8_MAX; q++) {
+        float y = func((q - z1) * s1);
+        int32_t res = (int32_t)roundf(y / s2) + z2;
+        res = res > INT8_MAX ? INT8_MAX : res;
+        res = res < INT8_MIN ? INT8_MIN : res;
+        lut[(uint8_t)q] = res;
+    }
+}
+
+/* output[i] = lut[(uint8_t)input[i]], the int8 codes are used as byte offsets */
+static void int8_lut(void *input, void *output, int32_t size, void *lut)
+{
+    int8_t *in = (int8_t *)input;
+    int8_t *out = (int8_t *)output;
+    while (size > 0) {
+        int vl = vsetvl_e8m4(size);
+        vuint8m4_t _idx = vreinterpret_v_i8m4_u8m4(vle8_v_i8m4(in, vl));
+        vint8m4_t _res = vluxei8_v_i8m4((int8_t *)lut, _idx, vl);
+        vse8_v_i8m4(out, _res, vl);
+        in += vl;
+        out += vl;
+        size -= vl;
+    }
+}
+
+void shl_rvv_int8_lut(const int8_t *input, int8_t *output, const int8_t *lut, int size)
+{
+    shl_rvv_unary_op_flat((void *)input, output, size, sizeof(int8_t), int8_lut, (void *)lut);
+}
+
+/*
+ * Fixed-point 1/sqrt(x) for x > 0: returns m in [2^30, 2^31) and e with
+ * 1/sqrt(x) = m * 2^(-30 - e). x is normalized into [2^60, 2^62), a linear guess
+ * (within 9%) is refined by three Newton steps y = y * (3 - x * y^2) / 2 in Q30.
+ */
+int32_t shl_rvv_rsqrt_fixed(uint64_t x, int32_t *exp)
+{
+    int j = 0;
+    while (x >= ((uint64_t)1 << 62)) {
+        x >>= 2;
+        j--;
+    }
+    while (x < ((uint64_t)1 << 60)) {
+        x <<= 2;
+        j++;
+    }
+    /* a in [0.25, 1) as Q30, so 1/sqrt(a) in (1, 2] */
+    uint64_t a = x >> 32;
+    uint64_t y = 2287070085u - ((1304596316u * a) >> 30); /* 2.13 - 1.215 * a */
+    for (int i = 0; i < 3; i++) {
+        uint64_t t = ((a * y) >> 30) * y >> 30;
+        y = y * (((uint64_t)3 << 30) - t) >> 31;
+    }
+    if (y >= ((uint64_t)1 << 31)) {
+        y = ((uint64_t)1 << 31) - 1;
+    }
+    /* 1/sqrt(x) = 1/sqrt(a * 2^62 * 2^-2j) = y * 2^-30 * 2^(j - 31) */
+    *exp = 31 - j;
+    return (int32_t)y;
+}
+
 static int rvv_tensor_dtype_convert(struct csinn_tensor *src, struct csinn_tensor *dst)
 {
     if (dst->quant_channel > 1 || src->quant_channel > 1) {
@@ -1962,3 +2141,142 @@ void shl_mem_copy_f32(float *output, const float *input, uint32_t length)
         length -= vl;
     }
 }
+
+/*
+ * Split [0, n) over the session threads once the op touches at least
+ * SHL_RVV_PARALLEL_THRESHOLD elements, smaller ops do not pay for the wake-up.
+ */
+void shl_rvv_parallel_for(int n, int64_t size, void (*func)(void *arg, int start, int end),
+                          void *arg)
+{
+    if (size < SHL_RVV_PARALLEL_THRESHOLD) {
+        func(arg, 0, n);
+    } else {
+        shl_multithread_parallel_for(n, func, arg);
+    }
+}
+
+/* number of pieces to cut `size` elements into so that each thread gets one */
+int shl_rvv_parallel_split(int64_t size)
+{
+    if (size < SHL_RVV_PARALLEL_THRESHOLD) {
+        return 1;
+    }
+    int threads = shl_multithread_get_threads();
+    int64_t max_split = size / (SHL_RVV_PARALLEL_THRESHOLD / 4);
+    return threads < max_split ? threads : (int)max_split;
+}
+
+struct pool_packn_task {
+    struct csinn_tensor *input;
+    struct csinn_tensor *output;
+    struct csinn_pool_params *params;
+    int (*kernel)(struct csinn_tensor *, struct csinn_tensor *, struct csinn_pool_params *);
+    int64_t in_block;
+    int64_t out_block;
+};
+
+/* run the kernel on the c1 blocks [start, end) of the flattened batch * c1 range */
+static void pool_packn_blocks(void *arg, int start, int end)
+{
+    struct pool_packn_task *t = (struct pool_packn_task *)arg;
+    struct csinn_tensor in = *t->input;
+    struct csinn_tensor out = *t->output;
+    in.dim[0] = out.dim[0] = 1;
+    in.dim[1] = out.dim[1] = end - start;
+    in.data = (int8_t *)t->input->data + start * t->in_block;
+    out.data = (int8_t *)t->output->data + start * t->out_block;
+    t->kernel(&in, &out, t->params);
+}
+
+/*
+ * Packn pooling windows never cross a c1 block, so large inputs are cut along
+ * batch * c1 and every thread runs the original kernel on its own blocks.
+ */
+int shl_rvv_pool_packn_parallel(struct csinn_tensor *input, struct csinn_tensor *output,
+                                struct csinn_pool_params *params,
+                                int (*kernel)(struct csinn_tensor *, struct csinn_tensor *,
+                                              struct csinn_pool_params *))
+{
+    if (shl_rvv_parallel_split(csinn_tensor_size(input)) <= 1) {
+        return kernel(input, output, params);
+    }
+
+    int elem_size;
+    if (input->dtype == CSINN_DTYPE_FLOAT32) {
+        elem_size = sizeof(float);
+        if (input->layout == CSINN_LAYOUT_NCHW) {
+            shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32(input);
+        }
+    } else if (input->dtype == CSINN_DTYPE_FLOAT16) {
+        elem_size = sizeof(__fp16);
+        if (input->layout == CSINN_LAYOUT_NCHW) {
+            shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp16(input);
+        }
+    } else if (input->dtype == CSINN_DTYPE_INT8) {
+        elem_size = sizeof(int8_t);
+        if (input->layout == CSINN_LAYOUT_NCHW) {
+            shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8(input);
+        }
+    } else {
+        return kernel(input, output, params);
+    }
+    if (output->layout == CSINN_LAYOUT_NCHW) {
+        output->dim[1] /= input->dim[4];
+        output->dim[4] = input->dim[4];
+        output->dim_count = 5;
+        output->layout = CSINN_LAYOUT_NC1HWC0;
+    }
+
+    struct pool_packn_task task;
+    task.input = input;
+    task.output = output;
+    task.params = params;
+    task.kernel = kernel;
+    task.in_block = (int64_t)input->dim[2] * input->dim[3] * input->dim[4] * elem_size;
+    task.out_block = (int64_t)output->dim[2] * output->dim[3] * output->dim[4] * elem_size;
+    shl_multithread_parallel_for(input->dim[0] * input->dim[1], pool_packn_blocks, &task);
+    return CSINN_TRUE;
+}
+
+struct unary_op_task {
+    void (*unary_op)(void *input, void *output, int32_t size, void *arg);
+    void *arg;
+    int8_t *input;
+    int8_t *output;
+    int elem_size;
+    int64_t size;
+    int64_t chunk;
+};
+
+static void unary_op_flat(void *arg, int start, int end)
+{
+    struct unary_op_task *t = (struct unary_op_task *)arg;
+    for (int i = start; i < end; i++) {
+        int64_t begin = i * t->chunk;
+        int64_t size = t->size - begin < t->chunk ? t->size - begin : t->chunk;
+        t->unary_op(t->input + begin * t->elem_size, t->output + begin * t->elem_size, size,
+                    t->arg);
+    }
+}
+
+/* elementwise unary op over flat data, cut into contiguous chunks over the threads */
+void shl_rvv_unary_op_flat(void *input, void *output, int64_t size, int elem_size,
+                           void (*unary_op)(void *input, void *output, int32_t size, void *arg),
+                           void *arg)
+{
+    if (size <= 0) {
+        return;
+    }
+    struct unary_op_task t;
+    t.unary_op = unary_op;
+    t.arg = arg;
+    t.input = input;
+    t.output = output;
+    t.elem_size = elem_size;
+    t.size = size;
+    int parts = shl_rvv_parallel_split(size);
+    /* keep the chunks cache line aligned */
+    t.chunk = ((size + parts - 1) / parts + 63) / 64 * 64;
+    shl_rvv_parallel_for((size + t.chunk - 1) / t.chunk, size, unary_op_flat, &t);
+}
@@ -20,36 +20,76 @@
 #include "shl_utils.h"
 #include "tvmgen/shl_tvmgen.h"
 
+/*
+ * Registered functions are looked up by layer name for every node at session setup,
+ * so the names are indexed in an open addressing hash table of entry indices.
+ */
 struct shl_tvmgen_name_func_map {
     int size;
     struct shl_tvmgen_name_func *reg;
+    int *slot; /* index into reg + 1, 0 when the slot is empty */
+    uint32_t mask;
 };
 
 static struct shl_tvmgen_name_func_map name_func_map;
 
+static uint32_t name_hash(const char *name)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
 int shl_tvmgen_map_reg(struct shl_tvmgen_name_func *map, int size)
 {
+    shl_mem_free(name_func_map.slot);
     name_func_map.size = size;
     name_func_map.reg = map;
+
+    uint32_t slots = 16;
+    while (slots < 2 * (uint32_t)size) {
+        slots *= 2;
+    }
+    name_func_map.mask = slots - 1;
+    name_func_map.slot = shl_mem_alloc(slots * sizeof(int));
+    for (int i = 0; i < size; i++) {
+        if (map[i].name == NULL) {
+            continue;
+        }
+        uint32_t h = name_hash(map[i].name) & name_func_map.mask;
+        while (name_func_map.slot[h] != 0) {
+            /* the first registration of a name wins, as with the former linear scan */
+            if (strcmp(map[name_func_map.slot[h] - 1].name, map[i].name) == 0) {
+                break;
+            }
+            h = (h + 1) & name_func_map.mask;
+        }
+        if (name_func_map.slot[h] == 0) {
+            name_func_map.slot[h] = i + 1;
+        }
+    }
     return CSINN_TRUE;
 }
 
 void *shl_tvmgen_find_reg(char *name, enum csinn_optimize_method_enum *opt_method)
 {
-    if (name == NULL) {
+    if (name == NULL || name_func_map.slot == NULL) {
         return NULL;
     }
-    for (int i = 0; i < name_func_map.size; i++) {
-        if (name_func_map.reg[i].name == NULL) {
-            continue;
-        }
-        if (strcmp(name, name_func_map.reg[i].name) == 0) {
-            if (name_func_map.reg[i].opt_method == 0) {
+    uint32_t h = name_hash(name) & name_func_map.mask;
+    while (name_func_map.slot[h] != 0) {
+        struct shl_tvmgen_name_func *reg = &name_func_map.reg[name_func_map.slot[h] - 1];
+        if (strcmp(name, reg->name) == 0) {
+            if (reg->opt_method == 0) {
                 shl_debug_warning("Get opt_method = 0\n, Please register valid opt_method\n");
             }
-            *opt_method = name_func_map.reg[i].opt_method;
-            return name_func_map.reg[i].ptr;
+            *opt_method = reg->opt_method;
+            return reg->ptr;
         }
+        h = (h + 1) & name_func_map.mask;
     }
     return NULL;
 }
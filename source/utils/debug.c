@@ -617,7 +617,8 @@ int shl_matmul_debug_info(struct csinn_tensor *mat0, struct csinn_tensor *mat1,
                           const char *name)
 {
     shl_debug_print_diso_base(mat0, mat1, output, &(params->base), name);
-    shl_debug_info("trans_a=%d, trans_b=%d", params->trans_a, params->trans_b);
+    shl_debug_info("trans_a=%d, trans_b=%d, act_quant=%d", params->trans_a, params->trans_b,
+                   params->act_quant);
     shl_debug_info(")\n");
     return CSINN_TRUE;
 }
@@ -16,11 +16,51 @@
  * limitations under the License.
  */
 
+#ifndef SHL_BUILD_RTOS
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "shl_debug.h"
 #include "shl_multithread.h"
+#include "shl_utils.h"
 
 int shl_thread_num = 1;
 
+#ifndef SHL_BUILD_RTOS
+/* busy-wait rounds before a worker goes to sleep on the condition variable */
+#define SHL_THREAD_POOL_SPIN 10000
+
+struct shl_thread_pool {
+    int num;       /* threads including the caller of shl_thread_pool_run */
+    int requested; /* thread_num of the session, num is smaller if workers failed to start */
+    uint64_t cpu_mask;
+    pthread_t *workers;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    void (*func)(void *arg, int idx, int num);
+    void *arg;
+    uint32_t generation; /* bumped for every job */
+    int32_t pending;     /* workers still running the current job */
+    int32_t sleeping;
+    bool parked; /* an OpenMP kernel is running, idle workers sleep instead of spinning */
+    bool quit;
+};
+
+/* saved by shl_multithread_session_begin, restored by shl_multithread_session_end */
+struct shl_thread_session {
+    struct shl_thread_pool *prev;
+    bool pinned;
+    cpu_set_t affinity;
+};
+
+/* pool of the session running on the calling thread, see csinn_session_run */
+static __thread struct shl_thread_pool *shl_current_pool;
+/* set while the thread runs a pool job, nested parallel loops run serially */
+static __thread bool shl_in_pool_job;
+#endif
+
 void shl_multithread_set_threads(int threads)
 {
 #ifdef _OPENMP
@@ -31,13 +71,288 @@ void shl_multithread_set_threads(int threads)
 #endif
 }
 
+int shl_multithread_get_threads()
+{
+#ifndef SHL_BUILD_RTOS
+    if (shl_in_pool_job) {
+        return 1;
+    }
+    if (shl_current_pool) {
+        return shl_current_pool->num;
+    }
+#endif
+#ifdef _OPENMP
+    return shl_thread_num;
+#else
+    return 1;
+#endif
+}
+
 int shl_multithread_is_enable()
 {
+    int threads = shl_multithread_get_threads();
+#ifndef SHL_BUILD_RTOS
+    /*
+     * The kernels ask before entering an OpenMP region, the omp team would share the cores
+     * with pool workers still spinning after the last pool job.
+     */
+    if (shl_current_pool && !shl_in_pool_job) {
+        __atomic_store_n(&shl_current_pool->parked, true, __ATOMIC_RELEASE);
+    }
+#endif
 #ifdef _OPENMP
-    omp_set_num_threads(shl_thread_num);
-    if (omp_get_max_threads() > 1) {
-        return CSINN_TRUE;
+    /* the omp setting is per thread, keep the remaining omp kernels on the same count */
+    if (omp_get_max_threads() != threads) {
+        omp_set_num_threads(threads);
+    }
+#endif
+    return threads > 1 ? CSINN_TRUE : CSINN_FALSE;
+}
+
+#ifndef SHL_BUILD_RTOS
+struct shl_thread_worker {
+    struct shl_thread_pool *pool;
+    int idx;
+};
+
+static bool thread_pool_bind(struct shl_thread_pool *pool, int idx)
+{
+    if (pool->cpu_mask == 0) {
+        return false;
+    }
+    /* thread idx takes the idx-th cpu of the mask, idx 0 is the caller */
+    int cpus[64];
+    int cpu_num = 0;
+    for (int i = 0; i < 64; i++) {
+        if (pool->cpu_mask & ((uint64_t)1 << i)) {
+            cpus[cpu_num++] = i;
+        }
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[idx % cpu_num], &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        shl_debug_warning("%s: cannot bind thread %d to cpu %d\n", __func__, idx,
+                          cpus[idx % cpu_num]);
+        return false;
+    }
+    return true;
+}
+
+static void *thread_pool_worker(void *data)
+{
+    struct shl_thread_worker *worker = data;
+    struct shl_thread_pool *pool = worker->pool;
+    int idx = worker->idx;
+    shl_mem_free(worker);
+    thread_pool_bind(pool, idx);
+    shl_in_pool_job = true;
+
+    uint32_t seen = 0;
+    while (1) {
+        uint32_t gen;
+        int spin = 0;
+        while ((gen = __atomic_load_n(&pool->generation, __ATOMIC_ACQUIRE)) == seen) {
+            if (++spin < SHL_THREAD_POOL_SPIN &&
+                !__atomic_load_n(&pool->parked, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            pthread_mutex_lock(&pool->lock);
+            pool->sleeping++;
+            while (__atomic_load_n(&pool->generation, __ATOMIC_ACQUIRE) == seen) {
+                pthread_cond_wait(&pool->wake, &pool->lock);
+            }
+            pool->sleeping--;
+            pthread_mutex_unlock(&pool->lock);
+            spin = 0;
+        }
+        seen = gen;
+        if (__atomic_load_n(&pool->quit, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        pool->func(pool->arg, idx, pool->num);
+        __atomic_fetch_sub(&pool->pending, 1, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+static void thread_pool_signal(struct shl_thread_pool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    __atomic_fetch_add(&pool->generation, 1, __ATOMIC_RELEASE);
+    if (pool->sleeping) {
+        pthread_cond_broadcast(&pool->wake);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+struct shl_thread_pool *shl_thread_pool_create(int threads, uint64_t cpu_mask)
+{
+    if (threads < 2) {
+        return NULL;
+    }
+    struct shl_thread_pool *pool = shl_mem_alloc(sizeof(struct shl_thread_pool));
+    pool->num = threads;
+    pool->requested = threads;
+    pool->cpu_mask = cpu_mask;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pool->workers = shl_mem_alloc((threads - 1) * sizeof(pthread_t));
+    for (int i = 1; i < threads; i++) {
+        struct shl_thread_worker *worker = shl_mem_alloc(sizeof(struct shl_thread_worker));
+        worker->pool = pool;
+        worker->idx = i;
+        if (pthread_create(&pool->workers[i - 1], NULL, thread_pool_worker, worker) != 0) {
+            /* keep the workers that started, a pool of one thread runs jobs on the caller */
+            shl_debug_warning("%s: cannot create worker %d, running with %d threads\n",
+                              __func__, i, i);
+            shl_mem_free(worker);
+            pool->num = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void shl_thread_pool_destroy(struct shl_thread_pool *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    __atomic_store_n(&pool->quit, true, __ATOMIC_RELEASE);
+    thread_pool_signal(pool);
+    for (int i = 1; i < pool->num; i++) {
+        pthread_join(pool->workers[i - 1], NULL);
     }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    shl_mem_free(pool->workers);
+    shl_mem_free(pool);
+}
+
+/* run func(arg, idx, num) on every thread of the pool, the caller takes idx 0 */
+void shl_thread_pool_run(struct shl_thread_pool *pool, void (*func)(void *arg, int idx, int num),
+                         void *arg)
+{
+    pool->func = func;
+    pool->arg = arg;
+    __atomic_store_n(&pool->parked, false, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->pending, pool->num - 1, __ATOMIC_RELAXED);
+    thread_pool_signal(pool);
+
+    shl_in_pool_job = true;
+    func(arg, 0, pool->num);
+    shl_in_pool_job = false;
+
+    int spin = 0;
+    while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) > 0) {
+        if (++spin >= SHL_THREAD_POOL_SPIN) {
+            sched_yield();
+        }
+    }
+}
+
+void *shl_multithread_session_begin(struct csinn_session *sess)
+{
+    struct shl_thread_session *ctx = shl_mem_alloc(sizeof(struct shl_thread_session));
+    ctx->prev = shl_current_pool;
+    struct shl_thread_pool *pool = sess->thread_pool;
+    if (pool && (pool->requested != sess->thread_num || pool->cpu_mask != sess->cpu_mask)) {
+        shl_thread_pool_destroy(pool);
+        pool = NULL;
+    }
+    if (pool == NULL && sess->thread_num > 1) {
+        pool = shl_thread_pool_create(sess->thread_num, sess->cpu_mask);
+    }
+    sess->thread_pool = pool;
+    /* sessions without own threads, e.g. subgraphs, run on the pool of the caller */
+    if (pool && pool != ctx->prev) {
+        shl_current_pool = pool;
+        /* the caller runs share 0 of every job, keep it on the first cpu of the mask */
+        if (pool->cpu_mask &&
+            pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &ctx->affinity) == 0) {
+            ctx->pinned = thread_pool_bind(pool, 0);
+        }
+    }
+    return ctx;
+}
+
+void shl_multithread_session_end(void *data)
+{
+    struct shl_thread_session *ctx = data;
+    if (ctx->pinned) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &ctx->affinity);
+    }
+    shl_current_pool = ctx->prev;
+    shl_mem_free(ctx);
+}
+
+void shl_multithread_session_free(struct csinn_session *sess)
+{
+    shl_thread_pool_destroy(sess->thread_pool);
+    sess->thread_pool = NULL;
+}
+#else
+struct shl_thread_pool *shl_thread_pool_create(int threads, uint64_t cpu_mask) { return NULL; }
+
+void shl_thread_pool_destroy(struct shl_thread_pool *pool) {}
+
+void shl_thread_pool_run(struct shl_thread_pool *pool, void (*func)(void *arg, int idx, int num),
+                         void *arg)
+{
+    func(arg, 0, 1);
+}
+
+void *shl_multithread_session_begin(struct csinn_session *sess) { return NULL; }
+
+void shl_multithread_session_end(void *data) {}
+
+void shl_multithread_session_free(struct csinn_session *sess) {}
+#endif
+
+struct parallel_for_task {
+    void (*func)(void *arg, int start, int end);
+    void *arg;
+    int n;
+};
+
+static void parallel_for_worker(void *data, int idx, int num)
+{
+    struct parallel_for_task *task = data;
+    int chunk = (task->n + num - 1) / num;
+    int start = idx * chunk;
+    int end = start + chunk < task->n ? start + chunk : task->n;
+    if (start < end) {
+        task->func(task->arg, start, end);
+    }
+}
+
+/*
+ * Split [0, n) into contiguous ranges over the threads of the running session,
+ * falls back to the global OpenMP team when the session has no pool.
+ */
+void shl_multithread_parallel_for(int n, void (*func)(void *arg, int start, int end), void *arg)
+{
+    if (n <= 0) {
+        return;
+    }
+    if (n == 1 || shl_multithread_get_threads() == 1) {
+        func(arg, 0, n);
+        return;
+    }
+#ifndef SHL_BUILD_RTOS
+    if (shl_current_pool) {
+        struct parallel_for_task task = {func, arg, n};
+        shl_thread_pool_run(shl_current_pool, parallel_for_worker, &task);
+        return;
+    }
+#endif
+#ifdef _OPENMP
+    /* one contiguous range per omp thread, as the pool does */
+    struct parallel_for_task task = {func, arg, n};
+#pragma omp parallel num_threads(shl_thread_num)
+    parallel_for_worker(&task, omp_get_thread_num(), omp_get_num_threads());
+#else
+    func(arg, 0, n);
 #endif
-    return CSINN_FALSE;
 }
@@ -97,12 +97,10 @@ int main(int argc, char **argv)
     float *result;
     if (dtype == 32) {
         result = (float *)ctx->output_session->output[0]->data;
-        // last logits
-        result += 32000 * 18;
+        // only the last token gets logits by default
     } else if (dtype == 16) {
         result = (float *)shl_mem_alloc(32000 * sizeof(float));
         int16_t *result_fp16 = ctx->output_session->output[0]->data;
-        result_fp16 += 32000 * 18;
         for (int i = 0; i < 32000; i++) {
             result[i] = shl_ref_float16_to_float32(result_fp16[i]);
         }
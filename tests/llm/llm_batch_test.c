@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Continuous batching: sequences admitted at different steps and decoded in one
+ * batched forward must give the logits of each sequence run alone in slot 0, and a
+ * retired slot must serve the next sequence as if it were fresh.
+ */
+
+#include "llm_test_model.h"
+
+#define N_SEQS 3
+#define N_DECODE 10
+#define MAX_PROMPT 20
+
+static const int n_prompts[N_SEQS] = {9, 17, 5};
+/* steps of the batched run at which the sequences are admitted */
+static const int admit_step[N_SEQS] = {0, 3, N_DECODE + 1};
+
+static void make_prompt(int seq, int32_t *prompt)
+{
+    for (int i = 0; i < n_prompts[seq]; i++) {
+        prompt[i] = (seq * 89 + i * 41 + 3) % TEST_VOCAB;
+    }
+}
+
+/* greedy decode of seq alone, logits holds [N_DECODE + 1][vocab] */
+static int run_alone(int seq, float *logits)
+{
+    struct shl_llm_sched *sched = shl_llm_sched_init(test_ctx(1, 1, 0));
+    int32_t prompt[MAX_PROMPT];
+    make_prompt(seq, prompt);
+    if (shl_llm_sched_admit(sched, prompt, n_prompts[seq]) != 0) {
+        return CSINN_FALSE;
+    }
+    for (int i = 0; i <= N_DECODE; i++) {
+        memcpy(logits + i * TEST_VOCAB, shl_llm_sched_logits(sched, 0), TEST_VOCAB * sizeof(float));
+        int32_t token = shl_llm_sched_sample(sched, 0);
+        if (i < N_DECODE && shl_llm_sched_step(sched, &token) != 1) {
+            return CSINN_FALSE;
+        }
+    }
+    shl_llm_sched_free(sched);
+    return CSINN_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+    float *ref = shl_mem_alloc(N_SEQS * (N_DECODE + 1) * TEST_VOCAB * sizeof(float));
+    for (int s = 0; s < N_SEQS; s++) {
+        if (run_alone(s, ref + s * (N_DECODE + 1) * TEST_VOCAB) != CSINN_TRUE) {
+            printf("sequence %d alone failed\n", s);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* two slots: the third sequence waits for the first to retire */
+    struct shl_llm_sched *sched = shl_llm_sched_init(test_ctx(1, 2, 0));
+    int slot_of[N_SEQS] = {-1, -1, -1};
+    int decoded[N_SEQS] = {0};
+    int32_t tokens[2];
+    int failures = 0;
+    for (int step = 0; failures == 0; step++) {
+        for (int s = 0; s < N_SEQS; s++) {
+            if (step != admit_step[s]) {
+                continue;
+            }
+            int32_t prompt[MAX_PROMPT];
+            make_prompt(s, prompt);
+            slot_of[s] = shl_llm_sched_admit(sched, prompt, n_prompts[s]);
+            if (slot_of[s] < 0) {
+                printf("step %d: sequence %d not admitted\n", step, s);
+                failures++;
+            }
+        }
+        if (failures > 0) {
+            break;
+        }
+
+        int n_active = 0;
+        for (int s = 0; s < N_SEQS; s++) {
+            int slot = slot_of[s];
+            if (slot < 0 || decoded[s] > N_DECODE) {
+                continue;
+            }
+            char name[48];
+            snprintf(name, sizeof(name), "step %d sequence %d slot %d", step, s, slot);
+            failures += test_compare(name, shl_llm_sched_logits(sched, slot),
+                                     ref + (s * (N_DECODE + 1) + decoded[s]) * TEST_VOCAB,
+                                     TEST_VOCAB, 1e-4f);
+            tokens[slot] = shl_llm_sched_sample(sched, slot);
+            if (decoded[s]++ == N_DECODE) {
+                shl_llm_sched_retire(sched, slot);
+            } else {
+                n_active++;
+            }
+        }
+        if (n_active == 0 && step > admit_step[N_SEQS - 1]) {
+            break;
+        }
+        if (n_active > 0 && shl_llm_sched_step(sched, tokens) != n_active) {
+            printf("step %d: batched forward failed\n", step);
+            failures++;
+        }
+    }
+
+    /* the last sequence took over the slot of the retired first one */
+    if (failures == 0 && (slot_of[2] != slot_of[0] || sched->n_active != 0)) {
+        printf("retired slot %d not reused, slot %d, %d active\n", slot_of[0], slot_of[2],
+               sched->n_active);
+        failures++;
+    }
+
+    shl_llm_sched_free(sched);
+    shl_mem_free(ref);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm continuous batching test passed\n");
+    return 0;
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * LLM benchmark on a synthetic random-weight llama model, no model files needed.
+ * Every (weight type, threads, prompt length, generated tokens) point runs in its own process so that
+ * the peak RSS belongs to that point only, and prints one JSON object per line.
+ */
+
+#include <getopt.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "llm/shl_llm.h"
+#include "shl_multithread.h"
+
+#define BENCH_MAX_LIST 16
+
+struct bench_list {
+    int n;
+    int v[BENCH_MAX_LIST];
+};
+
+struct bench_args {
+    int dim;
+    int n_layers;
+    int n_heads;
+    int hidden;
+    int vocab;
+    int max_seq_len;
+    struct bench_list prompt;
+    struct bench_list threads;
+    int n_quant;
+    char *quant[BENCH_MAX_LIST];
+    struct bench_list gen;
+    int chunk;
+    int act_dtype;  // 32 or 16, activations of the fp16/q8_0/q4_0 models
+    int api;
+};
+
+static uint64_t bench_rng = 0x2545f4914f6cdd1dULL;
+
+/* uniform in [-scale, scale) */
+static float bench_rand(float scale)
+{
+    bench_rng ^= bench_rng >> 12;
+    bench_rng ^= bench_rng << 25;
+    bench_rng ^= bench_rng >> 27;
+    uint32_t r = (bench_rng * 0x2545f4914f6cdd1dULL) >> 40;
+    return (r * (2.0f / 16777216.0f) - 1.0f) * scale;
+}
+
+static struct csinn_tensor *bench_tensor(char *name, int d0, int d1, float scale, float bias,
+                                         int dtype)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->name = name;
+    t->dtype = dtype;
+    t->dim_count = d1 ? 2 : 1;
+    t->dim[0] = d0;
+    t->dim[1] = d1;
+    int size = d0 * (d1 ? d1 : 1);
+    t->data = shl_mem_alloc(size * (dtype == CSINN_DTYPE_FLOAT16 ? 2 : 4));
+    for (int i = 0; i < size; i++) {
+        float v = bias + bench_rand(scale);
+        if (dtype == CSINN_DTYPE_FLOAT16) {
+            ((int16_t *)t->data)[i] = shl_ref_float32_to_float16(v);
+        } else {
+            ((float *)t->data)[i] = v;
+        }
+    }
+    t->is_const = 1;
+    return t;
+}
+
+/* matrices as mtype (CSINN_MEM_TYPE_CPU_NOT_ALIGNED keeps dtype), norms stay in dtype */
+static struct csinn_tensor *bench_weight(char *name, int d0, int d1, int dtype,
+                                         enum csinn_mem_type_enum mtype)
+{
+    struct csinn_tensor *t = bench_tensor(name, d0, d1, 1.0f / sqrtf(d1), 0.0f, dtype);
+    if (mtype == CSINN_MEM_TYPE_CPU_NOT_ALIGNED) {
+        return t;
+    }
+    struct csinn_tensor *q = quantize_tensor(t, mtype);
+    shl_mem_free(t->data);
+    csinn_free_tensor(t);
+    return q;
+}
+
+static struct shl_llm_model *bench_model(struct bench_args *args, int dtype,
+                                         enum csinn_mem_type_enum mtype)
+{
+    int dim = args->dim;
+    struct shl_llm_model *m = shl_mem_alloc(sizeof(struct shl_llm_model));
+    m->tok_embeddings = bench_weight("tok_embeddings", args->vocab, dim, dtype, mtype);
+    m->output_norm = bench_tensor("output_norm", dim, 0, 0.1f, 1.0f, dtype);
+    /* like the q4_0 converter, keep the vocab projection in q8_0 */
+    m->output = bench_weight("output", args->vocab, dim, dtype,
+                             mtype == CSINN_MEM_TYPE_BLOCK_Q4_0 ? CSINN_MEM_TYPE_BLOCK_Q8_0
+                                                                : mtype);
+    m->layers_num = args->n_layers;
+    for (int i = 0; i < args->n_layers; i++) {
+        struct shl_llm_layer *l = &m->layers[i];
+        l->attn_norm = bench_tensor("attn_norm", dim, 0, 0.1f, 1.0f, dtype);
+        l->ffn_norm = bench_tensor("ffn_norm", dim, 0, 0.1f, 1.0f, dtype);
+        l->wq = bench_weight("wq", dim, dim, dtype, mtype);
+        l->wk = bench_weight("wk", dim, dim, dtype, mtype);
+        l->wv = bench_weight("wv", dim, dim, dtype, mtype);
+        l->wo = bench_weight("wo", dim, dim, dtype, mtype);
+        l->w1 = bench_weight("w1", args->hidden, dim, dtype, mtype);
+        l->w2 = bench_weight("w2", dim, args->hidden, dtype, mtype);
+        l->w3 = bench_weight("w3", args->hidden, dim, dtype, mtype);
+    }
+    return m;
+}
+
+static int bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_ms(uint64_t ns) { return ns / 1e6; }
+
+/* one benchmark point, printed as a json line */
+static int bench_point(struct bench_args *args, char *quant, int threads, int n_prompt,
+                       int n_gen)
+{
+    int dtype = CSINN_DTYPE_FLOAT16;
+    int act_dtype = args->act_dtype;
+    enum csinn_mem_type_enum mtype = CSINN_MEM_TYPE_CPU_NOT_ALIGNED;
+    if (strcmp(quant, "fp32") == 0) {
+        dtype = CSINN_DTYPE_FLOAT32;
+        act_dtype = 32;
+    } else if (strcmp(quant, "fp16") == 0) {
+        /* fp16 weights, activations as -d */
+    } else if (strcmp(quant, "q8_0") == 0) {
+        mtype = CSINN_MEM_TYPE_BLOCK_Q8_0;
+    } else if (strcmp(quant, "q4_0") == 0) {
+        mtype = CSINN_MEM_TYPE_BLOCK_Q4_0;
+    } else {
+        printf("unknown weight type %s, use fp32/fp16/q8_0/q4_0\n", quant);
+        return 1;
+    }
+
+    struct llama_config *config = shl_mem_alloc(sizeof(struct llama_config));
+    config->dim = args->dim;
+    config->n_heads = args->n_heads;
+    config->n_layers = args->n_layers;
+    config->nor_eps = 1e-05;
+    config->vocab_size = args->vocab;
+    config->max_seq_len = args->max_seq_len;
+    config->prefill_chunk = args->chunk;
+    config->shl_model = bench_model(args, dtype, mtype);
+    config->base_api = args->api;
+    if (act_dtype == 16) {
+        config->base_quant_type = CSINN_QUANT_FLOAT16;
+        config->base_dtype = CSINN_DTYPE_FLOAT16;
+    } else {
+        config->base_quant_type = CSINN_QUANT_FLOAT32;
+        config->base_dtype = CSINN_DTYPE_FLOAT32;
+    }
+    shl_multithread_set_threads(threads);
+
+    struct shl_llm_ctx *ctx = llama2_build(config);
+    struct shl_llm_stats stats = {0};
+    stats.layer_ns = shl_mem_alloc(args->n_layers * sizeof(uint64_t));
+    struct shl_llm_sched *sched = shl_llm_sched_init(ctx);
+
+    int32_t *prompt = shl_mem_alloc(n_prompt * sizeof(int32_t));
+    for (int i = 0; i < n_prompt; i++) {
+        prompt[i] = (bench_rand(0.5f) + 0.5f) * (args->vocab - 1);
+    }
+
+    /* time to first token: prefill plus sampling the first token */
+    uint64_t start = shl_get_timespec();
+    int slot = shl_llm_sched_admit(sched, prompt, n_prompt);
+    if (slot < 0) {
+        printf("prefill failed\n");
+        return 1;
+    }
+    int32_t token = shl_llm_sched_sample(sched, slot);
+    uint64_t ttft = shl_get_timespec() - start;
+
+    int gen = n_gen;
+    if (n_prompt + gen > sched->max_seq_len) {
+        gen = sched->max_seq_len - n_prompt;
+    }
+    uint64_t *lat = shl_mem_alloc((gen > 0 ? gen : 1) * sizeof(uint64_t));
+    int32_t tokens[1];
+    ctx->stats = &stats;
+    for (int i = 0; i < gen; i++) {
+        start = shl_get_timespec();
+        tokens[0] = token;
+        shl_llm_sched_step(sched, tokens);
+        token = shl_llm_sched_sample(sched, slot);
+        lat[i] = shl_get_timespec() - start;
+    }
+    ctx->stats = NULL;
+
+    uint64_t decode = 0;
+    for (int i = 0; i < gen; i++) {
+        decode += lat[i];
+    }
+    qsort(lat, gen, sizeof(uint64_t), bench_cmp_u64);
+    int64_t runs = stats.n_runs > 0 ? stats.n_runs : 1;
+
+    printf("{\"quant\": \"%s\", \"act\": \"fp%d\", \"threads\": %d, \"prompt\": %d, "
+           "\"gen\": %d, \"dim\": %d, \"layers\": %d, \"heads\": %d, \"hidden\": %d, "
+           "\"vocab\": %d, \"chunk\": %d, ",
+           quant, act_dtype, threads, n_prompt, gen, args->dim, args->n_layers, args->n_heads,
+           args->hidden, args->vocab, args->chunk);
+    printf("\"ttft_ms\": %.3f, \"prefill_tok_s\": %.2f, ", bench_ms(ttft), n_prompt * 1e9 / ttft);
+    if (gen > 0) {
+        printf("\"decode_tok_s\": %.2f, \"decode_ms_p50\": %.3f, \"decode_ms_p90\": %.3f, "
+               "\"decode_ms_p99\": %.3f, ",
+               gen * 1e9 / decode, bench_ms(lat[gen / 2]), bench_ms(lat[gen * 9 / 10]),
+               bench_ms(lat[gen * 99 / 100]));
+    }
+    /* per decode token */
+    printf("\"embedding_ms\": %.3f, \"output_ms\": %.3f, \"layer_ms\": [",
+           bench_ms(stats.embedding_ns / runs), bench_ms(stats.output_ns / runs));
+    for (int i = 0; i < args->n_layers; i++) {
+        printf("%s%.3f", i ? ", " : "", bench_ms(stats.layer_ns[i] / runs));
+    }
+    printf("]");
+    return 0;
+}
+
+static int bench_parse_list(char *s, struct bench_list *list)
+{
+    list->n = 0;
+    for (char *tok = strtok(s, ","); tok && list->n < BENCH_MAX_LIST; tok = strtok(NULL, ",")) {
+        list->v[list->n++] = atoi(tok);
+    }
+    return list->n;
+}
+
+static void bench_usage(char *name)
+{
+    printf("usage: %s [options]\n", name);
+    printf("  -m dim,layers,heads,hidden,vocab  synthetic model (512,4,8,1408,4096)\n");
+    printf("  -p 16,64,256    prompt lengths\n");
+    printf("  -n 32,128       generated token counts\n");
+    printf("  -t 1,4          thread counts\n");
+    printf("  -q fp32,fp16,q8_0,q4_0  weight types\n");
+    printf("  -d 32|16        activation type of fp16/q8_0/q4_0, 16 needs c920 (32)\n");
+    printf("  -c 0            prefill chunk, 0: whole prompt\n");
+    printf("  -s 2048         max sequence length\n");
+    printf("  -a ref|c920     base api (ref)\n");
+}
+
+int main(int argc, char **argv)
+{
+    struct bench_args args = {512, 4, 8, 1408, 4096, 2048};
+    args.prompt = (struct bench_list){3, {16, 64, 256}};
+    args.threads = (struct bench_list){1, {1}};
+    args.quant[0] = "fp32";
+    args.n_quant = 1;
+    args.gen = (struct bench_list){1, {32}};
+    args.act_dtype = 32;
+    args.api = CSINN_REF;
+
+    struct bench_list model;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:p:n:t:q:d:c:s:a:h")) != -1) {
+        switch (opt) {
+            case 'm':
+                if (bench_parse_list(optarg, &model) != 5) {
+                    bench_usage(argv[0]);
+                    return 1;
+                }
+                args.dim = model.v[0];
+                args.n_layers = model.v[1];
+                args.n_heads = model.v[2];
+                args.hidden = model.v[3];
+                args.vocab = model.v[4];
+                break;
+            case 'p':
+                bench_parse_list(optarg, &args.prompt);
+                break;
+            case 'n':
+                bench_parse_list(optarg, &args.gen);
+                break;
+            case 't':
+                bench_parse_list(optarg, &args.threads);
+                break;
+            case 'q':
+                args.n_quant = 0;
+                for (char *tok = strtok(optarg, ","); tok && args.n_quant < BENCH_MAX_LIST;
+                     tok = strtok(NULL, ",")) {
+                    args.quant[args.n_quant++] = tok;
+                }
+                break;
+            case 'd':
+                args.act_dtype = atoi(optarg) == 16 ? 16 : 32;
+                break;
+            case 'c':
+                args.chunk = atoi(optarg);
+                break;
+            case 's':
+                args.max_seq_len = atoi(optarg);
+                break;
+            case 'a':
+                args.api = strcmp(optarg, "c920") == 0 ? CSINN_C920 : CSINN_REF;
+                break;
+            default:
+                bench_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (args.n_layers <= 0 || args.n_layers > 32) {
+        printf("layers must be in 1..32\n");
+        return 1;
+    }
+    if (args.dim % args.n_heads || args.dim % 32 || args.hidden % 32) {
+        printf("dim must split into heads, dim and hidden must be multiples of 32\n");
+        return 1;
+    }
+
+    int ret = 0;
+    for (int q = 0; q < args.n_quant; q++) {
+        for (int t = 0; t < args.threads.n; t++) {
+            for (int p = 0; p < args.prompt.n; p++) {
+                for (int g = 0; g < args.gen.n; g++) {
+                    fflush(stdout);
+                    pid_t pid = fork();
+                    if (pid == 0) {
+                        exit(bench_point(&args, args.quant[q], args.threads.v[t],
+                                         args.prompt.v[p], args.gen.v[g]));
+                    }
+                    int status;
+                    struct rusage usage;
+                    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) ||
+                        WEXITSTATUS(status) != 0) {
+                        printf("\nbenchmark point %s/%d/%d/%d failed\n", args.quant[q],
+                               args.threads.v[t], args.prompt.v[p], args.gen.v[g]);
+                        ret = 1;
+                        continue;
+                    }
+                    /* the child leaves its json object open for the peak rss */
+                    printf(", \"peak_rss_kb\": %ld}\n", usage.ru_maxrss);
+                }
+            }
+        }
+    }
+    return ret;
+}
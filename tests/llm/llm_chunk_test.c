@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Chunked prefill: a batch of prompts fed prefill_chunk tokens at a time must give
+ * the logits of a single pass, and leave the kv cache so that decoding continues
+ * the same way.
+ */
+
+#include "llm_test_model.h"
+
+#define N_SEQS 2
+#define N_PROMPT 24
+#define N_LOGITS 3
+#define N_DECODE 4
+
+/* prefill then decode greedily, logits holds [N_DECODE + 1][N_SEQS, N_LOGITS, vocab] */
+static int run_prompts(struct shl_llm_ctx *ctx, float *logits)
+{
+    int32_t token[N_SEQS * N_PROMPT];
+    int32_t pos[N_SEQS * N_PROMPT];
+    for (int s = 0; s < N_SEQS; s++) {
+        for (int i = 0; i < N_PROMPT; i++) {
+            token[s * N_PROMPT + i] = (s * 101 + i * 37 + 5) % TEST_VOCAB;
+            pos[s * N_PROMPT + i] = i;
+        }
+    }
+    /* logits rows from the first, a middle and the last chunk */
+    int32_t logits_idx[N_LOGITS] = {0, 9, N_PROMPT - 1};
+    struct shl_llm_input embd = {0};
+    embd.n_tokens = N_PROMPT;
+    embd.token = token;
+    embd.pos = pos;
+    embd.n_seqs = N_SEQS;
+    embd.n_logits = N_LOGITS;
+    embd.logits_idx = logits_idx;
+
+    int size = N_SEQS * N_LOGITS * TEST_VOCAB;
+    for (int step = 0; step <= N_DECODE; step++) {
+        if (llm_run(ctx, &embd) != CSINN_TRUE) {
+            return CSINN_FALSE;
+        }
+        float *out = ctx->output_session->output[0]->data;
+        memcpy(logits + step * size, out, embd.n_logits * N_SEQS * TEST_VOCAB * sizeof(float));
+
+        /* feed back the argmax of the last row of every sequence */
+        for (int s = 0; s < N_SEQS; s++) {
+            float *row = out + ((s + 1) * embd.n_logits - 1) * TEST_VOCAB;
+            int best = 0;
+            for (int v = 1; v < TEST_VOCAB; v++) {
+                best = row[v] > row[best] ? v : best;
+            }
+            token[s] = best;
+            pos[s] = N_PROMPT + step;
+        }
+        embd.n_tokens = 1;
+        embd.n_logits = 0;
+        embd.logits_idx = NULL;
+        size = N_SEQS * TEST_VOCAB;
+    }
+    return CSINN_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+    int size = N_SEQS * TEST_VOCAB * (N_LOGITS + N_DECODE);
+    float *ref = shl_mem_alloc(size * sizeof(float));
+    float *out = shl_mem_alloc(size * sizeof(float));
+    int failures = 0;
+
+    if (run_prompts(test_ctx(1, N_SEQS, 0), ref) != CSINN_TRUE) {
+        printf("single pass prefill failed\n");
+        return EXIT_FAILURE;
+    }
+    /* one token at a time, a remainder chunk, equal chunks, a last chunk of one token */
+    int chunks[] = {1, 5, 8, 23};
+    for (int i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        memset(out, 0, size * sizeof(float));
+        char name[32];
+        snprintf(name, sizeof(name), "chunk %d", chunks[i]);
+        if (run_prompts(test_ctx(1, N_SEQS, chunks[i]), out) != CSINN_TRUE) {
+            printf("%s: prefill failed\n", name);
+            failures++;
+            continue;
+        }
+        failures += test_compare(name, out, ref, size, 1e-4f);
+    }
+
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm chunked prefill test passed\n");
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Load options: a model saved with shl_llm_save_json and mapped back with each
+ * residency option must give the logits of the model it was saved from. mlock
+ * beyond RLIMIT_MEMLOCK only warns, and a missing file fails the load.
+ */
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "llm/shl_llm_json.h"
+#include "llm_test_model.h"
+
+#define N_PROMPT 8
+#define N_DECODE 4
+
+/* prompt then greedy decode, logits holds the last row of every step */
+static int run_model(struct shl_llm_model *model, float *logits)
+{
+    struct llama_config *config = shl_mem_alloc(sizeof(struct llama_config));
+    config->dim = TEST_DIM;
+    config->n_heads = TEST_HEADS;
+    config->n_layers = TEST_LAYERS;
+    config->nor_eps = 1e-05;
+    config->vocab_size = TEST_VOCAB;
+    config->max_batch = 1;
+    config->max_seq_len = TEST_MAX_SEQ_LEN;
+    config->shl_model = model;
+    config->base_api = CSINN_REF;
+    config->base_quant_type = CSINN_QUANT_FLOAT32;
+    config->base_dtype = CSINN_DTYPE_FLOAT32;
+    struct shl_llm_ctx *ctx = llama2_build(config);
+
+    int32_t token[N_PROMPT];
+    int32_t pos[N_PROMPT];
+    for (int i = 0; i < N_PROMPT; i++) {
+        token[i] = (i * 37 + 5) % TEST_VOCAB;
+        pos[i] = i;
+    }
+    struct shl_llm_input embd = {0};
+    embd.n_tokens = N_PROMPT;
+    embd.token = token;
+    embd.pos = pos;
+    for (int step = 0; step <= N_DECODE; step++) {
+        if (llm_run(ctx, &embd) != CSINN_TRUE) {
+            return CSINN_FALSE;
+        }
+        float *row = ctx->output_session->output[0]->data;
+        memcpy(logits + step * TEST_VOCAB, row, TEST_VOCAB * sizeof(float));
+        int best = 0;
+        for (int v = 1; v < TEST_VOCAB; v++) {
+            best = row[v] > row[best] ? v : best;
+        }
+        token[0] = best;
+        pos[0] = N_PROMPT + step;
+        embd.n_tokens = 1;
+    }
+    return CSINN_TRUE;
+}
+
+static int verify_load(const char *name, char *dir, struct shl_llm_load_options *opt, float *ref,
+                       float *out)
+{
+    struct shl_llm_model *model = shl_llm_load_json_opt(dir, opt);
+    if (model == NULL) {
+        printf("%s: load failed\n", name);
+        return 1;
+    }
+    if (model->mmap_addr == NULL || model->prefetch != opt->prefetch) {
+        printf("%s: mapping not recorded in the model\n", name);
+        return 1;
+    }
+    int size = (N_DECODE + 1) * TEST_VOCAB;
+    memset(out, 0, size * sizeof(float));
+    if (run_model(model, out) != CSINN_TRUE) {
+        printf("%s: run failed\n", name);
+        return 1;
+    }
+    /* the same weights through the same kernels */
+    if (memcmp(out, ref, size * sizeof(float)) != 0) {
+        return test_compare(name, out, ref, size, 0.0f) | 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int size = (N_DECODE + 1) * TEST_VOCAB;
+    float *ref = shl_mem_alloc(size * sizeof(float));
+    float *out = shl_mem_alloc(size * sizeof(float));
+    int failures = 0;
+
+    char dir[32] = "/tmp/shl_llm_load_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        printf("mkdtemp failed\n");
+        return EXIT_FAILURE;
+    }
+    strcat(dir, "/");
+    struct shl_llm_model *model = test_model(1);
+    shl_llm_save_json(dir, model);
+    if (run_model(model, ref) != CSINN_TRUE) {
+        printf("in memory model failed\n");
+        return EXIT_FAILURE;
+    }
+
+    struct {
+        const char *name;
+        struct shl_llm_load_options opt;
+    } cases[] = {
+        {"default", {0}},
+        {"populate", {.populate = true}},
+        {"willneed", {.willneed = true}},
+        {"hugepage", {.hugepage = true}},
+        {"prefetch", {.prefetch = true}},
+        {"mlock hot", {.mlock = SHL_LLM_MLOCK_HOT}},
+        {"mlock all", {.mlock = SHL_LLM_MLOCK_ALL}},
+        {"all options", {true, true, true, true, SHL_LLM_MLOCK_ALL}},
+    };
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        failures += verify_load(cases[i].name, dir, &cases[i].opt, ref, out);
+    }
+
+    /* without room to lock, the load warns and keeps the pages evictable */
+    struct rlimit limit;
+    getrlimit(RLIMIT_MEMLOCK, &limit);
+    struct rlimit none = {0, limit.rlim_max};
+    setrlimit(RLIMIT_MEMLOCK, &none);
+    struct shl_llm_load_options lock_all = {.mlock = SHL_LLM_MLOCK_ALL};
+    struct shl_llm_load_options lock_hot = {.mlock = SHL_LLM_MLOCK_HOT};
+    failures += verify_load("mlock all over the limit", dir, &lock_all, ref, out);
+    failures += verify_load("mlock hot over the limit", dir, &lock_hot, ref, out);
+    setrlimit(RLIMIT_MEMLOCK, &limit);
+
+    char path[64];
+    snprintf(path, sizeof(path), "%sshl.llm.weight.bm", dir);
+    unlink(path);
+    if (shl_llm_load_json_opt(dir, &lock_all) != NULL) {
+        printf("load without the weight file succeeded\n");
+        failures++;
+    }
+    snprintf(path, sizeof(path), "%sshl.llm.json", dir);
+    unlink(path);
+    if (shl_llm_load_json_opt(dir, NULL) != NULL) {
+        printf("load of a missing model succeeded\n");
+        failures++;
+    }
+    rmdir(dir);
+
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm load options test passed\n");
+    return 0;
+}
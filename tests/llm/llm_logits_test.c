@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Logits selection: the rows of logits_idx, and the last token by default, must be
+ * the same rows of the output over every position, bit for bit.
+ */
+
+#include "llm_test_model.h"
+
+#define N_SEQS 2
+#define N_PROMPT 5
+
+/* fp32 context of a one layer test_model(seed) */
+static struct shl_llm_ctx *one_layer_ctx(uint64_t seed)
+{
+    struct llama_config *config = shl_mem_alloc(sizeof(struct llama_config));
+    config->dim = TEST_DIM;
+    config->n_heads = TEST_HEADS;
+    config->n_layers = 1;
+    config->nor_eps = 1e-05;
+    config->vocab_size = TEST_VOCAB;
+    config->max_batch = N_SEQS;
+    config->max_seq_len = TEST_MAX_SEQ_LEN;
+    config->shl_model = test_model(seed);
+    config->shl_model->layers_num = 1;
+    config->base_api = CSINN_REF;
+    config->base_quant_type = CSINN_QUANT_FLOAT32;
+    config->base_dtype = CSINN_DTYPE_FLOAT32;
+    return llama2_build(config);
+}
+
+/* prefill the prompts on a fresh context, logits holds [N_SEQS, n_logits, vocab] */
+static int run_prompts(int32_t *logits_idx, int n_logits, float *logits)
+{
+    struct shl_llm_ctx *ctx = one_layer_ctx(1);
+    int32_t token[N_SEQS * N_PROMPT];
+    int32_t pos[N_SEQS * N_PROMPT];
+    for (int s = 0; s < N_SEQS; s++) {
+        for (int i = 0; i < N_PROMPT; i++) {
+            token[s * N_PROMPT + i] = (s * 101 + i * 37 + 5) % TEST_VOCAB;
+            pos[s * N_PROMPT + i] = i;
+        }
+    }
+    struct shl_llm_input embd = {0};
+    embd.n_tokens = N_PROMPT;
+    embd.token = token;
+    embd.pos = pos;
+    embd.n_seqs = N_SEQS;
+    embd.n_logits = n_logits;
+    embd.logits_idx = logits_idx;
+    if (llm_run(ctx, &embd) != CSINN_TRUE) {
+        return CSINN_FALSE;
+    }
+    int rows = logits_idx ? n_logits : 1;
+    memcpy(logits, ctx->output_session->output[0]->data,
+           N_SEQS * rows * TEST_VOCAB * sizeof(float));
+    return CSINN_TRUE;
+}
+
+/* rows of out against the rows idx of the full output */
+static int compare_rows(const char *name, float *out, float *full, int32_t *idx, int n)
+{
+    for (int s = 0; s < N_SEQS; s++) {
+        for (int j = 0; j < n; j++) {
+            float *row = out + (s * n + j) * TEST_VOCAB;
+            float *ref = full + (s * N_PROMPT + idx[j]) * TEST_VOCAB;
+            if (memcmp(row, ref, TEST_VOCAB * sizeof(float)) != 0) {
+                printf("%s: sequence %d, token %d differs\n", name, s, idx[j]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    float *full = shl_mem_alloc(N_SEQS * N_PROMPT * TEST_VOCAB * sizeof(float));
+    float *out = shl_mem_alloc(N_SEQS * N_PROMPT * TEST_VOCAB * sizeof(float));
+    int failures = 0;
+
+    int32_t all[N_PROMPT];
+    for (int i = 0; i < N_PROMPT; i++) {
+        all[i] = i;
+    }
+    if (run_prompts(all, N_PROMPT, full) != CSINN_TRUE) {
+        printf("full logits failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int32_t last[] = {N_PROMPT - 1};
+    if (run_prompts(NULL, 0, out) != CSINN_TRUE) {
+        printf("default logits failed\n");
+        failures++;
+    } else {
+        failures += compare_rows("default", out, full, last, 1);
+    }
+
+    int32_t some[] = {0, 2, 4};
+    memset(out, 0, N_SEQS * N_PROMPT * TEST_VOCAB * sizeof(float));
+    if (run_prompts(some, 3, out) != CSINN_TRUE) {
+        printf("logits {0, 2, 4} failed\n");
+        failures++;
+    } else {
+        failures += compare_rows("logits {0, 2, 4}", out, full, some, 3);
+    }
+
+    shl_mem_free(full);
+    shl_mem_free(out);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm logits selection test passed\n");
+    return 0;
+}
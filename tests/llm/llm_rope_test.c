@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Rotary table: rope through shl_llm_rope_table against the reference kernel
+ * computing the angles itself, the scalings expressed as its freq_base/freq_scale.
+ */
+
+#ifdef __riscv_vector
+#include "backend/rvv/rvv.h"
+#endif
+#include "llm_test_model.h"
+
+#define N_POS 40
+#define HEADS 4
+#define HEAD_DIM 64
+#define MAX_SEQ_LEN 1024
+#define FACTOR 4.0f
+#define ORIG_CTX 512
+
+static struct csinn_tensor *rope_tensor(float *data)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->dim[0] = 1;
+    t->dim[1] = N_POS;
+    t->dim[2] = HEADS;
+    t->dim[3] = HEAD_DIM;
+    t->dim_count = 4;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->data = data;
+    return t;
+}
+
+/* rope of input at pos, from table or from freq_base/freq_scale without one */
+static void run_rope(float *input, float *output, int32_t *pos, float *table, float freq_base,
+                     float freq_scale, bool rvv)
+{
+    struct csinn_rope_params *params = csinn_alloc_params(sizeof(struct csinn_rope_params), NULL);
+    params->freq_base = freq_base;
+    params->freq_scale = freq_scale;
+    params->n_dims = HEAD_DIM;
+    params->pos = pos;
+    params->use_rope_cache = table != NULL;
+    params->rope_cache = table;
+    params->rope_cache_shared = true;
+    struct csinn_tensor *in = rope_tensor(input);
+    struct csinn_tensor *out = rope_tensor(output);
+#ifdef __riscv_vector
+    if (rvv) {
+        shl_rvv_rope_fp32(in, out, params);
+    } else {
+        shl_ref_rope_f32(in, out, params);
+    }
+#else
+    shl_ref_rope_f32(in, out, params);
+#endif
+    csinn_free_tensor(in);
+    csinn_free_tensor(out);
+    shl_mem_free(params);
+}
+
+/*
+ * Mismatches between the table of rope and the reference, pairs [pair_begin, pair_end)
+ * of every head are compared after scaling the reference by mscale.
+ */
+static int verify_table(const char *name, struct shl_llm_rope_config *rope, float freq_base,
+                        float freq_scale, float mscale, int pair_begin, int pair_end)
+{
+    int size = N_POS * HEADS * HEAD_DIM;
+    float *input = shl_mem_alloc(size * sizeof(float));
+    float *ref = shl_mem_alloc(size * sizeof(float));
+    float *out = shl_mem_alloc(size * sizeof(float));
+    int32_t pos[N_POS];
+    for (int i = 0; i < N_POS; i++) {
+        pos[i] = i < N_POS / 2 ? i : (i * 97) % MAX_SEQ_LEN;
+    }
+    for (int i = 0; i < size; i++) {
+        input[i] = test_rand(1.0f);
+    }
+    float *table = shl_llm_rope_table(rope, HEAD_DIM, MAX_SEQ_LEN);
+    run_rope(input, ref, pos, NULL, freq_base, freq_scale, false);
+
+    int failures = 0;
+    for (int rvv = 0; rvv < 2; rvv++) {
+#ifndef __riscv_vector
+        if (rvv) {
+            break;
+        }
+#endif
+        run_rope(input, out, pos, table, 0, 0, rvv);
+        for (int i = 0; i < size && failures == 0; i++) {
+            int pair = i % HEAD_DIM / 2;
+            if (pair < pair_begin || pair >= pair_end) {
+                continue;
+            }
+            /* the reference accumulates the angle in fp32 over the pairs */
+            if (fabs(out[i] - ref[i] * mscale) > 5e-4f) {
+                printf("%s%s: position %d pair %d differs, %f vs %f\n", name, rvv ? " rvv" : "",
+                       pos[i / (HEADS * HEAD_DIM)], pair, out[i], ref[i] * mscale);
+                failures++;
+            }
+        }
+    }
+
+    shl_mem_free(table);
+    shl_mem_free(input);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    test_rng = 1;
+    int n_pairs = HEAD_DIM / 2;
+    int failures = 0;
+
+    struct shl_llm_rope_config rope = {0};
+    failures += verify_table("default", &rope, 10000.0f, 1.0f, 1.0f, 0, n_pairs);
+
+    rope.theta = 500000.0f;
+    failures += verify_table("theta", &rope, 500000.0f, 1.0f, 1.0f, 0, n_pairs);
+
+    rope.theta = 10000.0f;
+    rope.scaling = SHL_LLM_ROPE_SCALING_LINEAR;
+    rope.factor = FACTOR;
+    failures += verify_table("linear", &rope, 10000.0f, 1.0f / FACTOR, 1.0f, 0, n_pairs);
+
+    rope.scaling = SHL_LLM_ROPE_SCALING_NTK;
+    float ntk_base = 10000.0f * powf(FACTOR, (float)HEAD_DIM / (HEAD_DIM - 2));
+    failures += verify_table("ntk", &rope, ntk_base, 1.0f, 1.0f, 0, n_pairs);
+
+    /*
+     * YaRN with a 512 token training context: pairs up to the fast bound (3) keep the
+     * original frequencies, pairs from the slow bound (16) on are interpolated like
+     * linear, the whole table carries the attention factor.
+     */
+    rope.scaling = SHL_LLM_ROPE_SCALING_YARN;
+    rope.orig_ctx = ORIG_CTX;
+    float mscale = 1.0f + 0.1f * logf(FACTOR);
+    failures += verify_table("yarn extrapolated", &rope, 10000.0f, 1.0f, mscale, 0, 4);
+    failures += verify_table("yarn interpolated", &rope, 10000.0f, 1.0f / FACTOR, mscale, 16,
+                             n_pairs);
+
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm rope table test passed\n");
+    return 0;
+}
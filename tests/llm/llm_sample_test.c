@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Token sampler: greedy against argmax, seeded draws, the candidate sets of top-k,
+ * top-p and min-p against an exact softmax, the penalties, and the distribution
+ * left by the logit range cutoff. Built for RVV it also checks the whole-row scans
+ * against scalar loops.
+ */
+
+#ifdef __riscv_vector
+#include "backend/rvv/rvv.h"
+#endif
+#include "llm_test_model.h"
+
+#define VOCAB 1000
+#define N_DRAWS 20000
+
+static void random_logits(float *logits, int n, float scale)
+{
+    for (int i = 0; i < n; i++) {
+        logits[i] = test_rand(scale);
+    }
+}
+
+/* draw n tokens, counts holds how often each came out */
+static int draw(struct shl_llm_sampler_params *params, float *logits, int n, int *counts)
+{
+    struct shl_llm_sampler *s = shl_llm_sampler_init(params, VOCAB);
+    memset(counts, 0, VOCAB * sizeof(int));
+    int failures = 0;
+    for (int i = 0; i < n; i++) {
+        int32_t token = shl_llm_sampler_sample(s, logits);
+        if (token < 0 || token >= VOCAB) {
+            printf("draw %d: token %d out of the vocabulary\n", i, token);
+            failures++;
+            break;
+        }
+        counts[token]++;
+    }
+    shl_llm_sampler_free(s);
+    return failures;
+}
+
+/* exact softmax of logits / temperature in double, ids sorted by decreasing logit */
+static void exact_softmax(const float *logits, float temperature, double *prob, int *order)
+{
+    for (int i = 0; i < VOCAB; i++) {
+        order[i] = i;
+    }
+    for (int i = 1; i < VOCAB; i++) {
+        int id = order[i];
+        int j = i;
+        for (; j > 0 && logits[order[j - 1]] < logits[id]; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = id;
+    }
+    double sum = 0;
+    for (int i = 0; i < VOCAB; i++) {
+        prob[i] = exp((logits[i] - logits[order[0]]) / temperature);
+        sum += prob[i];
+    }
+    for (int i = 0; i < VOCAB; i++) {
+        prob[i] /= sum;
+    }
+}
+
+/* every draw within the n best tokens, each of which came out at least once */
+static int verify_set(const char *name, int *counts, int *order, int n)
+{
+    int drawn = 0;
+    for (int i = 0; i < n; i++) {
+        if (counts[order[i]] == 0) {
+            printf("%s: candidate %d of %d never drawn\n", name, i, n);
+            return 1;
+        }
+        drawn += counts[order[i]];
+    }
+    if (drawn != N_DRAWS) {
+        printf("%s: %d draws outside the %d candidates\n", name, N_DRAWS - drawn, n);
+        return 1;
+    }
+    return 0;
+}
+
+static int test_greedy()
+{
+    float logits[VOCAB];
+    struct shl_llm_sampler_params params = {0};
+    /* the truncation settings must not matter without a temperature */
+    params.top_k = 5;
+    params.top_p = 0.5f;
+    struct shl_llm_sampler *s = shl_llm_sampler_init(&params, VOCAB);
+    int failures = 0;
+    for (int row = 0; row < 50 && failures == 0; row++) {
+        random_logits(logits, VOCAB, 4.0f);
+        int best = 0;
+        for (int i = 1; i < VOCAB; i++) {
+            best = logits[i] > logits[best] ? i : best;
+        }
+        /* a tie keeps the first index */
+        if (row % 5 == 0) {
+            logits[VOCAB - 1 - row] = logits[best];
+            best = best < VOCAB - 1 - row ? best : VOCAB - 1 - row;
+        }
+        int32_t token = shl_llm_sampler_sample(s, logits);
+        if (token != best) {
+            printf("greedy row %d: %d, argmax %d\n", row, token, best);
+            failures++;
+        }
+    }
+    shl_llm_sampler_free(s);
+    return failures;
+}
+
+static int test_seed()
+{
+    float logits[VOCAB];
+    random_logits(logits, VOCAB, 2.0f);
+    struct shl_llm_sampler_params params = {0};
+    params.temperature = 1.0f;
+    params.seed = 42;
+    struct shl_llm_sampler *a = shl_llm_sampler_init(&params, VOCAB);
+    struct shl_llm_sampler *b = shl_llm_sampler_init(&params, VOCAB);
+    params.seed = 43;
+    struct shl_llm_sampler *c = shl_llm_sampler_init(&params, VOCAB);
+    int failures = 0;
+    int differ = 0;
+    for (int i = 0; i < 200; i++) {
+        int32_t ta = shl_llm_sampler_sample(a, logits);
+        int32_t tb = shl_llm_sampler_sample(b, logits);
+        differ += ta != shl_llm_sampler_sample(c, logits);
+        if (ta != tb) {
+            printf("seed: draw %d is %d and %d\n", i, ta, tb);
+            failures++;
+            break;
+        }
+    }
+    if (differ == 0) {
+        printf("seed: another seed drew the same tokens\n");
+        failures++;
+    }
+    shl_llm_sampler_free(a);
+    shl_llm_sampler_free(b);
+    shl_llm_sampler_free(c);
+    return failures;
+}
+
+/*
+ * Candidate sets on logits with a few clear leaders: the top-p and min-p bounds
+ * are put halfway between two consecutive candidates of the exact softmax, so
+ * rounding cannot move them.
+ */
+static int test_candidates(int *counts)
+{
+    float logits[VOCAB];
+    double prob[VOCAB];
+    int order[VOCAB];
+    random_logits(logits, VOCAB, 1.0f);
+    for (int i = 0; i < 8; i++) {
+        logits[(i * 131 + 17) % VOCAB] = 4.0f - 0.3f * i;
+    }
+    exact_softmax(logits, 1.0f, prob, order);
+    struct shl_llm_sampler_params params = {0};
+    params.temperature = 1.0f;
+    params.seed = 7;
+    int failures = 0;
+
+    params.top_k = 6;
+    failures += draw(&params, logits, N_DRAWS, counts);
+    failures += verify_set("top_k", counts, order, 6);
+    params.top_k = 0;
+
+    double cum[6];
+    cum[0] = prob[order[0]];
+    for (int i = 1; i < 6; i++) {
+        cum[i] = cum[i - 1] + prob[order[i]];
+    }
+    params.top_p = (cum[3] + cum[4]) / 2;
+    failures += draw(&params, logits, N_DRAWS, counts);
+    failures += verify_set("top_p", counts, order, 5);
+    params.top_p = 0.0f;
+
+    double p_max = prob[order[0]];
+    params.min_p = (prob[order[2]] + prob[order[3]]) / 2 / p_max;
+    failures += draw(&params, logits, N_DRAWS, counts);
+    failures += verify_set("min_p", counts, order, 3);
+
+    /* top_k, then min_p inside it, then top_p on what is left */
+    params.top_k = 7;
+    params.min_p = (prob[order[4]] + prob[order[5]]) / 2 / p_max;
+    params.top_p = (cum[2] + cum[3]) / (2 * cum[4]);
+    failures += draw(&params, logits, N_DRAWS, counts);
+    failures += verify_set("top_k min_p top_p", counts, order, 4);
+    return failures;
+}
+
+/*
+ * Without top_k only tokens SAMPLE_LOGIT_RANGE temperature-scaled nats below the
+ * max are candidates: the drawn frequencies must follow the exact softmax over the
+ * whole vocabulary, tokens beyond the cutoff must never come out.
+ */
+static int test_cutoff(int *counts)
+{
+    float temperature = 0.7f;
+    float logits[VOCAB];
+    double prob[VOCAB];
+    int order[VOCAB];
+    for (int i = 0; i < VOCAB; i++) {
+        logits[i] = -30.0f * temperature + test_rand(5.0f);
+    }
+    /* tokens spread over the kept range, the last one near its edge */
+    float nats[] = {0.0f, 0.5f, 1.0f, 1.5f, 2.5f, 3.5f, 19.0f};
+    for (int i = 0; i < sizeof(nats) / sizeof(nats[0]); i++) {
+        logits[i * 97] = 3.0f - nats[i] * temperature;
+    }
+    exact_softmax(logits, temperature, prob, order);
+    struct shl_llm_sampler_params params = {0};
+    params.temperature = temperature;
+    params.seed = 11;
+    int failures = draw(&params, logits, N_DRAWS, counts);
+
+    double dropped = 0;
+    for (int i = 0; i < VOCAB; i++) {
+        bool kept = logits[i] >= logits[order[0]] - 20.0f * temperature;
+        if (!kept) {
+            dropped += prob[i];
+            if (counts[i] > 0) {
+                printf("cutoff: token %d beyond the range drawn %d times\n", i, counts[i]);
+                failures++;
+            }
+        }
+        /* 4 standard deviations of a binomial count */
+        double expect = prob[i] * N_DRAWS;
+        if (fabs(counts[i] - expect) > 4 * sqrt(expect) + 1) {
+            printf("cutoff: token %d drawn %d times, %.1f expected\n", i, counts[i], expect);
+            failures++;
+            break;
+        }
+    }
+    if (dropped > 1e-6) {
+        printf("cutoff: %g of the probability mass beyond the range\n", dropped);
+        failures++;
+    }
+    return failures;
+}
+
+/* greedy choice between two close logits, 1 and 2 or negative 3 and 4, after history */
+static int penalty_case(const char *name, struct shl_llm_sampler_params *params,
+                        const int32_t *history, int n_history, bool negative, int32_t expect)
+{
+    float logits[VOCAB];
+    for (int i = 0; i < VOCAB; i++) {
+        logits[i] = -5.0f;
+    }
+    if (negative) {
+        logits[3] = -1.0f;
+        logits[4] = -1.3f;
+    } else {
+        logits[1] = 2.0f;
+        logits[2] = 1.8f;
+    }
+    float saved[VOCAB];
+    memcpy(saved, logits, sizeof(logits));
+
+    struct shl_llm_sampler *s = shl_llm_sampler_init(params, VOCAB);
+    for (int i = 0; i < n_history; i++) {
+        shl_llm_sampler_accept(s, history[i]);
+    }
+    int failures = 0;
+    int32_t token = shl_llm_sampler_sample(s, logits);
+    if (token != expect) {
+        printf("%s: %d, %d expected\n", name, token, expect);
+        failures++;
+    }
+    if (memcmp(saved, logits, sizeof(logits)) != 0) {
+        printf("%s: penalized logits not restored\n", name);
+        failures++;
+    }
+    shl_llm_sampler_free(s);
+    return failures;
+}
+
+static int test_penalties()
+{
+    int failures = 0;
+    struct shl_llm_sampler_params params = {0};
+    params.penalty_last_n = 4;
+    int32_t seen_1[] = {1};
+    int32_t seen_1_twice[] = {1, 7, 1};
+    int32_t seen_1_out_of_window[] = {1, 7, 8, 9, 10};
+    int32_t seen_3[] = {3};
+
+    failures += penalty_case("no penalty", &params, seen_1, 1, false, 1);
+    params.repeat_penalty = 1.5f;
+    failures += penalty_case("repeat", &params, seen_1, 1, false, 2);
+    failures += penalty_case("repeat window", &params, seen_1_out_of_window, 5, false, 1);
+    /* a negative logit is multiplied, so it moves further down */
+    failures += penalty_case("repeat negative", &params, seen_3, 1, true, 4);
+    params.repeat_penalty = 0.0f;
+
+    params.presence_penalty = 0.1f;
+    failures += penalty_case("presence small", &params, seen_1_twice, 3, false, 1);
+    params.presence_penalty = 0.3f;
+    failures += penalty_case("presence", &params, seen_1, 1, false, 2);
+    params.presence_penalty = 0.0f;
+
+    params.frequency_penalty = 0.15f;
+    failures += penalty_case("frequency once", &params, seen_1, 1, false, 1);
+    failures += penalty_case("frequency twice", &params, seen_1_twice, 3, false, 2);
+    return failures;
+}
+
+#ifdef __riscv_vector
+static int test_scans()
+{
+    float x[VOCAB];
+    int failures = 0;
+    int sizes[] = {1, 3, 16, 17, 63, 64, 65, VOCAB};
+    for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        int n = sizes[i];
+        random_logits(x, n, 3.0f);
+        float max = -FLT_MAX;
+        for (int j = 0; j < n; j++) {
+            max = fmax(max, x[j]);
+        }
+        if (shl_rvv_reduce_max_fp32(x, n) != max) {
+            printf("rvv max of %d differs\n", n);
+            failures++;
+        }
+        float thr[] = {max, max - 1.0f, max + 1.0f, -FLT_MAX};
+        for (int t = 0; t < sizeof(thr) / sizeof(thr[0]); t++) {
+            int first = -1;
+            for (int j = 0; j < n && first < 0; j++) {
+                first = x[j] >= thr[t] ? j : -1;
+            }
+            if (shl_rvv_find_ge_fp32(x, n, thr[t]) != first) {
+                printf("rvv find_ge of %d above %f differs\n", n, thr[t]);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    test_rng = 3;
+    int *counts = shl_mem_alloc(VOCAB * sizeof(int));
+    int failures = 0;
+    failures += test_greedy();
+    failures += test_seed();
+    failures += test_candidates(counts);
+    failures += test_cutoff(counts);
+    failures += test_penalties();
+#ifdef __riscv_vector
+    failures += test_scans();
+#endif
+    shl_mem_free(counts);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm sampler test passed\n");
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * KV cache snapshots: a prefix taken from one slot, saved, loaded back and restored
+ * into another slot must decode exactly like the slot that prefilled the prompt.
+ */
+
+#include <unistd.h>
+
+#include "llm_test_model.h"
+
+#define N_PROMPT 24
+#define N_PREFIX 16
+#define N_DECODE 8
+#define SNAPSHOT_PATH "llm_snapshot_test.kv"
+
+/* the loaded file against the snapshot it was saved from */
+static int verify_file(struct shl_llm_kv_snapshot *snap, struct shl_llm_kv_snapshot *loaded)
+{
+    if (loaded == NULL) {
+        printf("snapshot load failed\n");
+        return 1;
+    }
+    if (loaded->layers_num != snap->layers_num || loaded->n_tokens != snap->n_tokens ||
+        loaded->dtype != snap->dtype || loaded->row_size != snap->row_size) {
+        printf("loaded header differs\n");
+        return 1;
+    }
+    size_t size = 2 * (size_t)snap->layers_num * snap->n_tokens * snap->row_size;
+    if (memcmp(loaded->tokens, snap->tokens, snap->n_tokens * sizeof(int32_t)) != 0 ||
+        memcmp(loaded->data, snap->data, size) != 0) {
+        printf("loaded tokens or data differ\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    struct shl_llm_ctx *ctx = test_ctx(1, 3, 0);
+    struct shl_llm_sched *sched = shl_llm_sched_init(ctx);
+    int32_t prompt[N_PROMPT];
+    for (int i = 0; i < N_PROMPT; i++) {
+        prompt[i] = (i * 37 + 11) % TEST_VOCAB;
+    }
+    int failures = 0;
+
+    /* reference: the whole prompt prefilled in slot ref */
+    int ref = shl_llm_sched_admit(sched, prompt, N_PROMPT);
+    struct shl_llm_kv_snapshot *snap = shl_llm_kv_snapshot_take(ctx, ref, prompt, N_PREFIX);
+    if (ref < 0 || snap == NULL || shl_llm_kv_snapshot_save(snap, SNAPSHOT_PATH) != CSINN_TRUE) {
+        printf("prefill or snapshot save failed\n");
+        return EXIT_FAILURE;
+    }
+    struct shl_llm_kv_snapshot *loaded = shl_llm_kv_snapshot_load(SNAPSHOT_PATH);
+    unlink(SNAPSHOT_PATH);
+    failures += verify_file(snap, loaded);
+    if (loaded == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    /* a prompt sharing 10 tokens only restores those */
+    int32_t other[N_PROMPT];
+    memcpy(other, prompt, sizeof(prompt));
+    other[10] = (other[10] + 1) % TEST_VOCAB;
+    if (shl_llm_kv_snapshot_match(loaded, other, N_PROMPT) != 10 ||
+        shl_llm_kv_snapshot_match(loaded, prompt, N_PROMPT) != N_PREFIX) {
+        printf("snapshot match length differs\n");
+        failures++;
+    }
+
+    /* the prefix restored from the file, then only the rest of the prompt prefilled */
+    int slot = shl_llm_sched_admit_prefix(sched, loaded, prompt, N_PROMPT);
+    if (slot < 0) {
+        printf("admit from the snapshot failed\n");
+        return EXIT_FAILURE;
+    }
+    int32_t tokens[3];
+    for (int i = 0; i < N_DECODE && failures == 0; i++) {
+        failures += test_compare("logits", shl_llm_sched_logits(sched, slot),
+                                 shl_llm_sched_logits(sched, ref), TEST_VOCAB, 1e-4f);
+        tokens[ref] = shl_llm_sched_sample(sched, ref);
+        tokens[slot] = shl_llm_sched_sample(sched, slot);
+        if (tokens[ref] != tokens[slot]) {
+            printf("step %d: token %d vs %d\n", i, tokens[slot], tokens[ref]);
+            failures++;
+        }
+        shl_llm_sched_step(sched, tokens);
+    }
+
+    shl_llm_kv_snapshot_free(loaded);
+    shl_llm_kv_snapshot_free(snap);
+    shl_llm_sched_free(sched);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm snapshot test passed\n");
+    return 0;
+}
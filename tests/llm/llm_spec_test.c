@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Speculative decoding: drafts verified in one forward and a draft scheduler rolled
+ * back to the accepted prefix must emit the greedy tokens of a token by token run,
+ * and leave the kv cache so that the next decode gives the same logits.
+ */
+
+#include "llm_test_model.h"
+
+#define N_PROMPT 12
+#define N_TOTAL 56
+#define N_DRAFT 4
+
+/* greedy tokens [0, N_TOTAL) and the logits after feeding each of them */
+static int run_plain(int32_t *prompt, int32_t *tokens, float *logits)
+{
+    struct shl_llm_sched *sched = shl_llm_sched_init(test_ctx(1, 1, 0));
+    if (shl_llm_sched_admit(sched, prompt, N_PROMPT) != 0) {
+        return CSINN_FALSE;
+    }
+    memcpy(tokens, prompt, N_PROMPT * sizeof(int32_t));
+    int32_t token = 0;
+    for (int i = N_PROMPT - 1; i < N_TOTAL - 1; i++) {
+        memcpy(logits + i * TEST_VOCAB, shl_llm_sched_logits(sched, 0), TEST_VOCAB * sizeof(float));
+        token = shl_llm_sched_sample(sched, 0);
+        tokens[i + 1] = token;
+        if (shl_llm_sched_step(sched, &token) != 1) {
+            return CSINN_FALSE;
+        }
+    }
+    memcpy(logits + (N_TOTAL - 1) * TEST_VOCAB, shl_llm_sched_logits(sched, 0),
+           TEST_VOCAB * sizeof(float));
+    shl_llm_sched_free(sched);
+    return CSINN_TRUE;
+}
+
+/* step token at the slot's next position and compare the logits with the plain run */
+static int step_compare(struct shl_llm_sched *sched, int32_t token, float *logits)
+{
+    int n_past = sched->seqs[0].n_past;
+    if (shl_llm_sched_step(sched, &token) != 1) {
+        printf("step at %d failed\n", n_past);
+        return 1;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "decode at %d", n_past);
+    return test_compare(name, shl_llm_sched_logits(sched, 0), logits + n_past * TEST_VOCAB,
+                        TEST_VOCAB, 1e-4f);
+}
+
+int main(int argc, char **argv)
+{
+    int32_t prompt[N_PROMPT];
+    for (int i = 0; i < N_PROMPT; i++) {
+        prompt[i] = (i * 53 + 7) % TEST_VOCAB;
+    }
+    int32_t ref[N_TOTAL];
+    float *ref_logits = shl_mem_alloc(N_TOTAL * TEST_VOCAB * sizeof(float));
+    if (run_plain(prompt, ref, ref_logits) != CSINN_TRUE) {
+        printf("plain decode failed\n");
+        return EXIT_FAILURE;
+    }
+
+    /* the draft model is the target itself, so only the corrupted draft is rejected */
+    struct shl_llm_sched *target = shl_llm_sched_init(test_ctx(1, 1, 0));
+    struct shl_llm_sched *drafter = shl_llm_sched_init(test_ctx(1, 1, 0));
+    if (shl_llm_sched_admit(target, prompt, N_PROMPT) != 0 ||
+        shl_llm_sched_admit(drafter, prompt, N_PROMPT) != 0) {
+        printf("prefill failed\n");
+        return EXIT_FAILURE;
+    }
+    int failures = 0;
+    int32_t pending = shl_llm_sched_sample(target, 0);
+    int n_past = N_PROMPT;
+    for (int round = 0; failures == 0 && n_past + N_DRAFT + 2 < N_TOTAL; round++) {
+        /* draft N_DRAFT tokens, then break the one at round % (N_DRAFT + 1), none for
+         * N_DRAFT, so every accepted length from 0 to N_DRAFT is verified */
+        int32_t draft[N_DRAFT];
+        int32_t token = pending;
+        for (int i = 0; i < N_DRAFT; i++) {
+            shl_llm_sched_step(drafter, &token);
+            token = draft[i] = shl_llm_sched_sample(drafter, 0);
+        }
+        int broken = round % (N_DRAFT + 1);
+        if (broken < N_DRAFT) {
+            draft[broken] = (draft[broken] + 1) % TEST_VOCAB;
+        }
+
+        int32_t out[N_DRAFT + 1];
+        int n_out = shl_llm_sched_verify(target, 0, pending, draft, N_DRAFT, out);
+        int n_accept = broken < N_DRAFT ? broken : N_DRAFT;
+        if (n_out != n_accept + 1 || target->seqs[0].n_past != n_past + n_out) {
+            printf("round %d: %d tokens out, n_past %d, %d and %d expected\n", round, n_out,
+                   target->seqs[0].n_past, n_accept + 1, n_past + n_accept + 1);
+            failures++;
+            break;
+        }
+        for (int i = 0; i < n_out; i++) {
+            if (out[i] != ref[n_past + 1 + i]) {
+                printf("round %d: token %d is %d, %d expected\n", round, i, out[i],
+                       ref[n_past + 1 + i]);
+                failures++;
+            }
+        }
+        /* the slot logits are those of the last accepted position */
+        failures += test_compare("verify", shl_llm_sched_logits(target, 0),
+                                 ref_logits + (n_past + n_out - 1) * TEST_VOCAB, TEST_VOCAB,
+                                 1e-4f);
+
+        /* the drafter keeps pending and the accepted drafts, without a rejection it
+         * still has to feed its last draft */
+        n_past += n_out;
+        int keep = n_past < drafter->seqs[0].n_past ? n_past : drafter->seqs[0].n_past;
+        if (shl_llm_sched_rollback(drafter, 0, keep) != CSINN_TRUE) {
+            printf("round %d: draft rollback failed\n", round);
+            failures++;
+        }
+        if (drafter->seqs[0].n_past < n_past) {
+            shl_llm_sched_step(drafter, &draft[N_DRAFT - 1]);
+        }
+
+        /* the next decode sees the rolled back cache */
+        pending = out[n_out - 1];
+        failures += step_compare(target, pending, ref_logits);
+        shl_llm_sched_step(drafter, &pending);
+        n_past++;
+        pending = shl_llm_sched_sample(target, 0);
+    }
+
+    /* back to an empty prefix: the slot stays admitted and replays the prompt */
+    if (shl_llm_sched_rollback(target, 0, n_past + 1) == CSINN_TRUE ||
+        shl_llm_sched_rollback(target, 0, 0) != CSINN_TRUE || target->seqs[0].n_past != 0) {
+        printf("rollback to an empty prefix failed\n");
+        failures++;
+    }
+    for (int i = 0; i < N_PROMPT - 1 && failures == 0; i++) {
+        shl_llm_sched_step(target, &prompt[i]);
+    }
+    for (int i = N_PROMPT - 1; i < N_PROMPT + N_DRAFT && failures == 0; i++) {
+        failures += step_compare(target, ref[i], ref_logits);
+    }
+
+    shl_llm_sched_free(target);
+    shl_llm_sched_free(drafter);
+    shl_mem_free(ref_logits);
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    printf("llm speculative decoding test passed\n");
+    return 0;
+}
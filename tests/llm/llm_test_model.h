@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Small fp32 llama models of random weights for the llm tests. Models built from
+ * the same seed are identical, so two contexts run with different settings can be
+ * compared token by token.
+ */
+
+#ifndef TESTS_LLM_TEST_MODEL_H_
+#define TESTS_LLM_TEST_MODEL_H_
+
+#include "llm/shl_llm.h"
+
+#define TEST_DIM 64
+#define TEST_LAYERS 2
+#define TEST_HEADS 4
+#define TEST_HIDDEN 128
+#define TEST_VOCAB 256
+#define TEST_MAX_SEQ_LEN 64
+
+static uint64_t test_rng;
+
+/* uniform in [-scale, scale) */
+static inline float test_rand(float scale)
+{
+    test_rng ^= test_rng >> 12;
+    test_rng ^= test_rng << 25;
+    test_rng ^= test_rng >> 27;
+    uint32_t r = (test_rng * 0x2545f4914f6cdd1dULL) >> 40;
+    return (r * (2.0f / 16777216.0f) - 1.0f) * scale;
+}
+
+static inline struct csinn_tensor *test_tensor(char *name, int d0, int d1, float scale,
+                                               float bias)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->name = name;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->dim_count = d1 ? 2 : 1;
+    t->dim[0] = d0;
+    t->dim[1] = d1;
+    int size = d0 * (d1 ? d1 : 1);
+    float *data = shl_mem_alloc(size * sizeof(float));
+    for (int i = 0; i < size; i++) {
+        data[i] = bias + test_rand(scale);
+    }
+    t->data = data;
+    t->is_const = 1;
+    return t;
+}
+
+static inline struct shl_llm_model *test_model(uint64_t seed)
+{
+    test_rng = seed;
+    float scale = 1.0f / sqrtf(TEST_DIM);
+    struct shl_llm_model *m = shl_mem_alloc(sizeof(struct shl_llm_model));
+    m->tok_embeddings = test_tensor("tok_embeddings", TEST_VOCAB, TEST_DIM, 1.0f, 0.0f);
+    m->output_norm = test_tensor("output_norm", TEST_DIM, 0, 0.1f, 1.0f);
+    m->output = test_tensor("output", TEST_VOCAB, TEST_DIM, scale, 0.0f);
+    m->layers_num = TEST_LAYERS;
+    for (int i = 0; i < TEST_LAYERS; i++) {
+        struct shl_llm_layer *l = &m->layers[i];
+        l->attn_norm = test_tensor("attn_norm", TEST_DIM, 0, 0.1f, 1.0f);
+        l->ffn_norm = test_tensor("ffn_norm", TEST_DIM, 0, 0.1f, 1.0f);
+        l->wq = test_tensor("wq", TEST_DIM, TEST_DIM, scale, 0.0f);
+        l->wk = test_tensor("wk", TEST_DIM, TEST_DIM, scale, 0.0f);
+        l->wv = test_tensor("wv", TEST_DIM, TEST_DIM, scale, 0.0f);
+        l->wo = test_tensor("wo", TEST_DIM, TEST_DIM, scale, 0.0f);
+        l->w1 = test_tensor("w1", TEST_HIDDEN, TEST_DIM, scale, 0.0f);
+        l->w2 = test_tensor("w2", TEST_DIM, TEST_HIDDEN, 1.0f / sqrtf(TEST_HIDDEN), 0.0f);
+        l->w3 = test_tensor("w3", TEST_HIDDEN, TEST_DIM, scale, 0.0f);
+    }
+    return m;
+}
+
+/* fp32 context of a fresh test_model(seed) on the reference api */
+static inline struct shl_llm_ctx *test_ctx(uint64_t seed, int max_batch, int prefill_chunk)
+{
+    struct llama_config *config = shl_mem_alloc(sizeof(struct llama_config));
+    config->dim = TEST_DIM;
+    config->n_heads = TEST_HEADS;
+    config->n_layers = TEST_LAYERS;
+    config->nor_eps = 1e-05;
+    config->vocab_size = TEST_VOCAB;
+    config->max_batch = max_batch;
+    config->max_seq_len = TEST_MAX_SEQ_LEN;
+    config->prefill_chunk = prefill_chunk;
+    config->shl_model = test_model(seed);
+    config->base_api = CSINN_REF;
+    config->base_quant_type = CSINN_QUANT_FLOAT32;
+    config->base_dtype = CSINN_DTYPE_FLOAT32;
+    return llama2_build(config);
+}
+
+/* 1 if out differs from ref anywhere by more than a relative tolerance */
+static inline int test_compare(const char *name, float *out, float *ref, int size,
+                               float tolerance)
+{
+    for (int i = 0; i < size; i++) {
+        if (fabs(out[i] - ref[i]) > tolerance * (1 + fabs(ref[i]))) {
+            printf("%s: %d differs, %f vs %f\n", name, i, out[i], ref[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif  // TESTS_LLM_TEST_MODEL_H_
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "reference/ref.h"
+#include "test_utils.h"
+
+/*
+ * Model of the cache as the window it exposes: every insertion shifts the whole window
+ * by one frame. The ring in reference/utils.c only moves the new bytes and has to read
+ * back the same window after any number of wraps.
+ */
+struct shift_window {
+    float *hist;  // newest frame first
+    float *window;
+    int window_len;
+    int filled;
+    bool wrapped;
+};
+
+static void shift_insert_front(struct shift_window *s, float *frame, int len)
+{
+    if (s->filled + len > s->window_len) {
+        s->wrapped = true;
+    }
+    memmove(s->hist + len, s->hist, (s->window_len - len) * sizeof(float));
+    memcpy(s->hist, frame, len * sizeof(float));
+    s->filled = s->filled + len < s->window_len ? s->filled + len : s->window_len;
+
+    /* until the first wrap the frames sit behind zero padding */
+    int pad = s->wrapped ? 0 : s->window_len - s->filled;
+    memset(s->window, 0, pad * sizeof(float));
+    memcpy(s->window + pad, s->hist, (s->window_len - pad) * sizeof(float));
+}
+
+static void shift_insert_back(struct shift_window *s, float *frame, int len)
+{
+    memmove(s->window, s->window + len, (s->window_len - len) * sizeof(float));
+    memcpy(s->window + s->window_len - len, frame, len * sizeof(float));
+}
+
+static void read_window(struct csinn_asr_buffer_t *buffer, float *dst, int window_len)
+{
+    size_t offset = 0;
+    while (offset < window_len * sizeof(float)) {
+        size_t contig;
+        uint8_t *src = asr_buffer_get_data(buffer, offset, &contig);
+        memcpy((uint8_t *)dst + offset, src, contig);
+        offset += contig;
+    }
+}
+
+static int verify_asr_buffer(int window_len, int frame_len, bool front)
+{
+    int steps = window_len / frame_len * 5 + 3;
+    struct shift_window s;
+    s.hist = shl_mem_alloc(window_len * sizeof(float));
+    s.window = shl_mem_alloc(window_len * sizeof(float));
+    s.window_len = window_len;
+    s.filled = 0;
+    s.wrapped = false;
+
+    struct csinn_asr_buffer_t buffer;
+    asr_buffer_init(&buffer, window_len * sizeof(float));
+
+    float *frame = shl_mem_alloc(frame_len * sizeof(float));
+    float *ref = shl_mem_alloc(steps * window_len * sizeof(float));
+    float *out = shl_mem_alloc(steps * window_len * sizeof(float));
+    int mismatches = 0;
+    for (int i = 0; i < steps; i++) {
+        for (int j = 0; j < frame_len; j++) {
+            frame[j] = (float)(rand() % 2001) / 1000.0f - 1.0f;
+        }
+        if (front) {
+            shift_insert_front(&s, frame, frame_len);
+            asr_buffer_insert_front(&buffer, frame, frame_len * sizeof(float));
+        } else {
+            shift_insert_back(&s, frame, frame_len);
+            asr_buffer_insert_back(&buffer, frame, frame_len * sizeof(float));
+        }
+        memcpy(ref + i * window_len, s.window, window_len * sizeof(float));
+        read_window(&buffer, out + i * window_len, window_len);
+        if (memcmp(ref + i * window_len, out + i * window_len, window_len * sizeof(float))) {
+            printf("insert_%s window %d, frame %d: step %d differs\n", front ? "front" : "back",
+                   window_len, frame_len, i);
+            mismatches++;
+        }
+    }
+    evaluate_error(out, ref, steps * window_len, CSINN_DTYPE_FLOAT32);
+
+    asr_buffer_reset(&buffer);
+    shl_mem_free(s.hist);
+    shl_mem_free(s.window);
+    shl_mem_free(frame);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test ring wraparound of the asr buffer.\n");
+    int mismatches = 0;
+    int frame_lens[] = {8, 12, 7, 48};
+    for (int i = 0; i < sizeof(frame_lens) / sizeof(frame_lens[0]); i++) {
+        mismatches += verify_asr_buffer(48, frame_lens[i], true);
+        mismatches += verify_asr_buffer(48, frame_lens[i], false);
+    }
+    if (mismatches > 0) {
+        printf("%d windows differ from the shifted cache\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
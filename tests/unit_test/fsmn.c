@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "reference/ref.h"
+#include "rvv/rvv.h"
+#include "test_utils.h"
+
+#define LENGTH 37
+#define L_ORDER 3
+#define L_STRIDE 2
+#define R_ORDER 2
+#define R_STRIDE 1
+#define LEN_ORDER (L_ORDER * L_STRIDE + (R_ORDER - 1) * R_STRIDE + 1)
+#define UNAVAILABLE 2
+#define FRAMES (LEN_ORDER * 4 + 3)
+
+/* fsmn on a frame sequence that is shifted by one row for every pushed frame */
+static void shift_fsmn(float *frame, float *l_filter, float *r_filter, float *sequence,
+                       int *frame_count, float *output)
+{
+    frame_count[0]++;
+    if (frame_count[0] > UNAVAILABLE) {
+        memmove(sequence, sequence + LENGTH, (LEN_ORDER - 1) * LENGTH * sizeof(float));
+        memcpy(sequence + (LEN_ORDER - 1) * LENGTH, frame, LENGTH * sizeof(float));
+    }
+    for (int l = 0; l < LENGTH; l++) {
+        float acc = sequence[(L_ORDER - 1) * L_STRIDE * LENGTH + l];
+        for (int k = 0; k < L_ORDER; k++) {
+            acc += l_filter[(L_ORDER - k - 1) * LENGTH + l] * sequence[k * L_STRIDE * LENGTH + l];
+        }
+        for (int m = 0; m < R_ORDER; m++) {
+            int row = L_ORDER * L_STRIDE + m * R_STRIDE;
+            acc += r_filter[m * LENGTH + l] * sequence[row * LENGTH + l];
+        }
+        output[l] = acc;
+    }
+}
+
+static struct csinn_tensor *fsmn_tensor(int dim0, int dim1, void *data)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->dim[0] = dim0;
+    t->dim[1] = dim1;
+    t->dim_count = 2;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->data = data;
+    return t;
+}
+
+/* stream more frames than the sequence holds so that the ring wraps several times */
+static int verify_fsmn(int (*func)(), const char *name)
+{
+    float *frames = shl_mem_alloc(FRAMES * LENGTH * sizeof(float));
+    float *l_filter = shl_mem_alloc(L_ORDER * LENGTH * sizeof(float));
+    float *r_filter = shl_mem_alloc(R_ORDER * LENGTH * sizeof(float));
+    for (int i = 0; i < FRAMES * LENGTH; i++) {
+        frames[i] = (float)(rand() % 2001) / 1000.0f - 1.0f;
+    }
+    for (int i = 0; i < L_ORDER * LENGTH; i++) {
+        l_filter[i] = (float)(rand() % 2001) / 1000.0f - 1.0f;
+    }
+    for (int i = 0; i < R_ORDER * LENGTH; i++) {
+        r_filter[i] = (float)(rand() % 2001) / 1000.0f - 1.0f;
+    }
+
+    float *shift_sequence = shl_mem_alloc(LEN_ORDER * LENGTH * sizeof(float));
+    int shift_count = 0;
+    float *ref = shl_mem_alloc(FRAMES * LENGTH * sizeof(float));
+    float *out = shl_mem_alloc(FRAMES * LENGTH * sizeof(float));
+
+    struct csinn_tensor *frame = fsmn_tensor(1, LENGTH, NULL);
+    struct csinn_tensor *l_tensor = fsmn_tensor(L_ORDER, LENGTH, l_filter);
+    struct csinn_tensor *r_tensor = fsmn_tensor(R_ORDER, LENGTH, r_filter);
+    struct csinn_tensor *sequence =
+        fsmn_tensor(LEN_ORDER, LENGTH, shl_mem_alloc(LEN_ORDER * LENGTH * sizeof(float)));
+    struct csinn_tensor *counter = fsmn_tensor(1, 1, shl_mem_alloc(sizeof(int32_t)));
+    counter->dim_count = 1;
+    counter->dtype = CSINN_DTYPE_INT32;
+    struct csinn_tensor *output = fsmn_tensor(1, LENGTH, NULL);
+
+    struct csinn_fsmn_params *params = csinn_alloc_params(sizeof(struct csinn_fsmn_params), NULL);
+    params->base.name = "params";
+    params->l_order = L_ORDER;
+    params->r_order = R_ORDER;
+    params->l_stride = L_STRIDE;
+    params->r_stride = R_STRIDE;
+    params->unavailable_frames = UNAVAILABLE;
+
+    int mismatches = 0;
+    for (int i = 0; i < FRAMES; i++) {
+        shift_fsmn(frames + i * LENGTH, l_filter, r_filter, shift_sequence, &shift_count,
+                   ref + i * LENGTH);
+        frame->data = frames + i * LENGTH;
+        output->data = out + i * LENGTH;
+        func(frame, l_tensor, r_tensor, sequence, counter, output, params);
+        for (int l = 0; l < LENGTH; l++) {
+            if (fabs(ref[i * LENGTH + l] - out[i * LENGTH + l]) > 1e-4f) {
+                printf("%s frame %d differs\n", name, i);
+                mismatches++;
+                break;
+            }
+        }
+    }
+    evaluate_error(out, ref, FRAMES * LENGTH, CSINN_DTYPE_FLOAT32);
+
+    shl_mem_free(sequence->data);
+    shl_mem_free(counter->data);
+    csinn_free_tensor(frame);
+    csinn_free_tensor(l_tensor);
+    csinn_free_tensor(r_tensor);
+    csinn_free_tensor(sequence);
+    csinn_free_tensor(counter);
+    csinn_free_tensor(output);
+    shl_mem_free(params);
+    shl_mem_free(frames);
+    shl_mem_free(l_filter);
+    shl_mem_free(r_filter);
+    shl_mem_free(shift_sequence);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test ring wraparound of fsmn for RVV.\n");
+    int mismatches = 0;
+    mismatches += verify_fsmn(shl_ref_fsmn_f32, "ref");
+    mismatches += verify_fsmn(shl_rvv_fsmn_fp32, "rvv");
+    if (mismatches > 0) {
+        printf("%d frames differ from the shifted sequence\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
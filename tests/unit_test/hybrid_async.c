@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "shl_gref.h"
+#include "shl_utils.h"
+#include "test_utils.h"
+
+/*
+ * A hybrid graph with one CSINN_NPU_SIM subgraph and a cpu branch that does not need it:
+ * the asynchronous run must give the outputs of the sequential run and of a cpu only
+ * session, and the cpu branch must have finished while the subgraph was still in flight.
+ */
+
+#define SIZE 4096
+#define LATENCY_US 100000
+
+enum { SIM_OP = 0, CPU_ABS, CPU_SIGMOID, HOOK_NUM };
+
+/* exec of the hooked layers, wrapped to time them */
+static struct {
+    void *params;
+    int (*exec)();
+    uint64_t end;
+} hooks[HOOK_NUM];
+
+static int timed_exec(struct csinn_tensor *input, struct csinn_tensor *output, void *params)
+{
+    for (int i = 0; i < HOOK_NUM; i++) {
+        if (hooks[i].params == params) {
+            int ret = hooks[i].exec(input, output, params);
+            __atomic_store_n(&hooks[i].end, shl_get_timespec(), __ATOMIC_RELEASE);
+            return ret;
+        }
+    }
+    return CSINN_FALSE;
+}
+
+static void hook(int idx, struct csinn_params_base *params)
+{
+    hooks[idx].params = params;
+    hooks[idx].exec = params->cb->exec;
+    params->cb->exec = timed_exec;
+}
+
+static struct csinn_tensor *tensor(struct csinn_session *sess)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(sess);
+    t->dim[0] = 1;
+    t->dim[1] = SIZE;
+    t->dim_count = 2;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->layout = CSINN_LAYOUT_NC;
+    return t;
+}
+
+/*
+ * out = sigmoid(relu(x)) + sigmoid(abs(x)), relu and the sigmoid after it form the sim
+ * subgraph when hybrid is set, the abs branch and the add stay on the cpu
+ */
+static struct csinn_session *build_session(bool hybrid, struct csinn_params_base **layers)
+{
+    struct csinn_session *sess = csinn_alloc_session();
+    sess->base_api = CSINN_API;
+    sess->base_run_mode = hybrid ? CSINN_RM_CPU_BASE_HYBRID : CSINN_RM_CPU_GRAPH;
+    sess->base_dtype = CSINN_DTYPE_FLOAT32;
+    sess->base_quant_type = CSINN_QUANT_FLOAT32;
+    sess->model.save_mode = CSINN_RUN_ONLY;
+    csinn_session_init(sess);
+    csinn_set_input_number(1, sess);
+    csinn_set_output_number(1, sess);
+    if (hybrid) {
+        shl_gref_set_sim_latency(sess, LATENCY_US);
+    }
+
+    struct csinn_tensor *x = tensor(sess);
+    csinn_set_tensor_entry(x, sess);
+    csinn_set_input(0, x, sess);
+
+    struct csinn_tensor *s1 = tensor(sess);
+    struct csinn_tensor *s2 = tensor(sess);
+    struct csinn_relu_params *relu = csinn_alloc_params(sizeof(struct csinn_relu_params), sess);
+    relu->base.name = "sim_relu";
+    relu->base.api = hybrid ? CSINN_NPU_SIM : relu->base.api;
+    csinn_relu_init(x, s1, relu);
+    csinn_relu(x, s1, relu);
+    struct csinn_sigmoid_params *sim_sigmoid =
+        csinn_alloc_params(sizeof(struct csinn_sigmoid_params), sess);
+    sim_sigmoid->base.name = "sim_sigmoid";
+    sim_sigmoid->base.api = hybrid ? CSINN_NPU_SIM : sim_sigmoid->base.api;
+    csinn_sigmoid_init(s1, s2, sim_sigmoid);
+    csinn_sigmoid(s1, s2, sim_sigmoid);
+
+    struct csinn_tensor *c1 = tensor(sess);
+    struct csinn_tensor *c2 = tensor(sess);
+    struct csinn_siso_params *abs = csinn_alloc_params(sizeof(struct csinn_siso_params), sess);
+    abs->base.name = "cpu_abs";
+    csinn_abs_init(x, c1, abs);
+    csinn_abs(x, c1, abs);
+    struct csinn_sigmoid_params *cpu_sigmoid =
+        csinn_alloc_params(sizeof(struct csinn_sigmoid_params), sess);
+    cpu_sigmoid->base.name = "cpu_sigmoid";
+    csinn_sigmoid_init(c1, c2, cpu_sigmoid);
+    csinn_sigmoid(c1, c2, cpu_sigmoid);
+
+    struct csinn_tensor *out = tensor(sess);
+    struct csinn_diso_params *add = csinn_alloc_params(sizeof(struct csinn_diso_params), sess);
+    add->base.name = "add";
+    csinn_add_init(s2, c2, out, add);
+    csinn_add(s2, c2, out, add);
+
+    csinn_set_output(0, out, sess);
+    csinn_session_setup(sess);
+    if (layers) {
+        layers[SIM_OP] = &sim_sigmoid->base;
+        layers[CPU_ABS] = &abs->base;
+        layers[CPU_SIGMOID] = &cpu_sigmoid->base;
+    }
+    return sess;
+}
+
+static void run(struct csinn_session *sess, float *input, float *out)
+{
+    for (int i = 0; i < HOOK_NUM; i++) {
+        hooks[i].end = 0;
+    }
+    struct csinn_tensor *x = tensor(NULL);
+    x->data = input;
+    csinn_update_input(0, x, sess);
+    csinn_session_run(sess);
+    struct csinn_tensor *output = csinn_alloc_tensor(NULL);
+    csinn_get_output(0, output, sess);
+    memcpy(out, output->data, SIZE * sizeof(float));
+    csinn_free_tensor(output);
+    csinn_free_tensor(x);
+}
+
+static int compare(const char *name, float *out, float *ref)
+{
+    for (int i = 0; i < SIZE; i++) {
+        if (out[i] != ref[i]) {
+            printf("%s: output %d differs, %f vs %f\n", name, i, out[i], ref[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* the cpu branch finished before the sim subgraph returned, i.e. within its latency */
+static bool cpu_overlapped()
+{
+    for (int i = 0; i < HOOK_NUM; i++) {
+        if (hooks[i].end == 0) {
+            printf("layer %s did not run\n", ((struct csinn_params_base *)hooks[i].params)->name);
+            return false;
+        }
+    }
+    uint64_t sim_return = hooks[SIM_OP].end + LATENCY_US * 1000ull;
+    return hooks[CPU_ABS].end < sim_return && hooks[CPU_SIGMOID].end < sim_return;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test asynchronous hybrid runs on the CSINN_NPU_SIM stand-in.\n");
+    float *input = shl_mem_alloc(SIZE * sizeof(float));
+    float *ref = shl_mem_alloc(SIZE * sizeof(float));
+    float *out = shl_mem_alloc(SIZE * sizeof(float));
+    for (int i = 0; i < SIZE; i++) {
+        input[i] = (float)rand() / RAND_MAX * 8 - 4;
+    }
+    struct csinn_session *cpu = build_session(false, NULL);
+    run(cpu, input, ref);
+    csinn_session_deinit(cpu);
+    csinn_free_session(cpu);
+
+    struct csinn_params_base *layers[HOOK_NUM];
+    struct csinn_session *sess = build_session(true, layers);
+    for (int i = 0; i < HOOK_NUM; i++) {
+        hook(i, layers[i]);
+    }
+    int mismatches = 0;
+
+    /* the sequential path keeps graph order, the subgraph returns before the cpu branch */
+    run(sess, input, out);
+    mismatches += compare("sequential", out, ref);
+    if (cpu_overlapped()) {
+        printf("sequential run overlapped the cpu branch with the subgraph\n");
+        mismatches++;
+    }
+
+    shl_gref_set_async_subgraph(sess, true);
+    for (int r = 0; r < 2; r++) {
+        memset(out, 0, SIZE * sizeof(float));
+        run(sess, input, out);
+        mismatches += compare("async", out, ref);
+        if (!cpu_overlapped()) {
+            printf("run %d: cpu branch waited for the subgraph\n", r);
+            mismatches++;
+        }
+    }
+
+    csinn_session_deinit(sess);
+    csinn_free_session(sess);
+    shl_mem_free(input);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "reference/ref.h"
+#include "rvv/rvv.h"
+#include "test_utils.h"
+
+#define BLOCK 32
+
+struct w8a8_case {
+    int batch_a;
+    int batch_b;  // 1: one mat1 shared by every batch of mat0
+    int m;
+    int k;
+    int n;
+    bool q4;
+    int32_t act_quant;
+};
+
+/* mat1 as block q8_0/q4_0: [batch_b, n, k] values then [batch_b, n, k / 32] fp16 scales */
+static void *block_weight(int rows, int k, bool q4)
+{
+    int values = rows * k;
+    int bytes = q4 ? values / 2 : values;
+    int8_t *data = shl_mem_alloc(bytes + values / BLOCK * sizeof(__fp16));
+    for (int i = 0; i < bytes; i++) {
+        /* q4 bytes pack two nibbles of 0..15, each stands for nibble - 8 */
+        data[i] = q4 ? rand() % 256 : rand() % 255 - 127;
+    }
+    __fp16 *scale = (__fp16 *)(data + bytes);
+    for (int i = 0; i < values / BLOCK; i++) {
+        scale[i] = ((float)rand() / RAND_MAX + 0.5f) / (q4 ? 8 : 127);
+    }
+    return data;
+}
+
+static struct csinn_tensor *matrix(int batch, int rows, int cols, void *data, int dtype)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->dim[0] = batch;
+    t->dim[1] = rows;
+    t->dim[2] = cols;
+    t->dim_count = 3;
+    t->dtype = dtype;
+    t->layout = CSINN_LAYOUT_NCW;
+    t->data = data;
+    return t;
+}
+
+/* the int8 rvv kernels against the reference, which quantizes the rows the same way */
+static int verify_w8a8(struct w8a8_case *c, int dtype)
+{
+    int a_size = c->batch_a * c->m * c->k;
+    int out_size = c->batch_a * c->m * c->n;
+    float *a = shl_mem_alloc(a_size * sizeof(float));
+    __fp16 *a16 = shl_mem_alloc(a_size * sizeof(__fp16));
+    float *ref = shl_mem_alloc(out_size * sizeof(float));
+    float *out = shl_mem_alloc(out_size * sizeof(float));
+    __fp16 *ref16 = shl_mem_alloc(out_size * sizeof(__fp16));
+    __fp16 *out16 = shl_mem_alloc(out_size * sizeof(__fp16));
+    for (int i = 0; i < a_size; i++) {
+        /* a few large outliers per row, so per-token and per-block scales differ */
+        float scale = rand() % 61 == 0 ? 20.0f : 2.0f;
+        a16[i] = ((float)rand() / RAND_MAX - 0.5f) * scale;
+        a[i] = a16[i];
+    }
+    void *weight = block_weight(c->batch_b * c->n, c->k, c->q4);
+
+    struct csinn_matmul_params *params =
+        csinn_alloc_params(sizeof(struct csinn_matmul_params), NULL);
+    params->trans_b = true;
+    params->act_quant = c->act_quant;
+
+    bool fp16 = dtype == CSINN_DTYPE_FLOAT16;
+    struct csinn_tensor *mat0 = matrix(c->batch_a, c->m, c->k, fp16 ? (void *)a16 : a, dtype);
+    struct csinn_tensor *mat1 = matrix(c->batch_b, c->n, c->k, weight, CSINN_DTYPE_INT8);
+    mat1->mtype = c->q4 ? CSINN_MEM_TYPE_BLOCK_Q4_0 : CSINN_MEM_TYPE_BLOCK_Q8_0;
+    if (c->batch_b == 1) {
+        mat1->dim[0] = c->n;
+        mat1->dim[1] = c->k;
+        mat1->dim_count = 2;
+    }
+    struct csinn_tensor *output =
+        matrix(c->batch_a, c->m, c->n, fp16 ? (void *)ref16 : ref, dtype);
+
+    shl_ref_matmul_a0b1_dynamic_quant(mat0, mat1, output, params);
+    output->data = fp16 ? (void *)out16 : out;
+    shl_rvv_matmul_a0b1_dynamic_quant(mat0, mat1, output, params);
+    float tolerance = 1e-4f;
+    if (fp16) {
+        for (int i = 0; i < out_size; i++) {
+            ref[i] = ref16[i];
+            out[i] = out16[i];
+        }
+        tolerance = 2e-3f;
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < out_size; i++) {
+        if (fabs(ref[i] - out[i]) > tolerance * (1 + fabs(ref[i]))) {
+            printf("batch %d/%d m %d k %d n %d q4 %d act_quant %d dtype %d: %d differs, %f vs %f\n",
+                   c->batch_a, c->batch_b, c->m, c->k, c->n, c->q4, c->act_quant, dtype, i, out[i],
+                   ref[i]);
+            mismatches++;
+            break;
+        }
+    }
+    evaluate_error(out, ref, out_size, CSINN_DTYPE_FLOAT32);
+
+    csinn_free_tensor(mat0);
+    csinn_free_tensor(mat1);
+    csinn_free_tensor(output);
+    shl_mem_free(params);
+    shl_mem_free(weight);
+    shl_mem_free(a);
+    shl_mem_free(a16);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    shl_mem_free(ref16);
+    shl_mem_free(out16);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test W8A8 matmul against block quantized weights for RVV.\n");
+    struct w8a8_case cases[] = {
+        {1, 1, 1, 128, 67, false, CSINN_ACT_QUANT_BLOCK},  // decode step
+        {1, 1, 1, 128, 67, true, CSINN_ACT_QUANT_BLOCK},
+        {1, 1, 9, 96, 40, false, CSINN_ACT_QUANT_TOKEN},  // prefill, rows past the 4-row tiles
+        {1, 1, 9, 96, 40, true, CSINN_ACT_QUANT_TOKEN},
+        {3, 1, 5, 64, 33, true, CSINN_ACT_QUANT_BLOCK},   // batches folded into one gemm
+        {2, 2, 6, 64, 17, false, CSINN_ACT_QUANT_BLOCK},  // a mat1 per batch
+        {2, 2, 6, 64, 17, true, CSINN_ACT_QUANT_TOKEN},
+    };
+    int mismatches = 0;
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        mismatches += verify_w8a8(&cases[i], CSINN_DTYPE_FLOAT32);
+        mismatches += verify_w8a8(&cases[i], CSINN_DTYPE_FLOAT16);
+    }
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "csi_nn.h"
+#include "shl_utils.h"
+#include "test_utils.h"
+
+/*
+ * The thread pool of a session: every job runs once on each thread, parallel_for covers
+ * [0, n) with one contiguous range per thread, workers parked for an OpenMP kernel wake up
+ * for the next job, and nested sessions see their own thread count.
+ */
+
+#define MAX_THREADS 8
+#define MAX_N 1000
+
+struct pool_job {
+    int hits[MAX_THREADS];
+    int bad_num;
+    int num;
+};
+
+static void count_job(void *arg, int idx, int num)
+{
+    struct pool_job *job = arg;
+    __atomic_fetch_add(&job->hits[idx], 1, __ATOMIC_RELAXED);
+    if (num != job->num) {
+        __atomic_fetch_add(&job->bad_num, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static int verify_pool(int threads, int jobs)
+{
+    struct shl_thread_pool *pool = shl_thread_pool_create(threads, 0);
+    struct pool_job job = {{0}, 0, threads};
+    for (int i = 0; i < jobs; i++) {
+        shl_thread_pool_run(pool, count_job, &job);
+    }
+    shl_thread_pool_destroy(pool);
+
+    int mismatches = job.bad_num;
+    for (int i = 0; i < MAX_THREADS; i++) {
+        if (job.hits[i] != (i < threads ? jobs : 0)) {
+            printf("pool of %d: thread %d ran %d of %d jobs\n", threads, i, job.hits[i], jobs);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+struct range_job {
+    int covered[MAX_N];
+    int calls;
+    pthread_t owner[MAX_THREADS];
+    int nested_threads;
+};
+
+static void record_range(void *arg, int start, int end)
+{
+    struct range_job *job = arg;
+    int call = __atomic_fetch_add(&job->calls, 1, __ATOMIC_RELAXED);
+    if (call < MAX_THREADS) {
+        job->owner[call] = pthread_self();
+    }
+    for (int i = start; i < end; i++) {
+        __atomic_fetch_add(&job->covered[i], 1, __ATOMIC_RELAXED);
+    }
+    /* a pool job runs serially, a nested loop takes the whole range at once */
+    job->nested_threads = shl_multithread_get_threads();
+}
+
+/* parallel_for on n items from threads, each item once, one range on each thread */
+static int verify_ranges(const char *name, int n, int threads)
+{
+    struct range_job *job = shl_mem_alloc(sizeof(struct range_job));
+    shl_multithread_parallel_for(n, record_range, job);
+
+    int mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        if (job->covered[i] != 1) {
+            printf("%s: item %d covered %d times\n", name, i, job->covered[i]);
+            mismatches++;
+            break;
+        }
+    }
+    int chunk = (n + threads - 1) / threads;
+    int expected = (n + chunk - 1) / chunk;
+    if (job->calls != expected) {
+        printf("%s: %d items in %d ranges, %d expected\n", name, n, job->calls, expected);
+        mismatches++;
+    }
+    for (int i = 0; i < job->calls && i < MAX_THREADS && mismatches == 0; i++) {
+        for (int j = 0; j < i; j++) {
+            if (pthread_equal(job->owner[i], job->owner[j])) {
+                printf("%s: ranges %d and %d on one thread\n", name, j, i);
+                mismatches++;
+            }
+        }
+    }
+    shl_mem_free(job);
+    return mismatches;
+}
+
+static struct csinn_session *thread_session(int threads)
+{
+    struct csinn_session *sess = csinn_alloc_session();
+    sess->thread_num = threads;
+    return sess;
+}
+
+static int expect_threads(const char *name, int threads)
+{
+    if (shl_multithread_get_threads() != threads) {
+        printf("%s: %d threads, %d expected\n", name, shl_multithread_get_threads(), threads);
+        return 1;
+    }
+    return 0;
+}
+
+/* the pool of a session, parked by an OpenMP kernel, wakes up for the next loop */
+static int verify_session(int threads)
+{
+    struct csinn_session *sess = thread_session(threads);
+    void *ctx = shl_multithread_session_begin(sess);
+    int mismatches = expect_threads("session", threads);
+    mismatches += verify_ranges("session", MAX_N, threads);
+    mismatches += verify_ranges("session, fewer items", threads - 1, threads);
+    struct range_job *job = shl_mem_alloc(sizeof(struct range_job));
+    shl_multithread_parallel_for(MAX_N, record_range, job);
+    if (job->nested_threads != 1) {
+        printf("session: %d threads inside a pool job\n", job->nested_threads);
+        mismatches++;
+    }
+    shl_mem_free(job);
+
+    if (shl_multithread_is_enable() != CSINN_TRUE) {
+        printf("session of %d threads not parallel\n", threads);
+        mismatches++;
+    }
+    /* the workers stop spinning and sleep on the pool */
+    usleep(20000);
+    mismatches += verify_ranges("after park", MAX_N, threads);
+    mismatches += verify_ranges("after unpark", MAX_N, threads);
+    shl_multithread_session_end(ctx);
+
+    /* the pool is kept across runs and rebuilt when thread_num changes */
+    void *pool = sess->thread_pool;
+    ctx = shl_multithread_session_begin(sess);
+    if (sess->thread_pool != pool) {
+        printf("pool of %d threads not kept\n", threads);
+        mismatches++;
+    }
+    shl_multithread_session_end(ctx);
+    sess->thread_num = threads + 1;
+    ctx = shl_multithread_session_begin(sess);
+    mismatches += expect_threads("resized session", threads + 1);
+    mismatches += verify_ranges("resized session", MAX_N, threads + 1);
+    shl_multithread_session_end(ctx);
+
+    shl_multithread_session_free(sess);
+    csinn_free_session(sess);
+    return mismatches;
+}
+
+/* a session inside another one, e.g. a subgraph, and the global setting outside both */
+static int verify_nested_sessions()
+{
+    struct csinn_session *outer = thread_session(2);
+    struct csinn_session *inner = thread_session(4);
+    struct csinn_session *single = thread_session(0);
+    int mismatches = expect_threads("no session", 1);
+
+    void *outer_ctx = shl_multithread_session_begin(outer);
+    mismatches += expect_threads("outer", 2);
+    void *inner_ctx = shl_multithread_session_begin(inner);
+    mismatches += expect_threads("inner", 4);
+    mismatches += verify_ranges("inner", MAX_N, 4);
+    void *single_ctx = shl_multithread_session_begin(single);
+    mismatches += expect_threads("single in inner", 4);
+    shl_multithread_session_end(single_ctx);
+    shl_multithread_session_end(inner_ctx);
+    mismatches += expect_threads("outer after inner", 2);
+    mismatches += verify_ranges("outer after inner", MAX_N, 2);
+    shl_multithread_session_end(outer_ctx);
+    mismatches += expect_threads("after the sessions", 1);
+
+    shl_multithread_session_free(outer);
+    shl_multithread_session_free(inner);
+    shl_multithread_session_free(single);
+    csinn_free_session(outer);
+    csinn_free_session(inner);
+    csinn_free_session(single);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test the thread pool and parallel_for.\n");
+    int mismatches = 0;
+    mismatches += verify_pool(2, 1000);
+    mismatches += verify_pool(MAX_THREADS, 1000);
+    mismatches += verify_session(3);
+    mismatches += verify_nested_sessions();
+    mismatches += verify_ranges("serial", 17, 1);
+    /* without a session the global OpenMP team takes one range per thread */
+    shl_multithread_set_threads(4);
+    mismatches += verify_ranges("openmp", MAX_N, shl_multithread_get_threads());
+    shl_multithread_set_threads(1);
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
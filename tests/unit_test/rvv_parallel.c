@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "rvv/rvv.h"
+#include "shl_utils.h"
+#include "test_utils.h"
+
+/*
+ * RVV kernels split over the session threads: every case is larger than
+ * SHL_RVV_PARALLEL_THRESHOLD, and the output of a run on THREADS threads must be bit for bit
+ * the output of the same kernel on the calling thread alone, or of a plain C reference.
+ */
+
+#define THREADS 4
+
+static struct csinn_session *thread_sess;
+
+static void *threads_begin() { return shl_multithread_session_begin(thread_sess); }
+
+static void threads_end(void *ctx) { shl_multithread_session_end(ctx); }
+
+static struct csinn_tensor *tensor(enum csinn_dtype_enum dtype, enum csinn_layout_enum layout,
+                                   int dim_count, int d0, int d1, int d2, int d3, int d4)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    int32_t dim[5] = {d0, d1, d2, d3, d4};
+    for (int i = 0; i < dim_count; i++) {
+        t->dim[i] = dim[i];
+    }
+    t->dim_count = dim_count;
+    t->dtype = dtype;
+    t->layout = layout;
+    t->qinfo->scale = 0.05f;
+    t->qinfo->zero_point = 3;
+    int size = csinn_tensor_size(t);
+    if (dtype == CSINN_DTYPE_FLOAT32) {
+        float *data = shl_mem_alloc(size * sizeof(float));
+        for (int i = 0; i < size; i++) {
+            data[i] = (float)rand() / RAND_MAX * 8 - 4;
+        }
+        t->data = data;
+    } else {
+        int8_t *data = shl_mem_alloc(size);
+        for (int i = 0; i < size; i++) {
+            data[i] = rand() % 256 - 128;
+        }
+        t->data = data;
+    }
+    return t;
+}
+
+/* a tensor of the same shape and quantization, its data overwritten by the kernel */
+static struct csinn_tensor *like(struct csinn_tensor *t)
+{
+    return tensor(t->dtype, t->layout, t->dim_count, t->dim[0], t->dim[1], t->dim[2], t->dim[3],
+                  t->dim[4]);
+}
+
+static void free_tensor(struct csinn_tensor *t)
+{
+    shl_mem_free(t->data);
+    csinn_free_tensor(t);
+}
+
+static int compare_bytes(const char *name, struct csinn_tensor *out, void *ref)
+{
+    int size = csinn_tensor_byte_size(out);
+    int8_t *a = out->data;
+    int8_t *b = ref;
+    for (int i = 0; i < size; i++) {
+        if (a[i] != b[i]) {
+            printf("%s: byte %d of %d differs\n", name, i, size);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int packn_of(enum csinn_dtype_enum dtype)
+{
+    return dtype == CSINN_DTYPE_FLOAT32 ? csrr_vlenb() / sizeof(float) : csrr_vlenb() / 2;
+}
+
+typedef int (*diso_kernel)(struct csinn_tensor *, struct csinn_tensor *, struct csinn_tensor *,
+                           struct csinn_diso_params *);
+
+/* kernel on the calling thread and on the pool, both against ref when given */
+static int verify_diso(const char *name, diso_kernel kernel, struct csinn_tensor *a,
+                       struct csinn_tensor *b, float *ref)
+{
+    struct csinn_diso_params *params = csinn_alloc_params(sizeof(struct csinn_diso_params), NULL);
+    struct csinn_tensor *serial = like(a);
+    struct csinn_tensor *threaded = like(a);
+    kernel(a, b, serial, params);
+    void *ctx = threads_begin();
+    kernel(a, b, threaded, params);
+    threads_end(ctx);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%s, %d threads", name, THREADS);
+    int mismatches = compare_bytes(msg, threaded, serial->data);
+    if (ref) {
+        snprintf(msg, sizeof(msg), "%s, reference", name);
+        mismatches += compare_bytes(msg, threaded, ref);
+    }
+    free_tensor(serial);
+    free_tensor(threaded);
+    shl_mem_free(params);
+    return mismatches;
+}
+
+/* elementwise and scalar go through binary_op_flat, the channel broadcast by rows */
+static int verify_binary()
+{
+    int C = 64, H = 32, W = 32;
+    struct csinn_tensor *a = tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NCHW, 4, 1, C, H, W, 0);
+    struct csinn_tensor *b = tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NCHW, 4, 1, C, H, W, 0);
+    struct csinn_tensor *s = tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_N, 1, 1, 0, 0, 0, 0);
+    struct csinn_tensor *c = tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NCHW, 4, 1, C, 1, 1, 0);
+    float *pa = a->data, *pb = b->data, *ps = s->data, *pc = c->data;
+    int size = C * H * W;
+    float *ref[3];
+    for (int i = 0; i < 3; i++) {
+        ref[i] = shl_mem_alloc(size * sizeof(float));
+    }
+    for (int i = 0; i < size; i++) {
+        ref[0][i] = pa[i] + pb[i];
+        ref[1][i] = pa[i] + ps[0];
+        ref[2][i] = pa[i] + pc[i / (H * W)];
+    }
+
+    int mismatches = 0;
+    mismatches += verify_diso("add fp32", shl_rvv_add_fp32, a, b, ref[0]);
+    mismatches += verify_diso("add fp32 scalar", shl_rvv_add_fp32, a, s, ref[1]);
+    mismatches += verify_diso("add fp32 channel broadcast", shl_rvv_add_fp32, a, c, ref[2]);
+
+    struct csinn_tensor *qa = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NCHW, 4, 1, C, H, W, 0);
+    struct csinn_tensor *qb = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NCHW, 4, 1, C, H, W, 0);
+    mismatches += verify_diso("mul int8", shl_rvv_mul_int8, qa, qb, NULL);
+
+    for (int i = 0; i < 3; i++) {
+        shl_mem_free(ref[i]);
+    }
+    free_tensor(a);
+    free_tensor(b);
+    free_tensor(s);
+    free_tensor(c);
+    free_tensor(qa);
+    free_tensor(qb);
+    return mismatches;
+}
+
+typedef int (*pool_kernel)(struct csinn_tensor *, struct csinn_tensor *,
+                           struct csinn_pool_params *);
+
+static struct csinn_pool_params *pool_params(int kernel, int stride, int pad)
+{
+    struct csinn_pool_params *params = csinn_alloc_params(sizeof(struct csinn_pool_params), NULL);
+    params->filter_height = params->filter_width = kernel;
+    params->stride_height = params->stride_width = stride;
+    params->pad_top = params->pad_left = params->pad_down = params->pad_right = pad;
+    return params;
+}
+
+static int verify_pool(const char *name, pool_kernel kernel, struct csinn_tensor *input,
+                       struct csinn_tensor *out_shape, struct csinn_pool_params *params)
+{
+    struct csinn_tensor *serial = like(out_shape);
+    struct csinn_tensor *threaded = like(out_shape);
+    kernel(input, serial, params);
+    void *ctx = threads_begin();
+    kernel(input, threaded, params);
+    threads_end(ctx);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%s, %d threads", name, THREADS);
+    int mismatches = compare_bytes(msg, threaded, serial->data);
+    free_tensor(serial);
+    free_tensor(threaded);
+    return mismatches;
+}
+
+/* packn pooling runs the kernel on slices of batch * c1 blocks */
+static int verify_pool_packn()
+{
+    int mismatches = 0;
+    struct csinn_pool_params *params = pool_params(3, 2, 1);
+    struct csinn_pool_params *global = pool_params(33, 1, 0);
+
+    int packn = packn_of(CSINN_DTYPE_FLOAT32);
+    struct csinn_tensor *in =
+        tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NC1HWC0, 5, 2, 7, 33, 33, packn);
+    struct csinn_tensor *out =
+        tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NC1HWC0, 5, 2, 7, 17, 17, packn);
+    struct csinn_tensor *gout =
+        tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NC1HWC0, 5, 2, 7, 1, 1, packn);
+    mismatches += verify_pool("maxpool packn fp32", shl_rvv_maxpool_packn_fp32, in, out, params);
+    mismatches += verify_pool("avgpool packn fp32", shl_rvv_avgpool_packn_fp32, in, out, params);
+    mismatches += verify_pool("global avgpool packn fp32", shl_rvv_global_avgpool2d_packn_fp32,
+                              in, gout, global);
+    free_tensor(in);
+    free_tensor(out);
+    free_tensor(gout);
+
+    packn = packn_of(CSINN_DTYPE_INT8);
+    in = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NC1HWC0, 5, 2, 5, 33, 33, packn);
+    out = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NC1HWC0, 5, 2, 5, 17, 17, packn);
+    mismatches += verify_pool("maxpool packn int8", shl_rvv_maxpool_packn_int8, in, out, params);
+    free_tensor(in);
+    free_tensor(out);
+
+    shl_mem_free(params);
+    shl_mem_free(global);
+    return mismatches;
+}
+
+/* nhwc pooling splits the output rows of all batches */
+static int verify_pool_nhwc()
+{
+    int mismatches = 0;
+    struct csinn_pool_params *params = pool_params(3, 2, 1);
+    struct csinn_tensor *in = tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NHWC, 4, 2, 33, 33, 24, 0);
+    struct csinn_tensor *out = tensor(CSINN_DTYPE_FLOAT32, CSINN_LAYOUT_NHWC, 4, 2, 17, 17, 24, 0);
+    mismatches += verify_pool("avgpool nhwc fp32", shl_rvv_avgpool_nhwc_fp32, in, out, params);
+    mismatches += verify_pool("maxpool nhwc fp32", shl_rvv_maxpool_nhwc_fp32, in, out, params);
+    free_tensor(in);
+    free_tensor(out);
+
+    /* the second batch starts in_h * in_w * in_c codes in, every batch alone must agree */
+    in = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NHWC, 4, 2, 33, 33, 24, 0);
+    out = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NHWC, 4, 2, 17, 17, 24, 0);
+    mismatches += verify_pool("maxpool nhwc int8", shl_rvv_maxpool_nhwc_int8, in, out, params);
+    shl_rvv_maxpool_nhwc_int8(in, out, params);
+    int in_batch = 33 * 33 * 24, out_batch = 17 * 17 * 24;
+    for (int b = 0; b < 2; b++) {
+        struct csinn_tensor *in1 = tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NHWC, 4, 1, 33, 33, 24, 0);
+        struct csinn_tensor *out1 =
+            tensor(CSINN_DTYPE_INT8, CSINN_LAYOUT_NHWC, 4, 1, 17, 17, 24, 0);
+        memcpy(in1->data, (int8_t *)in->data + b * in_batch, in_batch);
+        shl_rvv_maxpool_nhwc_int8(in1, out1, params);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "maxpool nhwc int8, batch %d", b);
+        mismatches += compare_bytes(msg, out1, (int8_t *)out->data + b * out_batch);
+        free_tensor(in1);
+        free_tensor(out1);
+    }
+    free_tensor(in);
+    free_tensor(out);
+    shl_mem_free(params);
+    return mismatches;
+}
+
+typedef int (*concat_kernel)(struct csinn_tensor **, struct csinn_tensor *,
+                             struct csinn_concat_params *);
+
+/* concat splits the outer slices, each gathers its part of every input */
+static int verify_concat_dtype(enum csinn_dtype_enum dtype, concat_kernel kernel)
+{
+    int channels[3] = {5, 3, 8};
+    int batch = 2, hw = 32 * 32, out_c = 16;
+    int elem = dtype == CSINN_DTYPE_FLOAT32 ? sizeof(float) : sizeof(int8_t);
+    struct csinn_tensor *input[3];
+    for (int i = 0; i < 3; i++) {
+        input[i] = tensor(dtype, CSINN_LAYOUT_NCHW, 4, batch, channels[i], 32, 32, 0);
+    }
+    int8_t *ref = shl_mem_alloc(batch * out_c * hw * elem);
+    int8_t *dst = ref;
+    for (int b = 0; b < batch; b++) {
+        for (int i = 0; i < 3; i++) {
+            int bytes = channels[i] * hw * elem;
+            memcpy(dst, (int8_t *)input[i]->data + b * bytes, bytes);
+            dst += bytes;
+        }
+    }
+
+    struct csinn_concat_params *params =
+        csinn_alloc_params(sizeof(struct csinn_concat_params), NULL);
+    params->inputs_count = 3;
+    params->axis = 1;
+    struct csinn_tensor *serial = tensor(dtype, CSINN_LAYOUT_NCHW, 4, batch, out_c, 32, 32, 0);
+    struct csinn_tensor *threaded = like(serial);
+    kernel(input, serial, params);
+    void *ctx = threads_begin();
+    kernel(input, threaded, params);
+    threads_end(ctx);
+
+    const char *name = dtype == CSINN_DTYPE_FLOAT32 ? "concat fp32" : "concat int8";
+    int mismatches = compare_bytes(name, serial, ref);
+    mismatches += compare_bytes(name, threaded, ref);
+    for (int i = 0; i < 3; i++) {
+        free_tensor(input[i]);
+    }
+    free_tensor(serial);
+    free_tensor(threaded);
+    shl_mem_free(ref);
+    shl_mem_free(params);
+    return mismatches;
+}
+
+static int verify_concat()
+{
+    return verify_concat_dtype(CSINN_DTYPE_FLOAT32, shl_rvv_concat_fp32) +
+           verify_concat_dtype(CSINN_DTYPE_INT8, shl_rvv_concat_int8);
+}
+
+/* ndarray to nc1xc0 splits the batch * c1 blocks, and back */
+static int verify_layout_dtype(enum csinn_dtype_enum dtype, void (*to_packn)(struct csinn_tensor *),
+                               void (*to_ndarray)(struct csinn_tensor *))
+{
+    int packn = packn_of(dtype);
+    int batch = 2, c1 = 6, hw = 24 * 24;
+    int elem = dtype == CSINN_DTYPE_FLOAT32 ? sizeof(float) : sizeof(int8_t);
+    struct csinn_tensor *t = tensor(dtype, CSINN_LAYOUT_NCHW, 4, batch, c1 * packn, 24, 24, 0);
+    int bytes = csinn_tensor_byte_size(t);
+    int8_t *origin = shl_mem_alloc(bytes);
+    memcpy(origin, t->data, bytes);
+    int8_t *ref = shl_mem_alloc(bytes);
+    for (int b = 0; b < batch; b++) {
+        for (int c = 0; c < c1 * packn; c++) {
+            for (int s = 0; s < hw; s++) {
+                int src = (b * c1 * packn + c) * hw + s;
+                int dst = ((b * c1 + c / packn) * hw + s) * packn + c % packn;
+                memcpy(ref + dst * elem, origin + src * elem, elem);
+            }
+        }
+    }
+
+    const char *name = dtype == CSINN_DTYPE_FLOAT32 ? "layout fp32" : "layout int8";
+    void *ctx = threads_begin();
+    to_packn(t);
+    threads_end(ctx);
+    int mismatches = compare_bytes(name, t, ref);
+    if (t->layout != CSINN_LAYOUT_NC1HWC0 || t->dim[1] != c1 || t->dim[4] != packn) {
+        printf("%s: not converted to nc1hwc0\n", name);
+        mismatches++;
+    }
+    ctx = threads_begin();
+    to_ndarray(t);
+    threads_end(ctx);
+    mismatches += compare_bytes(name, t, origin);
+
+    free_tensor(t);
+    shl_mem_free(origin);
+    shl_mem_free(ref);
+    return mismatches;
+}
+
+static int verify_layout()
+{
+    return verify_layout_dtype(CSINN_DTYPE_FLOAT32, shl_rvv_tensor_ndarray_to_nc1xc0_replace_fp32,
+                               shl_rvv_tensor_nc1xc0_to_ndarray_replace_fp32) +
+           verify_layout_dtype(CSINN_DTYPE_INT8, shl_rvv_tensor_ndarray_to_nc1xc0_replace_int8,
+                               shl_rvv_tensor_nc1xc0_to_ndarray_replace_int8);
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test RVV kernels split over session threads.\n");
+    thread_sess = csinn_alloc_session();
+    thread_sess->thread_num = THREADS;
+
+    int mismatches = 0;
+    mismatches += verify_binary();
+    mismatches += verify_pool_packn();
+    mismatches += verify_pool_nhwc();
+    mismatches += verify_concat();
+    mismatches += verify_layout();
+
+    shl_multithread_session_free(thread_sess);
+    csinn_free_session(thread_sess);
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
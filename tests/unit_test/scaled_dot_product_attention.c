@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "reference/ref.h"
+#include "rvv/rvv.h"
+#include "test_utils.h"
+
+#define BATCH 2
+#define HEADS 3
+
+struct sdpa_case {
+    int sq;
+    int sk;
+    int head_dim;
+    int casual;
+    int transpose_v;
+};
+
+static struct csinn_tensor *sdpa_tensor(int seq, int head_dim, void *data, int dtype)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->dim[0] = BATCH;
+    t->dim[1] = HEADS;
+    t->dim[2] = seq;
+    t->dim[3] = head_dim;
+    t->dim_count = 4;
+    t->dtype = dtype;
+    t->layout = CSINN_LAYOUT_NCHW;
+    t->data = data;
+    return t;
+}
+
+/* the tiled rvv kernel against the naive reference, q/k/v rounded to fp16 first for fp16 */
+static int verify_sdpa(struct sdpa_case *c, int dtype)
+{
+    int q_size = BATCH * HEADS * c->sq * c->head_dim;
+    int kv_size = BATCH * HEADS * c->sk * c->head_dim;
+    float *q = shl_mem_alloc(q_size * sizeof(float));
+    float *k = shl_mem_alloc(kv_size * sizeof(float));
+    float *v = shl_mem_alloc(kv_size * sizeof(float));
+    float *ref = shl_mem_alloc(q_size * sizeof(float));
+    float *out = shl_mem_alloc(q_size * sizeof(float));
+    __fp16 *q16 = shl_mem_alloc(q_size * sizeof(__fp16));
+    __fp16 *k16 = shl_mem_alloc(kv_size * sizeof(__fp16));
+    __fp16 *v16 = shl_mem_alloc(kv_size * sizeof(__fp16));
+    __fp16 *out16 = shl_mem_alloc(q_size * sizeof(__fp16));
+    for (int i = 0; i < q_size; i++) {
+        q16[i] = ((float)rand() / RAND_MAX - 0.5f) * 4;
+        q[i] = q16[i];
+    }
+    for (int i = 0; i < kv_size; i++) {
+        k16[i] = ((float)rand() / RAND_MAX - 0.5f) * 4;
+        v16[i] = (float)rand() / RAND_MAX - 0.5f;
+        k[i] = k16[i];
+        v[i] = v16[i];
+    }
+
+    struct csinn_scale_dot_attention_params *params =
+        csinn_alloc_params(sizeof(struct csinn_scale_dot_attention_params), NULL);
+    params->norm_factor = sqrtf(c->head_dim);
+    params->casual = c->casual;
+    params->transpose_v = c->transpose_v;
+
+    struct csinn_tensor *query = sdpa_tensor(c->sq, c->head_dim, q, CSINN_DTYPE_FLOAT32);
+    struct csinn_tensor *key = sdpa_tensor(c->sk, c->head_dim, k, CSINN_DTYPE_FLOAT32);
+    struct csinn_tensor *value = sdpa_tensor(c->sk, c->head_dim, v, CSINN_DTYPE_FLOAT32);
+    struct csinn_tensor *output = sdpa_tensor(c->sq, c->head_dim, ref, CSINN_DTYPE_FLOAT32);
+    shl_ref_scaled_dot_product_attention_f32(query, key, value, output, params);
+
+    float tolerance;
+    if (dtype == CSINN_DTYPE_FLOAT32) {
+        output->data = out;
+        shl_rvv_scaled_dot_product_attention_fp32(query, key, value, output, params);
+        tolerance = 1e-4f;
+    } else {
+        query->data = q16;
+        key->data = k16;
+        value->data = v16;
+        output->data = out16;
+        query->dtype = key->dtype = value->dtype = output->dtype = CSINN_DTYPE_FLOAT16;
+        shl_rvv_scaled_dot_product_attention_fp16(query, key, value, output, params);
+        for (int i = 0; i < q_size; i++) {
+            out[i] = out16[i];
+        }
+        tolerance = 5e-3f;
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < q_size; i++) {
+        if (fabs(ref[i] - out[i]) > tolerance) {
+            printf("sq %d sk %d head_dim %d casual %d transpose_v %d dtype %d: %d differs\n",
+                   c->sq, c->sk, c->head_dim, c->casual, c->transpose_v, dtype, i);
+            mismatches++;
+            break;
+        }
+    }
+    evaluate_error(out, ref, q_size, CSINN_DTYPE_FLOAT32);
+
+    csinn_free_tensor(query);
+    csinn_free_tensor(key);
+    csinn_free_tensor(value);
+    csinn_free_tensor(output);
+    shl_mem_free(params);
+    shl_mem_free(q);
+    shl_mem_free(k);
+    shl_mem_free(v);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    shl_mem_free(q16);
+    shl_mem_free(k16);
+    shl_mem_free(v16);
+    shl_mem_free(out16);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test tiled scaled dot product attention for RVV.\n");
+    struct sdpa_case cases[] = {
+        {1, 70, 64, 1, 0},   // decode step over a kv cache
+        {45, 45, 64, 1, 0},  // causal prefill
+        {37, 100, 16, 1, 1}, // prefill after a cached prefix, value as [head_dim, sk]
+        {20, 33, 40, 0, 1},  // no mask
+        {3, 130, 128, 0, 0},
+    };
+    int mismatches = 0;
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        mismatches += verify_sdpa(&cases[i], CSINN_DTYPE_FLOAT32);
+        mismatches += verify_sdpa(&cases[i], CSINN_DTYPE_FLOAT16);
+    }
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
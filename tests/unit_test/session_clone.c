@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+
+#include "csi_nn.h"
+#include "shl_gref.h"
+#include "shl_utils.h"
+#include "test_utils.h"
+
+/*
+ * Contexts of one session run from concurrent threads: the origin session and its clones,
+ * each fed its own stream through an fsmn and a cache_matmul, must give the outputs of a
+ * session per stream run alone, so the frame state and the cache ring are per context.
+ */
+
+#define LENGTH 24
+#define L_ORDER 3
+#define L_STRIDE 1
+#define R_ORDER 1
+#define R_STRIDE 1
+#define LEN_ORDER (L_ORDER * L_STRIDE + (R_ORDER - 1) * R_STRIDE + 1)
+#define OUT_C 8
+#define WINDOW 5
+#define OUT_SIZE (WINDOW * OUT_C)
+#define N_FRAMES 48
+#define N_CONTEXTS 3
+
+static struct csinn_tensor *tensor(struct csinn_session *sess, int dim_count, int d0, int d1,
+                                   int d2, int d3)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(sess);
+    t->dim[0] = d0;
+    t->dim[1] = d1;
+    t->dim[2] = d2;
+    t->dim[3] = d3;
+    t->dim_count = dim_count;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->layout = CSINN_LAYOUT_NCHW;
+    return t;
+}
+
+/* constant tensor of random data, or zeros, the same for every session after one srand */
+static struct csinn_tensor *constant(struct csinn_session *sess, int d0, int d1, bool zero)
+{
+    struct csinn_tensor *t = tensor(sess, d1 > 0 ? 2 : 1, d0, d1, 0, 0);
+    t->layout = d1 > 0 ? CSINN_LAYOUT_NC : CSINN_LAYOUT_N;
+    t->is_const = true;
+    int size = csinn_tensor_size(t);
+    float *data = shl_mem_alloc(size * sizeof(float));
+    for (int i = 0; i < size && !zero; i++) {
+        data[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    t->data = data;
+    return t;
+}
+
+static struct csinn_session *build_session()
+{
+    struct csinn_session *sess = csinn_alloc_session();
+    sess->base_api = CSINN_API;
+    sess->base_run_mode = CSINN_RM_CPU_GRAPH;
+    sess->base_dtype = CSINN_DTYPE_FLOAT32;
+    sess->base_quant_type = CSINN_QUANT_FLOAT32;
+    sess->model.save_mode = CSINN_RUN_ONLY;
+    csinn_session_init(sess);
+    csinn_set_input_number(1, sess);
+    csinn_set_output_number(1, sess);
+
+    struct csinn_tensor *frame = tensor(sess, 2, 1, LENGTH, 0, 0);
+    frame->layout = CSINN_LAYOUT_NC;
+    csinn_set_tensor_entry(frame, sess);
+    csinn_set_input(0, frame, sess);
+    srand(0);
+
+    /* fsmn, whose frame sequence and counter are states */
+    struct csinn_tensor *l_filter = constant(sess, L_ORDER, LENGTH, false);
+    struct csinn_tensor *r_filter = constant(sess, R_ORDER, LENGTH, false);
+    struct csinn_tensor *sequence = constant(sess, LEN_ORDER, LENGTH, true);
+    struct csinn_tensor *counter = constant(sess, 1, 0, true);
+    counter->dtype = CSINN_DTYPE_INT32;
+    struct csinn_tensor *memory = tensor(sess, 3, 1, 1, LENGTH, 0);
+    struct csinn_fsmn_params *fsmn = csinn_alloc_params(sizeof(struct csinn_fsmn_params), sess);
+    fsmn->base.name = "fsmn";
+    fsmn->l_order = L_ORDER;
+    fsmn->r_order = R_ORDER;
+    fsmn->l_stride = L_STRIDE;
+    fsmn->r_stride = R_STRIDE;
+    fsmn->unavailable_frames = 2;
+    csinn_fsmn_init(frame, l_filter, r_filter, sequence, counter, memory, fsmn);
+    csinn_fsmn(frame, l_filter, r_filter, sequence, counter, memory, fsmn);
+
+    /* cache_matmul keeping the last WINDOW projections, its ring buffer is a state */
+    static int32_t shape[4] = {1, WINDOW, 1, OUT_C};
+    static int32_t axes[4] = {0, 2, 1, 3};
+    struct csinn_tensor *weight = constant(sess, LENGTH, OUT_C, false);
+    struct csinn_tensor *bias = constant(sess, OUT_C, 0, false);
+    ((float *)bias->data)[0] = 1.0f;  // a non-zero bias appends frames at the back
+    struct csinn_tensor *output = tensor(sess, 4, 1, WINDOW, 1, OUT_C);
+    struct csinn_cache_matmul_params *cache =
+        csinn_alloc_params(sizeof(struct csinn_cache_matmul_params), sess);
+    cache->base.name = "cache_matmul";
+    cache->cache_shape = shape;
+    cache->shape = shape;
+    cache->axes = axes;
+    csinn_cache_matmul_init(memory, output, weight, bias, cache);
+    csinn_cache_matmul(memory, output, weight, bias, cache);
+
+    csinn_set_output(0, output, sess);
+    csinn_session_setup(sess);
+    return sess;
+}
+
+/* run frames [begin, end) of stream, outputs at out */
+static void run_frames(struct csinn_session *sess, float *stream, int begin, int end, float *out)
+{
+    struct csinn_tensor *frame = tensor(NULL, 2, 1, LENGTH, 0, 0);
+    struct csinn_tensor *output = csinn_alloc_tensor(NULL);
+    for (int i = begin; i < end; i++) {
+        frame->data = stream + i * LENGTH;
+        csinn_update_input(0, frame, sess);
+        csinn_session_run(sess);
+        csinn_get_output(0, output, sess);
+        memcpy(out + (i - begin) * OUT_SIZE, output->data, OUT_SIZE * sizeof(float));
+    }
+    csinn_free_tensor(frame);
+    csinn_free_tensor(output);
+}
+
+static float *random_stream(int frames)
+{
+    float *stream = shl_mem_alloc(frames * LENGTH * sizeof(float));
+    for (int i = 0; i < frames * LENGTH; i++) {
+        stream[i] = (float)rand() / RAND_MAX * 2 - 1;
+    }
+    return stream;
+}
+
+static int compare(const char *name, float *out, float *ref, int frames)
+{
+    for (int i = 0; i < frames * OUT_SIZE; i++) {
+        if (out[i] != ref[i]) {
+            printf("%s: frame %d output %d differs, %f vs %f\n", name, i / OUT_SIZE,
+                   i % OUT_SIZE, out[i], ref[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+struct context_run {
+    struct csinn_session *sess;
+    float *stream;
+    float *out;
+    pthread_barrier_t *start;
+};
+
+static void *run_context(void *arg)
+{
+    struct context_run *run = arg;
+    pthread_barrier_wait(run->start);
+    run_frames(run->sess, run->stream, 0, N_FRAMES, run->out);
+    return NULL;
+}
+
+/*
+ * The origin has already run a few frames of another stream when it is cloned, a clone
+ * starts a new stream all the same. The origin is reset and every context then runs its
+ * stream from its own thread, released together by a barrier.
+ */
+static int verify_concurrent(float **stream, float *warmup)
+{
+    float *ref = shl_mem_alloc(N_CONTEXTS * N_FRAMES * OUT_SIZE * sizeof(float));
+    float *out = shl_mem_alloc(N_CONTEXTS * N_FRAMES * OUT_SIZE * sizeof(float));
+    for (int i = 0; i < N_CONTEXTS; i++) {
+        struct csinn_session *alone = build_session();
+        run_frames(alone, stream[i], 0, N_FRAMES, ref + i * N_FRAMES * OUT_SIZE);
+        csinn_session_deinit(alone);
+        csinn_free_session(alone);
+    }
+
+    struct csinn_session *sess = build_session();
+    run_frames(sess, warmup, 0, 3, out);
+    struct csinn_session *ctx[N_CONTEXTS] = {sess};
+    for (int i = 1; i < N_CONTEXTS; i++) {
+        ctx[i] = csinn_session_clone(sess);
+        if (ctx[i] == NULL) {
+            printf("clone %d failed\n", i);
+            return 1;
+        }
+    }
+    csinn_session_reset_state(sess);
+
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, N_CONTEXTS);
+    pthread_t thread[N_CONTEXTS];
+    struct context_run run[N_CONTEXTS];
+    for (int i = 0; i < N_CONTEXTS; i++) {
+        run[i].sess = ctx[i];
+        run[i].stream = stream[i];
+        run[i].out = out + i * N_FRAMES * OUT_SIZE;
+        run[i].start = &start;
+        pthread_create(&thread[i], NULL, run_context, &run[i]);
+    }
+    for (int i = 0; i < N_CONTEXTS; i++) {
+        pthread_join(thread[i], NULL);
+    }
+    pthread_barrier_destroy(&start);
+
+    int mismatches = 0;
+    for (int i = 0; i < N_CONTEXTS; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), i == 0 ? "origin" : "clone %d", i);
+        mismatches += compare(name, out + i * N_FRAMES * OUT_SIZE,
+                              ref + i * N_FRAMES * OUT_SIZE, N_FRAMES);
+    }
+
+    /* a clone is released before its origin, which keeps its weights */
+    for (int i = 1; i < N_CONTEXTS; i++) {
+        csinn_free_session_clone(ctx[i]);
+    }
+    csinn_session_reset_state(sess);
+    run_frames(sess, stream[1], 0, N_FRAMES, out);
+    mismatches += compare("origin after the clones", out, ref + N_FRAMES * OUT_SIZE, N_FRAMES);
+
+    csinn_session_deinit(sess);
+    csinn_free_session(sess);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test concurrent runs of session clones.\n");
+    srand(1);
+    float *stream[N_CONTEXTS];
+    for (int i = 0; i < N_CONTEXTS; i++) {
+        stream[i] = random_stream(N_FRAMES);
+    }
+    float *warmup = random_stream(3);
+    int mismatches = verify_concurrent(stream, warmup);
+    for (int i = 0; i < N_CONTEXTS; i++) {
+        shl_mem_free(stream[i]);
+    }
+    shl_mem_free(warmup);
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "shl_gref.h"
+#include "shl_utils.h"
+#include "test_utils.h"
+
+/*
+ * Streaming states of an fsmn followed by a cache_matmul: frames replayed after a restore
+ * or a reset, and two streams interleaved on one session through bound state sets, must
+ * give the outputs of a session that saw the frames uninterrupted.
+ */
+
+#define LENGTH 24
+#define L_ORDER 3
+#define L_STRIDE 1
+#define R_ORDER 1
+#define R_STRIDE 1
+#define LEN_ORDER (L_ORDER * L_STRIDE + (R_ORDER - 1) * R_STRIDE + 1)
+#define OUT_C 8
+#define WINDOW 5
+#define OUT_SIZE (WINDOW * OUT_C)
+#define N_FRAMES 7
+#define M_FRAMES 9
+
+static struct csinn_tensor *tensor(struct csinn_session *sess, int dim_count, int d0, int d1,
+                                   int d2, int d3)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(sess);
+    t->dim[0] = d0;
+    t->dim[1] = d1;
+    t->dim[2] = d2;
+    t->dim[3] = d3;
+    t->dim_count = dim_count;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->layout = CSINN_LAYOUT_NCHW;
+    return t;
+}
+
+/* constant tensor of random data, or zeros, the same for every session after one srand */
+static struct csinn_tensor *constant(struct csinn_session *sess, int d0, int d1, bool zero)
+{
+    struct csinn_tensor *t = tensor(sess, d1 > 0 ? 2 : 1, d0, d1, 0, 0);
+    t->layout = d1 > 0 ? CSINN_LAYOUT_NC : CSINN_LAYOUT_N;
+    t->is_const = true;
+    int size = csinn_tensor_size(t);
+    float *data = shl_mem_alloc(size * sizeof(float));
+    for (int i = 0; i < size && !zero; i++) {
+        data[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    t->data = data;
+    return t;
+}
+
+static struct csinn_session *build_session()
+{
+    struct csinn_session *sess = csinn_alloc_session();
+    sess->base_api = CSINN_API;
+    sess->base_run_mode = CSINN_RM_CPU_GRAPH;
+    sess->base_dtype = CSINN_DTYPE_FLOAT32;
+    sess->base_quant_type = CSINN_QUANT_FLOAT32;
+    sess->model.save_mode = CSINN_RUN_ONLY;
+    csinn_session_init(sess);
+    csinn_set_input_number(1, sess);
+    csinn_set_output_number(1, sess);
+
+    struct csinn_tensor *frame = tensor(sess, 2, 1, LENGTH, 0, 0);
+    frame->layout = CSINN_LAYOUT_NC;
+    csinn_set_tensor_entry(frame, sess);
+    csinn_set_input(0, frame, sess);
+    srand(0);
+
+    /* fsmn, whose frame sequence and counter are states */
+    struct csinn_tensor *l_filter = constant(sess, L_ORDER, LENGTH, false);
+    struct csinn_tensor *r_filter = constant(sess, R_ORDER, LENGTH, false);
+    struct csinn_tensor *sequence = constant(sess, LEN_ORDER, LENGTH, true);
+    struct csinn_tensor *counter = constant(sess, 1, 0, true);
+    counter->dtype = CSINN_DTYPE_INT32;
+    struct csinn_tensor *memory = tensor(sess, 3, 1, 1, LENGTH, 0);
+    struct csinn_fsmn_params *fsmn = csinn_alloc_params(sizeof(struct csinn_fsmn_params), sess);
+    fsmn->base.name = "fsmn";
+    fsmn->l_order = L_ORDER;
+    fsmn->r_order = R_ORDER;
+    fsmn->l_stride = L_STRIDE;
+    fsmn->r_stride = R_STRIDE;
+    fsmn->unavailable_frames = 2;
+    csinn_fsmn_init(frame, l_filter, r_filter, sequence, counter, memory, fsmn);
+    csinn_fsmn(frame, l_filter, r_filter, sequence, counter, memory, fsmn);
+
+    /* cache_matmul keeping the last WINDOW projections, its ring buffer is a state */
+    static int32_t shape[4] = {1, WINDOW, 1, OUT_C};
+    static int32_t axes[4] = {0, 2, 1, 3};
+    struct csinn_tensor *weight = constant(sess, LENGTH, OUT_C, false);
+    struct csinn_tensor *bias = constant(sess, OUT_C, 0, false);
+    ((float *)bias->data)[0] = 1.0f;  // a non-zero bias appends frames at the back
+    struct csinn_tensor *output = tensor(sess, 4, 1, WINDOW, 1, OUT_C);
+    struct csinn_cache_matmul_params *cache =
+        csinn_alloc_params(sizeof(struct csinn_cache_matmul_params), sess);
+    cache->base.name = "cache_matmul";
+    cache->cache_shape = shape;
+    cache->shape = shape;
+    cache->axes = axes;
+    csinn_cache_matmul_init(memory, output, weight, bias, cache);
+    csinn_cache_matmul(memory, output, weight, bias, cache);
+
+    csinn_set_output(0, output, sess);
+    csinn_session_setup(sess);
+    return sess;
+}
+
+/* run frames [begin, end) of stream, outputs at out */
+static void run_frames(struct csinn_session *sess, float *stream, int begin, int end, float *out)
+{
+    struct csinn_tensor *frame = tensor(NULL, 2, 1, LENGTH, 0, 0);
+    struct csinn_tensor *output = csinn_alloc_tensor(NULL);
+    for (int i = begin; i < end; i++) {
+        frame->data = stream + i * LENGTH;
+        csinn_update_input(0, frame, sess);
+        csinn_session_run(sess);
+        csinn_get_output(0, output, sess);
+        memcpy(out + (i - begin) * OUT_SIZE, output->data, OUT_SIZE * sizeof(float));
+    }
+    csinn_free_tensor(frame);
+    csinn_free_tensor(output);
+}
+
+static float *random_stream(int frames)
+{
+    float *stream = shl_mem_alloc(frames * LENGTH * sizeof(float));
+    for (int i = 0; i < frames * LENGTH; i++) {
+        stream[i] = (float)rand() / RAND_MAX * 2 - 1;
+    }
+    return stream;
+}
+
+static int compare(const char *name, float *out, float *ref, int frames)
+{
+    for (int i = 0; i < frames * OUT_SIZE; i++) {
+        if (out[i] != ref[i]) {
+            printf("%s: frame %d output %d differs, %f vs %f\n", name, i / OUT_SIZE,
+                   i % OUT_SIZE, out[i], ref[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* the frame sequence, the frame counter and the cache ring, in graph order */
+static int verify_enumerate(struct csinn_session *sess)
+{
+    int num = csinn_get_state_number(sess);
+    if (num != 3) {
+        printf("%d states, 3 expected\n", num);
+        return 1;
+    }
+    size_t sizes[3] = {LEN_ORDER * LENGTH * sizeof(float), sizeof(int32_t),
+                       OUT_SIZE * sizeof(float)};
+    struct csinn_tensor *state = csinn_alloc_tensor(NULL);
+    int mismatches = 0;
+    for (int i = 0; i < num; i++) {
+        if (csinn_get_state(i, state, sess) != CSINN_TRUE ||
+            csinn_tensor_byte_size(state) != sizes[i] || state->data == NULL) {
+            printf("state %d: %d bytes, %zu expected\n", i, csinn_tensor_byte_size(state),
+                   sizes[i]);
+            mismatches++;
+        }
+    }
+    if (csinn_get_state(num, state, sess) == CSINN_TRUE) {
+        printf("state %d out of range accepted\n", num);
+        mismatches++;
+    }
+    csinn_free_tensor(state);
+    return mismatches;
+}
+
+/* N frames, save, M frames, restore, the same M frames again; reset replays the start */
+static int verify_save_restore(float *stream)
+{
+    int total = N_FRAMES + M_FRAMES;
+    float *ref = shl_mem_alloc(total * OUT_SIZE * sizeof(float));
+    float *out = shl_mem_alloc(total * OUT_SIZE * sizeof(float));
+    struct csinn_session *sess = build_session();
+    int mismatches = verify_enumerate(sess);
+
+    run_frames(sess, stream, 0, total, ref);
+    csinn_session_reset_state(sess);
+    run_frames(sess, stream, 0, N_FRAMES, out);
+    mismatches += compare("reset", out, ref, N_FRAMES);
+
+    struct csinn_session_state *saved = csinn_alloc_session_state(sess);
+    csinn_session_save_state(saved, sess);
+    run_frames(sess, stream, N_FRAMES, total, out + N_FRAMES * OUT_SIZE);
+    mismatches += compare("after save", out, ref, total);
+    csinn_session_restore_state(saved, sess);
+    memset(out, 0, total * OUT_SIZE * sizeof(float));
+    run_frames(sess, stream, N_FRAMES, total, out);
+    mismatches += compare("after restore", out, ref + N_FRAMES * OUT_SIZE, M_FRAMES);
+
+    csinn_free_session_state(saved);
+    csinn_session_deinit(sess);
+    csinn_free_session(sess);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return mismatches;
+}
+
+/*
+ * Two streams on one session through bound sets, the session's own states carrying a
+ * third stream in between, against a session per stream. The last frame of stream b is
+ * run after the session was deinitialized with its set bound and advanced.
+ */
+static int verify_bind(float *stream_a, float *stream_b, float *stream_c)
+{
+    int total = N_FRAMES + M_FRAMES;
+    int len = total + 2;
+    float *ref = shl_mem_alloc(3 * len * OUT_SIZE * sizeof(float));
+    float *out = shl_mem_alloc(3 * len * OUT_SIZE * sizeof(float));
+    float *stream[3] = {stream_a, stream_b, stream_c};
+    for (int i = 0; i < 3; i++) {
+        struct csinn_session *alone = build_session();
+        run_frames(alone, stream[i], 0, len, ref + i * len * OUT_SIZE);
+        csinn_session_deinit(alone);
+        csinn_free_session(alone);
+    }
+
+    struct csinn_session *sess = build_session();
+    struct csinn_session_state *state[2] = {csinn_alloc_session_state(sess),
+                                            csinn_alloc_session_state(sess)};
+    for (int f = 0; f < total; f++) {
+        for (int i = 0; i < 3; i++) {
+            csinn_session_bind_state(i < 2 ? state[i] : NULL, sess);
+            run_frames(sess, stream[i], f, f + 1, out + (i * len + f) * OUT_SIZE);
+        }
+    }
+    int mismatches = 0;
+    mismatches += compare("bound a", out, ref, total);
+    mismatches += compare("bound b", out + len * OUT_SIZE, ref + len * OUT_SIZE, total);
+    mismatches += compare("own states", out + 2 * len * OUT_SIZE, ref + 2 * len * OUT_SIZE,
+                          total);
+
+    /*
+     * deinit unbinds the set and leaves it to its owner, the ring position the bound
+     * frame moved in params is written back so the set still holds the stream
+     */
+    csinn_session_bind_state(state[1], sess);
+    run_frames(sess, stream_b, total, total + 1, out);
+    csinn_session_deinit(sess);
+    csinn_free_session(sess);
+    sess = build_session();
+    csinn_session_restore_state(state[1], sess);
+    run_frames(sess, stream_b, total + 1, len, out);
+    mismatches += compare("bound b after deinit", out, ref + (2 * len - 1) * OUT_SIZE, 1);
+
+    csinn_session_deinit(sess);
+    csinn_free_session(sess);
+    csinn_free_session_state(state[0]);
+    csinn_free_session_state(state[1]);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test save, restore, reset and binding of streaming states.\n");
+    int total = N_FRAMES + M_FRAMES;
+    srand(1);
+    float *stream_a = random_stream(total + 2);
+    float *stream_b = random_stream(total + 2);
+    float *stream_c = random_stream(total + 2);
+    int mismatches = 0;
+    mismatches += verify_save_restore(stream_a);
+    mismatches += verify_bind(stream_a, stream_b, stream_c);
+    shl_mem_free(stream_a);
+    shl_mem_free(stream_b);
+    shl_mem_free(stream_c);
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "reference/ref.h"
+#include "rvv/rvv.h"
+#include "test_utils.h"
+
+/*
+ * The integer softmax, layer_norm and rms_norm kernels against the fp32 reference run on
+ * the dequantized inputs: every output must be within one int8 code of the quantized
+ * reference.
+ */
+
+/* random int8 codes of shape dim[0, dim_count) */
+static struct csinn_tensor *int8_tensor(int dim_count, int d0, int d1, int d2, float scale,
+                                        int32_t zp)
+{
+    enum csinn_layout_enum layouts[] = {CSINN_LAYOUT_N, CSINN_LAYOUT_NC, CSINN_LAYOUT_NCW};
+    struct csinn_tensor *t = csinn_alloc_tensor(NULL);
+    t->dim[0] = d0;
+    t->dim[1] = d1;
+    t->dim[2] = d2;
+    t->dim_count = dim_count;
+    t->dtype = CSINN_DTYPE_INT8;
+    t->layout = layouts[dim_count - 1];
+    t->qinfo->scale = scale;
+    t->qinfo->zero_point = zp;
+    int size = csinn_tensor_size(t);
+    int8_t *data = shl_mem_alloc(size);
+    for (int i = 0; i < size; i++) {
+        data[i] = rand() % 256 - 128;
+    }
+    t->data = data;
+    return t;
+}
+
+static void free_int8_tensor(struct csinn_tensor *t)
+{
+    shl_mem_free(t->data);
+    csinn_free_tensor(t);
+}
+
+/* quantize the fp32 reference into the output qinfo and count the codes more than one apart */
+static int verify_codes(const char *name, struct csinn_tensor *output, float *ref)
+{
+    int size = csinn_tensor_size(output);
+    int8_t *out = output->data;
+    int mismatches = 0;
+    for (int i = 0; i < size; i++) {
+        int32_t code = (int32_t)roundf(ref[i] / output->qinfo->scale) + output->qinfo->zero_point;
+        code = code > 127 ? 127 : (code < -128 ? -128 : code);
+        if (abs(out[i] - code) > 1) {
+            if (mismatches == 0) {
+                printf("%s: %d differs, %d vs %d\n", name, i, out[i], code);
+            }
+            mismatches++;
+        }
+    }
+    float *fout = shl_mem_alloc(size * sizeof(float));
+    for (int i = 0; i < size; i++) {
+        fout[i] = (out[i] - output->qinfo->zero_point) * output->qinfo->scale;
+    }
+    evaluate_error(fout, ref, size, CSINN_DTYPE_FLOAT32);
+    shl_mem_free(fout);
+    return mismatches;
+}
+
+static int verify_softmax(int outer, int cnt, int inner, float in_scale)
+{
+    struct csinn_tensor *input = int8_tensor(3, outer, cnt, inner, in_scale, 0);
+    struct csinn_tensor *output = int8_tensor(3, outer, cnt, inner, 1.0f / 256, -128);
+    struct csinn_softmax_params *params =
+        csinn_alloc_params(sizeof(struct csinn_softmax_params), NULL);
+    params->axis = 1;
+
+    struct csinn_tensor *finput = shl_ref_tensor_transform_f32(input);
+    struct csinn_tensor *foutput = shl_ref_tensor_transform_f32(output);
+    shl_ref_softmax_f32(finput, foutput, params);
+    shl_rvv_softmax_int8(input, output, params);
+
+    char name[64];
+    snprintf(name, sizeof(name), "softmax %dx%dx%d scale %g", outer, cnt, inner, in_scale);
+    int mismatches = verify_codes(name, output, foutput->data);
+
+    shl_ref_tensor_transform_free_f32(finput);
+    shl_ref_tensor_transform_free_f32(foutput);
+    free_int8_tensor(input);
+    free_int8_tensor(output);
+    shl_mem_free(params);
+    return mismatches;
+}
+
+static int verify_layer_norm(int rows, int cols, int32_t in_zp)
+{
+    struct csinn_tensor *input = int8_tensor(2, rows, cols, 0, 0.05f, in_zp);
+    struct csinn_tensor *output = int8_tensor(2, rows, cols, 0, 0.04f, 3);
+    struct csinn_tensor *gamma = int8_tensor(1, cols, 0, 0, 0.01f, -5);
+    struct csinn_tensor *beta = int8_tensor(1, cols, 0, 0, 0.005f, 7);
+    struct csinn_layer_norm_params *params =
+        csinn_alloc_params(sizeof(struct csinn_layer_norm_params), NULL);
+    params->epsilon = 1e-5f;
+    params->center = true;
+    params->scale = true;
+    params->axis = 1;
+
+    struct csinn_tensor *finput = shl_ref_tensor_transform_f32(input);
+    struct csinn_tensor *foutput = shl_ref_tensor_transform_f32(output);
+    struct csinn_tensor *fgamma = shl_ref_tensor_transform_f32(gamma);
+    struct csinn_tensor *fbeta = shl_ref_tensor_transform_f32(beta);
+    shl_ref_layer_norm_f32(finput, foutput, fgamma, fbeta, params);
+    shl_rvv_layer_norm_int8(input, output, gamma, beta, params);
+
+    char name[64];
+    snprintf(name, sizeof(name), "layer_norm %dx%d zp %d", rows, cols, in_zp);
+    int mismatches = verify_codes(name, output, foutput->data);
+
+    shl_ref_tensor_transform_free_f32(finput);
+    shl_ref_tensor_transform_free_f32(foutput);
+    shl_ref_tensor_transform_free_f32(fgamma);
+    shl_ref_tensor_transform_free_f32(fbeta);
+    free_int8_tensor(input);
+    free_int8_tensor(output);
+    free_int8_tensor(gamma);
+    free_int8_tensor(beta);
+    shl_mem_free(params);
+    return mismatches;
+}
+
+static int verify_rms_norm(int rows, int cols, int32_t in_zp)
+{
+    struct csinn_tensor *input = int8_tensor(2, rows, cols, 0, 0.05f, in_zp);
+    struct csinn_tensor *output = int8_tensor(2, rows, cols, 0, 0.02f, -4);
+    struct csinn_tensor *weight = int8_tensor(1, cols, 0, 0, 0.01f, 6);
+    struct csinn_rms_norm_params *params =
+        csinn_alloc_params(sizeof(struct csinn_rms_norm_params), NULL);
+    params->epsilon = 1e-5f;
+    params->axis = 1;
+
+    struct csinn_tensor *finput = shl_ref_tensor_transform_f32(input);
+    struct csinn_tensor *foutput = shl_ref_tensor_transform_f32(output);
+    struct csinn_tensor *fweight = shl_ref_tensor_transform_f32(weight);
+    shl_ref_rms_norm_f32(finput, fweight, foutput, params);
+    shl_rvv_rms_norm_int8(input, weight, output, params);
+
+    char name[64];
+    snprintf(name, sizeof(name), "rms_norm %dx%d zp %d", rows, cols, in_zp);
+    int mismatches = verify_codes(name, output, foutput->data);
+
+    shl_ref_tensor_transform_free_f32(finput);
+    shl_ref_tensor_transform_free_f32(foutput);
+    shl_ref_tensor_transform_free_f32(fweight);
+    free_int8_tensor(input);
+    free_int8_tensor(output);
+    free_int8_tensor(weight);
+    shl_mem_free(params);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test integer softmax, layer_norm and rms_norm for RVV.\n");
+    int mismatches = 0;
+    /* the last axis, a strided middle axis, a scale saturating the exp range */
+    mismatches += verify_softmax(5, 37, 1, 0.1f);
+    mismatches += verify_softmax(3, 10, 7, 0.05f);
+    mismatches += verify_softmax(2, 129, 1, 2.0f);
+    /* rows shorter and longer than a vector, a biased input */
+    mismatches += verify_layer_norm(4, 13, 0);
+    mismatches += verify_layer_norm(3, 200, 20);
+    mismatches += verify_rms_norm(4, 13, 0);
+    mismatches += verify_rms_norm(3, 200, -20);
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
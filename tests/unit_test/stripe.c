@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2016-2023 C-SKY Microsystems Co., Ltd. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csi_nn.h"
+#include "shl_gref.h"
+#include "shl_utils.h"
+#include "test_utils.h"
+
+/* sessions run more than once, the chains must not leave stale buffers behind */
+#define RUNS 2
+
+static struct csinn_tensor *feature(struct csinn_session *sess, int c, int h, int w)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(sess);
+    t->dim[0] = 1;
+    t->dim[1] = c;
+    t->dim[2] = h;
+    t->dim[3] = w;
+    t->dim_count = 4;
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->layout = CSINN_LAYOUT_NCHW;
+    return t;
+}
+
+/* constant tensors of random data, the same for every session built after one srand */
+static struct csinn_tensor *constant(struct csinn_session *sess, int o, int i, int k)
+{
+    struct csinn_tensor *t = csinn_alloc_tensor(sess);
+    t->dim[0] = o;
+    t->dim_count = 1;
+    t->layout = CSINN_LAYOUT_O;
+    if (i > 0) {
+        t->dim[1] = i;
+        t->dim[2] = k;
+        t->dim[3] = k;
+        t->dim_count = 4;
+        t->layout = CSINN_LAYOUT_OIHW;
+    }
+    t->dtype = CSINN_DTYPE_FLOAT32;
+    t->is_const = true;
+    int size = csinn_tensor_size(t);
+    float *data = shl_mem_alloc(size * sizeof(float));
+    for (int j = 0; j < size; j++) {
+        data[j] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    t->data = data;
+    return t;
+}
+
+static struct csinn_tensor *conv(struct csinn_session *sess, struct csinn_tensor *input,
+                                 int out_c, int k, int stride, int pad, int group)
+{
+    int out_h = (input->dim[2] + 2 * pad - k) / stride + 1;
+    int out_w = (input->dim[3] + 2 * pad - k) / stride + 1;
+    struct csinn_tensor *output = feature(sess, out_c, out_h, out_w);
+    struct csinn_tensor *kernel = constant(sess, out_c, input->dim[1] / group, k);
+    struct csinn_tensor *bias = constant(sess, out_c, 0, 0);
+    struct csinn_conv2d_params *params =
+        csinn_alloc_params(sizeof(struct csinn_conv2d_params), sess);
+    params->stride_height = stride;
+    params->stride_width = stride;
+    params->pad_top = pad;
+    params->pad_down = pad;
+    params->pad_left = pad;
+    params->pad_right = pad;
+    params->dilation_height = 1;
+    params->dilation_width = 1;
+    params->group = group;
+    params->base.layout = CSINN_LAYOUT_NCHW;
+    params->conv_extra.conv_mode = CSINN_DIRECT;
+    csinn_conv2d_init(input, output, kernel, bias, params);
+    csinn_conv2d(input, output, kernel, bias, params);
+    return output;
+}
+
+static struct csinn_tensor *relu6(struct csinn_session *sess, struct csinn_tensor *input)
+{
+    struct csinn_tensor *output = feature(sess, input->dim[1], input->dim[2], input->dim[3]);
+    struct csinn_relu_params *params = csinn_alloc_params(sizeof(struct csinn_relu_params), sess);
+    params->n = 6;
+    csinn_relu6_init(input, output, params);
+    csinn_relu6(input, output, params);
+    return output;
+}
+
+static struct csinn_tensor *pool(struct csinn_session *sess, struct csinn_tensor *input, bool max,
+                                 int k, int stride, int pad)
+{
+    int out_h = (input->dim[2] + 2 * pad - k) / stride + 1;
+    int out_w = (input->dim[3] + 2 * pad - k) / stride + 1;
+    struct csinn_tensor *output = feature(sess, input->dim[1], out_h, out_w);
+    struct csinn_pool_params *params = csinn_alloc_params(sizeof(struct csinn_pool_params), sess);
+    params->filter_height = k;
+    params->filter_width = k;
+    params->stride_height = stride;
+    params->stride_width = stride;
+    params->pad_top = pad;
+    params->pad_down = pad;
+    params->pad_left = pad;
+    params->pad_right = pad;
+    params->count_include_pad = false;
+    params->base.layout = CSINN_LAYOUT_NCHW;
+    if (max) {
+        csinn_maxpool2d_init(input, output, params);
+        csinn_maxpool2d(input, output, params);
+    } else {
+        csinn_avgpool2d_init(input, output, params);
+        csinn_avgpool2d(input, output, params);
+    }
+    return output;
+}
+
+static struct csinn_tensor *sigmoid(struct csinn_session *sess, struct csinn_tensor *input)
+{
+    struct csinn_tensor *output = feature(sess, input->dim[1], input->dim[2], input->dim[3]);
+    struct csinn_sigmoid_params *params =
+        csinn_alloc_params(sizeof(struct csinn_sigmoid_params), sess);
+    csinn_sigmoid_init(input, output, params);
+    csinn_sigmoid(input, output, params);
+    return output;
+}
+
+/* pointwise expand, depthwise, pointwise project with activations in between */
+static struct csinn_tensor *inverted_residual(struct csinn_session *sess,
+                                             struct csinn_tensor *input)
+{
+    struct csinn_tensor *t = conv(sess, input, 32, 1, 1, 0, 1);
+    t = relu6(sess, t);
+    t = conv(sess, t, 32, 3, 1, 1, 32);
+    t = relu6(sess, t);
+    return conv(sess, t, 8, 1, 1, 0, 1);
+}
+
+/* spatial layers whose stripes all need halo rows, with pads at both tensor edges */
+static struct csinn_tensor *tiled_chain(struct csinn_session *sess, struct csinn_tensor *input)
+{
+    struct csinn_tensor *t = conv(sess, input, 8, 3, 1, 1, 1);
+    t = pool(sess, t, true, 2, 2, 0);
+    t = relu6(sess, t);
+    t = conv(sess, t, 8, 3, 2, 1, 1);
+    t = pool(sess, t, false, 3, 1, 1);
+    return sigmoid(sess, t);
+}
+
+/*
+ * Build the graph of chain on a fresh session and run it RUNS times. budget < 0 runs
+ * every layer on its own. Returns the number of layers the first fused chain spans.
+ */
+static int run_chain(struct csinn_tensor *(*chain)(struct csinn_session *, struct csinn_tensor *),
+                     int32_t budget, bool tiling, float *input_data, int in_c, int in_h,
+                     int in_w, float *output_data, int out_size)
+{
+    struct csinn_session *sess = csinn_alloc_session();
+    sess->base_api = CSINN_API;
+    sess->base_run_mode = CSINN_RM_CPU_GRAPH;
+    sess->base_dtype = CSINN_DTYPE_FLOAT32;
+    sess->base_quant_type = CSINN_QUANT_FLOAT32;
+    sess->model.save_mode = CSINN_RUN_ONLY;
+    csinn_session_init(sess);
+    shl_gref_set_stripe_budget(sess, budget);
+    shl_gref_set_stripe_tiling(sess, tiling);
+    csinn_set_input_number(1, sess);
+    csinn_set_output_number(1, sess);
+
+    struct csinn_tensor *input = feature(sess, in_c, in_h, in_w);
+    csinn_set_tensor_entry(input, sess);
+    csinn_set_input(0, input, sess);
+    srand(0);
+    struct csinn_tensor *output = chain(sess, input);
+    csinn_set_output(0, output, sess);
+    csinn_session_setup(sess);
+
+    struct shl_gref_target_data *td = sess->td;
+    struct shl_gref_stripe *stripe = td->stripe;
+    int fused = 0;
+    for (int i = 0; stripe != NULL && i < td->graph->layer_index && fused == 0; i++) {
+        fused = stripe[i].layer_num;
+    }
+
+    struct csinn_tensor *real_input = feature(NULL, in_c, in_h, in_w);
+    real_input->data = input_data;
+    for (int r = 0; r < RUNS; r++) {
+        csinn_update_input(0, real_input, sess);
+        csinn_session_run(sess);
+        csinn_get_output(0, output, sess);
+        memcpy(output_data + r * out_size, output->data, out_size * sizeof(float));
+    }
+
+    csinn_free_tensor(real_input);
+    csinn_session_deinit(sess);
+    csinn_free_session(sess);
+    return fused;
+}
+
+static int verify_chain(struct csinn_tensor *(*chain)(struct csinn_session *,
+                                                     struct csinn_tensor *),
+                        int32_t budget, bool tiling, int min_layers, int in_c, int in_h, int in_w,
+                        int out_size, const char *name)
+{
+    int in_size = in_c * in_h * in_w;
+    float *input = shl_mem_alloc(in_size * sizeof(float));
+    for (int i = 0; i < in_size; i++) {
+        input[i] = (float)rand() / RAND_MAX * 2 - 1;
+    }
+    float *ref = shl_mem_alloc(RUNS * out_size * sizeof(float));
+    float *out = shl_mem_alloc(RUNS * out_size * sizeof(float));
+
+    int mismatches = 0;
+    run_chain(chain, -1, false, input, in_c, in_h, in_w, ref, out_size);
+    int fused = run_chain(chain, budget, tiling, input, in_c, in_h, in_w, out, out_size);
+    if (fused < min_layers) {
+        printf("%s: %d layers fused, expected %d\n", name, fused, min_layers);
+        mismatches++;
+    }
+    for (int i = 0; i < RUNS * out_size; i++) {
+        if (fabs(ref[i] - out[i]) > 1e-4f * (1 + fabs(ref[i]))) {
+            printf("%s: run %d output %d differs, %f vs %f\n", name, i / out_size,
+                   i % out_size, out[i], ref[i]);
+            mismatches++;
+            break;
+        }
+    }
+    evaluate_error(out, ref, RUNS * out_size, CSINN_DTYPE_FLOAT32);
+
+    shl_mem_free(input);
+    shl_mem_free(ref);
+    shl_mem_free(out);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    init_testsuite("Test row-stripe execution against unfused graphs.\n");
+    int mismatches = 0;
+    /* a budget of a few rows of the 32 channel intermediates, several stripes per block */
+    mismatches += verify_chain(inverted_residual, 48 * 1024, false, 5, 8, 20, 20, 8 * 20 * 20,
+                               "inverted residual");
+    /* 52x52 input, 13x13 output: a 4 KiB budget runs the chain in stripes of a few rows */
+    mismatches += verify_chain(tiled_chain, 4 * 1024, true, 6, 4, 52, 52, 8 * 13 * 13,
+                               "tiled chain");
+    if (mismatches > 0) {
+        return EXIT_FAILURE;
+    }
+    return done_testing();
+}
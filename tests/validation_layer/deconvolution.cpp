@@ -18,6 +18,92 @@
 
 #include "testutil.h"
 
+#if (DTYPE == 8)
+/* stride 2, uneven padding and 2 groups of 3 output channels */
+static struct csinn_conv2d_params *group_deconv2d_params(struct csinn_session *sess)
+{
+    struct csinn_conv2d_params *params =
+        (csinn_conv2d_params *)csinn_alloc_params(sizeof(struct csinn_conv2d_params), sess);
+    params->group = 2;
+    params->stride_height = 2;
+    params->stride_width = 2;
+    params->pad_top = 1;
+    params->pad_down = 0;
+    params->pad_left = 2;
+    params->pad_right = 1;
+    params->dilation_height = 1;
+    params->dilation_width = 1;
+    params->base.layout = CSINN_LAYOUT_NCHW;
+    return params;
+}
+
+/*
+ * Built-in int8 case for the gemm + col2im kernel, every group ends on a partial block of
+ * 4 output channels. The fp32 reference comes from the reference api in layer mode.
+ */
+static void test_group_deconv2d_int8(float *difference)
+{
+    struct csinn_session *ref_sess = csinn_alloc_session();
+    ref_sess->base_api = CSINN_REF;
+    ref_sess->base_run_mode = CSINN_RM_LAYER;
+    struct csinn_session *sess = csinn_alloc_session();
+    sess->base_run_mode = CSINN_RM_CPU_GRAPH;
+    sess->model.save_mode = CSINN_RUN_ONLY;
+    sess->dynamic_shape = CSINN_FALSE;
+    struct csinn_tensor *input = csinn_alloc_tensor(sess);
+    struct csinn_tensor *output = csinn_alloc_tensor(sess);
+    struct csinn_tensor *kernel = csinn_alloc_tensor(sess);
+    struct csinn_tensor *bias = csinn_alloc_tensor(sess);
+
+    input->dim[0] = 2;
+    input->dim[1] = 4;
+    input->dim[2] = 5;
+    input->dim[3] = 6;
+    kernel->dim[0] = 4;  // i
+    kernel->dim[1] = 3;  // o of one group
+    kernel->dim[2] = 3;
+    kernel->dim[3] = 4;
+    bias->dim[0] = 6;
+    output->dim[0] = 2;
+    output->dim[1] = 6;
+    output->dim[2] = (5 - 1) * 2 - 1 + 3;
+    output->dim[3] = (6 - 1) * 2 - 3 + 4;
+
+    struct csinn_tensor *tensors[4] = {input, kernel, bias, output};
+    for (int i = 0; i < 4; i++) {
+        struct csinn_tensor *t = tensors[i];
+        t->dim_count = t == bias ? 1 : 4;
+        t->dtype = CSINN_DTYPE_FLOAT32;
+        t->layout = CSINN_LAYOUT_NCHW;
+        t->is_const = t == kernel || t == bias;
+        t->quant_channel = 1;
+        int size = csinn_tensor_size(t);
+        float *data = (float *)malloc(size * sizeof(float));
+        for (int j = 0; j < size; j++) {
+            data[j] = (float)rand() / RAND_MAX * 2 - 1;
+        }
+        t->data = data;
+    }
+    kernel->layout = CSINN_LAYOUT_IOHW;
+    bias->layout = CSINN_LAYOUT_O;
+
+    struct csinn_conv2d_params *ref_params = group_deconv2d_params(ref_sess);
+    csinn_deconv2d_init(input, output, kernel, bias, ref_params);
+    csinn_deconv2d(input, output, kernel, bias, ref_params);
+
+    struct csinn_conv2d_params *params = group_deconv2d_params(sess);
+    params->base.api = CSINN_API;
+    test_conv2d_op(input, output, kernel, bias, params, CSINN_DTYPE_INT8,
+                   CSINN_QUANT_INT8_ASYM_W_SYM, sess, csinn_deconv2d_init, csinn_deconv2d,
+                   difference);
+    for (int i = 0; i < 4; i++) {
+        free(tensors[i]->data);
+    }
+    csinn_free_params(ref_params);
+    csinn_free_session(ref_sess);
+}
+#endif
+
 int main(int argc, char **argv)
 {
     init_testsuite("Testing function of deconvolution(layer).\n");
@@ -115,6 +201,7 @@ int main(int argc, char **argv)
     test_conv2d_op(input, output, kernel, bias, params, CSINN_DTYPE_INT8,
                    CSINN_QUANT_INT8_ASYM_W_SYM, sess, csinn_deconv2d_init, csinn_deconv2d,
                    &difference);
+    test_group_deconv2d_int8(&difference);
 #elif (DTYPE == 168)
     test_conv2d_op(input, output, kernel, bias, params, CSINN_DTYPE_FLOAT16,
                    CSINN_QUANT_FLOAT16_W_INT8, sess, csinn_deconv2d_init, csinn_deconv2d,